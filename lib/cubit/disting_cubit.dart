@@ -14,6 +14,7 @@ import 'package:nt_helper/db/database.dart'; // Added
 import 'package:nt_helper/domain/cc_reverse_lookup.dart';
 import 'package:nt_helper/domain/disting_midi_manager.dart';
 import 'package:nt_helper/domain/midi_command_factory.dart';
+import 'package:nt_helper/domain/midi_message_transport.dart';
 import 'package:nt_helper/domain/disting_nt_sysex.dart';
 import 'package:nt_helper/domain/i_disting_midi_manager.dart';
 import 'package:nt_helper/domain/mock_disting_midi_manager.dart';
@@ -28,6 +29,7 @@ import 'package:nt_helper/models/firmware_version.dart';
 import 'package:nt_helper/models/firmware_release.dart';
 import 'package:nt_helper/models/performance_page_item.dart';
 import 'package:nt_helper/services/firmware_version_service.dart';
+import 'package:nt_helper/services/platform_channels/alsa_midi_transport.dart';
 import 'package:nt_helper/ui/parameter_editor_registry.dart';
 import 'package:nt_helper/services/settings_service.dart';
 import 'package:nt_helper/services/startup_log_service.dart';
@@ -608,6 +608,7 @@ class _ConnectionDelegate {
         inputDevice: inputDevice,
         outputDevice: outputDevice,
         sysExId: sysExId,
+        transport: _openNativeTransport(inputDevice, outputDevice),
       );
 
       // Emit Connected state WITH the new manager AND devices
@@ -693,6 +694,41 @@ class _ConnectionDelegate {
     }
   }
 
+  /// The native ALSA sequencer transport to the same device, when it is
+  /// enabled and available; null keeps the manager on flutter_midi_command.
+  MidiMessageTransport? _openNativeTransport(
+    MidiDevice inputDevice,
+    MidiDevice outputDevice,
+  ) {
+    if (!Platform.isLinux) {
+      return null;
+    }
+    const prefix = 'DistingCubit.connectToDevices: MIDI transport:';
+    if (!SettingsService().nativeMidiTransportEnabled) {
+      StartupLogService.log(
+        '$prefix flutter_midi_command (native transport off in settings)',
+      );
+      return null;
+    }
+    if (AlsaMidiBindings.instance == null) {
+      StartupLogService.log(
+        '$prefix flutter_midi_command (libnt_midi.so could not be loaded)',
+      );
+      return null;
+    }
+    final transport = AlsaMidiTransport.open(
+      inputName: inputDevice.name,
+      outputName: outputDevice.name,
+    );
+    StartupLogService.log(
+      transport != null
+          ? '$prefix native ALSA sequencer (libnt_midi)'
+          : '$prefix flutter_midi_command (no ALSA sequencer port for '
+                '"${inputDevice.name}"/"${outputDevice.name}")',
+    );
+    return transport;
+  }
+
   Future<Map<String, List<MidiDevice>>> _fetchDeviceLists() async {
     final devices = await _cubit._midiCommand.devices;
     devices?.sort(
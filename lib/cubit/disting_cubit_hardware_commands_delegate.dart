@@ -6,15 +6,24 @@ class _HardwareCommandsDelegate {
   final DistingCubit _cubit;
 
   Future<Uint8List?> getHardwareScreenshot() async {
+    final fromVideo = await _cubit.videoManager?.captureScreenshot();
+    if (fromVideo != null) {
+      return fromVideo;
+    }
     final disting = _cubit.requireDisting();
     await disting.requestWake();
     return disting.encodeTakeScreenshot();
   }
 
   Future<void> updateScreenshot() async {
-    final disting = _cubit.requireDisting();
-    await disting.requestWake();
-    final screenshot = await disting.encodeTakeScreenshot();
+    // While the display is streaming over USB video, a frame is already at
+    // hand; the SysEx round trip is only needed without one.
+    var screenshot = await _cubit.videoManager?.captureScreenshot();
+    if (screenshot == null) {
+      final disting = _cubit.requireDisting();
+      await disting.requestWake();
+      screenshot = await disting.encodeTakeScreenshot();
+    }
     switch (_cubit.state) {
       case DistingStateSynchronized syncstate:
         _cubit._emitState(syncstate.copyWith(screenshot: screenshot));
@@ -15,6 +15,10 @@ class VideoFrameCubit extends Cubit<VideoFrameState> {
   static const int _fpsBufferSize = 10;
   final DebugService _debugService = DebugService();
 
+  /// Native texture the frames are rendered into, when the platform delivers
+  /// video as a texture instead of encoded frames.
+  final ValueNotifier<int?> textureId = ValueNotifier<int?>(null);
+
   void _debugLog(String message) {
     _debugService.addLocalMessage('[VideoFrameCubit] $message');
   }
@@ -30,6 +34,7 @@ class VideoFrameCubit extends Cubit<VideoFrameState> {
     _frameCounter = 0;
     _lastFrameTime = null;
     _fpsBuffer.clear();
+    textureId.value = null;
 
     // Subscribe to the video stream
     _frameSubscription = videoStream.listen(
@@ -53,6 +58,20 @@ class VideoFrameCubit extends Cubit<VideoFrameState> {
 
   /// Handle incoming video frame
   void _onFrameReceived(dynamic data) {
+    // Texture delivery: the native side announces the texture once and then
+    // only sends frame-count heartbeats, which carry nothing to display.
+    if (data is Map) {
+      final id = data['textureId'];
+      if (id is int) {
+        _debugLog('Video is rendered into texture $id');
+        textureId.value = id;
+      }
+      return;
+    }
+    if (data is int) {
+      return;
+    }
+
     _debugLog(
       'Frame received: ${data.runtimeType}, size: ${data is Uint8List ? data.length : 'unknown'}',
     );
@@ -153,12 +172,14 @@ class VideoFrameCubit extends Cubit<VideoFrameState> {
     } else {
       _debugLog('No active frame subscription to cancel');
     }
+    textureId.value = null;
     emit(const VideoFrameState.initial());
   }
 
   @override
   Future<void> close() {
     _frameSubscription?.cancel();
+    textureId.dispose();
     return super.close();
   }
 }
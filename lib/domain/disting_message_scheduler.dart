@@ -1,26 +1,41 @@
-// disting_message_scheduler.dart - Simple Sequential Scheduler
+// disting_message_scheduler.dart - Windowed Request Scheduler
 // -----------------------------------------------------------------------------
-// Redesigned for reliability and performance:
-// • Simple state machine: idle → sending → waiting → idle
-// • Sequential processing: one request at a time
-// • Single timer approach: no complex timer chains
-// • Immediate processing when idle
+// • Requests are sent in FIFO order. Those awaiting a response sit in
+//   _inFlight, each with its own state (sending → waitingForResponse), timeout
+//   and retry timer.
+// • At most _window requests are in flight. With maxInFlight 1, the default
+//   unless pipelined requests are enabled, that is one at a time.
+// • Requests share the window only when their responses say which request
+//   they answer (_canShareWindow): required requests for slot/parameter
+//   scoped types. Everything else, and any two requests with the same key,
+//   waits for the window to drain and goes alone.
+// • Each in-flight request registers its own handler with the demux
+//   (registerActive); responses are matched to the oldest request whose key
+//   fits, and removeActive/expireActive drop the handler on completion or
+//   timeout.
+// • The window starts at 2 and adapts from the RTT statistics
+//   (_adaptWindow): it grows while responses show no queueing on the device
+//   and shrinks when they do. Every timeout, including those that lead to a
+//   retry, and every truncated SysEx halve it (_shrinkWindow), down to 1.
 // • Retains device filtering and sysEx ID support
 // • Auto-recovery from MIDI stream corruption
 // -----------------------------------------------------------------------------
 
 import 'dart:async';
 import 'dart:collection';
+import 'dart:math' as math;
 import 'package:flutter/foundation.dart';
 import 'package:flutter_midi_command/flutter_midi_command.dart';
 
 // Domain classes
 import 'package:nt_helper/domain/disting_nt_sysex.dart';
+import 'package:nt_helper/domain/midi_message_transport.dart';
 import 'package:nt_helper/domain/request_key.dart';
 import 'package:nt_helper/domain/sd_card_operation.dart';
 import 'package:nt_helper/domain/sysex/response_factory.dart';
 import 'package:nt_helper/domain/sysex/responses/parameter_pages_response.dart';
 import 'package:nt_helper/domain/sysex/sysex_parser.dart';
+import 'package:nt_helper/domain/sysex/sysex_stream_parser.dart';
 
 // -----------------------------------------------------------------------------
 // Response expectation enum
@@ -65,9 +80,11 @@ class _ScheduledRequest {
   final int maxRetries;
   final Duration retryDelay;
 
+  _SchedulerState state = _SchedulerState.sending;
   int attemptCount = 0;
   int transferErrorRecoveryCount = 0;
   Timer? timeoutTimer;
+  Timer? retryTimer;
 
   /// Stopwatch to measure round-trip time from send to response
   final Stopwatch stopwatch = Stopwatch();
@@ -79,7 +96,10 @@ class _ScheduledRequest {
     }
   }
 
-  void dispose() => timeoutTimer?.cancel();
+  void dispose() {
+    timeoutTimer?.cancel();
+    retryTimer?.cancel();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -87,8 +107,9 @@ class _ScheduledRequest {
 // -----------------------------------------------------------------------------
 
 class _ActiveHandler {
-  _ActiveHandler({required this.key, required this.onMatch});
+  _ActiveHandler({required this.id, required this.key, required this.onMatch});
 
+  final int id; // The request's id.
   final RequestKey key;
   final void Function(DistingNTParsedMessage) onMatch;
 }
@@ -101,7 +122,8 @@ class _ExpiredHandler {
 }
 
 class _ResponseDemux {
-  _ActiveHandler? _activeHandler;
+  // One per request in flight, oldest first.
+  final List<_ActiveHandler> _activeHandlers = [];
   final List<_ExpiredHandler> _expiredHandlers = [];
   final List<void Function(DistingNTParsedMessage)> _observers = [];
 
@@ -109,27 +131,40 @@ class _ResponseDemux {
   int unmatchedResponsesDiscarded = 0;
 
   int get expiredHandlerCount => _expiredHandlers.length;
+  int get activeHandlerCount => _activeHandlers.length;
 
   static const int _maxExpiredHandlers = 20;
   static const Duration _expiredHandlerMaxAge = Duration(seconds: 30);
 
+  /// Registers the handler for request [id], replacing any it already has.
   void registerActive(
+    int id,
     RequestKey key,
     void Function(DistingNTParsedMessage) onMatch,
   ) {
-    _activeHandler = _ActiveHandler(key: key, onMatch: onMatch);
+    final handler = _ActiveHandler(id: id, key: key, onMatch: onMatch);
+    final index = _activeHandlers.indexWhere((h) => h.id == id);
+    if (index == -1) {
+      _activeHandlers.add(handler);
+    } else {
+      _activeHandlers[index] = handler;
+    }
   }
 
-  void expireActive() {
-    final handler = _activeHandler;
-    if (handler != null) {
-      _activeHandler = null;
+  void expireActive(int id) {
+    final index = _activeHandlers.indexWhere((h) => h.id == id);
+    if (index != -1) {
+      final handler = _activeHandlers.removeAt(index);
       _expiredHandlers.add(
         _ExpiredHandler(key: handler.key, expiredAt: DateTime.now()),
       );
     }
   }
 
+  void removeActive(int id) {
+    _activeHandlers.removeWhere((h) => h.id == id);
+  }
+
   void addObserver(void Function(DistingNTParsedMessage) observer) {
     _observers.add(observer);
   }
@@ -146,12 +181,15 @@ class _ResponseDemux {
       } catch (_) {}
     }
 
-    // 2. Check active handler first — active request always takes priority
-    if (_activeHandler != null && _activeHandler!.key.matches(parsed)) {
-      final handler = _activeHandler!;
-      _activeHandler = null;
-      handler.onMatch(parsed);
-      return;
+    // 2. Check active handlers first (oldest request first) — active
+    // requests always take priority
+    for (var i = 0; i < _activeHandlers.length; i++) {
+      final handler = _activeHandlers[i];
+      if (handler.key.matches(parsed)) {
+        _activeHandlers.removeAt(i);
+        handler.onMatch(parsed);
+        return;
+      }
     }
 
     // 3. Check expired handlers (oldest first) — absorb stale responses
@@ -186,7 +224,7 @@ class _ResponseDemux {
   }
 
   void clear() {
-    _activeHandler = null;
+    _activeHandlers.clear();
     _expiredHandlers.clear();
   }
 }
@@ -244,19 +282,21 @@ class DistingMessageScheduler {
     Duration defaultTimeout = const Duration(milliseconds: 1000),
     this.defaultMaxRetries = 5,
     Duration defaultRetryDelay = Duration.zero,
+    int maxInFlight = 1,
+    MidiMessageTransport? transport,
+    SysExStreamParser? sysExParser,
   }) : _midi = midiCommand,
+       _transport = transport,
+       _sysExParser = sysExParser,
        _inputDevice = inputDevice,
        _outputDevice = outputDevice,
        _sysExId = sysExId,
        messageInterval = _normalizeDuration(messageInterval),
        defaultTimeout = _normalizeDuration(defaultTimeout),
-       defaultRetryDelay = _normalizeDuration(defaultRetryDelay) {
-    _subscription = _midi.onMidiPacketReceived?.listen(
-      _handleIncomingPacket,
-      onError: _handleSubscriptionError,
-      onDone: _handleSubscriptionDone,
-      cancelOnError: false,
-    );
+       defaultRetryDelay = _normalizeDuration(defaultRetryDelay),
+       maxInFlight = math.max(1, maxInFlight),
+       _window = math.min(2, math.max(1, maxInFlight)) {
+    _subscribe();
     if (_subscription == null) {
       _subscriptionActive = false;
     }
@@ -268,6 +308,14 @@ class DistingMessageScheduler {
   final MidiDevice _outputDevice;
   final int _sysExId;
 
+  // When set, messages go through this instead of flutter_midi_command, and
+  // arrive already framed.
+  final MidiMessageTransport? _transport;
+
+  // When set, flutter_midi_command packets are split into messages by this
+  // rather than by the heuristics in _handleIncoming.
+  final SysExStreamParser? _sysExParser;
+
   static const bool _diagnosticsEnabled = true;
   static int _nextRequestId = 0;
   static const int _maxTransferErrorRecoveries = 1;
@@ -278,12 +326,31 @@ class DistingMessageScheduler {
   final int defaultMaxRetries;
   final Duration defaultRetryDelay;
 
+  /// The window the Pipelined Requests setting allows.
+  static const int defaultMaxInFlight = 8;
+
+  /// The most requests in flight at once. At 1, the default, requests go
+  /// strictly one at a time. Above it the window adapts between 1 and this
+  /// (see [_adaptWindow]), and only requests whose responses identify them
+  /// share it (see [_canShareWindow]); any other request waits for the
+  /// window to drain and then goes alone.
+  final int maxInFlight;
+
+  // Windowed mode: the current window, and responses since it last moved.
+  int _window;
+  int _responsesSinceWindowChange = 0;
+
+  // Estimated requests waiting inside the device, below which the window
+  // grows and above which it shrinks.
+  static const double _windowQueuedLow = 1;
+  static const double _windowQueuedHigh = 3;
+
   // State management
-  _SchedulerState _state = _SchedulerState.idle;
   final Queue<_ScheduledRequest> _queue = Queue();
-  _ScheduledRequest? _currentRequest;
+  // Requests sent and not yet finished, oldest first. At most one unless
+  // maxInFlight allows more.
+  final List<_ScheduledRequest> _inFlight = [];
   Timer? _nextProcessTimer;
-  Timer? _retryTimer;
   StreamSubscription? _subscription;
 
   // Response demultiplexer
@@ -309,6 +376,7 @@ class DistingMessageScheduler {
   DateTime? _lastPacketTime;
   bool _subscriptionActive = true;
   String? _lastSubscriptionError;
+  int _truncatedSysExCount = 0;
 
   // RTT (Round-Trip Time) tracking - overall stats
   int _totalRequestsCompleted = 0;
@@ -354,6 +422,7 @@ class DistingMessageScheduler {
         ? now.difference(_lastPacketTime!).inMilliseconds
         : -1;
 
+    final oldest = _inFlight.isEmpty ? null : _inFlight.first;
     final avgRttMs = _totalRequestsCompleted > 0
         ? (_totalRtt.inMicroseconds / _totalRequestsCompleted / 1000)
               .toStringAsFixed(2)
@@ -366,14 +435,18 @@ class DistingMessageScheduler {
       'sysexPacketsReceived': _sysexPacketsReceived,
       'nonSysexPacketsReceived': _nonSysexPacketsReceived,
       'ccMessagesDispatched': _ccMessagesDispatched,
+      'truncatedSysEx': _truncatedSysExCount,
+      'streamParser': _sysExParser != null,
       'ccCallbackRegistered': _ccCallback != null,
       'packetsFromWrongDevice': _packetsFromWrongDevice,
       'timeSinceLastPacketMs': timeSinceLastPacket,
-      'currentState': _state.name,
+      'currentState': (oldest?.state ?? _SchedulerState.idle).name,
       'queueLength': _queue.length,
-      'hasCurrentRequest': _currentRequest != null,
-      'currentRequestCompleted':
-          _currentRequest?.completer.isCompleted ?? false,
+      'hasCurrentRequest': oldest != null,
+      'currentRequestCompleted': oldest?.completer.isCompleted ?? false,
+      'inFlight': _inFlight.length,
+      'window': _window,
+      'maxInFlight': maxInFlight,
       // RTT statistics
       'rttRequestsCompleted': _totalRequestsCompleted,
       'rttRequestsTimedOut': _totalRequestsTimedOut,
@@ -391,6 +464,7 @@ class DistingMessageScheduler {
       'staleResponsesAbsorbed': _demux.staleResponsesAbsorbed,
       'unmatchedResponsesDiscarded': _demux.unmatchedResponsesDiscarded,
       'expiredHandlerCount': _demux.expiredHandlerCount,
+      'activeHandlerCount': _demux.activeHandlerCount,
     };
   }
 
@@ -451,17 +525,29 @@ class DistingMessageScheduler {
     }
   }
 
+  void _subscribe() {
+    final transport = _transport;
+    _subscription = transport != null
+        ? transport.messages.listen(
+            _handleFramedMessage,
+            onError: _handleSubscriptionError,
+            onDone: _handleSubscriptionDone,
+            cancelOnError: false,
+          )
+        : _midi.onMidiPacketReceived?.listen(
+            _handleIncomingPacket,
+            onError: _handleSubscriptionError,
+            onDone: _handleSubscriptionDone,
+            cancelOnError: false,
+          );
+  }
+
   /// Attempts to re-establish the MIDI subscription if it's dead.
   void tryReconnectSubscription() {
     _subscription?.cancel();
     _subscriptionActive = false;
 
-    _subscription = _midi.onMidiPacketReceived?.listen(
-      _handleIncomingPacket,
-      onError: _handleSubscriptionError,
-      onDone: _handleSubscriptionDone,
-      cancelOnError: false,
-    );
+    _subscribe();
 
     if (_subscription != null) {
       _subscriptionActive = true;
@@ -476,6 +562,7 @@ class DistingMessageScheduler {
     // Clear any partial SysEx data
     _sysExBuffer.clear();
     _isBufferingSysEx = false;
+    _sysExParser?.reset();
 
     // Reset consecutive timeout counter
     _consecutiveTimeouts = 0;
@@ -484,12 +571,7 @@ class DistingMessageScheduler {
     _subscription?.cancel();
     _subscriptionActive = false;
 
-    _subscription = _midi.onMidiPacketReceived?.listen(
-      _handleIncomingPacket,
-      onError: _handleSubscriptionError,
-      onDone: _handleSubscriptionDone,
-      cancelOnError: false,
-    );
+    _subscribe();
 
     if (_subscription != null) {
       _subscriptionActive = true;
@@ -510,58 +592,61 @@ class DistingMessageScheduler {
     _subscription?.cancel();
     _subscriptionActive = false;
 
-    // On Windows (and some other platforms), input and output are separate devices
-    // and both need to be disconnected/reconnected.
-    //
-    // IMPORTANT: If we suspect the device connection is broken (e.g., device was
-    // unplugged), we skip the disconnect call entirely. Calling disconnectDevice
-    // on an invalid handle can crash the native MIDI library on Windows.
-
-    if (!_deviceConnectionSuspectedBroken) {
-      // Try to disconnect, but wrap in defensive try-catch.
-      // On Windows, disconnecting an already-invalid handle can crash.
-      try {
-        _midi.disconnectDevice(_inputDevice);
-      } catch (e) {
-        // Disconnect failed - device likely already disconnected
-        _deviceConnectionSuspectedBroken = true;
-      }
-
-      if (_outputDevice.id != _inputDevice.id) {
+    final transport = _transport;
+    if (transport != null) {
+      // The native transport has its own sequencer connection, which
+      // reopens without touching flutter_midi_command's.
+      _deviceConnectionSuspectedBroken = !await transport.reopen();
+      if (_deviceConnectionSuspectedBroken) return;
+    } else {
+      // On Windows (and some other platforms), input and output are separate devices
+      // and both need to be disconnected/reconnected.
+      //
+      // IMPORTANT: If we suspect the device connection is broken (e.g., device was
+      // unplugged), we skip the disconnect call entirely. Calling disconnectDevice
+      // on an invalid handle can crash the native MIDI library on Windows.
+
+      if (!_deviceConnectionSuspectedBroken) {
+        // Try to disconnect, but wrap in defensive try-catch.
+        // On Windows, disconnecting an already-invalid handle can crash.
         try {
-          _midi.disconnectDevice(_outputDevice);
+          _midi.disconnectDevice(_inputDevice);
         } catch (e) {
           // Disconnect failed - device likely already disconnected
           _deviceConnectionSuspectedBroken = true;
         }
+
+        if (_outputDevice.id != _inputDevice.id) {
+          try {
+            _midi.disconnectDevice(_outputDevice);
+          } catch (e) {
+            // Disconnect failed - device likely already disconnected
+            _deviceConnectionSuspectedBroken = true;
+          }
+        }
       }
-    }
 
-    // Brief delay to let the system settle
-    await Future.delayed(const Duration(milliseconds: 500));
+      // Brief delay to let the system settle
+      await Future.delayed(const Duration(milliseconds: 500));
 
-    // Try to reconnect the devices
-    try {
-      _midi.connectToDevice(_inputDevice);
-      if (_outputDevice.id != _inputDevice.id) {
-        _midi.connectToDevice(_outputDevice);
+      // Try to reconnect the devices
+      try {
+        _midi.connectToDevice(_inputDevice);
+        if (_outputDevice.id != _inputDevice.id) {
+          _midi.connectToDevice(_outputDevice);
+        }
+        // If reconnect succeeded, clear the broken flag
+        _deviceConnectionSuspectedBroken = false;
+      } catch (e) {
+        // Reconnect failed - device may not be available
+        _deviceConnectionSuspectedBroken = true;
+        return; // Don't try to set up subscription if reconnect failed
       }
-      // If reconnect succeeded, clear the broken flag
-      _deviceConnectionSuspectedBroken = false;
-    } catch (e) {
-      // Reconnect failed - device may not be available
-      _deviceConnectionSuspectedBroken = true;
-      return; // Don't try to set up subscription if reconnect failed
     }
 
     // Re-establish subscription
     await Future.delayed(const Duration(milliseconds: 200));
-    _subscription = _midi.onMidiPacketReceived?.listen(
-      _handleIncomingPacket,
-      onError: _handleSubscriptionError,
-      onDone: _handleSubscriptionDone,
-      cancelOnError: false,
-    );
+    _subscribe();
 
     if (_subscription != null) {
       _subscriptionActive = true;
@@ -585,10 +670,39 @@ class DistingMessageScheduler {
     // SD requests retain their one-attempt timeout policy, while a confirmed
     // receive-side transfer failure can recover immediately.
     _subscriptionActive = _subscription != null;
-    final request = _currentRequest;
-    if (_state != _SchedulerState.waitingForResponse ||
-        !_isBufferingSysEx ||
-        request == null ||
+    final parser = _sysExParser;
+    final interrupted = parser != null ? parser.inSysEx : _isBufferingSysEx;
+    // The rest of a stream parser's partial frame went with the error.
+    parser?.reset();
+    if (interrupted) {
+      _replayAfterLostResponse();
+    }
+  }
+
+  /// A SysEx was abandoned unfinished, which the stream parser reports as
+  /// it happens. If it was the awaited response it can never complete, so
+  /// replay the request now instead of waiting out the timeout.
+  void _handleTruncatedSysEx() {
+    _truncatedSysExCount++;
+    _diag('sysex-truncated current=#${_oldestAwaitingResponse()?.id}');
+    _shrinkWindow();
+    _replayAfterLostResponse();
+  }
+
+  /// The device answers in order, so a response in transit belongs to the
+  /// oldest request still waiting for one.
+  _ScheduledRequest? _oldestAwaitingResponse() {
+    for (final request in _inFlight) {
+      if (request.state == _SchedulerState.waitingForResponse) return request;
+    }
+    return null;
+  }
+
+  /// Replays the active request once after its response was lost in
+  /// transit, discarding any partial frame.
+  void _replayAfterLostResponse() {
+    final request = _oldestAwaitingResponse();
+    if (request == null ||
         request.completer.isCompleted ||
         request.transferErrorRecoveryCount >= _maxTransferErrorRecoveries) {
       return;
@@ -599,12 +713,7 @@ class DistingMessageScheduler {
     request.timeoutTimer?.cancel();
     request.stopwatch.stop();
     request.transferErrorRecoveryCount++;
-    _state = _SchedulerState.sending;
-    if (request.retryDelay == Duration.zero) {
-      _sendCurrentRequest();
-    } else {
-      _retryTimer = Timer(request.retryDelay, _sendCurrentRequest);
-    }
+    _resend(request);
   }
 
   void _handleSubscriptionDone() {
@@ -649,8 +758,9 @@ class DistingMessageScheduler {
       'maxRetries=${request.maxRetries} queue=${_queue.length} key=$key',
     );
 
-    // Process immediately if idle
-    if (_state == _SchedulerState.idle) {
+    // Process immediately if idle, or if the window may have room and no
+    // send is already scheduled
+    if (_inFlight.isEmpty || _nextProcessTimer == null) {
       _processNext();
     }
 
@@ -659,16 +769,16 @@ class DistingMessageScheduler {
 
   void dispose() {
     _subscription?.cancel();
+    _sysExParser?.dispose();
     _nextProcessTimer?.cancel();
-    _retryTimer?.cancel();
     _demux.clear();
-    final current = _currentRequest;
-    if (current != null && !current.completer.isCompleted) {
-      current.completer.completeError(StateError('Scheduler disposed'));
+    for (final request in _inFlight) {
+      if (!request.completer.isCompleted) {
+        request.completer.completeError(StateError('Scheduler disposed'));
+      }
+      request.dispose();
     }
-    current?.dispose();
-    _currentRequest = null;
-    _state = _SchedulerState.idle;
+    _inFlight.clear();
 
     // Fail all pending requests
     for (final request in _queue) {
@@ -688,22 +798,78 @@ class DistingMessageScheduler {
     _nextProcessTimer?.cancel();
     _nextProcessTimer = null;
 
-    if (_state != _SchedulerState.idle || _queue.isEmpty) {
-      return;
+    while (_queue.isNotEmpty && _canAdmit(_queue.first)) {
+      final request = _queue.removeFirst();
+      _inFlight.add(request);
+      _sendRequest(request);
+
+      // A request that finished at once (fire-and-forget, or a failed send)
+      // has already scheduled the next one.
+      if (!_inFlight.contains(request)) return;
+
+      // Otherwise keep filling the window, spaced by the message interval.
+      if (messageInterval > Duration.zero) {
+        if (_queue.isNotEmpty && _canAdmit(_queue.first)) {
+          _nextProcessTimer = Timer(messageInterval, _processNext);
+        }
+        return;
+      }
+    }
+  }
+
+  /// Whether [request] may be sent with what is already in flight.
+  bool _canAdmit(_ScheduledRequest request) {
+    if (_inFlight.isEmpty) return true;
+    if (_inFlight.length >= _window) return false;
+    if (!_canShareWindow(request)) return false;
+    for (final other in _inFlight) {
+      // Identical keys could take each other's responses.
+      if (!_canShareWindow(other) || other.key == request.key) return false;
     }
+    return true;
+  }
 
-    _currentRequest = _queue.removeFirst();
-    _state = _SchedulerState.sending;
-    _sendCurrentRequest();
+  /// Whether [request]'s response names it well enough to be told apart
+  /// from others in flight. Fire-and-forget and optional requests go alone
+  /// too: writes must not overtake reads that may still be retried, and a
+  /// response that may never come would hold a slot until it times out.
+  static bool _canShareWindow(_ScheduledRequest request) {
+    if (request.expectation != ResponseExpectation.required) return false;
+    final key = request.key;
+    switch (key.messageType) {
+      // Responses that echo the slot.
+      case DistingNTRespMessageType.respNumParameters:
+      case DistingNTRespMessageType.respAllParameterValues:
+      case DistingNTRespMessageType.respAlgorithm:
+      case DistingNTRespMessageType.respParameterPages:
+      case DistingNTRespMessageType.respRouting:
+        return key.algorithmIndex != null;
+
+      // Responses that echo the slot and parameter. Enum strings are left
+      // out: they match leniently, ignoring the parameter.
+      case DistingNTRespMessageType.respParameterInfo:
+      case DistingNTRespMessageType.respParameterValue:
+      case DistingNTRespMessageType.respMapping:
+      case DistingNTRespMessageType.respParameterValueString:
+      case DistingNTRespMessageType.respOutputModeUsage:
+        return key.algorithmIndex != null && key.parameterNumber != null;
+
+      case DistingNTRespMessageType.respPerfPageItem:
+        return key.parameterNumber != null;
+
+      // Algorithm Info does not echo its library index, and SD card errors
+      // do not name their operation.
+      default:
+        return false;
+    }
   }
 
-  void _sendCurrentRequest() {
-    _retryTimer?.cancel();
-    _retryTimer = null;
+  void _sendRequest(_ScheduledRequest request) {
+    request.retryTimer?.cancel();
+    request.retryTimer = null;
 
-    final request = _currentRequest;
-    if (request == null || request.completer.isCompleted) {
-      _finishCurrentRequest();
+    if (request.completer.isCompleted) {
+      _finishRequest(request);
       return;
     }
 
@@ -717,28 +883,34 @@ class DistingMessageScheduler {
       return;
     }
 
+    request.state = _SchedulerState.sending;
     request.attemptCount++;
     _diag(
       'send #${request.id} attempt=${request.attemptCount}/'
       '${request.maxRetries} packetBytes=${request.packet.length} '
-      'queue=${_queue.length} key=${request.key}',
+      'queue=${_queue.length} inFlight=${_inFlight.length} key=${request.key}',
     );
 
     // Start/restart stopwatch for RTT measurement
     request.stopwatch.reset();
     request.stopwatch.start();
 
-    // Register handler with demux BEFORE sending (first attempt only).
+    // Register handler with demux BEFORE sending.
     // Handler persists across retries — only moved to expired on final timeout.
     if (request.expectation != ResponseExpectation.none) {
-      _demux.registerActive(request.key, (parsed) {
+      _demux.registerActive(request.id, request.key, (parsed) {
         _onResponseMatched(request, parsed);
       });
     }
 
     // Send the message
     try {
-      _midi.sendData(request.packet, deviceId: _outputDevice.id);
+      final transport = _transport;
+      if (transport != null) {
+        transport.send(request.packet);
+      } else {
+        _midi.sendData(request.packet, deviceId: _outputDevice.id);
+      }
     } catch (e) {
       request.stopwatch.stop();
       _handleSendFailure(request, e);
@@ -749,14 +921,57 @@ class DistingMessageScheduler {
       // Fire-and-forget: complete immediately and schedule next
       _diag('complete #${request.id} fire-and-forget key=${request.key}');
       request.completer.complete(null);
-      _finishCurrentRequest();
+      _finishRequest(request);
     } else {
       // Wait for response
-      _state = _SchedulerState.waitingForResponse;
-      request.startTimeout(() => _onTimeout());
+      request.state = _SchedulerState.waitingForResponse;
+      request.startTimeout(() => _onTimeout(request));
     }
   }
 
+  /// Sends [request] again after its retry delay.
+  void _resend(_ScheduledRequest request) {
+    request.state = _SchedulerState.sending;
+    if (request.retryDelay == Duration.zero) {
+      _sendRequest(request);
+    } else {
+      request.retryTimer = Timer(
+        request.retryDelay,
+        () => _sendRequest(request),
+      );
+    }
+  }
+
+  /// Windowed mode: moves the window by one, once per window's worth of
+  /// responses, after estimating from [rtt] how many requests are waiting
+  /// inside the device. With n requests in flight and the fastest round
+  /// trip seen for the type as the unloaded time, that is about
+  /// n * (1 - fastest / rtt). Below one the link sits idle between
+  /// responses, so the window grows; above three more requests only add
+  /// latency, so it shrinks.
+  void _adaptWindow(Duration rtt, _RttStats stats, int inFlight) {
+    if (maxInFlight <= 1 || stats.count < 2) return;
+    if (++_responsesSinceWindowChange < _window) return;
+    _responsesSinceWindowChange = 0;
+
+    final rttMs = rtt.inMicroseconds / 1000;
+    if (rttMs <= 0) return;
+    final queued = inFlight * (1 - stats.minMs / rttMs);
+    if (queued < _windowQueuedLow && _window < maxInFlight) {
+      _window++;
+    } else if (queued > _windowQueuedHigh && _window > 1) {
+      _window--;
+    }
+  }
+
+  /// Halves the window after a lost or late response, which suggests the
+  /// device is falling behind.
+  void _shrinkWindow() {
+    if (maxInFlight <= 1) return;
+    _window = math.max(1, _window ~/ 2);
+    _responsesSinceWindowChange = 0;
+  }
+
   /// Called by the demux when a response matches the active handler.
   void _onResponseMatched(
     _ScheduledRequest request,
@@ -764,7 +979,7 @@ class DistingMessageScheduler {
   ) {
     // Guard against race conditions
     if (request.completer.isCompleted) {
-      _finishCurrentRequest();
+      _finishRequest(request);
       return;
     }
 
@@ -778,6 +993,7 @@ class DistingMessageScheduler {
     request.stopwatch.stop();
     final rtt = request.stopwatch.elapsed;
     _recordRtt(rtt, parsed.messageType, libraryIndex: request.key.libraryIndex);
+    _adaptWindow(rtt, _rttByMessageType[parsed.messageType]!, _inFlight.length);
     _diag(
       'response #${request.id} rtt=${rtt.inMicroseconds / 1000}ms '
       'messageType=${parsed.messageType.name} key=${request.key}',
@@ -796,7 +1012,7 @@ class DistingMessageScheduler {
           payload: parsed.payload,
         ),
       );
-      _finishCurrentRequest();
+      _finishRequest(request);
       return;
     }
 
@@ -823,12 +1039,7 @@ class DistingMessageScheduler {
           final shouldRetryParseError = e is! TruncatedParameterPagesException;
           if (shouldRetryParseError &&
               request.attemptCount < request.maxRetries) {
-            _state = _SchedulerState.sending;
-            if (request.retryDelay == Duration.zero) {
-              _sendCurrentRequest();
-            } else {
-              _retryTimer = Timer(request.retryDelay, _sendCurrentRequest);
-            }
+            _resend(request);
             return;
           }
           request.completer.completeError(
@@ -853,28 +1064,31 @@ class DistingMessageScheduler {
       }
     }
 
-    _finishCurrentRequest();
+    _finishRequest(request);
   }
 
-  void _onTimeout() {
-    final request = _currentRequest;
-
-    // Clear any partial SysEx buffer on timeout to prevent stale data
-    if (_isBufferingSysEx) {
+  void _onTimeout(_ScheduledRequest request) {
+    // Clear any partial SysEx buffer on timeout to prevent stale data. With
+    // several requests in flight, a partial frame belongs to the oldest.
+    if (_isBufferingSysEx &&
+        _inFlight.isNotEmpty &&
+        identical(_inFlight.first, request)) {
       _sysExBuffer.clear();
       _isBufferingSysEx = false;
     }
 
     // Guard against race conditions where response arrived just before timeout
-    if (request == null || request.completer.isCompleted) {
+    if (request.completer.isCompleted) {
       _consecutiveTimeouts = 0;
-      _finishCurrentRequest();
+      _finishRequest(request);
       return;
     }
 
+    _shrinkWindow();
+
     if (request.attemptCount >= request.maxRetries) {
       // Out of retries — expire the handler so late responses get absorbed
-      _demux.expireActive();
+      _demux.expireActive(request.id);
 
       // Record timeout for stats
       request.stopwatch.stop();
@@ -906,32 +1120,26 @@ class DistingMessageScheduler {
         );
         request.completer.complete(null);
       }
-      _finishCurrentRequest();
+      _finishRequest(request);
     } else {
       // Retry after delay — handler persists across retries
-      _state = _SchedulerState.sending;
       _diag(
         'timeout-retry #${request.id} attempt=${request.attemptCount} '
         'nextAttempt=${request.attemptCount + 1} retryDelay='
         '${request.retryDelay.inMilliseconds}ms key=${request.key}',
       );
-
-      if (request.retryDelay == Duration.zero) {
-        _sendCurrentRequest();
-      } else {
-        _retryTimer = Timer(request.retryDelay, _sendCurrentRequest);
-      }
+      _resend(request);
     }
   }
 
   void _handleSendFailure(_ScheduledRequest request, Object error) {
     if (request.completer.isCompleted) {
-      _finishCurrentRequest();
+      _finishRequest(request);
       return;
     }
 
     if (request.attemptCount >= request.maxRetries) {
-      _demux.expireActive();
+      _demux.expireActive(request.id);
       _diag(
         'send-failed-final #${request.id} attempts=${request.attemptCount} '
         'key=${request.key} error=$error',
@@ -941,21 +1149,16 @@ class DistingMessageScheduler {
           'Failed to send request after ${request.attemptCount} attempts: $error',
         ),
       );
-      _finishCurrentRequest();
+      _finishRequest(request);
       return;
     }
 
-    _state = _SchedulerState.sending;
     _diag(
       'send-failed-retry #${request.id} attempt=${request.attemptCount} '
       'retryDelay=${request.retryDelay.inMilliseconds}ms '
       'key=${request.key} error=$error',
     );
-    if (request.retryDelay == Duration.zero) {
-      _sendCurrentRequest();
-    } else {
-      _retryTimer = Timer(request.retryDelay, _sendCurrentRequest);
-    }
+    _resend(request);
   }
 
   void _diag(String message) {
@@ -979,12 +1182,10 @@ class DistingMessageScheduler {
         .join(' ');
   }
 
-  void _finishCurrentRequest() {
-    _currentRequest?.dispose();
-    _currentRequest = null;
-    _state = _SchedulerState.idle;
-    _retryTimer?.cancel();
-    _retryTimer = null;
+  void _finishRequest(_ScheduledRequest request) {
+    request.dispose();
+    _inFlight.remove(request);
+    _demux.removeActive(request.id);
 
     // Schedule next request after message interval
     if (_queue.isNotEmpty) {
@@ -1040,7 +1241,48 @@ class DistingMessageScheduler {
     }
   }
 
+  /// One whole message from a [MidiMessageTransport], which has already
+  /// done the SysEx reassembly [_handleIncoming] does for raw packets.
+  void _handleFramedMessage(Uint8List message) {
+    _totalPacketsReceived++;
+    _lastPacketTime = DateTime.now();
+    if (message.isEmpty) return;
+    if (message[0] == 0xF0) {
+      _sysexPacketsReceived++;
+      _dispatchSysEx(message);
+    } else {
+      _nonSysexPacketsReceived++;
+      _dispatchCcMessages(message);
+    }
+  }
+
   void _handleIncoming(Uint8List raw) {
+    final parser = _sysExParser;
+    if (parser != null) {
+      // The counters keep counting packets, as on the Dart path, not the
+      // messages reassembled from them.
+      var sawSysEx = false;
+      var sawOther = false;
+      parser.feed(
+        raw,
+        onSysEx: (sysex) {
+          sawSysEx = true;
+          _dispatchSysEx(sysex);
+        },
+        onOther: (message) {
+          sawOther = true;
+          _dispatchCcMessages(message);
+        },
+        onTruncated: _handleTruncatedSysEx,
+      );
+      if (sawSysEx) {
+        _sysexPacketsReceived++;
+      } else if (sawOther) {
+        _nonSysexPacketsReceived++;
+      }
+      return;
+    }
+
     // Handle SysEx buffering for split messages (common on Windows with large SysEx)
     final hasF0 = raw.contains(0xF0);
     final hasF7 = raw.contains(0xF7);
@@ -6,6 +6,8 @@ import 'package:path/path.dart' as p;
 import 'package:nt_helper/db/daos/presets_dao.dart';
 import 'package:nt_helper/db/database.dart';
 import 'package:nt_helper/domain/disting_message_scheduler.dart';
+import 'package:nt_helper/domain/midi_message_transport.dart';
+import 'package:nt_helper/services/platform_channels/native_sysex_parser.dart';
 import 'package:nt_helper/domain/disting_nt_sysex.dart';
 import 'package:nt_helper/domain/i_disting_midi_manager.dart';
 import 'package:nt_helper/domain/request_key.dart';
@@ -77,6 +79,7 @@ import 'package:nt_helper/models/sd_card_file_system.dart';
 class DistingMidiManager implements IDistingMidiManager {
   // Implement interface
   final DistingMessageScheduler _scheduler;
+  final MidiMessageTransport? _transport;
   final int sysExId;
   String? _firmwareVersion;
 
@@ -85,7 +88,9 @@ class DistingMidiManager implements IDistingMidiManager {
     required MidiDevice inputDevice,
     required MidiDevice outputDevice,
     required this.sysExId,
-  }) : _scheduler = DistingMessageScheduler(
+    MidiMessageTransport? transport,
+  }) : _transport = transport,
+       _scheduler = DistingMessageScheduler(
          midiCommand: midiCommand,
          inputDevice: inputDevice,
          outputDevice: outputDevice,
@@ -98,6 +103,16 @@ class DistingMidiManager implements IDistingMidiManager {
          ),
          defaultRetryDelay:
              Duration(milliseconds: SettingsService().interMessageDelay) * 2,
+         maxInFlight: SettingsService().pipelinedRequestsEnabled
+             ? DistingMessageScheduler.defaultMaxInFlight
+             : 1,
+         transport: transport,
+         // A transport delivers whole messages already. Without the
+         // setting, or the library, the scheduler reassembles in Dart.
+         sysExParser:
+             transport == null && SettingsService().nativeSysExParserEnabled
+             ? NativeSysExParser.create()
+             : null,
        );
 
   Future<void> _checkSdCardSupport() async {
@@ -134,6 +149,7 @@ class DistingMidiManager implements IDistingMidiManager {
   void dispose() {
     _scheduler.clearCcCallback();
     _scheduler.dispose();
+    _transport?.close();
   }
 
   @override
@@ -0,0 +1,27 @@
+import 'dart:typed_data';
+
+/// A MIDI link to the Disting NT that delivers whole messages.
+///
+/// An alternative to `flutter_midi_command` packets for
+/// `DistingMessageScheduler`: the transport puts SysEx back together itself,
+/// so every event on [messages] is exactly one message, either a complete
+/// SysEx (`F0 ... F7`) or one channel message with its status byte.
+abstract class MidiMessageTransport {
+  /// Messages from the device. Closes when the device goes away; [reopen]
+  /// starts a new stream, so listen again afterwards.
+  Stream<Uint8List> get messages;
+
+  /// Whether the device is connected.
+  bool get isOpen;
+
+  /// Queues complete MIDI messages for the device without waiting for them
+  /// to be written. Throws [StateError] if the transport is closed.
+  void send(Uint8List data);
+
+  /// Drops and re-establishes the connection, e.g. to recover from a
+  /// corrupted stream. Returns whether the device could be reached.
+  Future<bool> reopen();
+
+  /// Closes the connection for good.
+  void close();
+}
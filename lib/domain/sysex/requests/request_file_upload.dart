@@ -24,25 +24,27 @@ class RequestFileUploadMessage extends SysexMessage {
     final count = data.length;
     final positionBytes = encode32(0);
     final countBytes = encode32(count);
-    final nybbleData = bytesToNybbles(data);
 
-    final payload = [
+    final header = [
+      ...buildHeader(sysExId),
+      DistingNTRequestMessageType.sdCardOperation.value,
       SdCardOperation.fileUpload.code,
       ...pathBytes,
       0, // Null terminator
       0,
       ...positionBytes,
       ...countBytes,
-      ...nybbleData,
     ];
-    final checksum = calculateChecksum(payload);
 
-    return Uint8List.fromList([
-      ...buildHeader(sysExId),
-      DistingNTRequestMessageType.sdCardOperation.value,
-      ...payload,
-      checksum,
-      ...buildFooter(),
-    ]);
+    // The checksum covers everything after the message type.
+    final message = Uint8List(header.length + 2 * count + 2);
+    message.setAll(0, header);
+    var sum = encodeNybblesInto(data, message, header.length);
+    for (var i = 7; i < header.length; i++) {
+      sum += header[i];
+    }
+    message[message.length - 2] = (-sum) & 0x7F;
+    message[message.length - 1] = kSysExEnd;
+    return message;
   }
 }
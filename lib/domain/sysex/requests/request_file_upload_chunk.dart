@@ -24,7 +24,7 @@ class RequestFileUploadChunkMessage extends SysexMessage {
     final count = data.length;
 
     // Build the message exactly like the Python code
-    final message = <int>[
+    final header = <int>[
       ...buildHeader(sysExId),
       DistingNTRequestMessageType.sdCardOperation.value,
       SdCardOperation.fileUpload.code,
@@ -56,23 +56,19 @@ class RequestFileUploadChunkMessage extends SysexMessage {
       (count >> 0) & 0x7f,
     ];
 
-    // Add data as nibbles (exactly like Python: split each byte into two 4-bit nibbles)
-    for (int i = 0; i < data.length; i++) {
-      final byte = data[i];
-      message.add((byte >> 4) & 0xf); // High nibble
-      message.add(byte & 0xf); // Low nibble
-    }
+    // Data follows as nibbles (exactly like Python: split each byte into
+    // two 4-bit nibbles), written straight into the message.
+    final message = Uint8List(header.length + 2 * count + 2);
+    message.setAll(0, header);
+    var sum = encodeNybblesInto(data, message, header.length);
 
-    // Calculate checksum (sum of bytes from position 7 onwards, then negate and mask)
-    int sum = 0;
-    for (int i = 7; i < message.length; i++) {
-      sum += message[i];
+    // Checksum (sum of bytes from position 7 onwards, then negate and mask)
+    for (int i = 7; i < header.length; i++) {
+      sum += header[i];
     }
-    final checksum = (-sum) & 0x7f;
-
-    message.add(checksum);
-    message.add(0xF7);
+    message[message.length - 2] = (-sum) & 0x7f;
+    message[message.length - 1] = 0xF7;
 
-    return Uint8List.fromList(message);
+    return message;
   }
 }
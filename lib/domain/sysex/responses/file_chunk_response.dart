@@ -2,6 +2,7 @@ import 'dart:typed_data';
 import 'package:nt_helper/domain/sd_card_operation.dart';
 import 'package:nt_helper/models/sd_card_file_system.dart';
 import 'package:nt_helper/domain/sysex/responses/sysex_response.dart';
+import 'package:nt_helper/domain/sysex/sysex_utils.dart';
 
 class FileChunkResponse extends SysexResponse {
   FileChunkResponse(super.payload);
@@ -31,17 +32,9 @@ class FileChunkResponse extends SysexResponse {
       return FileChunk(offset: 0, data: Uint8List(0));
     }
 
-    // The rest is nibble-encoded file data
-    final nibbleData = data.sublist(2);
-
-    // Convert nibbles to bytes (exactly like Python: (data[2*i] << 4) | data[2*i+1])
-    final fileBytes = <int>[];
-    final size = nibbleData.length >> 1; // Divide by 2
-    for (int i = 0; i < size; i++) {
-      final byte = (nibbleData[2 * i] << 4) | nibbleData[2 * i + 1];
-      fileBytes.add(byte);
-    }
-
-    return FileChunk(offset: 0, data: Uint8List.fromList(fileBytes));
+    // The rest is nibble-encoded file data; join the pairs (like Python:
+    // (data[2*i] << 4) | data[2*i+1])
+    final nibbleData = Uint8List.sublistView(data, 2);
+    return FileChunk(offset: 0, data: decodeNybbles(nibbleData));
   }
 }
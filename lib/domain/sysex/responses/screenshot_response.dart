@@ -3,73 +3,60 @@ import 'dart:math';
 import 'package:flutter/foundation.dart';
 import 'package:image/image.dart' as img;
 import 'package:nt_helper/domain/sysex/responses/sysex_response.dart';
+import 'package:nt_helper/services/platform_channels/native_screenshot.dart';
 
 class ScreenshotResponse extends SysexResponse {
   ScreenshotResponse(super.data);
 
+  static const int width = 256;
+  static const int height = 64;
+  static const int borderWidth = 5;
+
+  /// Displayed intensity of each of the module's 16 brightness levels:
+  /// the level, scaled to 0..1, gamma corrected twice and scaled to 0..255.
+  static final List<int> gamma = List.generate(16, (level) {
+    double v = pow(level * 0.066666666666667, 0.45).toDouble();
+    v = pow(v, 0.45).toDouble() * 255;
+    return v.clamp(0, 255).toInt();
+  }, growable: false);
+
   @override
   Uint8List parse() {
     try {
-      // Define screenshot properties (adjust based on actual format)
-      const int width = 256; // Example width
-      const int height = 64; // Example height
-      const int borderWidth = 5; // Border size in pixels
-
-      const int newWidth = width + 2 * borderWidth;
-      const int newHeight = height + 2 * borderWidth;
-
-      // Create a new image with the border dimensions
-      final img.Image borderedImage = img.Image(
-        width: newWidth,
-        height: newHeight,
-      );
-
-      // Fill the entire image with a border color (e.g., black)
-      final img.Color borderColor = img.ColorFloat16.rgb(0, 0, 0); // Black
-      for (int y = 0; y < newHeight; y++) {
-        for (int x = 0; x < newWidth; x++) {
-          borderedImage.setPixel(x, y, borderColor);
-        }
-      }
-
-      // Create an empty image with specified dimensions
-      final img.Image image = img.Image(width: width, height: height);
-
-      // Assuming screenshotData is raw RGB data
-      for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-          int pixelIndex = y * width + x;
-          if (pixelIndex < data.length) {
-            double v = data[pixelIndex].toDouble();
-            v = pow(
-              v * 0.066666666666667,
-              0.45,
-            ).toDouble(); // Apply gamma correction
-            v = pow(v, 0.45).toDouble(); // Apply gamma correction again
-            v = v * 255; // Scale to 0–255
-            int intensity = v.clamp(0, 255).toInt();
-            img.Color color = img.ColorFloat16.rgb(0, intensity, intensity);
-            image.setPixel(x, y, color);
-          }
-        }
-      }
-
-      // Copy the original image into the center of the bordered image
-      for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-          img.Pixel originalPixel = image.getPixel(x, y);
-          borderedImage.setPixel(
-            x + borderWidth,
-            y + borderWidth,
-            originalPixel,
-          );
-        }
-      }
-
-      // Encode the image as PNG
-      return Uint8List.fromList(img.encodePng(borderedImage));
+      return NativeScreenshot.instance?.encodeLevels(data) ?? render(data);
     } catch (e) {
       return Uint8List(0); // Return empty on error
     }
   }
+
+  /// PNG of [levels] (one per pixel, row by row) inside a black border.
+  static Uint8List render(Uint8List levels) {
+    const int newWidth = width + 2 * borderWidth;
+    const int newHeight = height + 2 * borderWidth;
+
+    // Opaque black, then each level's teal written straight into the bytes.
+    final rgba = Uint32List(newWidth * newHeight);
+    final palette = Uint32List(16);
+    final bytes = palette.buffer.asUint8List();
+    for (int level = 0; level < 16; level++) {
+      bytes.setAll(level * 4, [0, gamma[level], gamma[level], 255]);
+    }
+    rgba.fillRange(0, rgba.length, palette[0]);
+
+    final count = min(levels.length, width * height);
+    for (int i = 0; i < count; i++) {
+      final y = i ~/ width;
+      final x = i - y * width;
+      rgba[(y + borderWidth) * newWidth + x + borderWidth] =
+          palette[min(levels[i], 15)];
+    }
+
+    final image = img.Image.fromBytes(
+      width: newWidth,
+      height: newHeight,
+      bytes: rgba.buffer,
+      numChannels: 4,
+    );
+    return Uint8List.fromList(img.encodePng(image));
+  }
 }
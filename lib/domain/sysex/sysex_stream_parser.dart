@@ -0,0 +1,30 @@
+import 'dart:typed_data';
+
+/// Splits raw MIDI input, in whatever pieces the MIDI library delivers it,
+/// into whole messages.
+///
+/// Unlike the packet heuristics in `DistingMessageScheduler`, a stream
+/// parser knows exactly when a SysEx was cut short, so a lost response is
+/// noticed when it happens rather than when its request times out.
+abstract class SysExStreamParser {
+  /// Parses [data], calling [onSysEx] with each complete Disting NT SysEx
+  /// message (`F0 00 21 27 6D ... F7`), [onOther] with every other complete
+  /// message (CCs, other manufacturers' SysEx) and [onTruncated] whenever a
+  /// SysEx is abandoned unfinished. All calls happen before this returns,
+  /// in stream order.
+  void feed(
+    Uint8List data, {
+    required void Function(Uint8List sysex) onSysEx,
+    required void Function(Uint8List message) onOther,
+    required void Function() onTruncated,
+  });
+
+  /// Whether a SysEx has started and not yet ended.
+  bool get inSysEx;
+
+  /// Forgets any partial message, e.g. after input was lost.
+  void reset();
+
+  /// Frees the parser.
+  void dispose();
+}
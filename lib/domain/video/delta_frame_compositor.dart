@@ -0,0 +1,152 @@
+import 'dart:typed_data';
+
+/// Rebuilds full frames from the Linux plugin's delta video stream.
+///
+/// The native side sends a full frame as a keyframe (a BMP, or a "G4" packed
+/// grayscale frame, see `native/usb_video/gray4.h`), then "ND" delta frames
+/// carrying only the pixel rows that changed (layout documented in
+/// `native/usb_video/delta_frame.h`). The compositor keeps the last full frame
+/// and patches each delta into it, so everything downstream still receives
+/// complete frames in the keyframe's format.
+///
+/// Each rebuilt frame is a fresh full-size copy of the canvas, so deltas
+/// save bytes on the platform channel and work on the native side, not
+/// allocation or decoding in Dart.
+class DeltaFrameCompositor {
+  static const int _bmpHeaderSize = 54;
+  static const int _gray4HeaderSize = 8;
+  static const int _gray4Version = 1;
+  static const int _deltaHeaderSize = 10;
+  static const int _spanHeaderSize = 4;
+  static const int _deltaVersion = 1;
+
+  Uint8List? _canvas;
+  int _width = 0;
+  int _height = 0;
+  int _pixelOffset = 0;
+  int _rowStride = 0;
+
+  /// Whether a keyframe has been received, i.e. deltas can be applied.
+  bool get hasKeyframe => _canvas != null;
+
+  /// Returns the full frame for [data], or null when [data] is a delta that
+  /// cannot be applied (no keyframe yet, or a size mismatch). Anything that
+  /// is neither a keyframe nor a delta is returned unchanged.
+  Uint8List? apply(Uint8List data) {
+    if (_isBmp(data)) {
+      _takeBmpKeyframe(data);
+      return data;
+    }
+    if (_isGray4(data)) {
+      _takeGray4Keyframe(data);
+      return data;
+    }
+    if (!_isDelta(data)) {
+      return data;
+    }
+
+    final canvas = _canvas;
+    if (canvas == null) {
+      return null;
+    }
+    final header = ByteData.sublistView(data);
+    final width = header.getUint16(4, Endian.little);
+    final height = header.getUint16(6, Endian.little);
+    if (width != _width || height != _height) {
+      return null;
+    }
+
+    // Validate every span before touching the canvas, so a malformed delta
+    // never leaves a half-patched picture behind.
+    final spanCount = header.getUint16(8, Endian.little);
+    var offset = _deltaHeaderSize;
+    for (var i = 0; i < spanCount; i++) {
+      if (offset + _spanHeaderSize > data.length) {
+        return null;
+      }
+      final firstRow = header.getUint16(offset, Endian.little);
+      final rowCount = header.getUint16(offset + 2, Endian.little);
+      offset += _spanHeaderSize + rowCount * _rowStride;
+      if (firstRow + rowCount > _height || offset > data.length) {
+        return null;
+      }
+    }
+
+    offset = _deltaHeaderSize;
+    for (var i = 0; i < spanCount; i++) {
+      final firstRow = header.getUint16(offset, Endian.little);
+      final rowCount = header.getUint16(offset + 2, Endian.little);
+      offset += _spanHeaderSize;
+      final bytes = rowCount * _rowStride;
+      final target = _pixelOffset + firstRow * _rowStride;
+      canvas.setRange(target, target + bytes, data, offset);
+      offset += bytes;
+    }
+
+    // Hand out a copy: consumers may hold on to (and cache images by) the
+    // previous frame's bytes while the canvas keeps changing.
+    return Uint8List.fromList(canvas);
+  }
+
+  /// Forgets the current picture; deltas are ignored until the next keyframe.
+  void reset() {
+    _canvas = null;
+  }
+
+  bool _isBmp(Uint8List data) =>
+      data.length >= _bmpHeaderSize && data[0] == 0x42 && data[1] == 0x4D;
+
+  bool _isGray4(Uint8List data) =>
+      data.length >= _gray4HeaderSize &&
+      data[0] == 0x47 &&
+      data[1] == 0x34 &&
+      data[2] == _gray4Version;
+
+  bool _isDelta(Uint8List data) =>
+      data.length >= _deltaHeaderSize &&
+      data[0] == 0x4E &&
+      data[1] == 0x44 &&
+      data[2] == _deltaVersion;
+
+  void _takeBmpKeyframe(Uint8List bmp) {
+    final header = ByteData.sublistView(bmp);
+    final width = header.getInt32(18, Endian.little);
+    _takeKeyframe(
+      bmp,
+      width: width,
+      height: header.getInt32(22, Endian.little).abs(),
+      pixelOffset: header.getUint32(10, Endian.little),
+      rowStride: ((width * 3 + 3) ~/ 4) * 4,
+    );
+  }
+
+  void _takeGray4Keyframe(Uint8List frame) {
+    final header = ByteData.sublistView(frame);
+    final width = header.getUint16(4, Endian.little);
+    _takeKeyframe(
+      frame,
+      width: width,
+      height: header.getUint16(6, Endian.little),
+      pixelOffset: _gray4HeaderSize,
+      rowStride: (width + 1) ~/ 2,
+    );
+  }
+
+  void _takeKeyframe(
+    Uint8List frame, {
+    required int width,
+    required int height,
+    required int pixelOffset,
+    required int rowStride,
+  }) {
+    _width = width;
+    _height = height;
+    _pixelOffset = pixelOffset;
+    _rowStride = rowStride;
+    if (_pixelOffset + _rowStride * _height > frame.length) {
+      _canvas = null;
+      return;
+    }
+    _canvas = Uint8List.fromList(frame);
+  }
+}
@@ -0,0 +1,85 @@
+import 'dart:typed_data';
+
+/// Turns the Linux plugin's packed 4-bit grayscale frames into BMPs.
+///
+/// A "G4" frame (layout documented in `native/usb_video/gray4.h`) carries one
+/// 0-15 intensity per pixel, two pixels per byte with the left pixel in the
+/// high nibble. That is already the row layout of a 4 bpp palettised BMP,
+/// so conversion is a header, a 16-entry palette and a row copy; the colour
+/// of each level is decided here rather than on the native side.
+class Gray4FrameConverter {
+  static const int _headerSize = 8;
+  static const int _version = 1;
+  static const int _bmpHeaderSize = 54;
+  static const int _paletteSize = 16 * 4;
+
+  /// 16 ARGB colours, one per intensity level.
+  final List<int> palette;
+
+  Gray4FrameConverter({List<int>? palette})
+    : palette = palette ?? grayscalePalette {
+    if (this.palette.length != 16) {
+      throw ArgumentError.value(palette, 'palette', 'must have 16 entries');
+    }
+  }
+
+  /// Evenly spaced grays from black (level 0) to white (level 15).
+  static final List<int> grayscalePalette = List<int>.unmodifiable([
+    for (var level = 0; level < 16; level++)
+      0xFF000000 | (level * 17) << 16 | (level * 17) << 8 | level * 17,
+  ]);
+
+  /// Whether [data] is a packed grayscale frame.
+  static bool isGray4(Uint8List data) =>
+      data.length >= _headerSize &&
+      data[0] == 0x47 &&
+      data[1] == 0x34 &&
+      data[2] == _version;
+
+  /// Returns a top-down 4 bpp BMP for a "G4" frame, or null when [data] is
+  /// truncated. Anything that is not a "G4" frame is returned unchanged.
+  Uint8List? apply(Uint8List data) {
+    if (!isGray4(data)) {
+      return data;
+    }
+    final header = ByteData.sublistView(data);
+    final width = header.getUint16(4, Endian.little);
+    final height = header.getUint16(6, Endian.little);
+    final rowBytes = (width + 1) ~/ 2;
+    if (_headerSize + rowBytes * height > data.length) {
+      return null;
+    }
+
+    final bmpStride = (rowBytes + 3) & ~3;
+    final pixelOffset = _bmpHeaderSize + _paletteSize;
+    final bmp = Uint8List(pixelOffset + bmpStride * height);
+    ByteData.sublistView(bmp)
+      ..setUint8(0, 0x42) // B
+      ..setUint8(1, 0x4D) // M
+      ..setUint32(2, bmp.length, Endian.little)
+      ..setUint32(10, pixelOffset, Endian.little)
+      ..setUint32(14, 40, Endian.little)
+      ..setInt32(18, width, Endian.little)
+      ..setInt32(22, -height, Endian.little) // top-down, like the native BMPs
+      ..setUint16(26, 1, Endian.little)
+      ..setUint16(28, 4, Endian.little)
+      ..setUint32(34, bmpStride * height, Endian.little)
+      ..setUint32(46, 16, Endian.little);
+
+    // Palette entries are stored as B, G, R, reserved.
+    for (var level = 0; level < 16; level++) {
+      final colour = palette[level];
+      final entry = _bmpHeaderSize + level * 4;
+      bmp[entry] = colour & 0xFF;
+      bmp[entry + 1] = (colour >> 8) & 0xFF;
+      bmp[entry + 2] = (colour >> 16) & 0xFF;
+    }
+
+    for (var row = 0; row < height; row++) {
+      final source = _headerSize + row * rowBytes;
+      final target = pixelOffset + row * bmpStride;
+      bmp.setRange(target, target + rowBytes, data, source);
+    }
+    return bmp;
+  }
+}
@@ -5,12 +5,17 @@ class UsbDeviceInfo {
   final int productId;
   final bool isDistingNT;
 
+  /// Frame rates the device can capture at, fastest first; empty where the
+  /// platform does not report them.
+  final List<double> frameRates;
+
   const UsbDeviceInfo({
     required this.deviceId,
     required this.productName,
     required this.vendorId,
     required this.productId,
     required this.isDistingNT,
+    this.frameRates = const [],
   });
 
   factory UsbDeviceInfo.fromMap(Map<dynamic, dynamic> map) {
@@ -20,6 +25,10 @@ class UsbDeviceInfo {
       vendorId: map['vendorId'] as int,
       productId: map['productId'] as int,
       isDistingNT: map['isDistingNT'] as bool,
+      frameRates: [
+        for (final fps in map['frameRates'] as List? ?? const [])
+          (fps as num).toDouble(),
+      ],
     );
   }
 
@@ -30,6 +39,7 @@ class UsbDeviceInfo {
       'vendorId': vendorId,
       'productId': productId,
       'isDistingNT': isDistingNT,
+      'frameRates': frameRates,
     };
   }
 }
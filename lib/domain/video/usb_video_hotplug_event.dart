@@ -0,0 +1,36 @@
+import 'package:nt_helper/domain/video/usb_device_info.dart';
+
+/// A Disting NT video device appearing or disappearing, pushed by the
+/// native plugin as it happens (Linux).
+sealed class UsbVideoHotplugEvent {
+  const UsbVideoHotplugEvent();
+
+  /// Parses an event from the hotplug channel, or null for anything else.
+  static UsbVideoHotplugEvent? fromMap(Map<dynamic, dynamic> map) {
+    switch (map['event']) {
+      case 'attached':
+        final device = map['device'];
+        return device is Map
+            ? UsbVideoDeviceAttached(UsbDeviceInfo.fromMap(device))
+            : null;
+      case 'detached':
+        final deviceId = map['deviceId'];
+        return deviceId is String ? UsbVideoDeviceDetached(deviceId) : null;
+    }
+    return null;
+  }
+}
+
+/// A usable Disting NT capture node is now available.
+class UsbVideoDeviceAttached extends UsbVideoHotplugEvent {
+  final UsbDeviceInfo device;
+
+  const UsbVideoDeviceAttached(this.device);
+}
+
+/// A previously attached capture node has gone away.
+class UsbVideoDeviceDetached extends UsbVideoHotplugEvent {
+  final String deviceId;
+
+  const UsbVideoDeviceDetached(this.deviceId);
+}
@@ -3,9 +3,11 @@ import 'dart:async';
 import 'package:flutter/foundation.dart';
 import 'package:collection/collection.dart';
 import 'package:nt_helper/domain/video/usb_device_info.dart';
+import 'package:nt_helper/domain/video/usb_video_hotplug_event.dart';
 import 'package:nt_helper/domain/video/video_stream_state.dart';
 import 'package:nt_helper/services/platform_channels/usb_video_channel.dart';
 import 'package:nt_helper/services/debug_service.dart';
+import 'package:nt_helper/services/settings_service.dart';
 
 class UsbVideoManager {
   final UsbVideoChannel _channel;
@@ -16,8 +18,14 @@ class UsbVideoManager {
   StreamController<VideoStreamState>? _stateController;
   Timer? _recoveryTimer;
   Timer? _stallWatchdogTimer;
+  StreamSubscription<UsbVideoHotplugEvent>? _hotplugSubscription;
+  // Disting NT devices the native hotplug watcher reports as plugged in.
+  final Set<String> _attachedDeviceIds = {};
   String? _lastConnectedDeviceId;
   DateTime? _lastFrameReceivedTime;
+  // Set while the platform has paused capture because no window showing it
+  // can be seen; nothing arrives then, and that is not a stall.
+  bool _capturePaused = false;
   Duration _currentBackoffDuration = _minBackoffDuration;
 
   Stream<VideoStreamState> get stateStream =>
@@ -36,6 +44,10 @@ class UsbVideoManager {
   static const Duration _stallThreshold = Duration(seconds: 3);
   static const Duration _stallCheckInterval = Duration(seconds: 1);
 
+  // The native side stops sending unchanged frames; it re-sends the current
+  // one this often, comfortably inside the stall threshold.
+  static const Duration _unchangedFrameKeepAlive = Duration(seconds: 1);
+
   void _debugLog(String message) {
     _debugService.addLocalMessage('[UsbVideoManager] $message');
   }
@@ -43,6 +55,74 @@ class UsbVideoManager {
   Future<void> initialize() async {
     _stateController = StreamController<VideoStreamState>.broadcast();
     _updateState(const VideoStreamState.disconnected());
+    await _startHotplugMonitoring();
+  }
+
+  /// Where the platform pushes attach/detach events, reconnect as soon as
+  /// the device appears instead of polling for it.
+  Future<void> _startHotplugMonitoring() async {
+    await _hotplugSubscription?.cancel();
+    _hotplugSubscription = null;
+    _attachedDeviceIds.clear();
+    if (!_channel.supportsHotplugEvents) {
+      return;
+    }
+    _hotplugSubscription = _channel.hotplugEvents.listen(
+      _onHotplugEvent,
+      onError: (Object error) {
+        // Fall back to polling with backoff.
+        _debugLog('Hotplug monitoring unavailable: $error');
+        _hotplugSubscription?.cancel();
+        _hotplugSubscription = null;
+        _attachedDeviceIds.clear();
+        if (_isInErrorState) {
+          _startRecoveryTimer();
+        }
+      },
+    );
+  }
+
+  bool get _isInErrorState =>
+      _currentState.maybeWhen(error: (_) => true, orElse: () => false);
+
+  Future<void> _onHotplugEvent(UsbVideoHotplugEvent event) async {
+    switch (event) {
+      case UsbVideoDeviceAttached(:final device):
+        if (!device.isDistingNT) {
+          return;
+        }
+        _attachedDeviceIds.add(device.deviceId);
+        _debugLog('Device attached: ${device.deviceId}');
+        // Only reconnect when a connection is wanted but missing; an
+        // explicit disconnect() leaves the state disconnected, not error.
+        if (_isInErrorState) {
+          _stopRecoveryTimer();
+          _resetBackoff();
+          await connectToDevice(device.deviceId);
+        }
+      case UsbVideoDeviceDetached(:final deviceId):
+        _attachedDeviceIds.remove(deviceId);
+        _debugLog('Device detached: $deviceId');
+        final wasStreaming =
+            deviceId == _lastConnectedDeviceId &&
+            _currentState.maybeWhen(
+              streaming: (stream, width, height, fps) => true,
+              connecting: () => true,
+              orElse: () => false,
+            );
+        if (wasStreaming) {
+          _stopStallWatchdog();
+          try {
+            await _channel.stopVideoStream();
+          } catch (e) {
+            _debugLog('Error stopping stream after detach: $e');
+          }
+          _updateState(
+            const VideoStreamState.error('Disting NT video disconnected'),
+          );
+          _startRecoveryTimer();
+        }
+    }
   }
 
   Future<bool> isSupported() async {
@@ -92,13 +172,25 @@ class UsbVideoManager {
 
       // Start video stream
       _debugLog('Starting video stream...');
-      final videoStream = _channel.startVideoStream(deviceId);
+      final videoStream = _channel.startVideoStream(
+        deviceId,
+        useTexture: SettingsService().videoTextureDeliveryEnabled,
+        useDeltaFrames: SettingsService().videoDeltaFramesEnabled,
+        useGray4: SettingsService().videoGray4Enabled,
+        keepAlive: _unchangedFrameKeepAlive,
+        pauseWhenHidden: SettingsService().videoPauseWhenHidden,
+      );
+      _capturePaused = false;
 
       // Add debug monitoring to the stream and track frame reception
       final monitoredStream = videoStream.map((data) {
         _debugLog(
           'Received frame data: ${data?.runtimeType} ${data is Uint8List ? data.length : 'unknown'} bytes',
         );
+        if (data is Map && data['paused'] is bool) {
+          _capturePaused = data['paused'] as bool;
+          _debugLog(_capturePaused ? 'Capture paused' : 'Capture resumed');
+        }
         // Track frame reception time for stall detection
         _onFrameReceived();
         return data;
@@ -158,6 +250,20 @@ class UsbVideoManager {
     }
   }
 
+  /// PNG screenshot of the live video, or null when it cannot take one
+  /// (not streaming, capture paused, or not supported here), in which case
+  /// callers should ask the module over SysEx instead.
+  Future<Uint8List?> captureScreenshot() async {
+    final isStreaming = _currentState.maybeWhen(
+      streaming: (stream, width, height, fps) => true,
+      orElse: () => false,
+    );
+    if (!isStreaming || _capturePaused || !_channel.supportsScreenshot) {
+      return null;
+    }
+    return _channel.captureScreenshot();
+  }
+
   Future<void> autoConnect() async {
     // First check if video is supported on this platform
     final supported = await isSupported();
@@ -186,6 +292,13 @@ class UsbVideoManager {
   void _startRecoveryTimer() {
     _stopRecoveryTimer(); // Cancel any existing timer
 
+    // With hotplug events and nothing plugged in, polling cannot succeed;
+    // the attach event reconnects instead.
+    if (_hotplugSubscription != null && _attachedDeviceIds.isEmpty) {
+      _debugLog('No device attached - waiting for hotplug');
+      return;
+    }
+
     _debugLog(
       'Starting recovery timer with ${_currentBackoffDuration.inSeconds}s backoff',
     );
@@ -258,12 +371,13 @@ class UsbVideoManager {
     _stopStallWatchdog();
 
     _stallWatchdogTimer = Timer.periodic(_stallCheckInterval, (timer) {
-      // Only check for stalls during streaming state
+      // Only check for stalls during streaming state, and not while the
+      // platform has paused capture on purpose
       final isStreaming = _currentState.maybeWhen(
         streaming: (stream, width, height, fps) => true,
         orElse: () => false,
       );
-      if (!isStreaming) {
+      if (!isStreaming || _capturePaused) {
         return;
       }
 
@@ -318,6 +432,8 @@ class UsbVideoManager {
   Future<void> dispose() async {
     _stopRecoveryTimer();
     _stopStallWatchdog();
+    await _hotplugSubscription?.cancel();
+    _hotplugSubscription = null;
     _stateController?.close();
     await _channel.stopVideoStream();
     await _channel.dispose();
@@ -0,0 +1,147 @@
+/// Latency distribution of one stage of the native video pipeline, in
+/// microseconds. Percentiles are accurate to within about 12.5%.
+class VideoStageTiming {
+  final int count;
+  final int minUs;
+  final int meanUs;
+  final int p50Us;
+  final int p90Us;
+  final int p99Us;
+  final int maxUs;
+
+  const VideoStageTiming({
+    required this.count,
+    required this.minUs,
+    required this.meanUs,
+    required this.p50Us,
+    required this.p90Us,
+    required this.p99Us,
+    required this.maxUs,
+  });
+
+  static const empty = VideoStageTiming(
+    count: 0,
+    minUs: 0,
+    meanUs: 0,
+    p50Us: 0,
+    p90Us: 0,
+    p99Us: 0,
+    maxUs: 0,
+  );
+
+  factory VideoStageTiming.fromMap(Map<dynamic, dynamic>? map) {
+    if (map == null) {
+      return empty;
+    }
+    return VideoStageTiming(
+      count: map['count'] as int? ?? 0,
+      minUs: map['minUs'] as int? ?? 0,
+      meanUs: map['meanUs'] as int? ?? 0,
+      p50Us: map['p50Us'] as int? ?? 0,
+      p90Us: map['p90Us'] as int? ?? 0,
+      p99Us: map['p99Us'] as int? ?? 0,
+      maxUs: map['maxUs'] as int? ?? 0,
+    );
+  }
+
+  @override
+  String toString() =>
+      'p50 ${p50Us}us p90 ${p90Us}us p99 ${p99Us}us max ${maxUs}us (n=$count)';
+}
+
+/// One report from the Linux plugin's telemetry stream (see
+/// `native/usb_video/pipeline_telemetry.h`).
+///
+/// Stage timings and frame counts cover the whole capture session; the fps
+/// and CPU figures cover only the window since the previous report.
+class VideoPipelineTelemetry {
+  final int session;
+  final Duration sessionDuration;
+  final Duration window;
+
+  /// Driver timestamp to the capture thread dequeuing the buffer.
+  final VideoStageTiming dequeue;
+
+  /// Capture thread publishing a frame to the main thread picking it up.
+  final VideoStageTiming queueWait;
+
+  /// YUYV to RGB24, or packing to 4-bit gray.
+  final VideoStageTiming convert;
+
+  /// BMP and/or delta encoding.
+  final VideoStageTiming encode;
+
+  /// Handing the encoded frame to the platform channel.
+  final VideoStageTiming send;
+
+  final int framesCaptured;
+  final int framesDelivered;
+  final int framesSuppressed;
+  final int framesOverwritten;
+  final int framesDroppedByDriver;
+  final double captureFps;
+  final double deliveredFps;
+  final Duration captureThreadCpu;
+
+  /// Share of one core the capture thread used over the window.
+  final double captureThreadCpuPercent;
+
+  const VideoPipelineTelemetry({
+    required this.session,
+    required this.sessionDuration,
+    required this.window,
+    required this.dequeue,
+    required this.queueWait,
+    required this.convert,
+    required this.encode,
+    required this.send,
+    required this.framesCaptured,
+    required this.framesDelivered,
+    required this.framesSuppressed,
+    required this.framesOverwritten,
+    required this.framesDroppedByDriver,
+    required this.captureFps,
+    required this.deliveredFps,
+    required this.captureThreadCpu,
+    required this.captureThreadCpuPercent,
+  });
+
+  /// Whether [event] from the debug channel is a telemetry report.
+  static bool isReport(dynamic event) =>
+      event is Map && event['type'] == 'videoTelemetry';
+
+  factory VideoPipelineTelemetry.fromMap(Map<dynamic, dynamic> map) {
+    return VideoPipelineTelemetry(
+      session: map['session'] as int? ?? 0,
+      sessionDuration: Duration(milliseconds: map['sessionMs'] as int? ?? 0),
+      window: Duration(milliseconds: map['windowMs'] as int? ?? 0),
+      dequeue: VideoStageTiming.fromMap(map['dequeue'] as Map?),
+      queueWait: VideoStageTiming.fromMap(map['queueWait'] as Map?),
+      convert: VideoStageTiming.fromMap(map['convert'] as Map?),
+      encode: VideoStageTiming.fromMap(map['encode'] as Map?),
+      send: VideoStageTiming.fromMap(map['send'] as Map?),
+      framesCaptured: map['framesCaptured'] as int? ?? 0,
+      framesDelivered: map['framesDelivered'] as int? ?? 0,
+      framesSuppressed: map['framesSuppressed'] as int? ?? 0,
+      framesOverwritten: map['framesOverwritten'] as int? ?? 0,
+      framesDroppedByDriver: map['framesDroppedByDriver'] as int? ?? 0,
+      captureFps: (map['captureFps'] as num? ?? 0).toDouble(),
+      deliveredFps: (map['deliveredFps'] as num? ?? 0).toDouble(),
+      captureThreadCpu: Duration(
+        milliseconds: map['captureThreadCpuMs'] as int? ?? 0,
+      ),
+      captureThreadCpuPercent: (map['captureThreadCpuPercent'] as num? ?? 0)
+          .toDouble(),
+    );
+  }
+
+  @override
+  String toString() =>
+      'session $session: ${captureFps.toStringAsFixed(1)} fps captured, '
+      '${deliveredFps.toStringAsFixed(1)} fps delivered, '
+      'capture CPU ${captureThreadCpuPercent.toStringAsFixed(1)}%; '
+      'dequeue $dequeue, queue $queueWait, convert $convert, '
+      'encode $encode, send $send; '
+      'suppressed $framesSuppressed, overwritten $framesOverwritten, '
+      'driver drops $framesDroppedByDriver';
+}
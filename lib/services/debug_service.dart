@@ -1,5 +1,6 @@
 import 'dart:async';
 import 'package:flutter/foundation.dart';
+import 'package:nt_helper/domain/video/video_pipeline_telemetry.dart';
 import 'package:nt_helper/services/platform_channels/usb_video_debug_channel.dart';
 
 class DebugService {
@@ -26,6 +27,12 @@ class DebugService {
     }
   }
 
+  /// Native video pipeline timing reports (Linux), produced only while
+  /// listened to.
+  Stream<VideoPipelineTelemetry> videoTelemetry({
+    Duration interval = UsbVideoDebugChannel.defaultTelemetryInterval,
+  }) => _debugChannel.telemetry(interval: interval);
+
   void _addDebugMessage(String message) {
     _debugMessages.add(message);
 
@@ -0,0 +1,317 @@
+import 'dart:async';
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:isolate';
+
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+import 'package:nt_helper/domain/midi_message_transport.dart';
+
+typedef _InitializeNative = IntPtr Function(Pointer<Void> data);
+typedef _Initialize = int Function(Pointer<Void> data);
+typedef _ListPortsNative = Int64 Function(Pointer<Utf8> buffer, Int64 capacity);
+typedef _ListPorts = int Function(Pointer<Utf8> buffer, int capacity);
+typedef _OpenNative =
+    Pointer<Void> Function(
+      Int32 inputClient,
+      Int32 inputPort,
+      Int32 outputClient,
+      Int32 outputPort,
+      Int64 dartPort,
+    );
+typedef _Open =
+    Pointer<Void> Function(
+      int inputClient,
+      int inputPort,
+      int outputClient,
+      int outputPort,
+      int dartPort,
+    );
+typedef _SendNative =
+    Int32 Function(Pointer<Void> transport, Pointer<Uint8> data, Int64 size);
+typedef _Send = int Function(Pointer<Void> transport, Pointer<Uint8> data, int size);
+typedef _CloseNative = Void Function(Pointer<Void> transport);
+typedef _Close = void Function(Pointer<Void> transport);
+typedef _LastErrorNative = Pointer<Utf8> Function();
+
+/// A port another ALSA sequencer client offers.
+@immutable
+class AlsaSeqPort {
+  const AlsaSeqPort({
+    required this.client,
+    required this.port,
+    required this.clientName,
+    required this.portName,
+    required this.readable,
+    required this.writable,
+  });
+
+  final int client;
+  final int port;
+  final String clientName;
+  final String portName;
+
+  /// Whether the device sends on this port.
+  final bool readable;
+
+  /// Whether the device receives on this port.
+  final bool writable;
+
+  @override
+  String toString() => '$client:$port $clientName/$portName';
+}
+
+/// Binding to `libnt_midi`, the native ALSA sequencer transport bundled with
+/// the Linux build (`native/midi/midi_ffi.h`).
+///
+/// SysEx is framed on the library's own I/O thread and each complete
+/// message is posted straight to a [ReceivePort], so nothing goes through
+/// the platform thread or a method channel on the way in.
+class AlsaMidiBindings {
+  AlsaMidiBindings._(DynamicLibrary library)
+    : _initialize = library.lookupFunction<_InitializeNative, _Initialize>(
+        'nt_midi_initialize',
+      ),
+      _listPorts = library.lookupFunction<_ListPortsNative, _ListPorts>(
+        'nt_midi_list_ports',
+      ),
+      _open = library.lookupFunction<_OpenNative, _Open>('nt_midi_open'),
+      _send = library.lookupFunction<_SendNative, _Send>('nt_midi_send'),
+      _close = library.lookupFunction<_CloseNative, _Close>('nt_midi_close'),
+      _lastError = library
+          .lookupFunction<_LastErrorNative, _LastErrorNative>(
+            'nt_midi_last_error',
+          );
+
+  final _Initialize _initialize;
+  final _ListPorts _listPorts;
+  final _Open _open;
+  final _Send _send;
+  final _Close _close;
+  final _LastErrorNative _lastError;
+
+  static AlsaMidiBindings? _instance;
+  static bool _loaded = false;
+
+  /// The bindings, or null where the library is not available.
+  static AlsaMidiBindings? get instance {
+    if (!_loaded) {
+      _loaded = true;
+      _instance = _load();
+    }
+    return _instance;
+  }
+
+  static AlsaMidiBindings? _load() {
+    if (kIsWeb || !Platform.isLinux) {
+      return null;
+    }
+    try {
+      final bindings = AlsaMidiBindings._(
+        DynamicLibrary.open('libnt_midi.so'),
+      );
+      if (bindings._initialize(NativeApi.initializeApiDLData) != 0) {
+        return null;
+      }
+      return bindings;
+    } on ArgumentError {
+      return null;
+    }
+  }
+
+  /// The sequencer ports other clients offer.
+  List<AlsaSeqPort> listPorts() {
+    var capacity = 4096;
+    for (;;) {
+      final buffer = malloc<Uint8>(capacity);
+      try {
+        final length = _listPorts(buffer.cast(), capacity);
+        if (length >= capacity) {
+          capacity = length + 1;
+          continue;
+        }
+        return _parsePorts(buffer.cast<Utf8>().toDartString(length: length));
+      } finally {
+        malloc.free(buffer);
+      }
+    }
+  }
+
+  static List<AlsaSeqPort> _parsePorts(String text) {
+    final ports = <AlsaSeqPort>[];
+    for (final line in text.split('\n')) {
+      final fields = line.split('\t');
+      if (fields.length != 5) continue;
+      final client = int.tryParse(fields[0]);
+      final port = int.tryParse(fields[1]);
+      if (client == null || port == null) continue;
+      ports.add(
+        AlsaSeqPort(
+          client: client,
+          port: port,
+          clientName: fields[3],
+          portName: fields[4],
+          readable: fields[2].contains('r'),
+          writable: fields[2].contains('w'),
+        ),
+      );
+    }
+    return ports;
+  }
+}
+
+/// [MidiMessageTransport] over the ALSA sequencer.
+///
+/// Subscribes alongside any other client, `flutter_midi_command` included,
+/// so it can be opened on a device that is already connected there.
+class AlsaMidiTransport implements MidiMessageTransport {
+  AlsaMidiTransport._(this._bindings, this._input, this._output);
+
+  final AlsaMidiBindings _bindings;
+  final AlsaSeqPort _input;
+  final AlsaSeqPort _output;
+
+  Pointer<Void> _handle = nullptr;
+  ReceivePort? _receivePort;
+  StreamController<Uint8List> _messages = StreamController.broadcast();
+
+  // Reused for sends, grown to the largest message seen.
+  Pointer<Uint8> _sendBuffer = nullptr;
+  int _sendCapacity = 0;
+
+  /// Opens the sequencer ports of the device `flutter_midi_command` calls
+  /// [inputName] and [outputName], or returns null if the library is not
+  /// bundled or no such port is found.
+  ///
+  /// Names match as in device selection: case-insensitively, falling back
+  /// to any port with "disting" in its name.
+  static AlsaMidiTransport? open({
+    required String inputName,
+    required String outputName,
+  }) {
+    final bindings = AlsaMidiBindings.instance;
+    if (bindings == null) {
+      return null;
+    }
+    final ports = bindings.listPorts();
+    final input = matchPort(ports, inputName, input: true);
+    final output = matchPort(ports, outputName, input: false);
+    if (input == null || output == null) {
+      return null;
+    }
+    final transport = AlsaMidiTransport._(bindings, input, output);
+    return transport._connect() ? transport : null;
+  }
+
+  /// The port in [ports] for the device named [name]: the first whose
+  /// client or port name is [name], then the first containing it, then the
+  /// first Disting port.
+  @visibleForTesting
+  static AlsaSeqPort? matchPort(
+    List<AlsaSeqPort> ports,
+    String name, {
+    required bool input,
+  }) {
+    final candidates = ports
+        .where((port) => input ? port.readable : port.writable)
+        .toList();
+    final expected = name.trim().toLowerCase();
+    bool test(AlsaSeqPort port, bool Function(String) matches) =>
+        matches(port.portName.trim().toLowerCase()) ||
+        matches(port.clientName.trim().toLowerCase());
+
+    for (final matches in <bool Function(String)>[
+      (actual) => expected.isNotEmpty && actual == expected,
+      (actual) =>
+          expected.isNotEmpty &&
+          (actual.contains(expected) || expected.contains(actual)),
+      (actual) => actual.contains('disting'),
+    ]) {
+      for (final port in candidates) {
+        if (test(port, matches)) return port;
+      }
+    }
+    return null;
+  }
+
+  bool _connect() {
+    final receivePort = ReceivePort('nt_midi');
+    final handle = _bindings._open(
+      _input.client,
+      _input.port,
+      _output.client,
+      _output.port,
+      receivePort.sendPort.nativePort,
+    );
+    if (handle == nullptr) {
+      debugPrint(
+        'AlsaMidiTransport: cannot open $_input -> $_output: '
+        '${_bindings._lastError().toDartString()}',
+      );
+      receivePort.close();
+      return false;
+    }
+    _handle = handle;
+    _receivePort = receivePort;
+    final messages = _messages;
+    receivePort.listen((message) {
+      if (message is Uint8List) {
+        messages.add(message);
+      } else if (message == null) {
+        // The device went away.
+        _disconnect();
+      }
+    });
+    return true;
+  }
+
+  void _disconnect() {
+    if (_handle != nullptr) {
+      _bindings._close(_handle);
+      _handle = nullptr;
+    }
+    _receivePort?.close();
+    _receivePort = null;
+    _messages.close();
+  }
+
+  @override
+  Stream<Uint8List> get messages => _messages.stream;
+
+  @override
+  bool get isOpen => _handle != nullptr;
+
+  @override
+  void send(Uint8List data) {
+    if (_handle == nullptr) {
+      throw StateError('MIDI transport is closed');
+    }
+    if (data.isEmpty) return;
+    if (data.length > _sendCapacity) {
+      if (_sendBuffer != nullptr) malloc.free(_sendBuffer);
+      _sendBuffer = malloc<Uint8>(data.length);
+      _sendCapacity = data.length;
+    }
+    _sendBuffer.asTypedList(data.length).setAll(0, data);
+    if (_bindings._send(_handle, _sendBuffer, data.length) != 0) {
+      throw StateError('MIDI transport send failed');
+    }
+  }
+
+  @override
+  Future<bool> reopen() async {
+    _disconnect();
+    _messages = StreamController.broadcast();
+    return _connect();
+  }
+
+  @override
+  void close() {
+    _disconnect();
+    if (_sendBuffer != nullptr) {
+      malloc.free(_sendBuffer);
+      _sendBuffer = nullptr;
+      _sendCapacity = 0;
+    }
+  }
+}
@@ -0,0 +1,88 @@
+import 'dart:ffi';
+import 'dart:io';
+
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+
+typedef _EncodeLevelsNative =
+    Int64 Function(
+      Pointer<Uint8> levels,
+      Int64 length,
+      Int32 width,
+      Int32 height,
+      Pointer<Pointer<Uint8>> png,
+    );
+typedef _EncodeLevels =
+    int Function(
+      Pointer<Uint8> levels,
+      int length,
+      int width,
+      int height,
+      Pointer<Pointer<Uint8>> png,
+    );
+typedef _FreeNative = Void Function(Pointer<Uint8> png);
+typedef _Free = void Function(Pointer<Uint8> png);
+
+/// Binding to `libnt_screenshot`, the native screenshot encoder bundled with
+/// the Linux build (`native/usb_video/screenshot_ffi.h`).
+///
+/// It renders the display's brightness levels to the same pixels as the
+/// Dart fallback in `ScreenshotResponse`, without a per-pixel loop in Dart.
+class NativeScreenshot {
+  NativeScreenshot._(DynamicLibrary library)
+    : _encodeLevels = library
+          .lookupFunction<_EncodeLevelsNative, _EncodeLevels>(
+            'nt_screenshot_encode_levels',
+          ),
+      _free = library.lookupFunction<_FreeNative, _Free>('nt_screenshot_free');
+
+  final _EncodeLevels _encodeLevels;
+  final _Free _free;
+
+  static NativeScreenshot? _instance;
+  static bool _loaded = false;
+
+  /// The encoder, or null where the library is not available.
+  static NativeScreenshot? get instance {
+    if (!_loaded) {
+      _loaded = true;
+      _instance = _load();
+    }
+    return _instance;
+  }
+
+  static NativeScreenshot? _load() {
+    if (kIsWeb || !Platform.isLinux) {
+      return null;
+    }
+    try {
+      return NativeScreenshot._(DynamicLibrary.open('libnt_screenshot.so'));
+    } on ArgumentError {
+      return null;
+    }
+  }
+
+  /// PNG of a [width] x [height] display given one level (0-15) per pixel,
+  /// inside a 5 pixel black border, or null if encoding failed.
+  Uint8List? encodeLevels(
+    Uint8List levels, {
+    int width = 256,
+    int height = 64,
+  }) {
+    final input = malloc<Uint8>(levels.isEmpty ? 1 : levels.length);
+    final output = malloc<Pointer<Uint8>>();
+    try {
+      input.asTypedList(levels.length).setAll(0, levels);
+      final size = _encodeLevels(input, levels.length, width, height, output);
+      if (size <= 0) {
+        return null;
+      }
+      final png = Uint8List.fromList(output.value.asTypedList(size));
+      _free(output.value);
+      return png;
+    } finally {
+      malloc.free(input);
+      malloc.free(output);
+    }
+  }
+}
@@ -0,0 +1,138 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:math';
+
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+
+typedef _EncodeNybblesNative =
+    Int64 Function(Pointer<Uint8> input, Int64 size, Pointer<Uint8> output);
+typedef _EncodeNybbles =
+    int Function(Pointer<Uint8> input, int size, Pointer<Uint8> output);
+typedef _DecodeParameterValuesNative =
+    Void Function(
+      Pointer<Uint8> data,
+      Int64 count,
+      Pointer<Int16> values,
+      Pointer<Uint8> flags,
+    );
+typedef _DecodeParameterValues =
+    void Function(
+      Pointer<Uint8> data,
+      int count,
+      Pointer<Int16> values,
+      Pointer<Uint8> flags,
+    );
+
+/// Binding to the SysEx field codec in `libnt_sysex`, bundled with the
+/// Linux build (`native/midi/nt_sysex_codec_ffi.h`).
+///
+/// Each call copies its input into a native scratch buffer, kept between
+/// calls so nothing is allocated once it has grown, and its output back.
+/// That pays off only on large buffers; the helpers in `sysex_utils.dart`
+/// decide when to use it and produce the same bytes either way.
+class NativeSysExCodec {
+  NativeSysExCodec._(DynamicLibrary library)
+    : _encodeNybbles = library
+          .lookupFunction<_EncodeNybblesNative, _EncodeNybbles>(
+            'nt_sysex_encode_nybbles',
+            isLeaf: true,
+          ),
+      _decodeNybbles = library
+          .lookupFunction<_EncodeNybblesNative, _EncodeNybbles>(
+            'nt_sysex_decode_nybbles',
+            isLeaf: true,
+          ),
+      _decodeParameterValues = library
+          .lookupFunction<_DecodeParameterValuesNative, _DecodeParameterValues>(
+            'nt_sysex_decode_parameter_values',
+            isLeaf: true,
+          );
+
+  final _EncodeNybbles _encodeNybbles;
+  final _EncodeNybbles _decodeNybbles;
+  final _DecodeParameterValues _decodeParameterValues;
+
+  // Input and output of the current call. Calls are synchronous, so one
+  // buffer per isolate is enough; it lives as long as the codec does.
+  Pointer<Uint8> _scratch = nullptr;
+  int _scratchSize = 0;
+
+  static NativeSysExCodec? _instance;
+  static bool _loaded = false;
+
+  /// The codec, or null where the library is not available.
+  static NativeSysExCodec? get instance {
+    if (!_loaded) {
+      _loaded = true;
+      _instance = _load();
+    }
+    return _instance;
+  }
+
+  static NativeSysExCodec? _load() {
+    if (kIsWeb || !Platform.isLinux) {
+      return null;
+    }
+    try {
+      return NativeSysExCodec._(DynamicLibrary.open('libnt_sysex.so'));
+    } on ArgumentError {
+      return null;
+    }
+  }
+
+  Pointer<Uint8> _scratchOf(int size) {
+    if (size > _scratchSize) {
+      if (_scratchSize > 0) {
+        malloc.free(_scratch);
+      }
+      _scratchSize = max(size, 2 * _scratchSize);
+      _scratch = malloc<Uint8>(_scratchSize);
+    }
+    return _scratch;
+  }
+
+  /// Writes each of [bytes] as two nybbles into [out] from [offset] and
+  /// returns the sum of the nybbles.
+  int encodeNybbles(Uint8List bytes, Uint8List out, int offset) {
+    final size = bytes.length;
+    final input = _scratchOf(3 * size + 1);
+    final output = input + size;
+    input.asTypedList(size).setAll(0, bytes);
+    final sum = _encodeNybbles(input, size, output);
+    out.setAll(offset, output.asTypedList(2 * size));
+    return sum;
+  }
+
+  /// Joins the nybble pairs of [nybbles] into bytes.
+  Uint8List decodeNybbles(Uint8List nybbles) {
+    final size = nybbles.length;
+    final input = _scratchOf(size + size ~/ 2 + 1);
+    final output = input + size;
+    input.asTypedList(size).setAll(0, nybbles);
+    final count = _decodeNybbles(input, size, output);
+    return Uint8List.fromList(output.asTypedList(count));
+  }
+
+  /// Reads `values.length` 21-bit parameter values from [data] at
+  /// [offset], the flag field of each going to [flags].
+  void decodeParameterValues(
+    Uint8List data,
+    int offset,
+    Int16List values,
+    Uint8List flags,
+  ) {
+    final count = values.length;
+    // Data, then flags, then the values on an aligned offset.
+    final valuesOffset = (4 * count + 7) & ~7;
+    final input = _scratchOf(valuesOffset + 2 * count + 2);
+    final flagsOut = input + 3 * count;
+    final output = (input + valuesOffset).cast<Int16>();
+    input
+        .asTypedList(3 * count)
+        .setAll(0, Uint8List.sublistView(data, offset, offset + 3 * count));
+    _decodeParameterValues(input, count, output, flagsOut);
+    values.setAll(0, output.asTypedList(count));
+    flags.setAll(0, flagsOut.asTypedList(count));
+  }
+}
@@ -0,0 +1,160 @@
+import 'dart:ffi';
+import 'dart:io';
+
+import 'package:ffi/ffi.dart';
+import 'package:flutter/foundation.dart';
+import 'package:nt_helper/domain/sysex/sysex_stream_parser.dart';
+
+/// `NtSysExEvent` in `native/midi/nt_sysex_ffi.h`.
+final class _NtSysExEvent extends Struct {
+  @Int32()
+  external int kind;
+  @Int32()
+  external int sysExId;
+  @Int32()
+  external int messageType;
+  @Int32()
+  external int payloadOffset;
+  external Pointer<Uint8> data;
+  @Int64()
+  external int size;
+}
+
+const int _kEventMessage = 0;
+const int _kEventOther = 1;
+const int _kEventTruncated = 2;
+
+typedef _CreateNative = Pointer<Void> Function();
+typedef _DestroyNative = Void Function(Pointer<Void> parser);
+typedef _Destroy = void Function(Pointer<Void> parser);
+typedef _InputNative =
+    Pointer<Uint8> Function(Pointer<Void> parser, Int64 capacity);
+typedef _Input = Pointer<Uint8> Function(Pointer<Void> parser, int capacity);
+typedef _FeedNative = Int64 Function(Pointer<Void> parser, Int64 size);
+typedef _Feed = int Function(Pointer<Void> parser, int size);
+typedef _EventsNative = Pointer<_NtSysExEvent> Function(Pointer<Void> parser);
+typedef _InSysExNative = Int32 Function(Pointer<Void> parser);
+typedef _InSysEx = int Function(Pointer<Void> parser);
+
+class _Bindings {
+  _Bindings(DynamicLibrary library)
+    : create = library.lookupFunction<_CreateNative, _CreateNative>(
+        'nt_sysex_create',
+      ),
+      destroy = library.lookupFunction<_DestroyNative, _Destroy>(
+        'nt_sysex_destroy',
+      ),
+      input = library.lookupFunction<_InputNative, _Input>('nt_sysex_input'),
+      feed = library.lookupFunction<_FeedNative, _Feed>('nt_sysex_feed'),
+      events = library.lookupFunction<_EventsNative, _EventsNative>(
+        'nt_sysex_events',
+      ),
+      inSysEx = library.lookupFunction<_InSysExNative, _InSysEx>(
+        'nt_sysex_in_sysex',
+      ),
+      reset = library.lookupFunction<_DestroyNative, _Destroy>(
+        'nt_sysex_reset',
+      );
+
+  final _CreateNative create;
+  final _Destroy destroy;
+  final _Input input;
+  final _Feed feed;
+  final _EventsNative events;
+  final _InSysEx inSysEx;
+  final _Destroy reset;
+}
+
+/// [SysExStreamParser] backed by `libnt_sysex`, the native reassembler
+/// bundled with the Linux build (`native/midi/nt_sysex_ffi.h`).
+///
+/// Headers are checked natively, so only Disting NT messages cross back
+/// into Dart as SysEx, and each is copied out of native memory once.
+class NativeSysExParser implements SysExStreamParser {
+  NativeSysExParser._(this._bindings, this._parser);
+
+  final _Bindings _bindings;
+  Pointer<Void> _parser;
+
+  static _Bindings? _library;
+  static bool _loaded = false;
+
+  /// A new parser, or null where the library is not available.
+  static NativeSysExParser? create() {
+    if (!_loaded) {
+      _loaded = true;
+      _library = _load();
+    }
+    final bindings = _library;
+    if (bindings == null) {
+      return null;
+    }
+    final parser = bindings.create();
+    return parser == nullptr ? null : NativeSysExParser._(bindings, parser);
+  }
+
+  static _Bindings? _load() {
+    if (kIsWeb || !Platform.isLinux) {
+      return null;
+    }
+    try {
+      return _Bindings(DynamicLibrary.open('libnt_sysex.so'));
+    } on ArgumentError {
+      return null;
+    }
+  }
+
+  @override
+  void feed(
+    Uint8List data, {
+    required void Function(Uint8List sysex) onSysEx,
+    required void Function(Uint8List message) onOther,
+    required void Function() onTruncated,
+  }) {
+    if (_parser == nullptr || data.isEmpty) return;
+    final input = _bindings.input(_parser, data.length);
+    if (input == nullptr) return;
+    input.asTypedList(data.length).setAll(0, data);
+    final count = _bindings.feed(_parser, data.length);
+    if (count == 0) return;
+
+    // Copy everything out before calling back, since a callback may feed
+    // this parser again and reuse the native buffers.
+    final events = _bindings.events(_parser);
+    final kinds = List<int>.filled(count, 0);
+    final messages = List<Uint8List?>.filled(count, null);
+    for (var i = 0; i < count; i++) {
+      final event = events[i];
+      kinds[i] = event.kind;
+      if (event.kind != _kEventTruncated) {
+        messages[i] = Uint8List.fromList(event.data.asTypedList(event.size));
+      }
+    }
+    for (var i = 0; i < count; i++) {
+      switch (kinds[i]) {
+        case _kEventMessage:
+          onSysEx(messages[i]!);
+        case _kEventOther:
+          onOther(messages[i]!);
+        case _kEventTruncated:
+          onTruncated();
+      }
+    }
+  }
+
+  @override
+  bool get inSysEx => _parser != nullptr && _bindings.inSysEx(_parser) != 0;
+
+  @override
+  void reset() {
+    if (_parser != nullptr) _bindings.reset(_parser);
+  }
+
+  @override
+  void dispose() {
+    if (_parser != nullptr) {
+      _bindings.destroy(_parser);
+      _parser = nullptr;
+    }
+  }
+}
@@ -3,7 +3,10 @@ import 'dart:io';
 
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
+import 'package:nt_helper/domain/video/delta_frame_compositor.dart';
+import 'package:nt_helper/domain/video/gray4_frame.dart';
 import 'package:nt_helper/domain/video/usb_device_info.dart';
+import 'package:nt_helper/domain/video/usb_video_hotplug_event.dart';
 import 'package:nt_helper/services/debug_service.dart';
 import 'package:nt_helper/services/platform_channels/android_usb_video_channel.dart';
 
@@ -12,6 +15,9 @@ class UsbVideoChannel {
   static const _eventChannel = EventChannel(
     'com.example.nt_helper/usb_video_stream',
   );
+  static const _hotplugChannel = EventChannel(
+    'com.example.nt_helper/usb_video_hotplug',
+  );
 
   Stream<dynamic>? _videoStream;
   StreamSubscription<dynamic>? _keepAliveSubscription; // Keep stream alive
@@ -27,6 +33,33 @@ class UsbVideoChannel {
 
   bool get _useAndroidImplementation => !kIsWeb && Platform.isAndroid;
 
+  /// Whether the native plugin can render frames into a Flutter texture.
+  bool get supportsTextureDelivery => !kIsWeb && Platform.isLinux;
+
+  /// Whether the native plugin can send dirty-row delta frames.
+  bool get supportsDeltaFrames => !kIsWeb && Platform.isLinux;
+
+  /// Whether the platform can send packed 4-bit grayscale frames.
+  bool get supportsGray4Frames => !kIsWeb && Platform.isLinux;
+
+  /// Whether the platform pushes [hotplugEvents].
+  bool get supportsHotplugEvents => !kIsWeb && Platform.isLinux;
+
+  /// Disting NT video devices attaching and detaching (Linux). Listening
+  /// starts the native watcher, which first reports every device already
+  /// attached; cancelling stops it.
+  Stream<UsbVideoHotplugEvent> get hotplugEvents {
+    if (!supportsHotplugEvents) {
+      return const Stream.empty();
+    }
+    return _hotplugChannel
+        .receiveBroadcastStream()
+        .where((event) => event is Map)
+        .map((event) => UsbVideoHotplugEvent.fromMap(event as Map))
+        .where((event) => event != null)
+        .cast<UsbVideoHotplugEvent>();
+  }
+
   void _ensureAndroidChannel() {
     if (_useAndroidImplementation && _androidChannel == null) {
       _debugLog('Creating AndroidUsbVideoChannel');
@@ -74,7 +107,49 @@ class UsbVideoChannel {
     }
   }
 
-  Stream<dynamic> startVideoStream(String deviceId) {
+  /// Starts streaming from [deviceId].
+  ///
+  /// When [useTexture] is set and the platform supports it (Linux), frames are
+  /// rendered into a native GPU texture. The stream then emits a single
+  /// `{'textureId': int}` map followed by integer frame-count heartbeats
+  /// instead of encoded frames.
+  ///
+  /// Where supported (Linux), frames identical to the last one delivered are
+  /// suppressed natively, but one is still re-sent every [keepAlive] so the
+  /// stream never looks stalled. [Duration.zero] disables suppression; null
+  /// keeps the platform default.
+  ///
+  /// With [useDeltaFrames] (Linux, BMP delivery only) the plugin sends only
+  /// the rows that changed since the previous frame plus periodic keyframes;
+  /// they are composited back into full BMPs here, so the returned stream
+  /// looks the same either way. This shrinks what crosses the platform
+  /// channel only: each composited frame is still a full-size copy.
+  ///
+  /// With [useGray4] (Linux, BMP delivery only) the plugin quantises the
+  /// picture to the display's 16 levels and packs two pixels per byte, about
+  /// a sixth of the 24-bit size. Frames are expanded into 4 bpp BMPs through
+  /// [gray4Palette] (plain grays by default) before reaching listeners.
+  ///
+  /// Where supported (Linux), [fps] caps the capture rate at the closest rate
+  /// the device offers (see [UsbDeviceInfo.frameRates]); null takes the
+  /// fastest. The plugin also steps the rate down on its own while frames
+  /// arrive faster than they are shown, or while the window is unfocused,
+  /// and back up once that passes.
+  ///
+  /// Where supported (Linux), capture also follows the window: while no
+  /// window showing the stream can be seen, it stops altogether with
+  /// [pauseWhenHidden], or else drops to one frame a second. A paused stream
+  /// emits `{'paused': true}`, then nothing until `{'paused': false}`.
+  Stream<dynamic> startVideoStream(
+    String deviceId, {
+    bool useTexture = false,
+    Duration? keepAlive,
+    bool useDeltaFrames = false,
+    bool useGray4 = false,
+    List<int>? gray4Palette,
+    double? fps,
+    bool pauseWhenHidden = true,
+  }) {
     _debugLog('Starting video stream for device: $deviceId');
 
     // Use Android-specific implementation if on Android
@@ -102,10 +177,30 @@ class UsbVideoChannel {
     // Track the current device
     _currentDeviceId = deviceId;
 
+    final requestTexture = useTexture && supportsTextureDelivery;
+    final requestDelta =
+        useDeltaFrames && supportsDeltaFrames && !requestTexture;
+    final requestGray4 = useGray4 && supportsGray4Frames && !requestTexture;
+
     // Create a fresh event channel stream for receiving frames
     _debugLog('Creating new event channel stream');
     _videoStream = _eventChannel.receiveBroadcastStream({'deviceId': deviceId});
 
+    // Rebuild full frames before the stream is shared, so the compositor
+    // runs once per event rather than once per listener.
+    if (requestDelta) {
+      final compositor = DeltaFrameCompositor();
+      _videoStream = _videoStream!
+          .map((data) => data is Uint8List ? compositor.apply(data) : data)
+          .where((data) => data != null);
+    }
+    if (requestGray4) {
+      final converter = Gray4FrameConverter(palette: gray4Palette);
+      _videoStream = _videoStream!
+          .map((data) => data is Uint8List ? converter.apply(data) : data)
+          .where((data) => data != null);
+    }
+
     // Convert to broadcast stream and add error handling
     _videoStream = _videoStream!
         .asBroadcastStream()
@@ -132,7 +227,15 @@ class UsbVideoChannel {
 
     // Then call the method channel to start the capture (after event channel is ready)
     _channel
-        .invokeMethod('startVideoStream', {'deviceId': deviceId})
+        .invokeMethod('startVideoStream', {
+          'deviceId': deviceId,
+          if (requestTexture) 'delivery': 'texture',
+          if (requestDelta) 'encoding': 'delta',
+          if (requestGray4) 'format': 'gray4',
+          if (keepAlive != null) 'keepAliveMs': keepAlive.inMilliseconds,
+          if (fps != null) 'fps': fps,
+          'whenHidden': pauseWhenHidden ? 'pause' : 'keepAlive',
+        })
         .then((result) {
           _debugLog('startVideoStream result: $result');
         })
@@ -181,6 +284,139 @@ class UsbVideoChannel {
     }
   }
 
+  /// Native capture diagnostics, such as how long frames wait between the
+  /// driver timestamping them and the capture thread dequeuing them.
+  ///
+  /// Returns null where the platform does not report statistics.
+  Future<Map<String, dynamic>?> getStreamStatistics() async {
+    if (_useAndroidImplementation) {
+      return null;
+    }
+
+    try {
+      final Map<dynamic, dynamic>? stats = await _channel.invokeMethod(
+        'getStreamStatistics',
+      );
+      return stats?.cast<String, dynamic>();
+    } on PlatformException catch (e) {
+      _debugLog('Failed to get stream statistics: ${e.message}');
+      return null;
+    } on MissingPluginException {
+      return null;
+    }
+  }
+
+  /// Whether the native plugin can record the display to a file.
+  bool get supportsRecording => !kIsWeb && Platform.isLinux;
+
+  /// Records every captured frame to [path] until [stopRecording] or the
+  /// stream stops. Requires a running stream.
+  ///
+  /// Frames are stored raw (YUYV) or, with [gray4], as the display's 16
+  /// gray levels, delta-coded and compressed with a keyframe index for
+  /// seeking. Recording runs on its own native thread and never delays the
+  /// live picture; if the disk falls behind, frames are left out of the file.
+  ///
+  /// Returns false if recording could not start.
+  Future<bool> startRecording(String path, {bool gray4 = true}) async {
+    if (!supportsRecording) {
+      return false;
+    }
+    try {
+      await _channel.invokeMethod('startRecording', {
+        'path': path,
+        'format': gray4 ? 'gray4' : 'yuyv',
+      });
+      return true;
+    } on PlatformException catch (e) {
+      _debugLog('Failed to start recording: ${e.message}');
+      return false;
+    }
+  }
+
+  /// Finishes the current recording. Returns its totals (`framesWritten`,
+  /// `framesDropped`, `bytesWritten`), or null if nothing was recording.
+  Future<Map<String, dynamic>?> stopRecording() async {
+    if (!supportsRecording) {
+      return null;
+    }
+    try {
+      final Map<dynamic, dynamic>? totals = await _channel.invokeMethod(
+        'stopRecording',
+      );
+      return totals?.cast<String, dynamic>();
+    } on PlatformException catch (e) {
+      _debugLog('Failed to stop recording: ${e.message}');
+      return (e.details as Map<dynamic, dynamic>?)?.cast<String, dynamic>();
+    }
+  }
+
+  /// Whether the native plugin can export frames to shared memory.
+  bool get supportsFrameExport => !kIsWeb && Platform.isLinux;
+
+  /// Publishes every captured frame, raw YUYV, to a POSIX shared-memory ring
+  /// other programs (OBS, recorders) can read without copies, until
+  /// [stopFrameExport] or the stream stops. Requires a running stream.
+  ///
+  /// [name] is the shared-memory object to create, e.g. `/nt_helper_video`
+  /// (the default). The native side never waits on readers, so a slow one
+  /// misses frames instead of delaying the live picture. See
+  /// `native/usb_video/shared_frame_format.h` for the layout and
+  /// `native/usb_video/tools/shared_frame_reader.h` for a reader.
+  ///
+  /// Returns the export's `name`, `width`, `height` and `slots`, or null if
+  /// it could not start.
+  Future<Map<String, dynamic>?> startFrameExport({String? name}) async {
+    if (!supportsFrameExport) {
+      return null;
+    }
+    try {
+      final Map<dynamic, dynamic>? info = await _channel.invokeMethod(
+        'startFrameExport',
+        {if (name != null) 'name': name},
+      );
+      return info?.cast<String, dynamic>();
+    } on PlatformException catch (e) {
+      _debugLog('Failed to start frame export: ${e.message}');
+      return null;
+    }
+  }
+
+  /// Stops the shared-memory export. Returns how many frames it published
+  /// (`framesExported`), or null if nothing was being exported.
+  Future<Map<String, dynamic>?> stopFrameExport() async {
+    if (!supportsFrameExport) {
+      return null;
+    }
+    try {
+      final Map<dynamic, dynamic>? totals = await _channel.invokeMethod(
+        'stopFrameExport',
+      );
+      return totals?.cast<String, dynamic>();
+    } on PlatformException catch (e) {
+      _debugLog('Failed to stop frame export: ${e.message}');
+      return null;
+    }
+  }
+
+  /// Whether the native plugin can screenshot the live video.
+  bool get supportsScreenshot => !kIsWeb && Platform.isLinux;
+
+  /// PNG of the next captured frame, rendered like a SysEx screenshot (the
+  /// display's 16 levels in teal inside a black border), or null if the
+  /// stream is not running or stops first.
+  Future<Uint8List?> captureScreenshot() async {
+    if (!supportsScreenshot) {
+      return null;
+    }
+    try {
+      return await _channel.invokeMethod<Uint8List>('captureScreenshot');
+    } on PlatformException catch (e) {
+      _debugLog('Failed to capture screenshot: ${e.message}');
+      return null;
+    }
+  }
+
   /// Called when app enters background
   Future<void> pauseStreaming() async {
     _debugLog('Pausing video streaming');
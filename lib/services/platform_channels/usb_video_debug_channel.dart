@@ -1,18 +1,69 @@
+import 'dart:async';
+
 import 'package:flutter/services.dart';
+import 'package:nt_helper/domain/video/video_pipeline_telemetry.dart';
 
 class UsbVideoDebugChannel {
   static const _eventChannel = EventChannel(
     'com.example.nt_helper/usb_video_debug',
   );
+  static const _methodChannel = MethodChannel(
+    'com.example.nt_helper/usb_video',
+  );
 
+  /// How often the plugin reports while someone listens to [telemetry].
+  static const defaultTelemetryInterval = Duration(seconds: 1);
+
+  // One platform subscription shared by the log and telemetry streams;
+  // cancelling either must not cut the other off.
+  Stream<dynamic>? _events;
   Stream<String>? _debugStream;
 
+  Stream<dynamic> get _platformEvents =>
+      _events ??= _eventChannel.receiveBroadcastStream();
+
   Stream<String> get debugStream {
-    _debugStream ??= _eventChannel.receiveBroadcastStream().cast<String>();
+    _debugStream ??= _platformEvents.where((e) => e is String).cast<String>();
     return _debugStream!;
   }
 
+  /// Pipeline timing reports (Linux). Reports are only produced natively
+  /// while this stream has a listener, at most once per [interval].
+  Stream<VideoPipelineTelemetry> telemetry({
+    Duration interval = defaultTelemetryInterval,
+  }) {
+    StreamSubscription<dynamic>? subscription;
+    late final StreamController<VideoPipelineTelemetry> controller;
+    controller = StreamController<VideoPipelineTelemetry>(
+      onListen: () {
+        subscription = _platformEvents
+            .where(VideoPipelineTelemetry.isReport)
+            .map((e) => VideoPipelineTelemetry.fromMap(e as Map))
+            .listen(controller.add, onError: controller.addError);
+        _setTelemetryInterval(interval);
+      },
+      onCancel: () async {
+        await _setTelemetryInterval(Duration.zero);
+        await subscription?.cancel();
+      },
+    );
+    return controller.stream;
+  }
+
+  Future<void> _setTelemetryInterval(Duration interval) async {
+    try {
+      await _methodChannel.invokeMethod('setTelemetryInterval', {
+        'intervalMs': interval.inMilliseconds,
+      });
+    } on PlatformException {
+      // Plugins without telemetry reject the call; the stream stays quiet.
+    } on MissingPluginException {
+      // No video plugin on this platform.
+    }
+  }
+
   void dispose() {
     _debugStream = null;
+    _events = null;
   }
 }
@@ -67,6 +67,18 @@ class SettingsService {
   static const String _videoPopupBoundsYKey = 'video_popup_bounds_y';
   static const String _videoPopupBoundsWidthKey = 'video_popup_bounds_width';
   static const String _videoPopupBoundsHeightKey = 'video_popup_bounds_height';
+  static const String _videoTextureDeliveryEnabledKey =
+      'video_texture_delivery_enabled';
+  static const String _videoDeltaFramesEnabledKey =
+      'video_delta_frames_enabled';
+  static const String _videoGray4EnabledKey = 'video_gray4_enabled';
+  static const String _videoPauseWhenHiddenKey = 'video_pause_when_hidden';
+  static const String _nativeMidiTransportEnabledKey =
+      'native_midi_transport_enabled';
+  static const String _nativeSysExParserEnabledKey =
+      'native_sysex_parser_enabled';
+  static const String _pipelinedRequestsEnabledKey =
+      'pipelined_requests_enabled';
   static const String _showDebugPanelKey = 'show_debug_panel';
   static const String _showContextualHelpKey = 'show_contextual_help';
   static const String _algorithmCacheDaysKey = 'algorithm_cache_days';
@@ -118,6 +130,13 @@ class SettingsService {
     _videoPopupBoundsYKey,
     _videoPopupBoundsWidthKey,
     _videoPopupBoundsHeightKey,
+    _videoTextureDeliveryEnabledKey,
+    _videoDeltaFramesEnabledKey,
+    _videoGray4EnabledKey,
+    _videoPauseWhenHiddenKey,
+    _nativeMidiTransportEnabledKey,
+    _nativeSysExParserEnabledKey,
+    _pipelinedRequestsEnabledKey,
     _showDebugPanelKey,
     _showContextualHelpKey,
     _algorithmCacheDaysKey,
@@ -172,6 +191,13 @@ class SettingsService {
   static const double defaultVideoPopupBoundsY = -1.0;
   static const double defaultVideoPopupBoundsWidth = 384.0;
   static const double defaultVideoPopupBoundsHeight = 132.0;
+  static const bool defaultVideoTextureDeliveryEnabled = false;
+  static const bool defaultVideoDeltaFramesEnabled = false;
+  static const bool defaultVideoGray4Enabled = false;
+  static const bool defaultVideoPauseWhenHidden = true;
+  static const bool defaultNativeMidiTransportEnabled = false;
+  static const bool defaultNativeSysExParserEnabled = false;
+  static const bool defaultPipelinedRequestsEnabled = false;
   static const bool defaultShowDebugPanel = true;
   static const bool defaultShowContextualHelp = true;
   static const int defaultAlgorithmCacheDays = 2;
@@ -410,6 +436,86 @@ class SettingsService {
         false;
   }
 
+  /// Check if USB video should render through a native GPU texture instead of
+  /// sending encoded frames over the platform channel (Linux only).
+  bool get videoTextureDeliveryEnabled =>
+      _prefs?.getBool(_videoTextureDeliveryEnabledKey) ??
+      defaultVideoTextureDeliveryEnabled;
+
+  /// Set whether USB video should render through a native GPU texture.
+  Future<bool> setVideoTextureDeliveryEnabled(bool value) async {
+    return await _prefs?.setBool(_videoTextureDeliveryEnabledKey, value) ??
+        false;
+  }
+
+  /// Check if USB video frames should be sent as changed rows only, with
+  /// periodic keyframes (Linux only).
+  bool get videoDeltaFramesEnabled =>
+      _prefs?.getBool(_videoDeltaFramesEnabledKey) ??
+      defaultVideoDeltaFramesEnabled;
+
+  /// Set whether USB video frames should be sent as changed rows only.
+  Future<bool> setVideoDeltaFramesEnabled(bool value) async {
+    return await _prefs?.setBool(_videoDeltaFramesEnabledKey, value) ??
+        false;
+  }
+
+  /// Check if USB video frames should be sent as packed 4-bit grayscale
+  /// instead of 24-bit colour (Linux only).
+  bool get videoGray4Enabled =>
+      _prefs?.getBool(_videoGray4EnabledKey) ?? defaultVideoGray4Enabled;
+
+  /// Set whether USB video frames should be sent as packed 4-bit grayscale.
+  Future<bool> setVideoGray4Enabled(bool value) async {
+    return await _prefs?.setBool(_videoGray4EnabledKey, value) ?? false;
+  }
+
+  /// Check if USB video capture should stop altogether while no window
+  /// showing it can be seen, rather than carry on at one frame a second
+  /// (Linux only).
+  bool get videoPauseWhenHidden =>
+      _prefs?.getBool(_videoPauseWhenHiddenKey) ?? defaultVideoPauseWhenHidden;
+
+  /// Set whether USB video capture should stop while its windows are hidden.
+  Future<bool> setVideoPauseWhenHidden(bool value) async {
+    return await _prefs?.setBool(_videoPauseWhenHiddenKey, value) ?? false;
+  }
+
+  /// Check if Disting NT MIDI should go through the native ALSA sequencer
+  /// transport rather than flutter_midi_command (Linux only).
+  bool get nativeMidiTransportEnabled =>
+      _prefs?.getBool(_nativeMidiTransportEnabledKey) ??
+      defaultNativeMidiTransportEnabled;
+
+  /// Set whether to use the native ALSA sequencer MIDI transport.
+  Future<bool> setNativeMidiTransportEnabled(bool value) async {
+    return await _prefs?.setBool(_nativeMidiTransportEnabledKey, value) ??
+        false;
+  }
+
+  /// Check if incoming SysEx from the MIDI plugin should be reassembled by
+  /// the native parser in libnt_sysex rather than in Dart (Linux only).
+  bool get nativeSysExParserEnabled =>
+      _prefs?.getBool(_nativeSysExParserEnabledKey) ??
+      defaultNativeSysExParserEnabled;
+
+  /// Set whether to reassemble incoming SysEx with the native parser.
+  Future<bool> setNativeSysExParserEnabled(bool value) async {
+    return await _prefs?.setBool(_nativeSysExParserEnabledKey, value) ??
+        false;
+  }
+
+  /// Check if the scheduler may keep several requests in flight at once.
+  bool get pipelinedRequestsEnabled =>
+      _prefs?.getBool(_pipelinedRequestsEnabledKey) ??
+      defaultPipelinedRequestsEnabled;
+
+  /// Set whether the scheduler may keep several requests in flight at once.
+  Future<bool> setPipelinedRequestsEnabled(bool value) async {
+    return await _prefs?.setBool(_pipelinedRequestsEnabledKey, value) ??
+        false;
+  }
+
   /// Check if video toolbar controls should remain visible.
   bool get videoToolbarAlwaysVisible =>
       _prefs?.getBool(_videoToolbarAlwaysVisibleKey) ??
@@ -806,6 +912,13 @@ class _SettingsDialogState extends State<SettingsDialog> {
   late bool _showBackwardConnections;
   late bool _videoPopupNativeWindowEnabled;
   late bool _videoToolbarAlwaysVisible;
+  late bool _videoTextureDeliveryEnabled;
+  late bool _videoDeltaFramesEnabled;
+  late bool _videoGray4Enabled;
+  late bool _videoPauseWhenHidden;
+  late bool _nativeMidiTransportEnabled;
+  late bool _nativeSysExParserEnabled;
+  late bool _pipelinedRequestsEnabled;
   late double _uiScale;
   late Color _themeSeedColor;
 
@@ -833,6 +946,13 @@ class _SettingsDialogState extends State<SettingsDialog> {
       _showBackwardConnections = settings.showBackwardConnections;
       _videoPopupNativeWindowEnabled = settings.videoPopupNativeWindowEnabled;
       _videoToolbarAlwaysVisible = settings.videoToolbarAlwaysVisible;
+      _videoTextureDeliveryEnabled = settings.videoTextureDeliveryEnabled;
+      _videoDeltaFramesEnabled = settings.videoDeltaFramesEnabled;
+      _videoGray4Enabled = settings.videoGray4Enabled;
+      _videoPauseWhenHidden = settings.videoPauseWhenHidden;
+      _nativeMidiTransportEnabled = settings.nativeMidiTransportEnabled;
+      _nativeSysExParserEnabled = settings.nativeSysExParserEnabled;
+      _pipelinedRequestsEnabled = settings.pipelinedRequestsEnabled;
       _uiScale = settings.uiScale;
       _themeSeedColor = settings.themeSeedColor;
     });
@@ -864,6 +984,17 @@ class _SettingsDialogState extends State<SettingsDialog> {
         _videoPopupNativeWindowEnabled,
       );
       await settings.setVideoToolbarAlwaysVisible(_videoToolbarAlwaysVisible);
+      await settings.setVideoTextureDeliveryEnabled(
+        _videoTextureDeliveryEnabled,
+      );
+      await settings.setVideoDeltaFramesEnabled(_videoDeltaFramesEnabled);
+      await settings.setVideoGray4Enabled(_videoGray4Enabled);
+      await settings.setVideoPauseWhenHidden(_videoPauseWhenHidden);
+      await settings.setNativeMidiTransportEnabled(
+        _nativeMidiTransportEnabled,
+      );
+      await settings.setNativeSysExParserEnabled(_nativeSysExParserEnabled);
+      await settings.setPipelinedRequestsEnabled(_pipelinedRequestsEnabled);
       await settings.setUiScale(_uiScale);
       await settings.setThemeSeedColor(_themeSeedColor);
 
@@ -969,6 +1100,61 @@ class _SettingsDialogState extends State<SettingsDialog> {
                       ),
                     ),
 
+                    if (Platform.isLinux) ...[
+                      const SizedBox(height: 8),
+                      SwitchListTile(
+                        title: Text(
+                          'Native MIDI Transport',
+                          style: Theme.of(context).textTheme.titleMedium,
+                        ),
+                        subtitle: const Text(
+                          'Talk to the Disting NT through the ALSA sequencer on a dedicated thread instead of the MIDI plugin; takes effect on the next connection',
+                        ),
+                        value: _nativeMidiTransportEnabled,
+                        onChanged: (value) {
+                          setState(() {
+                            _nativeMidiTransportEnabled = value;
+                          });
+                        },
+                        contentPadding: EdgeInsets.zero,
+                      ),
+                      const SizedBox(height: 8),
+                      SwitchListTile(
+                        title: Text(
+                          'Native SysEx Parser',
+                          style: Theme.of(context).textTheme.titleMedium,
+                        ),
+                        subtitle: const Text(
+                          'Reassemble incoming SysEx from the MIDI plugin in native code instead of Dart; takes effect on the next connection',
+                        ),
+                        value: _nativeSysExParserEnabled,
+                        onChanged: (value) {
+                          setState(() {
+                            _nativeSysExParserEnabled = value;
+                          });
+                        },
+                        contentPadding: EdgeInsets.zero,
+                      ),
+                    ],
+
+                    const SizedBox(height: 8),
+                    SwitchListTile(
+                      title: Text(
+                        'Pipelined Requests',
+                        style: Theme.of(context).textTheme.titleMedium,
+                      ),
+                      subtitle: const Text(
+                        'Keep several requests in flight while syncing instead of waiting for each response; takes effect on the next connection',
+                      ),
+                      value: _pipelinedRequestsEnabled,
+                      onChanged: (value) {
+                        setState(() {
+                          _pipelinedRequestsEnabled = value;
+                        });
+                      },
+                      contentPadding: EdgeInsets.zero,
+                    ),
+
                     const SizedBox(height: 24),
 
                     // Algorithm cache duration setting
@@ -1243,6 +1429,78 @@ class _SettingsDialogState extends State<SettingsDialog> {
                       contentPadding: EdgeInsets.zero,
                     ),
 
+                    if (Platform.isLinux)
+                      SwitchListTile(
+                        title: Text(
+                          'Render Video as GPU Texture',
+                          style: Theme.of(context).textTheme.titleMedium,
+                        ),
+                        subtitle: const Text(
+                          'Draw the Disting NT display directly from the capture buffer; lowers CPU use but disables copying frames to the clipboard',
+                        ),
+                        value: _videoTextureDeliveryEnabled,
+                        onChanged: (value) {
+                          setState(() {
+                            _videoTextureDeliveryEnabled = value;
+                          });
+                        },
+                        contentPadding: EdgeInsets.zero,
+                      ),
+
+                    if (Platform.isLinux)
+                      SwitchListTile(
+                        title: Text(
+                          'Send Only Changed Video Rows',
+                          style: Theme.of(context).textTheme.titleMedium,
+                        ),
+                        subtitle: const Text(
+                          'Send the rows of the display that changed instead of whole frames; cuts the video sent from the plugin when only part of the screen moves',
+                        ),
+                        value: _videoDeltaFramesEnabled,
+                        onChanged: (value) {
+                          setState(() {
+                            _videoDeltaFramesEnabled = value;
+                          });
+                        },
+                        contentPadding: EdgeInsets.zero,
+                      ),
+
+                    if (Platform.isLinux)
+                      SwitchListTile(
+                        title: Text(
+                          'Send Video as 16-Level Grayscale',
+                          style: Theme.of(context).textTheme.titleMedium,
+                        ),
+                        subtitle: const Text(
+                          'Match the Disting NT display\'s 16 brightness levels; cuts video bandwidth and memory about six-fold',
+                        ),
+                        value: _videoGray4Enabled,
+                        onChanged: (value) {
+                          setState(() {
+                            _videoGray4Enabled = value;
+                          });
+                        },
+                        contentPadding: EdgeInsets.zero,
+                      ),
+
+                    if (Platform.isLinux)
+                      SwitchListTile(
+                        title: Text(
+                          'Pause Video While Hidden',
+                          style: Theme.of(context).textTheme.titleMedium,
+                        ),
+                        subtitle: const Text(
+                          'Stop capturing while the app is minimized or covered, resuming as soon as it is shown; when off, video drops to one frame a second instead',
+                        ),
+                        value: _videoPauseWhenHidden,
+                        onChanged: (value) {
+                          setState(() {
+                            _videoPauseWhenHidden = value;
+                          });
+                        },
+                        contentPadding: EdgeInsets.zero,
+                      ),
+
                     const SizedBox(height: 24),
 
                     // Gallery URL setting
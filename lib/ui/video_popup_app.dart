@@ -15,6 +15,7 @@ import 'package:nt_helper/services/settings_service.dart';
 import 'package:nt_helper/services/video_popup_window_service.dart';
 import 'package:nt_helper/ui/theme/app_theme.dart';
 import 'package:nt_helper/ui/widgets/contextual_help_tooltip_scope.dart';
+import 'package:nt_helper/ui/widgets/usb_video_texture_view.dart';
 import 'package:pasteboard/pasteboard.dart';
 import 'package:window_manager/window_manager.dart';
 
@@ -461,6 +462,16 @@ class VideoPopupContent extends StatelessWidget {
 
   @override
   Widget build(BuildContext context) {
+    return ValueListenableBuilder<int?>(
+      valueListenable: videoFrameCubit.textureId,
+      builder: (context, textureId, child) => textureId != null
+          ? UsbVideoTextureView(textureId: textureId)
+          : child!,
+      child: _buildFrames(context),
+    );
+  }
+
+  Widget _buildFrames(BuildContext context) {
     return BlocBuilder<VideoFrameCubit, VideoFrameState>(
       bloc: videoFrameCubit,
       builder: (context, frameState) {
@@ -9,6 +9,7 @@ import 'package:nt_helper/cubit/video_frame_cubit.dart';
 import 'package:nt_helper/cubit/video_frame_state.dart';
 import 'package:nt_helper/domain/video/video_stream_state.dart';
 import 'package:nt_helper/ui/widgets/draggable_resizable_overlay.dart';
+import 'package:nt_helper/ui/widgets/usb_video_texture_view.dart';
 import 'package:pasteboard/pasteboard.dart';
 
 class FloatingVideoOverlay extends StatefulWidget {
@@ -184,6 +185,17 @@ class FloatingVideoContent extends StatelessWidget {
   });
 
   Widget _buildVideoContent(BuildContext context) {
+    // Texture delivery renders natively; encoded frames never arrive.
+    return ValueListenableBuilder<int?>(
+      valueListenable: videoFrameCubit.textureId,
+      builder: (context, textureId, child) => textureId != null
+          ? UsbVideoTextureView(textureId: textureId, fit: BoxFit.cover)
+          : child!,
+      child: _buildFrameContent(context),
+    );
+  }
+
+  Widget _buildFrameContent(BuildContext context) {
     // Use VideoFrameCubit for all other platforms
     return BlocBuilder<VideoFrameCubit, VideoFrameState>(
       bloc: videoFrameCubit,
@@ -0,0 +1,39 @@
+import 'package:flutter/material.dart';
+
+/// Shows the Disting NT display from a native texture the video plugin renders
+/// into, preserving the 256x64 aspect ratio with the given [fit].
+class UsbVideoTextureView extends StatelessWidget {
+  const UsbVideoTextureView({
+    super.key,
+    required this.textureId,
+    this.fit = BoxFit.contain,
+  });
+
+  final int textureId;
+  final BoxFit fit;
+
+  static const double _frameWidth = 256;
+  static const double _frameHeight = 64;
+
+  @override
+  Widget build(BuildContext context) {
+    return Semantics(
+      label: 'Disting NT video feed.',
+      child: SizedBox.expand(
+        child: RepaintBoundary(
+          child: ColoredBox(
+            color: Colors.black,
+            child: FittedBox(
+              fit: fit,
+              child: SizedBox(
+                width: _frameWidth,
+                height: _frameHeight,
+                child: Texture(textureId: textureId),
+              ),
+            ),
+          ),
+        ),
+      ),
+    );
+  }
+}
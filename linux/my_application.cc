@@ -11,6 +11,7 @@
 // Declare the USB video capture plugin registration function
 extern "C" {
   void usb_video_capture_plugin_register_with_registrar(FlPluginRegistrar* registrar);
+  void usb_video_capture_plugin_set_window_visible(GtkWindow* window, gboolean visible);
 }
 
 struct _MyApplication {
@@ -64,6 +65,55 @@ static void on_window_destroy(GtkWidget* widget, gpointer user_data) {
   self->window = nullptr;
 }
 
+// Tells the USB video plugin whether a window can be seen, so capture can
+// pause while it is minimized, unmapped or fully covered. Window managers
+// report windows on another workspace as hidden or unmapped.
+static void report_window_visibility(GtkWidget* window, GdkWindowState state) {
+  gboolean visible =
+      gtk_widget_get_mapped(window) &&
+      (state & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)) == 0 &&
+      g_object_get_data(G_OBJECT(window), "window-obscured") == nullptr;
+  usb_video_capture_plugin_set_window_visible(GTK_WINDOW(window), visible);
+}
+
+static void report_current_window_visibility(GtkWidget* window) {
+  GdkWindow* gdk_window = gtk_widget_get_window(window);
+  report_window_visibility(
+      window, gdk_window != nullptr ? gdk_window_get_state(gdk_window)
+                                    : GDK_WINDOW_STATE_WITHDRAWN);
+}
+
+static gboolean on_window_state_event(GtkWidget* widget, GdkEventWindowState* event,
+                                      gpointer user_data) {
+  report_window_visibility(widget, event->new_window_state);
+  return FALSE;
+}
+
+// Only delivered where nothing composites the screen; a compositor keeps
+// every window unobscured.
+static gboolean on_window_visibility_event(GtkWidget* widget, GdkEventVisibility* event,
+                                           gpointer user_data) {
+  g_object_set_data(G_OBJECT(widget), "window-obscured",
+                    event->state == GDK_VISIBILITY_FULLY_OBSCURED ? GINT_TO_POINTER(1)
+                                                                  : nullptr);
+  report_current_window_visibility(widget);
+  return FALSE;
+}
+
+static gboolean on_window_map_event(GtkWidget* widget, GdkEvent* event, gpointer user_data) {
+  report_current_window_visibility(widget);
+  return FALSE;
+}
+
+static void track_window_visibility(GtkWidget* window) {
+  gtk_widget_add_events(window, GDK_VISIBILITY_NOTIFY_MASK);
+  g_signal_connect(window, "window-state-event", G_CALLBACK(on_window_state_event), nullptr);
+  g_signal_connect(window, "visibility-notify-event",
+                   G_CALLBACK(on_window_visibility_event), nullptr);
+  g_signal_connect(window, "map-event", G_CALLBACK(on_window_map_event), nullptr);
+  g_signal_connect(window, "unmap-event", G_CALLBACK(on_window_map_event), nullptr);
+}
+
 // Suppress known harmless shutdown warnings from Flutter embedder
 static GLogWriterOutput shutdown_log_writer(GLogLevelFlags log_level,
                                             const GLogField* fields,
@@ -161,6 +211,8 @@ static void my_application_activate(GApplication* application) {
   g_signal_connect(window, "delete-event", G_CALLBACK(on_window_delete_event), self);
   // Connect to destroy signal to clean up before Flutter engine shuts down
   g_signal_connect(window, "destroy", G_CALLBACK(on_window_destroy), self);
+  // Let USB video capture pause while the window cannot be seen
+  track_window_visibility(GTK_WIDGET(window));
 
   // Register the USB video capture plugin
   g_autoptr(FlPluginRegistrar) usb_video_registrar =
@@ -184,6 +236,7 @@ static void my_application_activate(GApplication* application) {
               return TRUE;
             }),
             nullptr);
+        track_window_visibility(child_window);
       }
     }
   });
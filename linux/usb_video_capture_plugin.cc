@@ -1,27 +1,52 @@
 #include <flutter_linux/flutter_linux.h>
+#include <glib-unix.h>
 #include <gtk/gtk.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
-#include <sys/mman.h>
+#include <sys/stat.h>
 #include <linux/videodev2.h>
 #include <dirent.h>
 #include <string.h>
 #include <errno.h>
-#include <thread>
+#include <limits.h>
+#include <stdlib.h>
+#include <algorithm>
 #include <atomic>
+#include <map>
+#include <set>
 #include <vector>
 #include <string>
-#include <mutex>
-#include <queue>
+
+#include "frame_suppressor.h"
+#include "usb_video_hotplug.h"
+#include "usb_video_session.h"
+#include "v4l2_capture_backend.h"
 
 #define USB_VIDEO_CAPTURE_PLUGIN(obj) \
   (G_TYPE_CHECK_INSTANCE_CAST((obj), usb_video_capture_plugin_get_type(), \
                                UsbVideoCapturePlugin))
 
-struct Buffer {
-  void* start;
-  size_t length;
+// What probing a /dev/videoN node found. Plain data, so probes can run on a
+// worker thread and be cached between listUsbCameras calls.
+struct CameraProbe {
+  std::string node_name;
+  // Identity of the node when it was probed; see camera_probe_key.
+  std::string key;
+  // A Disting NT capture node that can deliver YUYV.
+  bool usable;
+  std::string product_name;
+  // Frame rates offered at the node's current size, fastest first.
+  std::vector<double> frame_rates;
+};
+
+// A hotplug probe on a worker thread. Only the newest probe of a node may
+// announce it, and only while it is still listed in hotplug_probes.
+struct HotplugProbe {
+  guint serial;
+  // Another event for the node arrived while the probe ran, so its result
+  // may be stale and the node is checked again when it finishes.
+  bool recheck;
 };
 
 typedef struct _UsbVideoCapturePlugin UsbVideoCapturePlugin;
@@ -32,17 +57,36 @@ struct _UsbVideoCapturePlugin {
 
   FlEventChannel* event_channel;
   FlEventChannel* debug_channel;
+  FlEventChannel* hotplug_channel;
   std::atomic<bool> stream_active;
-
-  int fd;
-  struct Buffer* buffers;
-  unsigned int n_buffers;
-  std::thread* capture_thread;
-  std::atomic<bool> capturing;
-
-  std::mutex* frame_queue_mutex;
-  std::queue<std::vector<uint8_t>>* pending_frames;
-  guint idle_source_id;
+  // Whether Dart is listening on debug_channel; telemetry reports are only
+  // built and sent while it is.
+  std::atomic<bool> debug_active;
+
+  // This window's share of the process-wide capture session, or null while
+  // it is not streaming.
+  UsbVideoSubscriber* subscriber;
+  // Registrar of this window's engine, for texture delivery.
+  FlTextureRegistrar* texture_registrar;
+  // This engine's view, if it has one, and the window holding it while
+  // subscribed; the session slows capture down while the window is not
+  // focused, and pauses it while the window cannot be seen. Both are weak
+  // pointers.
+  FlView* view;
+  GtkWindow* window;
+
+  // Watches /dev while Dart listens on hotplug_channel.
+  UsbVideoHotplug* hotplug;
+  // Usable Disting NT nodes already announced as attached, by /dev path.
+  std::set<std::string>* attached_devices;
+  // Probe results by node name, so listUsbCameras only opens nodes that
+  // are new or changed. Main thread only.
+  std::map<std::string, CameraProbe>* camera_cache;
+  // Hotplug probes running on a worker, by node name; see
+  // hotplug_check_node. Main thread only.
+  std::map<std::string, HotplugProbe>* hotplug_probes;
+  // Source of HotplugProbe::serial.
+  guint hotplug_probe_serial;
 };
 
 struct _UsbVideoCapturePluginClass {
@@ -51,43 +95,107 @@ struct _UsbVideoCapturePluginClass {
 
 G_DEFINE_TYPE(UsbVideoCapturePlugin, usb_video_capture_plugin, G_TYPE_OBJECT)
 
-// Forward declaration
-static void stop_capture(UsbVideoCapturePlugin* self);
+// Window data the runner's visibility reports leave behind, so a window
+// that was hidden before anything subscribed is still known to be hidden.
+static const char kWindowHiddenKey[] = "usb-video-window-hidden";
+
+// Every plugin instance, one per engine. Main thread only.
+static std::vector<UsbVideoCapturePlugin*>& live_plugins() {
+  static std::vector<UsbVideoCapturePlugin*>* plugins =
+      new std::vector<UsbVideoCapturePlugin*>();
+  return *plugins;
+}
+
+static void subscriber_frame(const uint8_t* data, size_t size, gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  // The codec copies the bytes into the platform message.
+  g_autoptr(FlValue) frame_data = fl_value_new_uint8_list(data, size);
+  GError* error = nullptr;
+  if (!fl_event_channel_send(self->event_channel, frame_data, nullptr, &error)) {
+    if (error) {
+      g_warning("[USB Video] Failed to send frame: %s", error->message);
+      g_error_free(error);
+    }
+  }
+}
+
+static void subscriber_heartbeat(uint64_t frames, gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  g_autoptr(FlValue) heartbeat = fl_value_new_int(static_cast<int64_t>(frames));
+  fl_event_channel_send(self->event_channel, heartbeat, nullptr, nullptr);
+}
+
+static void subscriber_telemetry(FlValue* report, gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  fl_event_channel_send(self->debug_channel, report, nullptr, nullptr);
+}
 
-// Callback to send frames from the main GTK thread
-static gboolean send_pending_frames(gpointer user_data) {
+// Lets the stall watchdog in UsbVideoManager tell a paused stream from a
+// dead one.
+static void subscriber_paused(gboolean paused, gpointer user_data) {
   UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  g_autoptr(FlValue) event = fl_value_new_map();
+  fl_value_set_string_take(event, "paused", fl_value_new_bool(paused));
+  fl_event_channel_send(self->event_channel, event, nullptr, nullptr);
+}
+
+static const UsbVideoSubscriberCallbacks kSubscriberCallbacks = {
+    subscriber_frame,
+    subscriber_heartbeat,
+    subscriber_telemetry,
+    subscriber_paused,
+};
 
-  if (!self->event_channel || !self->stream_active || self->idle_source_id == 0) {
-    return G_SOURCE_CONTINUE;
+static void window_is_active_changed(GObject* window, GParamSpec* pspec,
+                                     gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  if (self->subscriber != nullptr) {
+    usb_video_subscriber_set_focused(self->subscriber,
+                                     gtk_window_is_active(GTK_WINDOW(window)));
   }
+}
 
-  std::vector<uint8_t> frame;
-  {
-    std::lock_guard<std::mutex> lock(*self->frame_queue_mutex);
-    if (self->pending_frames->empty()) {
-      return G_SOURCE_CONTINUE;
-    }
-    frame = std::move(self->pending_frames->front());
-    self->pending_frames->pop();
-    // Clear any backlog to prevent memory buildup - keep only latest frame
-    while (!self->pending_frames->empty()) {
-      self->pending_frames->pop();
-    }
+// Follows the focus of the window showing this engine's view, so the
+// subscriber can tell the session when a few frames a second will do, and
+// picks up the visibility the runner last reported for it (see
+// usb_video_capture_plugin_set_window_visible).
+static void watch_window(UsbVideoCapturePlugin* self) {
+  if (self->view == nullptr || self->window != nullptr) {
+    return;
   }
+  GtkWidget* toplevel = gtk_widget_get_toplevel(GTK_WIDGET(self->view));
+  if (!GTK_IS_WINDOW(toplevel)) {
+    return;
+  }
+  self->window = GTK_WINDOW(toplevel);
+  g_object_add_weak_pointer(G_OBJECT(self->window),
+                            reinterpret_cast<gpointer*>(&self->window));
+  g_signal_connect_object(self->window, "notify::is-active",
+                          G_CALLBACK(window_is_active_changed), self,
+                          static_cast<GConnectFlags>(0));
+  usb_video_subscriber_set_focused(self->subscriber,
+                                   gtk_window_is_active(self->window));
+  usb_video_subscriber_set_visible(
+      self->subscriber,
+      g_object_get_data(G_OBJECT(self->window), kWindowHiddenKey) == nullptr);
+}
 
-  if (!frame.empty()) {
-    g_autoptr(FlValue) frame_data = fl_value_new_uint8_list(frame.data(), frame.size());
-    GError* error = nullptr;
-    if (!fl_event_channel_send(self->event_channel, frame_data, nullptr, &error)) {
-      if (error) {
-        g_warning("[USB Video] Failed to send frame: %s", error->message);
-        g_error_free(error);
-      }
-    }
+static void unwatch_window(UsbVideoCapturePlugin* self) {
+  if (self->window == nullptr) {
+    return;
   }
+  g_signal_handlers_disconnect_by_data(self->window, self);
+  g_object_remove_weak_pointer(G_OBJECT(self->window),
+                               reinterpret_cast<gpointer*>(&self->window));
+  self->window = nullptr;
+}
 
-  return G_SOURCE_CONTINUE;  // Keep the idle source active
+// Leaves the shared capture session; the device closes once no window is
+// subscribed.
+static void stop_video_stream(UsbVideoCapturePlugin* self) {
+  unwatch_window(self);
+  usb_video_session_unsubscribe(self->subscriber);
+  self->subscriber = nullptr;
 }
 
 static FlMethodErrorResponse* event_channel_listen(FlEventChannel* channel,
@@ -96,6 +204,31 @@ static FlMethodErrorResponse* event_channel_listen(FlEventChannel* channel,
   UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
   g_print("[USB Video] Event channel listen called\n");
   self->stream_active = true;  // Mark stream as active
+  if (self->subscriber != nullptr) {
+    usb_video_subscriber_set_active(self->subscriber, TRUE);
+  }
+  return nullptr;
+}
+
+static FlMethodErrorResponse* debug_channel_listen(FlEventChannel* channel,
+                                                   FlValue* args,
+                                                   gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  self->debug_active = true;
+  if (self->subscriber != nullptr) {
+    usb_video_subscriber_set_telemetry(self->subscriber, TRUE);
+  }
+  return nullptr;
+}
+
+static FlMethodErrorResponse* debug_channel_cancel(FlEventChannel* channel,
+                                                   FlValue* args,
+                                                   gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  self->debug_active = false;
+  if (self->subscriber != nullptr) {
+    usb_video_subscriber_set_telemetry(self->subscriber, FALSE);
+  }
   return nullptr;
 }
 
@@ -108,324 +241,405 @@ static FlMethodErrorResponse* event_channel_cancel(FlEventChannel* channel,
   // CRITICAL: Mark stream inactive FIRST to prevent any pending callbacks
   self->stream_active = false;
   
-  // CRITICAL: Remove the idle source IMMEDIATELY to prevent callbacks
-  // from trying to send to a dead Dart isolate during shutdown.
+  // CRITICAL: Unsubscribe IMMEDIATELY so the session never calls back into
+  // a dead Dart isolate during shutdown; other windows keep streaming.
   // This prevents the GetFfiCallbackMetadata crash.
-  if (self->idle_source_id != 0) {
-    g_source_remove(self->idle_source_id);
-    self->idle_source_id = 0;
-    g_print("[USB Video] Idle source removed during channel cancel\n");
-  }
-  
-  stop_capture(self);
+  stop_video_stream(self);
   return nullptr;
 }
 
-static void stop_capture(UsbVideoCapturePlugin* self) {
-  if (self->capturing) {
-    self->capturing = false;
-
-    if (self->fd >= 0) {
-      enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-      ioctl(self->fd, VIDIOC_STREAMOFF, &type);
+static std::string read_sysfs_line(const std::string& path) {
+  char line[64] = "";
+  FILE* f = fopen(path.c_str(), "r");
+  if (f != nullptr) {
+    if (fgets(line, sizeof(line), f) == nullptr) {
+      line[0] = '\0';
     }
+    fclose(f);
+  }
+  line[strcspn(line, "\n")] = '\0';
+  return line;
+}
 
-    if (self->capture_thread) {
-      self->capture_thread->join();
-      delete self->capture_thread;
-      self->capture_thread = nullptr;
-    }
+// A cached probe stays valid while the node's sysfs device path, the USB
+// bus/device numbers behind it and the sysfs node's mtime are unchanged.
+// A replug gets a new devnum even on the same port, and none of this needs
+// the device node itself to be opened. Empty if the node has gone.
+static std::string camera_probe_key(const char* node_name) {
+  std::string sysfs_node = std::string("/sys/class/video4linux/") + node_name;
+  struct stat node_stat;
+  char device_path[PATH_MAX];
+  if (stat(sysfs_node.c_str(), &node_stat) != 0 ||
+      realpath((sysfs_node + "/device").c_str(), device_path) == nullptr) {
+    return std::string();
   }
+  // The "device" link points at the UVC interface; bus and device numbers
+  // live on the USB device one level up.
+  std::string usb_device = std::string(device_path) + "/..";
+  char mtime[48];
+  snprintf(mtime, sizeof(mtime), "%lld.%09ld",
+           static_cast<long long>(node_stat.st_mtim.tv_sec), node_stat.st_mtim.tv_nsec);
+  return std::string(device_path) + "|" + read_sysfs_line(usb_device + "/busnum") + ":" +
+         read_sysfs_line(usb_device + "/devnum") + "|" + mtime;
+}
 
-  // Stop the idle timer when not capturing
-  if (self->idle_source_id != 0) {
-    g_source_remove(self->idle_source_id);
-    self->idle_source_id = 0;
+// Fills in |probe| for /dev/|probe->node_name|. Opens the device, so it can
+// block for a while on a busy node; safe to call off the main thread.
+static void probe_camera_node(CameraProbe* probe) {
+  const char* node_name = probe->node_name.c_str();
+  char path[256];
+  char name[256];
+  snprintf(path, sizeof(path), "/sys/class/video4linux/%s/name", node_name);
+  probe->usable = false;
+  probe->frame_rates.clear();
+
+  FILE* f = fopen(path, "r");
+  if (f == nullptr) {
+    return;
   }
-  
-  if (self->fd >= 0) {
-    if (self->buffers) {
-      for (unsigned int i = 0; i < self->n_buffers; ++i) {
-        munmap(self->buffers[i].start, self->buffers[i].length);
+  if (fgets(name, sizeof(name), f)) {
+    // Remove newline
+    size_t len = strlen(name);
+    if (len > 0 && name[len-1] == '\n') {
+      name[len-1] = '\0';
+    }
+
+    // Check if it's the Disting NT
+    if (strstr(name, "disting") || strstr(name, "NT")) {
+      g_print("[USB Video] Found Disting NT device: %s at /dev/%s\n", name, node_name);
+
+      // Each UVC device creates two video nodes — only the one that
+      // supports V4L2_CAP_VIDEO_CAPTURE and YUYV format is usable.
+      char device_path[32];
+      snprintf(device_path, sizeof(device_path), "/dev/%s", node_name);
+      int probe_fd = open(device_path, O_RDWR);
+      if (probe_fd >= 0) {
+        struct v4l2_capability cap;
+        memset(&cap, 0, sizeof(cap));
+        bool usable = false;
+        if (ioctl(probe_fd, VIDIOC_QUERYCAP, &cap) == 0 &&
+            (cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) != 0) {
+          // Also verify YUYV format is supported
+          struct v4l2_fmtdesc fmtdesc;
+          memset(&fmtdesc, 0, sizeof(fmtdesc));
+          fmtdesc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+          while (ioctl(probe_fd, VIDIOC_ENUM_FMT, &fmtdesc) == 0) {
+            if (fmtdesc.pixelformat == V4L2_PIX_FMT_YUYV) {
+              usable = true;
+              break;
+            }
+            fmtdesc.index++;
+          }
+        }
+        // Rates at whatever size the node is set to, which is the one
+        // startVideoStream asks for on the Disting NT.
+        struct v4l2_format fmt;
+        memset(&fmt, 0, sizeof(fmt));
+        fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (usable && ioctl(probe_fd, VIDIOC_G_FMT, &fmt) == 0) {
+          for (const usb_video::FrameInterval& interval :
+               usb_video::V4l2CaptureBackend::QueryFrameIntervals(
+                   probe_fd, fmt.fmt.pix.width, fmt.fmt.pix.height)) {
+            probe->frame_rates.push_back(interval.fps());
+          }
+        }
+        close(probe_fd);
+
+        if (usable) {
+          g_print("[USB Video] Device %s supports YUYV capture\n", device_path);
+          probe->usable = true;
+          probe->product_name = name;
+        } else {
+          g_print("[USB Video] Device %s does not support YUYV capture, skipping\n", device_path);
+        }
+      } else {
+        // Not cached: udev may not have granted access yet.
+        probe->key.clear();
       }
-      free(self->buffers);
-      self->buffers = nullptr;
     }
-    
-    close(self->fd);
-    self->fd = -1;
   }
+  fclose(f);
 }
 
-// Simple BMP encoder for 256x64 RGB images
-static std::vector<uint8_t> encode_bmp(const uint8_t* rgb_data, int width, int height) {
-  // BMP header size
-  const int header_size = 54;
-  const int row_size = ((width * 3 + 3) / 4) * 4;  // Rows are padded to 4 bytes
-  const int data_size = row_size * height;
-  const int file_size = header_size + data_size;
-  
-  std::vector<uint8_t> bmp(file_size);
-  
-  // BMP Header
-  bmp[0] = 'B'; bmp[1] = 'M';
-  // File size
-  bmp[2] = file_size & 0xFF;
-  bmp[3] = (file_size >> 8) & 0xFF;
-  bmp[4] = (file_size >> 16) & 0xFF;
-  bmp[5] = (file_size >> 24) & 0xFF;
-  // Reserved
-  bmp[6] = 0; bmp[7] = 0; bmp[8] = 0; bmp[9] = 0;
-  // Offset to pixel data
-  bmp[10] = header_size; bmp[11] = 0; bmp[12] = 0; bmp[13] = 0;
-  
-  // DIB Header
-  bmp[14] = 40; bmp[15] = 0; bmp[16] = 0; bmp[17] = 0;  // Header size
-  // Width
-  bmp[18] = width & 0xFF;
-  bmp[19] = (width >> 8) & 0xFF;
-  bmp[20] = (width >> 16) & 0xFF;
-  bmp[21] = (width >> 24) & 0xFF;
-  // Height (negative for top-down)
-  int neg_height = -height;
-  bmp[22] = neg_height & 0xFF;
-  bmp[23] = (neg_height >> 8) & 0xFF;
-  bmp[24] = (neg_height >> 16) & 0xFF;
-  bmp[25] = (neg_height >> 24) & 0xFF;
-  // Planes
-  bmp[26] = 1; bmp[27] = 0;
-  // Bits per pixel
-  bmp[28] = 24; bmp[29] = 0;
-  // Compression (none)
-  for (int i = 30; i < 54; i++) bmp[i] = 0;
-  
-  // Copy pixel data (BMP uses BGR order)
-  int bmp_idx = header_size;
-  for (int y = 0; y < height; y++) {
-    for (int x = 0; x < width; x++) {
-      int rgb_idx = (y * width + x) * 3;
-      bmp[bmp_idx++] = rgb_data[rgb_idx + 2];  // B
-      bmp[bmp_idx++] = rgb_data[rgb_idx + 1];  // G
-      bmp[bmp_idx++] = rgb_data[rgb_idx];      // R
-    }
-    // Padding
-    while (bmp_idx % 4 != header_size % 4) {
-      bmp[bmp_idx++] = 0;
-    }
+static FlValue* camera_probe_value(const CameraProbe& probe) {
+  std::string device_path = "/dev/" + probe.node_name;
+  FlValue* camera = fl_value_new_map();
+  fl_value_set_string(camera, "deviceId", fl_value_new_string(device_path.c_str()));
+  fl_value_set_string(camera, "productName", fl_value_new_string(probe.product_name.c_str()));
+  fl_value_set_string(camera, "vendorId", fl_value_new_int(0x3773));
+  fl_value_set_string(camera, "productId", fl_value_new_int(0x0001));
+  fl_value_set_string(camera, "isDistingNT", fl_value_new_bool(TRUE));
+  FlValue* frame_rates = fl_value_new_list();
+  for (double fps : probe.frame_rates) {
+    fl_value_append_take(frame_rates, fl_value_new_float(fps));
   }
-  
-  return bmp;
+  fl_value_set_string_take(camera, "frameRates", frame_rates);
+  return camera;
 }
 
-static void capture_frames(UsbVideoCapturePlugin* self) {
-  struct v4l2_buffer buf;
-  int frame_count = 0;
-  
-  g_print("[USB Video] Capture thread running\n");
-  
-  while (self->capturing) {
-    memset(&buf, 0, sizeof(buf));
-    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_MMAP;
-    
-    // Dequeue buffer
-    if (ioctl(self->fd, VIDIOC_DQBUF, &buf) == -1) {
-      if (errno == EAGAIN) {
-        usleep(10000); // 10ms
-        continue;
-      }
-      g_warning("Failed to dequeue buffer: %s", strerror(errno));
-      break;
-    }
-    
-    // Convert YUYV to RGB
-    unsigned char* yuyv = (unsigned char*)self->buffers[buf.index].start;
-    size_t yuyv_size = buf.bytesused;
-    size_t rgb_size = (yuyv_size / 2) * 3; // YUYV is 2 bytes per pixel, RGB is 3
-    
-    std::vector<uint8_t> rgb_data(rgb_size);
-    
-    // Simple YUYV to RGB conversion
-    for (size_t i = 0, j = 0; i < yuyv_size; i += 4, j += 6) {
-      int y0 = yuyv[i];
-      int u = yuyv[i + 1];
-      int y1 = yuyv[i + 2];
-      int v = yuyv[i + 3];
-      
-      int c = y0 - 16;
-      int d = u - 128;
-      int e = v - 128;
-      
-      rgb_data[j] = std::min(255, std::max(0, (298 * c + 409 * e + 128) >> 8));
-      rgb_data[j + 1] = std::min(255, std::max(0, (298 * c - 100 * d - 208 * e + 128) >> 8));
-      rgb_data[j + 2] = std::min(255, std::max(0, (298 * c + 516 * d + 128) >> 8));
-      
-      c = y1 - 16;
-      rgb_data[j + 3] = std::min(255, std::max(0, (298 * c + 409 * e + 128) >> 8));
-      rgb_data[j + 4] = std::min(255, std::max(0, (298 * c - 100 * d - 208 * e + 128) >> 8));
-      rgb_data[j + 5] = std::min(255, std::max(0, (298 * c + 516 * d + 128) >> 8));
-    }
-    
-    // Encode as BMP and queue for sending on main thread
-    if (self->event_channel && self->stream_active) {
-      frame_count++;
+static void cache_camera_probe(UsbVideoCapturePlugin* self, const CameraProbe& probe) {
+  if (probe.key.empty()) {
+    self->camera_cache->erase(probe.node_name);
+  } else {
+    (*self->camera_cache)[probe.node_name] = probe;
+  }
+}
 
-      // Encode RGB to BMP
-      std::vector<uint8_t> bmp_data = encode_bmp(rgb_data.data(), 256, 64);
+// The cached probe for |node_name| if it still matches |key|, else nullptr.
+static const CameraProbe* cached_camera_probe(UsbVideoCapturePlugin* self,
+                                              const std::string& node_name,
+                                              const std::string& key) {
+  auto it = self->camera_cache->find(node_name);
+  if (key.empty() || it == self->camera_cache->end() || it->second.key != key) {
+    return nullptr;
+  }
+  return &it->second;
+}
 
-      if (frame_count % 30 == 1) {  // Log every 30th frame to avoid spam
-        g_print("[USB Video] Queueing frame %d, BMP size=%zu bytes\n", frame_count, bmp_data.size());
-      }
+static void send_hotplug_attached(UsbVideoCapturePlugin* self, FlValue* camera) {
+  g_autoptr(FlValue) event = fl_value_new_map();
+  fl_value_set_string_take(event, "event", fl_value_new_string("attached"));
+  fl_value_set_string_take(event, "device", camera);
+  fl_event_channel_send(self->hotplug_channel, event, nullptr, nullptr);
+}
 
-      // Queue frame for main thread to send (thread-safe)
-      {
-        std::lock_guard<std::mutex> lock(*self->frame_queue_mutex);
-        self->pending_frames->push(std::move(bmp_data));
-      }
-    } else {
-      if (frame_count % 30 == 0) {  // Log periodically
-        g_print("[USB Video] Warning: event_channel or stream not active, frames not being sent\n");
-      }
-    }
-    
-    // Queue buffer again
-    if (ioctl(self->fd, VIDIOC_QBUF, &buf) == -1) {
-      g_warning("Failed to queue buffer: %s", strerror(errno));
-      break;
-    }
+static void send_hotplug_detached(UsbVideoCapturePlugin* self, const std::string& device_path) {
+  g_autoptr(FlValue) event = fl_value_new_map();
+  fl_value_set_string_take(event, "event", fl_value_new_string("detached"));
+  fl_value_set_string_take(event, "deviceId", fl_value_new_string(device_path.c_str()));
+  fl_event_channel_send(self->hotplug_channel, event, nullptr, nullptr);
+}
+
+// Announces the node |probe| describes if it found the node usable and
+// it is not announced yet.
+static void hotplug_announce(UsbVideoCapturePlugin* self, const CameraProbe& probe) {
+  std::string device_path = "/dev/" + probe.node_name;
+  if (probe.usable && self->attached_devices->insert(device_path).second) {
+    send_hotplug_attached(self, camera_probe_value(probe));
   }
 }
 
-static bool start_video_stream(UsbVideoCapturePlugin* self, const char* device_path) {
-  g_print("[USB Video] Starting video stream for device: %s\n", device_path);
-  
-  // Open device
-  self->fd = open(device_path, O_RDWR);
-  if (self->fd == -1) {
-    g_warning("Cannot open device %s: %s", device_path, strerror(errno));
-    return false;
+// One hotplug probe, run with the listUsbCameras worker's probe_camera_node.
+struct HotplugProbeJob {
+  CameraProbe probe;
+  guint serial;
+};
+
+static void hotplug_probe_job_free(gpointer data) {
+  delete static_cast<HotplugProbeJob*>(data);
+}
+
+static void hotplug_probe_job_run(GTask* task, gpointer source_object, gpointer task_data,
+                                  GCancellable* cancellable) {
+  probe_camera_node(&static_cast<HotplugProbeJob*>(task_data)->probe);
+  g_task_return_pointer(task, nullptr, nullptr);
+}
+
+static void hotplug_check_node(UsbVideoCapturePlugin* self, const char* node_name);
+
+// Main thread: caches the probe and announces the node, unless the node
+// went away, the listener cancelled or a newer probe superseded this one.
+static void hotplug_probe_job_done(GObject* source_object, GAsyncResult* result,
+                                   gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(source_object);
+  HotplugProbeJob* job =
+      static_cast<HotplugProbeJob*>(g_task_get_task_data(G_TASK(result)));
+  if (self->hotplug_probes == nullptr) {
+    return;  // Disposed while the probe ran.
   }
-  g_print("[USB Video] Device opened successfully, fd=%d\n", self->fd);
-  
-  // Get current format
-  struct v4l2_format fmt;
-  memset(&fmt, 0, sizeof(fmt));
-  fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-  
-  if (ioctl(self->fd, VIDIOC_G_FMT, &fmt) == -1) {
-    g_warning("[USB Video] Failed to get format: %s", strerror(errno));
-    close(self->fd);
-    self->fd = -1;
-    return false;
+  cache_camera_probe(self, job->probe);
+  auto it = self->hotplug_probes->find(job->probe.node_name);
+  if (it == self->hotplug_probes->end() || it->second.serial != job->serial) {
+    return;
   }
-  
-  g_print("[USB Video] Current format: %dx%d, pixelformat=0x%08X\n", 
-          fmt.fmt.pix.width, fmt.fmt.pix.height, fmt.fmt.pix.pixelformat);
-  
-  // Check if format is already correct
-  if (fmt.fmt.pix.width == 256 && fmt.fmt.pix.height == 64 && 
-      fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_YUYV) {
-    g_print("[USB Video] Format already correct, skipping format set\n");
+  bool recheck = it->second.recheck;
+  self->hotplug_probes->erase(it);
+  if (recheck) {
+    hotplug_check_node(self, job->probe.node_name.c_str());
   } else {
-    // Try to set format
-    fmt.fmt.pix.width = 256;
-    fmt.fmt.pix.height = 64;
-    fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
-    fmt.fmt.pix.field = V4L2_FIELD_ANY;
-    
-    g_print("[USB Video] Setting format to 256x64 YUYV...\n");
-    if (ioctl(self->fd, VIDIOC_S_FMT, &fmt) == -1) {
-      g_warning("[USB Video] Failed to set format: %s (errno=%d)", strerror(errno), errno);
-      // Don't fail here, try to continue with current format
-      g_print("[USB Video] Continuing with current format\n");
+    hotplug_announce(self, job->probe);
+  }
+}
+
+// Announces /dev/|node_name| if it just became a usable Disting NT node.
+// Known nodes are skipped, and a valid cached probe answers at once, so
+// udev's permission changes and the UVC metadata node cost no probing.
+// Anything else is probed on a worker, never on the main thread.
+static void hotplug_check_node(UsbVideoCapturePlugin* self, const char* node_name) {
+  std::string device_path = std::string("/dev/") + node_name;
+  if (self->attached_devices->count(device_path) != 0) {
+    return;
+  }
+  auto pending = self->hotplug_probes->find(node_name);
+  if (pending != self->hotplug_probes->end()) {
+    pending->second.recheck = true;
+    return;
+  }
+  std::string key = camera_probe_key(node_name);
+  const CameraProbe* cached = cached_camera_probe(self, node_name, key);
+  if (cached != nullptr) {
+    hotplug_announce(self, *cached);
+    return;
+  }
+
+  HotplugProbeJob* job = new HotplugProbeJob();
+  job->probe.node_name = node_name;
+  job->probe.key = key;
+  job->probe.usable = false;
+  job->serial = ++self->hotplug_probe_serial;
+  (*self->hotplug_probes)[node_name] = HotplugProbe{job->serial, false};
+  GTask* task = g_task_new(self, nullptr, hotplug_probe_job_done, nullptr);
+  g_task_set_task_data(task, job, hotplug_probe_job_free);
+  g_task_run_in_thread(task, hotplug_probe_job_run);
+  g_object_unref(task);
+}
+
+// Reconciles the announced set with what is plugged in now: on listen, and
+// whenever inotify reports it dropped events.
+static void hotplug_rescan(UsbVideoCapturePlugin* self) {
+  for (auto it = self->attached_devices->begin(); it != self->attached_devices->end();) {
+    if (access(it->c_str(), F_OK) != 0) {
+      send_hotplug_detached(self, *it);
+      it = self->attached_devices->erase(it);
     } else {
-      g_print("[USB Video] Format set successfully: actual %dx%d\n", 
-              fmt.fmt.pix.width, fmt.fmt.pix.height);
+      ++it;
     }
   }
-  
-  // Request buffers
-  struct v4l2_requestbuffers req;
-  memset(&req, 0, sizeof(req));
-  req.count = 4;
-  req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-  req.memory = V4L2_MEMORY_MMAP;
-  
-  g_print("[USB Video] Requesting 4 buffers...\n");
-  if (ioctl(self->fd, VIDIOC_REQBUFS, &req) == -1) {
-    g_warning("[USB Video] Failed to request buffers: %s", strerror(errno));
-    close(self->fd);
-    self->fd = -1;
-    return false;
-  }
-  g_print("[USB Video] Got %d buffers\n", req.count);
-  
-  // Allocate buffer info
-  g_print("[USB Video] Allocating and mapping %d buffers...\n", req.count);
-  self->buffers = (struct Buffer*)calloc(req.count, sizeof(struct Buffer));
-  self->n_buffers = req.count;
-  
-  // Map buffers
-  for (unsigned int i = 0; i < req.count; ++i) {
-    struct v4l2_buffer buf;
-    memset(&buf, 0, sizeof(buf));
-    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_MMAP;
-    buf.index = i;
-    
-    if (ioctl(self->fd, VIDIOC_QUERYBUF, &buf) == -1) {
-      g_warning("Failed to query buffer: %s", strerror(errno));
-      stop_capture(self);
-      return false;
+  DIR* dir = opendir("/sys/class/video4linux");
+  if (dir == nullptr) {
+    return;
+  }
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (strncmp(entry->d_name, "video", 5) == 0) {
+      hotplug_check_node(self, entry->d_name);
     }
-    
-    self->buffers[i].length = buf.length;
-    self->buffers[i].start = mmap(NULL, buf.length,
-                                  PROT_READ | PROT_WRITE,
-                                  MAP_SHARED,
-                                  self->fd, buf.m.offset);
-    
-    if (self->buffers[i].start == MAP_FAILED) {
-      g_warning("Failed to map buffer: %s", strerror(errno));
-      stop_capture(self);
-      return false;
+  }
+  closedir(dir);
+}
+
+static void on_hotplug(const char* node_name, gboolean present, gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  if (node_name == nullptr) {
+    self->camera_cache->clear();
+    hotplug_rescan(self);
+    return;
+  }
+  // A change to a present node is caught by its probe key, so the cached
+  // probe is only dropped, along with any probe still running, once the
+  // node has gone.
+  if (present) {
+    hotplug_check_node(self, node_name);
+  } else {
+    self->camera_cache->erase(node_name);
+    self->hotplug_probes->erase(node_name);
+    std::string device_path = std::string("/dev/") + node_name;
+    if (self->attached_devices->erase(device_path) != 0) {
+      g_print("[USB Video] Device %s detached\n", device_path.c_str());
+      send_hotplug_detached(self, device_path);
     }
   }
-  
-  // Queue buffers
-  for (unsigned int i = 0; i < self->n_buffers; ++i) {
-    struct v4l2_buffer buf;
-    memset(&buf, 0, sizeof(buf));
-    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-    buf.memory = V4L2_MEMORY_MMAP;
-    buf.index = i;
-    
-    if (ioctl(self->fd, VIDIOC_QBUF, &buf) == -1) {
-      g_warning("Failed to queue buffer: %s", strerror(errno));
-      stop_capture(self);
-      return false;
+}
+
+// The watcher only exists while Dart listens, and starts by announcing what
+// is already plugged in so nothing attached in between is missed.
+static FlMethodErrorResponse* hotplug_channel_listen(FlEventChannel* channel,
+                                                     FlValue* args,
+                                                     gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  if (self->hotplug == nullptr) {
+    self->hotplug = usb_video_hotplug_new(on_hotplug, self);
+  }
+  if (self->hotplug == nullptr) {
+    return fl_method_error_response_new("HOTPLUG_UNAVAILABLE",
+                                        "Cannot watch for video devices", nullptr);
+  }
+  self->attached_devices->clear();
+  self->hotplug_probes->clear();
+  hotplug_rescan(self);
+  return nullptr;
+}
+
+static FlMethodErrorResponse* hotplug_channel_cancel(FlEventChannel* channel,
+                                                     FlValue* args,
+                                                     gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(user_data);
+  usb_video_hotplug_free(self->hotplug);
+  self->hotplug = nullptr;
+  self->attached_devices->clear();
+  self->hotplug_probes->clear();
+  return nullptr;
+}
+
+// One listUsbCameras request: every candidate node in directory order, and
+// the probes still to run for those without a valid cache entry.
+struct CameraListJob {
+  std::vector<std::string> node_names;
+  std::vector<CameraProbe> probes;
+};
+
+static void camera_list_job_free(gpointer data) {
+  delete static_cast<CameraListJob*>(data);
+}
+
+// Builds the listUsbCameras result from the cache, dropping entries for
+// nodes that no longer exist.
+static FlMethodResponse* camera_list_response(UsbVideoCapturePlugin* self,
+                                              const std::vector<std::string>& node_names) {
+  std::set<std::string> present(node_names.begin(), node_names.end());
+  for (auto it = self->camera_cache->begin(); it != self->camera_cache->end();) {
+    it = present.count(it->first) != 0 ? std::next(it) : self->camera_cache->erase(it);
+  }
+
+  g_autoptr(FlValue) cameras = fl_value_new_list();
+  for (const std::string& node_name : node_names) {
+    auto it = self->camera_cache->find(node_name);
+    if (it != self->camera_cache->end() && it->second.usable) {
+      fl_value_append_take(cameras, camera_probe_value(it->second));
     }
   }
-  
-  // Start streaming
-  enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-  if (ioctl(self->fd, VIDIOC_STREAMON, &type) == -1) {
-    g_warning("Failed to start streaming: %s", strerror(errno));
-    stop_capture(self);
-    return false;
+  return FL_METHOD_RESPONSE(fl_method_success_response_new(cameras));
+}
+
+// Worker thread: opens and queries the uncached nodes.
+static void camera_list_job_run(GTask* task, gpointer source_object, gpointer task_data,
+                                GCancellable* cancellable) {
+  CameraListJob* job = static_cast<CameraListJob*>(task_data);
+  for (CameraProbe& probe : job->probes) {
+    probe_camera_node(&probe);
   }
-  
-  // Start capture thread
-  self->capturing = true;
-  self->capture_thread = new std::thread(capture_frames, self);
-  g_print("[USB Video] Capture thread started\n");
+  g_task_return_pointer(task, nullptr, nullptr);
+}
 
-  // Start the idle timer to deliver frames to Flutter (only while capturing)
-  if (self->idle_source_id == 0) {
-    self->idle_source_id = g_timeout_add(16, send_pending_frames, self);
+// Main thread: caches the new probes and answers the method call.
+static void camera_list_job_done(GObject* source_object, GAsyncResult* result,
+                                 gpointer user_data) {
+  UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(source_object);
+  g_autoptr(FlMethodCall) method_call = FL_METHOD_CALL(user_data);
+  CameraListJob* job = static_cast<CameraListJob*>(g_task_get_task_data(G_TASK(result)));
+  for (const CameraProbe& probe : job->probes) {
+    cache_camera_probe(self, probe);
   }
+  // A node the worker could not open is not cached, but is still left out
+  // of this answer, as before.
+  g_autoptr(FlMethodResponse) response = camera_list_response(self, job->node_names);
+  fl_method_call_respond(method_call, response, nullptr);
+}
 
-  return true;
+// Main thread: answers a captureScreenshot call with the PNG of a live frame.
+static void screenshot_ready(GBytes* png, gpointer user_data) {
+  g_autoptr(FlMethodCall) method_call = FL_METHOD_CALL(user_data);
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (png != nullptr) {
+    gsize size = 0;
+    const uint8_t* data = static_cast<const uint8_t*>(g_bytes_get_data(png, &size));
+    g_autoptr(FlValue) result = fl_value_new_uint8_list(data, size);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+      "NO_FRAME", "The video stream stopped before a frame arrived", nullptr));
+  }
+  fl_method_call_respond(method_call, response, nullptr);
 }
 
 // Called when a method call is received from Flutter.
@@ -443,81 +657,40 @@ static void usb_video_capture_plugin_handle_method_call(
     response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
   } else if (strcmp(method, "listUsbCameras") == 0) {
     g_print("[USB Video] listUsbCameras called\n");
-    g_autoptr(FlValue) cameras = fl_value_new_list();
+    CameraListJob* job = new CameraListJob();
     
-    // Check for Disting NT video device
+    // Check for Disting NT video device. Reading sysfs is cheap; only nodes
+    // without a valid cached probe need opening.
     DIR* dir = opendir("/sys/class/video4linux");
     if (dir) {
       struct dirent* entry;
       while ((entry = readdir(dir)) != NULL) {
         if (strncmp(entry->d_name, "video", 5) == 0) {
-          char path[256];
-          char name[256];
-          snprintf(path, sizeof(path), "/sys/class/video4linux/%s/name", entry->d_name);
-          
-          FILE* f = fopen(path, "r");
-          if (f) {
-            if (fgets(name, sizeof(name), f)) {
-              // Remove newline
-              size_t len = strlen(name);
-              if (len > 0 && name[len-1] == '\n') {
-                name[len-1] = '\0';
-              }
-              
-              // Check if it's the Disting NT
-              if (strstr(name, "disting") || strstr(name, "NT")) {
-                g_print("[USB Video] Found Disting NT device: %s at /dev/%s\n", name, entry->d_name);
-
-                // Each UVC device creates two video nodes — only the one that
-                // supports V4L2_CAP_VIDEO_CAPTURE and YUYV format is usable.
-                char device_path[32];
-                snprintf(device_path, sizeof(device_path), "/dev/%s", entry->d_name);
-                int probe_fd = open(device_path, O_RDWR);
-                if (probe_fd >= 0) {
-                  struct v4l2_capability cap;
-                  memset(&cap, 0, sizeof(cap));
-                  bool usable = false;
-                  if (ioctl(probe_fd, VIDIOC_QUERYCAP, &cap) == 0 &&
-                      (cap.capabilities & V4L2_CAP_VIDEO_CAPTURE) != 0) {
-                    // Also verify YUYV format is supported
-                    struct v4l2_fmtdesc fmtdesc;
-                    memset(&fmtdesc, 0, sizeof(fmtdesc));
-                    fmtdesc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-                    while (ioctl(probe_fd, VIDIOC_ENUM_FMT, &fmtdesc) == 0) {
-                      if (fmtdesc.pixelformat == V4L2_PIX_FMT_YUYV) {
-                        usable = true;
-                        break;
-                      }
-                      fmtdesc.index++;
-                    }
-                  }
-                  close(probe_fd);
-
-                  if (usable) {
-                    g_print("[USB Video] Device %s supports YUYV capture\n", device_path);
-                    FlValue* camera = fl_value_new_map();
-
-                    fl_value_set_string(camera, "deviceId", fl_value_new_string(device_path));
-                    fl_value_set_string(camera, "productName", fl_value_new_string(name));
-                    fl_value_set_string(camera, "vendorId", fl_value_new_int(0x3773));
-                    fl_value_set_string(camera, "productId", fl_value_new_int(0x0001));
-                    fl_value_set_string(camera, "isDistingNT", fl_value_new_bool(TRUE));
-
-                    fl_value_append_take(cameras, camera);
-                  } else {
-                    g_print("[USB Video] Device %s does not support YUYV capture, skipping\n", device_path);
-                  }
-                }
-              }
-            }
-            fclose(f);
+          std::string key = camera_probe_key(entry->d_name);
+          job->node_names.push_back(entry->d_name);
+          if (cached_camera_probe(self, entry->d_name, key) == nullptr) {
+            CameraProbe probe;
+            probe.node_name = entry->d_name;
+            probe.key = key;
+            probe.usable = false;
+            job->probes.push_back(probe);
           }
         }
       }
       closedir(dir);
     }
     
-    response = FL_METHOD_RESPONSE(fl_method_success_response_new(cameras));
+    if (job->probes.empty()) {
+      response = camera_list_response(self, job->node_names);
+      delete job;
+    } else {
+      // Probe off the main thread and answer when done.
+      GTask* task = g_task_new(self, nullptr, camera_list_job_done, g_object_ref(method_call));
+      g_task_set_task_data(task, job, camera_list_job_free);
+      g_task_run_in_thread(task, camera_list_job_run);
+      g_object_unref(task);
+      return;
+    }
   } else if (strcmp(method, "requestUsbPermission") == 0) {
     // Linux doesn't need special USB permissions if user is in video group
     g_autoptr(FlValue) result = fl_value_new_bool(TRUE);
@@ -531,15 +704,72 @@ static void usb_video_capture_plugin_handle_method_call(
         const char* device_path = fl_value_get_string(device_id);
         g_print("[USB Video] Starting stream for device: %s\n", device_path);
         
-        stop_capture(self); // Stop any existing capture
+        UsbVideoStreamOptions options;
+        FlValue* delivery = fl_value_lookup_string(args, "delivery");
+        options.use_texture = delivery != nullptr &&
+                              fl_value_get_type(delivery) == FL_VALUE_TYPE_STRING &&
+                              strcmp(fl_value_get_string(delivery), "texture") == 0;
+        FlValue* encoding = fl_value_lookup_string(args, "encoding");
+        options.delta_frames = encoding != nullptr &&
+                               fl_value_get_type(encoding) == FL_VALUE_TYPE_STRING &&
+                               strcmp(fl_value_get_string(encoding), "delta") == 0;
+        FlValue* format = fl_value_lookup_string(args, "format");
+        options.gray4 = format != nullptr &&
+                        fl_value_get_type(format) == FL_VALUE_TYPE_STRING &&
+                        strcmp(fl_value_get_string(format), "gray4") == 0;
+        FlValue* keep_alive = fl_value_lookup_string(args, "keepAliveMs");
+        options.keep_alive_us =
+            keep_alive != nullptr && fl_value_get_type(keep_alive) == FL_VALUE_TYPE_INT
+                ? fl_value_get_int(keep_alive) * 1000
+                : usb_video::FrameSuppressor::kDefaultKeepAliveUs;
+        FlValue* fps = fl_value_lookup_string(args, "fps");
+        options.max_fps = 0;
+        if (fps != nullptr && fl_value_get_type(fps) == FL_VALUE_TYPE_FLOAT) {
+          options.max_fps = fl_value_get_float(fps);
+        } else if (fps != nullptr && fl_value_get_type(fps) == FL_VALUE_TYPE_INT) {
+          options.max_fps = static_cast<double>(fl_value_get_int(fps));
+        }
+        FlValue* when_hidden = fl_value_lookup_string(args, "whenHidden");
+        options.pause_when_hidden =
+            when_hidden == nullptr || fl_value_get_type(when_hidden) != FL_VALUE_TYPE_STRING ||
+            strcmp(fl_value_get_string(when_hidden), "keepAlive") != 0;
+
+        stop_video_stream(self); // Stop any existing capture
         
-        if (start_video_stream(self, device_path)) {
-          g_print("[USB Video] start_video_stream returned true\n");
-          response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
-        } else {
-          g_print("[USB Video] start_video_stream returned false\n");
+        // Windows share one capture session, so another window streaming a
+        // different device keeps it until that window stops.
+        const char* busy_device = usb_video_session_get_device();
+        if (busy_device != nullptr && strcmp(busy_device, device_path) != 0) {
+          g_autofree gchar* message =
+              g_strdup_printf("%s is streaming in another window", busy_device);
           response = FL_METHOD_RESPONSE(fl_method_error_response_new(
-            "STREAM_ERROR", "Failed to start video stream", nullptr));
+            "DEVICE_BUSY", message, nullptr));
+        } else {
+          self->subscriber = usb_video_session_subscribe(
+              device_path, &options, self->texture_registrar, &kSubscriberCallbacks, self);
+          if (self->subscriber != nullptr) {
+            g_print("[USB Video] Subscribed to capture session\n");
+            usb_video_subscriber_set_active(self->subscriber, self->stream_active);
+            usb_video_subscriber_set_telemetry(self->subscriber, self->debug_active);
+            watch_window(self);
+            int64_t texture_id = usb_video_subscriber_get_texture_id(self->subscriber);
+            if (texture_id >= 0) {
+              // Tell both the caller and the stream listener which texture to
+              // show; the listener otherwise only sees heartbeats.
+              g_autoptr(FlValue) result = fl_value_new_map();
+              fl_value_set_string_take(result, "textureId", fl_value_new_int(texture_id));
+              if (self->stream_active) {
+                fl_event_channel_send(self->event_channel, result, nullptr, nullptr);
+              }
+              response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+            } else {
+              response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+            }
+          } else {
+            g_print("[USB Video] Failed to subscribe to capture session\n");
+            response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+              "STREAM_ERROR", "Failed to start video stream", nullptr));
+          }
         }
       } else {
         response = FL_METHOD_RESPONSE(fl_method_error_response_new(
@@ -549,9 +779,103 @@ static void usb_video_capture_plugin_handle_method_call(
       response = FL_METHOD_RESPONSE(fl_method_error_response_new(
         "INVALID_ARGUMENTS", "Arguments must be a map", nullptr));
     }
+  } else if (strcmp(method, "setTelemetryInterval") == 0) {
+    // Dart asks for reports while it wants them; 0 turns them off.
+    FlValue* args = fl_method_call_get_args(method_call);
+    FlValue* interval = fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                            ? fl_value_lookup_string(args, "intervalMs")
+                            : nullptr;
+    if (interval != nullptr && fl_value_get_type(interval) == FL_VALUE_TYPE_INT) {
+      int64_t interval_us =
+          usb_video_session_set_telemetry_interval_us(fl_value_get_int(interval) * 1000);
+      g_autoptr(FlValue) result = fl_value_new_int(interval_us / 1000);
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    } else {
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARGUMENTS", "intervalMs is required", nullptr));
+    }
+  } else if (strcmp(method, "startRecording") == 0) {
+    // Records the shared session to a file; see recording_format.h.
+    FlValue* args = fl_method_call_get_args(method_call);
+    FlValue* path = fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                        ? fl_value_lookup_string(args, "path")
+                        : nullptr;
+    if (path != nullptr && fl_value_get_type(path) == FL_VALUE_TYPE_STRING) {
+      FlValue* format = fl_value_lookup_string(args, "format");
+      gboolean gray4 = format != nullptr &&
+                       fl_value_get_type(format) == FL_VALUE_TYPE_STRING &&
+                       strcmp(fl_value_get_string(format), "gray4") == 0;
+      if (self->subscriber == nullptr) {
+        response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "NOT_STREAMING", "Start the video stream before recording", nullptr));
+      } else if (usb_video_session_start_recording(fl_value_get_string(path), gray4)) {
+        response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+      } else {
+        response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+          "RECORDING_ERROR", "Already recording, or the file cannot be created", nullptr));
+      }
+    } else {
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "INVALID_ARGUMENTS", "path is required", nullptr));
+    }
+  } else if (strcmp(method, "stopRecording") == 0) {
+    g_autoptr(FlValue) result = fl_value_new_map();
+    if (usb_video_session_stop_recording(result)) {
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    } else if (fl_value_get_length(result) != 0) {
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "RECORDING_ERROR", "The recording could not be written completely", result));
+    } else {
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    }
+  } else if (strcmp(method, "startFrameExport") == 0) {
+    // Publishes raw frames to shared memory for other processes; see
+    // shared_frame_format.h.
+    FlValue* args = fl_method_call_get_args(method_call);
+    FlValue* name = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                        ? fl_value_lookup_string(args, "name")
+                        : nullptr;
+    const char* shm_name = name != nullptr && fl_value_get_type(name) == FL_VALUE_TYPE_STRING
+                               ? fl_value_get_string(name)
+                               : nullptr;
+    g_autoptr(FlValue) result = fl_value_new_map();
+    if (self->subscriber == nullptr) {
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "NOT_STREAMING", "Start the video stream before exporting frames", nullptr));
+    } else if (usb_video_session_start_export(shm_name, result)) {
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    } else {
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "EXPORT_ERROR", "Already exporting, or the shared memory cannot be created", nullptr));
+    }
+  } else if (strcmp(method, "stopFrameExport") == 0) {
+    g_autoptr(FlValue) result = fl_value_new_map();
+    if (usb_video_session_stop_export(result)) {
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    } else {
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    }
+  } else if (strcmp(method, "captureScreenshot") == 0) {
+    // Answered from the next captured frame, so the app need not ask the
+    // module for a SysEx screenshot while the display is streaming.
+    if (self->subscriber == nullptr) {
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "NOT_STREAMING", "Start the video stream before taking a screenshot", nullptr));
+    } else if (usb_video_session_request_screenshot(screenshot_ready,
+                                                    g_object_ref(method_call))) {
+      return;
+    } else {
+      g_object_unref(method_call);
+      response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        "NO_FRAME", "The video stream is paused", nullptr));
+    }
   } else if (strcmp(method, "stopVideoStream") == 0) {
-    stop_capture(self);
+    stop_video_stream(self);
     response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  } else if (strcmp(method, "getStreamStatistics") == 0) {
+    g_autoptr(FlValue) result = fl_value_new_map();
+    usb_video_session_add_statistics(self->subscriber, result);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(result));
   } else {
     response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
   }
@@ -562,22 +886,28 @@ static void usb_video_capture_plugin_handle_method_call(
 static void usb_video_capture_plugin_dispose(GObject* object) {
   UsbVideoCapturePlugin* self = USB_VIDEO_CAPTURE_PLUGIN(object);
 
-  // Remove idle handler
-  if (self->idle_source_id != 0) {
-    g_source_remove(self->idle_source_id);
-    self->idle_source_id = 0;
+  stop_video_stream(self);
+  std::vector<UsbVideoCapturePlugin*>& plugins = live_plugins();
+  plugins.erase(std::remove(plugins.begin(), plugins.end(), self), plugins.end());
+  if (self->view != nullptr) {
+    g_object_remove_weak_pointer(G_OBJECT(self->view),
+                                 reinterpret_cast<gpointer*>(&self->view));
+    self->view = nullptr;
   }
 
-  stop_capture(self);
-
-  // Clean up frame queue
-  if (self->pending_frames) {
-    delete self->pending_frames;
-    self->pending_frames = nullptr;
+  usb_video_hotplug_free(self->hotplug);
+  self->hotplug = nullptr;
+  if (self->attached_devices) {
+    delete self->attached_devices;
+    self->attached_devices = nullptr;
+  }
+  if (self->camera_cache) {
+    delete self->camera_cache;
+    self->camera_cache = nullptr;
   }
-  if (self->frame_queue_mutex) {
-    delete self->frame_queue_mutex;
-    self->frame_queue_mutex = nullptr;
+  if (self->hotplug_probes) {
+    delete self->hotplug_probes;
+    self->hotplug_probes = nullptr;
   }
 
   G_OBJECT_CLASS(usb_video_capture_plugin_parent_class)->dispose(object);
@@ -588,18 +918,22 @@ static void usb_video_capture_plugin_class_init(UsbVideoCapturePluginClass* klas
 }
 
 static void usb_video_capture_plugin_init(UsbVideoCapturePlugin* self) {
-  self->fd = -1;
-  self->buffers = nullptr;
-  self->n_buffers = 0;
-  self->capture_thread = nullptr;
-  self->capturing = false;
   self->event_channel = nullptr;
   self->debug_channel = nullptr;
+  self->hotplug_channel = nullptr;
   self->stream_active = false;
-
-  self->frame_queue_mutex = new std::mutex();
-  self->pending_frames = new std::queue<std::vector<uint8_t>>();
-  self->idle_source_id = 0;
+  self->debug_active = false;
+  self->subscriber = nullptr;
+  self->texture_registrar = nullptr;
+  self->view = nullptr;
+  self->window = nullptr;
+
+  self->hotplug = nullptr;
+  live_plugins().push_back(self);
+  self->attached_devices = new std::set<std::string>();
+  self->camera_cache = new std::map<std::string, CameraProbe>();
+  self->hotplug_probes = new std::map<std::string, HotplugProbe>();
+  self->hotplug_probe_serial = 0;
 }
 
 static void method_call_cb(FlMethodChannel* channel, FlMethodCall* method_call,
@@ -611,6 +945,13 @@ static void method_call_cb(FlMethodChannel* channel, FlMethodCall* method_call,
 extern "C" void usb_video_capture_plugin_register_with_registrar(FlPluginRegistrar* registrar) {
   UsbVideoCapturePlugin* plugin = USB_VIDEO_CAPTURE_PLUGIN(
       g_object_new(usb_video_capture_plugin_get_type(), nullptr));
+  plugin->texture_registrar = fl_plugin_registrar_get_texture_registrar(registrar);
+  // Null for a headless engine, which then always counts as focused.
+  plugin->view = fl_plugin_registrar_get_view(registrar);
+  if (plugin->view != nullptr) {
+    g_object_add_weak_pointer(G_OBJECT(plugin->view),
+                              reinterpret_cast<gpointer*>(&plugin->view));
+  }
 
   g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
   g_autoptr(FlMethodChannel) channel =
@@ -636,6 +977,35 @@ extern "C" void usb_video_capture_plugin_register_with_registrar(FlPluginRegistr
       fl_plugin_registrar_get_messenger(registrar),
       "com.example.nt_helper/usb_video_debug",
       FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(plugin->debug_channel,
+                                       debug_channel_listen,
+                                       debug_channel_cancel,
+                                       plugin,
+                                       nullptr);
+
+  // Attach/detach events for Disting NT video nodes
+  plugin->hotplug_channel = fl_event_channel_new(
+      fl_plugin_registrar_get_messenger(registrar),
+      "com.example.nt_helper/usb_video_hotplug",
+      FL_METHOD_CODEC(codec));
+  fl_event_channel_set_stream_handlers(plugin->hotplug_channel,
+                                       hotplug_channel_listen,
+                                       hotplug_channel_cancel,
+                                       plugin,
+                                       nullptr);
 
   g_object_unref(plugin);
-}
\ No newline at end of file
+}
+
+// Called by the runner whenever a window is minimized, restored, mapped,
+// unmapped or covered.
+extern "C" void usb_video_capture_plugin_set_window_visible(GtkWindow* window,
+                                                            gboolean visible) {
+  g_object_set_data(G_OBJECT(window), kWindowHiddenKey,
+                    visible ? nullptr : GINT_TO_POINTER(1));
+  for (UsbVideoCapturePlugin* plugin : live_plugins()) {
+    if (plugin->subscriber != nullptr && plugin->window == window) {
+      usb_video_subscriber_set_visible(plugin->subscriber, visible);
+    }
+  }
+}
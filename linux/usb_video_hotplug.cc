@@ -0,0 +1,82 @@
+#include "usb_video_hotplug.h"
+
+#include <glib-unix.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+struct _UsbVideoHotplug {
+  int inotify_fd;
+  guint source_id;
+  UsbVideoHotplugFunc callback;
+  gpointer user_data;
+};
+
+static gboolean is_video_node(const char* name) {
+  return strncmp(name, "video", 5) == 0;
+}
+
+static gboolean usb_video_hotplug_on_events(gint fd, GIOCondition condition,
+                                            gpointer user_data) {
+  UsbVideoHotplug* self = static_cast<UsbVideoHotplug*>(user_data);
+
+  // inotify hands out whole events, so a buffer of this size always holds
+  // at least one.
+  alignas(struct inotify_event) char buffer[4096];
+  for (;;) {
+    ssize_t length = read(fd, buffer, sizeof(buffer));
+    if (length <= 0) {
+      if (length == -1 && errno == EINTR) {
+        continue;
+      }
+      break;  // EAGAIN: drained.
+    }
+    for (char* p = buffer; p < buffer + length;) {
+      const struct inotify_event* event =
+          reinterpret_cast<const struct inotify_event*>(p);
+      p += sizeof(struct inotify_event) + event->len;
+
+      if ((event->mask & IN_Q_OVERFLOW) != 0) {
+        self->callback(nullptr, TRUE, self->user_data);
+        continue;
+      }
+      if (event->len == 0 || !is_video_node(event->name)) {
+        continue;
+      }
+      gboolean present = (event->mask & IN_DELETE) == 0;
+      self->callback(event->name, present, self->user_data);
+    }
+  }
+  return G_SOURCE_CONTINUE;
+}
+
+UsbVideoHotplug* usb_video_hotplug_new(UsbVideoHotplugFunc callback,
+                                       gpointer user_data) {
+  int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd == -1) {
+    g_warning("[USB Video] inotify unavailable: %s", strerror(errno));
+    return nullptr;
+  }
+  if (inotify_add_watch(fd, "/dev", IN_CREATE | IN_ATTRIB | IN_DELETE) == -1) {
+    g_warning("[USB Video] Cannot watch /dev: %s", strerror(errno));
+    close(fd);
+    return nullptr;
+  }
+
+  UsbVideoHotplug* self = new UsbVideoHotplug();
+  self->inotify_fd = fd;
+  self->callback = callback;
+  self->user_data = user_data;
+  self->source_id = g_unix_fd_add(fd, G_IO_IN, usb_video_hotplug_on_events, self);
+  return self;
+}
+
+void usb_video_hotplug_free(UsbVideoHotplug* hotplug) {
+  if (hotplug == nullptr) {
+    return;
+  }
+  g_source_remove(hotplug->source_id);
+  close(hotplug->inotify_fd);
+  delete hotplug;
+}
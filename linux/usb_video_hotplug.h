@@ -0,0 +1,44 @@
+#ifndef FLUTTER_USB_VIDEO_HOTPLUG_H_
+#define FLUTTER_USB_VIDEO_HOTPLUG_H_
+
+#include <glib.h>
+
+typedef struct _UsbVideoHotplug UsbVideoHotplug;
+
+/**
+ * UsbVideoHotplugFunc:
+ * @node_name: the /dev entry that changed, e.g. "video2", or %NULL when
+ *   events were lost and every node should be rechecked.
+ * @present: %TRUE when the node appeared or its permissions changed (it may
+ *   have just become openable), %FALSE when it was removed.
+ * @user_data: data passed to usb_video_hotplug_new().
+ *
+ * Called on the main thread for every V4L2 device node change.
+ */
+typedef void (*UsbVideoHotplugFunc)(const char* node_name, gboolean present,
+                                    gpointer user_data);
+
+/**
+ * usb_video_hotplug_new:
+ * @callback: called for each video node change.
+ * @user_data: passed to @callback.
+ *
+ * Watches /dev with inotify from the default main context. The kernel
+ * creates a node as soon as a camera enumerates and udev fixes up its
+ * permissions moments later, so callers see %TRUE for both and should probe
+ * the node each time until it opens. Nothing runs while no device changes.
+ *
+ * Returns: a new watcher, or %NULL if inotify is unavailable.
+ */
+UsbVideoHotplug* usb_video_hotplug_new(UsbVideoHotplugFunc callback,
+                                       gpointer user_data);
+
+/**
+ * usb_video_hotplug_free:
+ * @hotplug: a #UsbVideoHotplug, or %NULL.
+ *
+ * Stops watching; @callback is not called again.
+ */
+void usb_video_hotplug_free(UsbVideoHotplug* hotplug);
+
+#endif  // FLUTTER_USB_VIDEO_HOTPLUG_H_
@@ -0,0 +1,1295 @@
+#include "usb_video_session.h"
+
+#include <glib-unix.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <pthread.h>
+#include <time.h>
+#include <string.h>
+#include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "capture_backend.h"
+#include "frame_encoder.h"
+#include "frame_pool.h"
+#include "frame_rate_controller.h"
+#include "frame_suppressor.h"
+#include "latency_stats.h"
+#include "pipeline_telemetry.h"
+#include "recording_writer.h"
+#include "screenshot.h"
+#include "shared_frame_ring.h"
+#include "synthetic_capture_backend.h"
+#include "triple_buffer.h"
+#include "usb_video_texture.h"
+#include "v4l2_capture_backend.h"
+#include "yuyv_convert.h"
+
+namespace {
+
+// Raw YUYV slots behind the triple buffer.
+const size_t kHandoffSlots = 3;
+
+// Device paths starting with this stream from a SyntheticCaptureBackend
+// configured by the rest of the path, e.g. "synthetic:pattern=noise,fps=30"
+// (see SyntheticCaptureBackend::ParseOptions), for working on the pipeline
+// without a module attached.
+const char kSyntheticDevicePrefix[] = "synthetic:";
+
+// The Disting NT display.
+const int kFrameWidth = 256;
+const int kFrameHeight = 64;
+
+// Delta streams resend the whole picture at least this often (in delivered
+// frames) so a receiver that missed a frame recovers on its own.
+const int kDeltaKeyframeInterval = 60;
+
+// In texture mode the stall watchdog in UsbVideoManager still needs to see
+// traffic, so the capture thread asks for the frame counter to be sent about
+// once a second instead of frames.
+const gint64 kTextureHeartbeatIntervalUs = G_USEC_PER_SEC;
+
+// What a subscriber in an unfocused window asks for, however fast it would
+// take frames otherwise: enough to show the picture is alive.
+const double kUnfocusedMaxFps = 10;
+
+// While every window is hidden and one of them wants a keep-alive rather
+// than a pause, frames are delivered at this rate (and the device asked
+// for it, where it goes that low).
+const double kHiddenMaxFps = 1;
+const gint64 kHiddenFrameGapUs = G_USEC_PER_SEC;
+
+// Frame intervals cross to the capture thread packed into one atomic word,
+// numerator high; zero means none.
+uint64_t pack_interval(const usb_video::FrameInterval& interval) {
+  return static_cast<uint64_t>(interval.numerator) << 32 | interval.denominator;
+}
+
+usb_video::FrameInterval unpack_interval(uint64_t packed) {
+  return usb_video::FrameInterval{static_cast<uint32_t>(packed >> 32),
+                                  static_cast<uint32_t>(packed)};
+}
+
+}  // namespace
+
+struct _UsbVideoSubscriber {
+  UsbVideoStreamOptions options;
+  const UsbVideoSubscriberCallbacks* callbacks;
+  gpointer user_data;
+  // Whether Dart listens for this subscriber's frames.
+  bool active;
+  bool wants_telemetry;
+  // Whether the subscriber's window has the focus, and whether it can be
+  // seen at all.
+  bool focused;
+  bool visible;
+
+  // Texture delivery: the capture thread copies frames straight into the
+  // texture, which belongs to this subscriber's engine.
+  FlTextureRegistrar* texture_registrar;
+  UsbVideoTexture* texture;
+  uint64_t heartbeat_frames;
+
+  // Channel traffic to this subscriber. Main thread only.
+  uint64_t frames_sent;
+  uint64_t keyframes_sent;
+  uint64_t bytes_sent;
+};
+
+// The one capture session per process. Every field except the atomics and
+// those guarded by texture_lock is main-thread only, apart from what the
+// capture thread owns while capturing.
+struct UsbVideoSession {
+  std::string device_path;
+  // Where frames come from; Wake() lets stop_capture interrupt the capture
+  // thread without waiting on the driver.
+  usb_video::CaptureBackend* backend;
+  std::thread* capture_thread;
+  std::atomic<bool> capturing;
+  // Time from the driver timestamping a buffer to the capture thread
+  // dequeuing it.
+  usb_video::LatencyStats dequeue_latency;
+  // Per-stage histograms and report pacing for the debug channel. Outlives
+  // sessions so the reporting interval Dart asked for sticks.
+  usb_video::PipelineTelemetry telemetry;
+  // Frames the driver skipped, from gaps in the V4L2 sequence numbers.
+  std::atomic<uint64_t> driver_dropped_frames;
+  // Frames that left the session by any route, counted once each.
+  std::atomic<uint64_t> frames_delivered;
+  uint64_t session_id;
+
+  // Cache-line-aligned slots behind frame_buffer, sized from the negotiated
+  // format and kept across stop/start so a restart does not reallocate.
+  usb_video::FramePool frame_pool;
+  // Latest raw YUYV frame handed from the capture thread to the main loop.
+  usb_video::TripleBuffer<usb_video::FrameSlot> frame_buffer;
+  // Drops frames identical to the last delivered one (the Disting display is
+  // static most of the time), apart from a periodic keep-alive.
+  usb_video::FrameSuppressor suppressor;
+  // Encodes each frame once per format, with one delta stream per format
+  // shared by every subscriber using it. Main thread only.
+  usb_video::FrameEncoder encoder;
+
+  // eventfd the capture thread signals when there is something to send; the
+  // main loop watches it through delivery_source_id rather than polling.
+  int frame_ready_fd;
+  // Set while a wakeup is outstanding, so a burst of frames costs one
+  // eventfd write and one main-loop dispatch.
+  std::atomic<bool> delivery_pending;
+  // Set by the capture thread when texture subscribers are due a heartbeat.
+  std::atomic<bool> heartbeat_due;
+  guint delivery_source_id;
+
+  // Negotiated frame size, filled in by start_capture.
+  uint32_t width;
+  uint32_t height;
+
+  std::vector<UsbVideoSubscriber*> subscribers;
+  // Active subscribers taking frames over their event channel; the capture
+  // thread only snapshots frames while there is one.
+  std::atomic<int> channel_listeners;
+  // Texture subscribers, read by the capture thread for every frame.
+  std::mutex texture_lock;
+  std::vector<UsbVideoSubscriber*> texture_subscribers;
+  // Size of texture_subscribers, readable without the lock.
+  std::atomic<int> texture_count;
+  std::atomic<uint64_t> texture_frames;
+  // Frames written to textures, and those replaced before the engine drew
+  // them. Written by the capture thread, read by the main thread.
+  std::atomic<uint64_t> texture_offered;
+  std::atomic<uint64_t> texture_missed;
+
+  // Picks the capture rate from what the subscribers want and keep up with.
+  // Main thread only.
+  usb_video::FrameRateController rate_controller;
+  // The interval last asked of the capture thread. Main thread only.
+  uint64_t requested_interval;
+  // An interval for the capture thread to switch to between frames (see
+  // pack_interval), and the one the backend last reported using.
+  std::atomic<uint64_t> pending_interval;
+  std::atomic<uint64_t> capture_interval;
+
+  // Set while no subscriber can be seen: either the capture thread pauses
+  // the backend, or it delivers a frame a second.
+  std::atomic<bool> pause_requested;
+  std::atomic<bool> hidden_keep_alive;
+  // Whether the backend is paused, as last reported by the capture thread.
+  std::atomic<bool> capture_paused;
+  // The pause state subscribers were last told about. Main thread only.
+  bool pause_reported;
+
+  // Non-null while recording. The capture thread submits frames under
+  // recording_lock, and only looks while |recording| is set.
+  std::mutex recording_lock;
+  usb_video::RecordingWriter* recorder;
+  std::atomic<bool> recording;
+
+  // Non-null while exporting frames to shared memory. The capture thread
+  // only try-locks export_lock, and only looks while |exporting| is set.
+  std::mutex export_lock;
+  usb_video::SharedFrameRing* frame_export;
+  std::atomic<bool> exporting;
+
+  // Screenshot requests waiting for a frame. While screenshot_wanted is set
+  // the capture thread copies the next frame into screenshot_frame, sets
+  // screenshot_ready and wakes the main loop, which encodes it once for
+  // every waiting request.
+  std::vector<std::pair<UsbVideoScreenshotCallback, gpointer>> screenshot_requests;
+  std::atomic<bool> screenshot_wanted;
+  std::atomic<bool> screenshot_ready;
+  std::vector<uint8_t> screenshot_frame;
+  usb_video::ScreenshotEncoder screenshot_encoder;
+};
+
+// Process-wide, and never freed: the frame pool and telemetry settings are
+// reused by the next session.
+static UsbVideoSession* default_session() {
+  static UsbVideoSession* session = [] {
+    UsbVideoSession* s = new UsbVideoSession();
+    s->backend = nullptr;
+    s->capture_thread = nullptr;
+    s->capturing = false;
+    s->driver_dropped_frames = 0;
+    s->frames_delivered = 0;
+    s->session_id = 0;
+    s->frame_ready_fd = -1;
+    s->delivery_pending = false;
+    s->heartbeat_due = false;
+    s->delivery_source_id = 0;
+    s->width = kFrameWidth;
+    s->height = kFrameHeight;
+    s->channel_listeners = 0;
+    s->texture_count = 0;
+    s->texture_frames = 0;
+    s->texture_offered = 0;
+    s->texture_missed = 0;
+    s->requested_interval = 0;
+    s->pending_interval = 0;
+    s->capture_interval = 0;
+    s->pause_requested = false;
+    s->hidden_keep_alive = false;
+    s->capture_paused = false;
+    s->pause_reported = false;
+    s->recorder = nullptr;
+    s->recording = false;
+    s->frame_export = nullptr;
+    s->exporting = false;
+    s->screenshot_wanted = false;
+    s->screenshot_ready = false;
+    return s;
+  }();
+  return session;
+}
+
+static bool is_channel_listener(const UsbVideoSubscriber* subscriber) {
+  return subscriber->active && subscriber->texture == nullptr;
+}
+
+static usb_video::FrameEncoder::Format subscriber_format(
+    const UsbVideoSubscriber* subscriber) {
+  return subscriber->options.gray4 ? usb_video::FrameEncoder::kGray4
+                                   : usb_video::FrameEncoder::kBmp;
+}
+
+// Capture thread: wakes the main loop to deliver whatever is newest. Only
+// the first request after a delivery touches the eventfd.
+static void request_delivery(UsbVideoSession* session) {
+  if (!session->delivery_pending.exchange(true)) {
+    eventfd_write(session->frame_ready_fd, 1);
+  }
+}
+
+// Asks the capture thread for the controller's current target, if that is
+// not what it was last asked for.
+static void request_frame_interval(UsbVideoSession* session) {
+  if (!session->rate_controller.has_target()) {
+    return;
+  }
+  uint64_t target = pack_interval(session->rate_controller.target());
+  if (target != session->requested_interval) {
+    session->requested_interval = target;
+    session->pending_interval = target;
+  }
+}
+
+// Uses the shortest keep-alive any subscriber wants. One suppressor serves
+// them all, so a subscriber that wants every frame turns suppression off.
+static void update_keep_alive(UsbVideoSession* session) {
+  int64_t keep_alive_us = 0;
+  for (const UsbVideoSubscriber* subscriber : session->subscribers) {
+    int64_t wanted = subscriber->options.keep_alive_us;
+    if (wanted <= 0) {
+      keep_alive_us = 0;
+      break;
+    }
+    keep_alive_us = keep_alive_us > 0 ? std::min(keep_alive_us, wanted) : wanted;
+  }
+  if (keep_alive_us != session->suppressor.keep_alive_us()) {
+    g_print("[USB Video] Keep-alive now %" G_GINT64_FORMAT " ms\n",
+            static_cast<gint64>(keep_alive_us / 1000));
+    session->suppressor.SetKeepAlive(keep_alive_us);
+  }
+}
+
+// Caps the capture rate at the fastest any subscriber wants.
+static void update_frame_rate_cap(UsbVideoSession* session) {
+  double max_fps = 0;
+  for (const UsbVideoSubscriber* subscriber : session->subscribers) {
+    double wanted = subscriber->options.max_fps;
+    if (!subscriber->focused) {
+      wanted = wanted > 0 ? std::min(wanted, kUnfocusedMaxFps) : kUnfocusedMaxFps;
+    }
+    if (session->hidden_keep_alive) {
+      wanted = kHiddenMaxFps;
+    }
+    if (wanted <= 0) {
+      max_fps = 0;
+      break;
+    }
+    max_fps = std::max(max_fps, wanted);
+  }
+  session->rate_controller.set_max_fps(max_fps);
+  request_frame_interval(session);
+}
+
+// Answers the waiting screenshot requests: with the frame the capture
+// thread copied, if there is one, or with nothing when |fail| says none
+// will come.
+static void send_screenshots(UsbVideoSession* session, bool fail) {
+  if (session->screenshot_requests.empty()) {
+    return;
+  }
+  g_autoptr(GBytes) png = nullptr;
+  if (session->screenshot_ready) {
+    session->screenshot_wanted = false;
+    if (session->screenshot_encoder.EncodeYuyv(session->screenshot_frame.data(),
+                                               session->width, session->height)) {
+      png = g_bytes_new(session->screenshot_encoder.data(), session->screenshot_encoder.size());
+    }
+  } else if (!fail) {
+    return;
+  }
+  // Callbacks may ask for another screenshot; that one waits for a new frame.
+  std::vector<std::pair<UsbVideoScreenshotCallback, gpointer>> requests;
+  requests.swap(session->screenshot_requests);
+  session->screenshot_wanted = false;
+  session->screenshot_ready = false;
+  for (const auto& request : requests) {
+    request.first(png, request.second);
+  }
+}
+
+// Pauses capture, or slows it to a keep-alive, while no subscriber's window
+// can be seen, and wakes the capture thread to resume as soon as one can.
+static void update_hidden_mode(UsbVideoSession* session) {
+  bool any_visible = false;
+  bool all_pause = true;
+  for (const UsbVideoSubscriber* subscriber : session->subscribers) {
+    any_visible = any_visible || subscriber->visible;
+    all_pause = all_pause && subscriber->options.pause_when_hidden;
+  }
+  const bool hidden = !session->subscribers.empty() && !any_visible;
+  const bool pause = hidden && all_pause;
+  if (session->hidden_keep_alive != (hidden && !pause)) {
+    session->hidden_keep_alive = hidden && !pause;
+    g_print("[USB Video] %s\n", session->hidden_keep_alive
+                                    ? "All windows hidden, slowing capture to a keep-alive"
+                                    : "Capture back to full rate");
+  }
+  if (session->pause_requested != pause) {
+    session->pause_requested = pause;
+    if (session->backend != nullptr) {
+      session->backend->Wake();
+    }
+    // No frame will come for a screenshot while paused.
+    if (pause) {
+      send_screenshots(session, true);
+    }
+  }
+  // Receivers stop hearing from a paused session, so they are told why
+  // rather than left to take it for a stall.
+  if (session->pause_reported != pause) {
+    session->pause_reported = pause;
+    for (UsbVideoSubscriber* subscriber : session->subscribers) {
+      if (subscriber->callbacks->paused != nullptr) {
+        subscriber->callbacks->paused(pause, subscriber->user_data);
+      }
+    }
+  }
+  update_frame_rate_cap(session);
+}
+
+// Steps the capture rate down while the receivers miss frames, whether a
+// channel listener's main loop or a texture's raster thread is the one
+// falling behind, and back up once they keep up again.
+static void update_frame_rate(UsbVideoSession* session) {
+  uint64_t offered = session->frame_buffer.produced() +
+                     session->texture_offered.load(std::memory_order_relaxed);
+  uint64_t missed = session->frame_buffer.overwritten() +
+                    session->texture_missed.load(std::memory_order_relaxed);
+  if (session->rate_controller.Update(offered, missed, g_get_monotonic_time())) {
+    g_print("[USB Video] Frame rate now %.2f fps (%d steps down)\n",
+            session->rate_controller.target().fps(),
+            session->rate_controller.step_down());
+    request_frame_interval(session);
+  }
+}
+
+static void send_texture_heartbeats(UsbVideoSession* session) {
+  uint64_t frames = session->texture_frames.load(std::memory_order_relaxed);
+  for (UsbVideoSubscriber* subscriber : session->subscribers) {
+    if (subscriber->texture == nullptr || !subscriber->active ||
+        frames == subscriber->heartbeat_frames) {
+      continue;
+    }
+    subscriber->heartbeat_frames = frames;
+    if (subscriber->callbacks->heartbeat != nullptr) {
+      subscriber->callbacks->heartbeat(frames, subscriber->user_data);
+    }
+  }
+}
+
+// Converts and encodes the newest frame once per format that an active
+// subscriber wants, then hands each subscriber its payload.
+static void send_pending_frames(UsbVideoSession* session) {
+  if (session->channel_listeners == 0) {
+    return;
+  }
+
+  // Only the newest frame is ever sent; anything published in between was
+  // already overwritten in place by the capture thread.
+  if (!session->frame_buffer.TakeLatest()) {
+    return;
+  }
+  // A short capture leaves the rest of the previous picture in the scratch
+  // buffer rather than reading past the end of the snapshot.
+  const usb_video::FrameSlot& raw = session->frame_buffer.read_slot();
+  if (raw.size == 0) {
+    return;
+  }
+
+  usb_video::FrameEncoder::Request request = {};
+  for (const UsbVideoSubscriber* subscriber : session->subscribers) {
+    if (is_channel_listener(subscriber)) {
+      (subscriber->options.delta_frames ? request.delta
+                                        : request.full)[subscriber_format(subscriber)] = true;
+    }
+  }
+
+  usb_video::PipelineTelemetry* telemetry = &session->telemetry;
+  gint64 picked_up = g_get_monotonic_time();
+  telemetry->Record(usb_video::PipelineTelemetry::kQueueWait,
+                    picked_up - raw.published_us);
+
+  // Slots are full-frame sized, so a short capture encodes whatever the
+  // slot held past it instead of reading out of bounds.
+  usb_video::FrameEncoder* encoder = &session->encoder;
+  usb_video::FrameEncoder::Timing timing = encoder->Encode(raw.data, raw.size, request);
+  telemetry->Record(usb_video::PipelineTelemetry::kConvert, timing.convert_us);
+  if (timing.encoded) {
+    telemetry->Record(usb_video::PipelineTelemetry::kEncode, timing.encode_us);
+  }
+  gint64 encoded_time = g_get_monotonic_time();
+
+  // The codec copies the bytes into each platform message, so the encoder's
+  // buffers can be reused for the next frame straight away.
+  for (UsbVideoSubscriber* subscriber : session->subscribers) {
+    if (!is_channel_listener(subscriber)) {
+      continue;
+    }
+    usb_video::FrameEncoder::Format format = subscriber_format(subscriber);
+    usb_video::DeltaFrameEncoder::Output payload = encoder->full(format);
+    if (subscriber->options.delta_frames) {
+      payload = encoder->delta(format);
+      if (payload.keyframe) {
+        subscriber->keyframes_sent++;
+      }
+    }
+    if (subscriber->callbacks->frame != nullptr) {
+      subscriber->callbacks->frame(payload.data, payload.size, subscriber->user_data);
+    }
+    subscriber->bytes_sent += payload.size;
+    subscriber->frames_sent++;
+  }
+  telemetry->Record(usb_video::PipelineTelemetry::kSend,
+                    g_get_monotonic_time() - encoded_time);
+  session->frames_delivered.fetch_add(1, std::memory_order_relaxed);
+}
+
+static FlValue* telemetry_histogram_value(const usb_video::LatencyHistogram& histogram) {
+  usb_video::LatencyHistogram::Summary summary = histogram.Summarize();
+  FlValue* value = fl_value_new_map();
+  fl_value_set_string_take(value, "count", fl_value_new_int(static_cast<int64_t>(summary.count)));
+  fl_value_set_string_take(value, "minUs", fl_value_new_int(summary.min_us));
+  fl_value_set_string_take(value, "meanUs", fl_value_new_int(summary.mean_us));
+  fl_value_set_string_take(value, "p50Us", fl_value_new_int(summary.p50_us));
+  fl_value_set_string_take(value, "p90Us", fl_value_new_int(summary.p90_us));
+  fl_value_set_string_take(value, "p99Us", fl_value_new_int(summary.p99_us));
+  fl_value_set_string_take(value, "maxUs", fl_value_new_int(summary.max_us));
+  return value;
+}
+
+// CPU time the capture thread has used, read from the main thread through
+// the thread's CPU clock so the capture loop itself pays nothing for it.
+static int64_t capture_thread_cpu_us(UsbVideoSession* session) {
+  if (session->capture_thread == nullptr) {
+    return 0;
+  }
+  clockid_t clock;
+  struct timespec cpu;
+  if (pthread_getcpuclockid(session->capture_thread->native_handle(), &clock) != 0 ||
+      clock_gettime(clock, &cpu) != 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(cpu.tv_sec) * 1000000 + cpu.tv_nsec / 1000;
+}
+
+// Sends a telemetry report to the subscribers that want one when it is due.
+// Reports ride on frame deliveries, so a stalled stream stops reporting too.
+static void send_telemetry(UsbVideoSession* session) {
+  bool wanted = false;
+  for (const UsbVideoSubscriber* subscriber : session->subscribers) {
+    wanted = wanted || (subscriber->active && subscriber->wants_telemetry);
+  }
+  usb_video::PipelineTelemetry* telemetry = &session->telemetry;
+  gint64 now = g_get_monotonic_time();
+  if (!wanted || !telemetry->StartNextWindow(now)) {
+    return;
+  }
+
+  uint64_t captured = session->suppressor.frames_seen();
+  uint64_t suppressed = session->suppressor.frames_suppressed();
+  uint64_t delivered = session->frames_delivered.load(std::memory_order_relaxed);
+  int64_t cpu_us = capture_thread_cpu_us(session);
+
+  g_autoptr(FlValue) report = fl_value_new_map();
+  fl_value_set_string_take(report, "type", fl_value_new_string("videoTelemetry"));
+  fl_value_set_string_take(report, "session", fl_value_new_int(static_cast<int64_t>(session->session_id)));
+  fl_value_set_string_take(report, "sessionMs", fl_value_new_int(telemetry->session_us(now) / 1000));
+  fl_value_set_string_take(report, "windowMs", fl_value_new_int(telemetry->window_us() / 1000));
+  fl_value_set_string_take(report, "subscribers",
+                           fl_value_new_int(static_cast<int64_t>(session->subscribers.size())));
+  for (int i = 0; i < usb_video::PipelineTelemetry::kStageCount; ++i) {
+    auto stage = static_cast<usb_video::PipelineTelemetry::Stage>(i);
+    fl_value_set_string_take(report, usb_video::PipelineTelemetry::StageName(stage),
+                             telemetry_histogram_value(telemetry->histogram(stage)));
+  }
+  fl_value_set_string_take(report, "framesCaptured", fl_value_new_int(static_cast<int64_t>(captured)));
+  fl_value_set_string_take(report, "framesDelivered", fl_value_new_int(static_cast<int64_t>(delivered)));
+  fl_value_set_string_take(report, "framesSuppressed", fl_value_new_int(static_cast<int64_t>(suppressed)));
+  fl_value_set_string_take(report, "framesOverwritten",
+                           fl_value_new_int(static_cast<int64_t>(session->frame_buffer.overwritten())));
+  fl_value_set_string_take(report, "framesDroppedByDriver",
+                           fl_value_new_int(static_cast<int64_t>(session->driver_dropped_frames.load())));
+  fl_value_set_string_take(
+      report, "captureFps",
+      fl_value_new_float(telemetry->WindowRate(usb_video::PipelineTelemetry::kFramesCaptured, captured)));
+  fl_value_set_string_take(
+      report, "deliveredFps",
+      fl_value_new_float(telemetry->WindowRate(usb_video::PipelineTelemetry::kFramesDelivered, delivered)));
+  fl_value_set_string_take(
+      report, "frameRate",
+      fl_value_new_float(unpack_interval(session->capture_interval.load()).fps()));
+  fl_value_set_string_take(report, "frameRateStepDown",
+                           fl_value_new_int(session->rate_controller.step_down()));
+  fl_value_set_string_take(report, "captureThreadCpuMs", fl_value_new_int(cpu_us / 1000));
+  // CPU microseconds per second of wall time, as a percentage of one core.
+  fl_value_set_string_take(
+      report, "captureThreadCpuPercent",
+      fl_value_new_float(telemetry->WindowRate(usb_video::PipelineTelemetry::kCaptureCpuUs,
+                                               static_cast<uint64_t>(cpu_us)) / 1e4));
+
+  for (UsbVideoSubscriber* subscriber : session->subscribers) {
+    if (subscriber->active && subscriber->wants_telemetry &&
+        subscriber->callbacks->telemetry != nullptr) {
+      subscriber->callbacks->telemetry(report, subscriber->user_data);
+    }
+  }
+}
+
+// Main loop side of request_delivery.
+static gboolean on_frame_ready(gint fd, GIOCondition condition, gpointer user_data) {
+  UsbVideoSession* session = static_cast<UsbVideoSession*>(user_data);
+  // Re-arm before draining and taking the frame: anything published from
+  // here on raises a fresh wakeup instead of being stranded until the next.
+  session->delivery_pending = false;
+  eventfd_t count;
+  eventfd_read(fd, &count);
+  if (session->heartbeat_due.exchange(false)) {
+    send_texture_heartbeats(session);
+  }
+  send_pending_frames(session);
+  send_screenshots(session, false);
+  update_frame_rate(session);
+  send_telemetry(session);
+  return G_SOURCE_CONTINUE;
+}
+
+static void stop_capture(UsbVideoSession* session) {
+  usb_video_session_stop_recording(nullptr);
+  usb_video_session_stop_export(nullptr);
+
+  if (session->capturing) {
+    session->capturing = false;
+    session->backend->Wake();
+    if (session->capture_thread) {
+      session->capture_thread->join();
+      delete session->capture_thread;
+      session->capture_thread = nullptr;
+    }
+  }
+
+  // The capture thread is gone, so nothing signals frame_ready_fd any more.
+  if (session->delivery_source_id != 0) {
+    g_source_remove(session->delivery_source_id);
+    session->delivery_source_id = 0;
+  }
+  if (session->frame_ready_fd >= 0) {
+    close(session->frame_ready_fd);
+    session->frame_ready_fd = -1;
+  }
+  session->delivery_pending = false;
+  session->heartbeat_due = false;
+  send_screenshots(session, true);
+
+  if (session->backend != nullptr) {
+    session->backend->Stop();
+    delete session->backend;
+    session->backend = nullptr;
+  }
+  session->device_path.clear();
+}
+
+// Backends stamp frames with CLOCK_MONOTONIC at capture, so the difference
+// from "now" is how long the frame waited to be picked up.
+static void record_dequeue_latency(UsbVideoSession* session,
+                                   const usb_video::CapturedFrame& frame) {
+  if (frame.timestamp_us <= 0) {
+    return;
+  }
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  int64_t now_us = static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+  if (now_us < frame.timestamp_us) {
+    return;
+  }
+  session->dequeue_latency.Record(now_us - frame.timestamp_us);
+  session->telemetry.Record(usb_video::PipelineTelemetry::kDequeue,
+                            now_us - frame.timestamp_us);
+}
+
+// Copies a frame into every texture subscriber's texture. Returns false if
+// there are none.
+static bool write_textures(UsbVideoSession* session, const uint8_t* yuyv, size_t size,
+                           bool deliver) {
+  std::lock_guard<std::mutex> lock(session->texture_lock);
+  if (session->texture_subscribers.empty()) {
+    return false;
+  }
+  if (!deliver) {
+    return true;
+  }
+  for (UsbVideoSubscriber* subscriber : session->texture_subscribers) {
+    memcpy(usb_video_texture_begin_write(subscriber->texture), yuyv, size);
+    if (usb_video_texture_end_write(subscriber->texture)) {
+      session->texture_missed.fetch_add(1, std::memory_order_relaxed);
+    }
+    session->texture_offered.fetch_add(1, std::memory_order_relaxed);
+    // The texture registrar is safe to poke from any thread, and the
+    // texture outlives its place in this list (unsubscribe removes it
+    // under the lock before unregistering).
+    fl_texture_registrar_mark_texture_frame_available(
+        subscriber->texture_registrar, FL_TEXTURE(subscriber->texture));
+  }
+  return true;
+}
+
+// Hands a frame to the recorder, stamped with the backend's capture time.
+// Costs a copy into the recorder's queue, or nothing if the queue is full.
+static void record_frame(UsbVideoSession* session, const usb_video::CapturedFrame& frame) {
+  std::lock_guard<std::mutex> lock(session->recording_lock);
+  if (session->recorder != nullptr) {
+    session->recorder->Submit(frame.data, frame.size, frame.timestamp_us, frame.sequence);
+  }
+}
+
+// Publishes a frame to the shared-memory export. Never waits: while
+// usb_video_session_stop_export holds the lock the frame is left out.
+static void export_frame(UsbVideoSession* session, const usb_video::CapturedFrame& frame) {
+  std::unique_lock<std::mutex> lock(session->export_lock, std::try_to_lock);
+  if (lock.owns_lock() && session->frame_export != nullptr) {
+    session->frame_export->Publish(frame.data, frame.size, frame.timestamp_us, frame.sequence);
+  }
+}
+
+// Capture thread: switches the backend to the interval the main thread
+// asked for, if any. Returns false if the sequence numbers may have
+// restarted, as they do when V4L2 restarts streaming.
+static bool apply_frame_interval(UsbVideoSession* session) {
+  uint64_t pending = session->pending_interval.exchange(0);
+  if (pending == 0) {
+    return true;
+  }
+  usb_video::CaptureBackend* backend = session->backend;
+  if (!backend->SetFrameInterval(unpack_interval(pending))) {
+    g_warning("[USB Video] Cannot change frame rate: %s", backend->error().c_str());
+  } else {
+    g_print("[USB Video] Capturing at %.2f fps\n", backend->frame_interval().fps());
+  }
+  session->capture_interval = pack_interval(backend->frame_interval());
+  return false;
+}
+
+// Capture thread: pauses or resumes the backend as the main thread asked.
+// Returns false if the backend failed to.
+static bool apply_pause(UsbVideoSession* session) {
+  usb_video::CaptureBackend* backend = session->backend;
+  const bool pause = session->pause_requested;
+  if (pause == backend->paused()) {
+    return true;
+  }
+  if (!(pause ? backend->Pause() : backend->Resume())) {
+    g_warning("[USB Video] Cannot %s capture: %s", pause ? "pause" : "resume",
+              backend->error().c_str());
+    return false;
+  }
+  session->capture_paused = pause;
+  g_print("[USB Video] Capture %s\n", pause ? "paused" : "resumed");
+  return true;
+}
+
+static void capture_frames(UsbVideoSession* session) {
+  usb_video::CaptureBackend* backend = session->backend;
+  usb_video::CapturedFrame frame;
+  int frame_count = 0;
+  gint64 next_heartbeat_us = 0;
+  gint64 next_hidden_frame_us = 0;
+  bool have_sequence = false;
+  uint32_t last_sequence = 0;
+
+  g_print("[USB Video] Capture thread running (%s backend, %s YUYV kernel)\n",
+          backend->name(), usb_video::ActiveYuyvKernel().name);
+
+  while (session->capturing) {
+    if (!apply_frame_interval(session)) {
+      have_sequence = false;
+    }
+    if (session->pause_requested != backend->paused()) {
+      if (!apply_pause(session)) {
+        break;
+      }
+      have_sequence = false;
+    }
+    // Sleep until the backend has a frame or stop_capture wakes us.
+    usb_video::CaptureBackend::Result result = backend->Next(&frame);
+    if (result == usb_video::CaptureBackend::kRetry) {
+      continue;
+    }
+    if (result == usb_video::CaptureBackend::kWoken) {
+      // Either stop_capture or a pause change; the loop sorts out which.
+      continue;
+    }
+    if (result == usb_video::CaptureBackend::kError) {
+      g_warning("[USB Video] Capture failed, stopping: %s", backend->error().c_str());
+      break;
+    }
+    record_dequeue_latency(session, frame);
+    if (have_sequence && frame.sequence - last_sequence > 1) {
+      session->driver_dropped_frames.fetch_add(frame.sequence - last_sequence - 1,
+                                               std::memory_order_relaxed);
+    }
+    have_sequence = true;
+    last_sequence = frame.sequence;
+
+    const uint8_t* yuyv = frame.data;
+    if (session->recording) {
+      record_frame(session, frame);
+    }
+    if (session->exporting) {
+      export_frame(session, frame);
+    }
+    if (session->screenshot_wanted && !session->screenshot_ready) {
+      memcpy(session->screenshot_frame.data(), frame.data,
+             std::min(frame.size, session->screenshot_frame.size()));
+      session->screenshot_ready = true;
+      request_delivery(session);
+    }
+    size_t frame_bytes = static_cast<size_t>(session->width) * session->height * 2;
+    size_t size = std::min(frame.size, frame_bytes);
+
+    // One suppression decision per frame serves every subscriber. Nothing
+    // is done without a texture or a listener.
+    bool has_textures = session->texture_count > 0;
+    bool has_listeners = session->channel_listeners > 0;
+    bool deliver = false;
+    gint64 now = g_get_monotonic_time();
+    if (session->hidden_keep_alive && now < next_hidden_frame_us) {
+      // Hidden: nobody is looking, so skip even the suppressor's hash.
+    } else if (has_textures || has_listeners) {
+      deliver = session->suppressor.ShouldDeliver(yuyv, size, now);
+      if (deliver && session->hidden_keep_alive) {
+        next_hidden_frame_us = now + kHiddenFrameGapUs;
+      }
+    } else if (frame_count % 30 == 0) {  // Log periodically
+      g_print("[USB Video] Warning: no active subscribers, frames not being sent\n");
+    }
+
+    // Texture delivery: hand the raw frame to the textures, which convert
+    // it on the raster thread only when their engine actually draws it. No
+    // BMP, no channel copy, no Dart decode.
+    if (has_textures && write_textures(session, yuyv, size, deliver)) {
+      // Counts captured frames, suppressed or not, so the heartbeat keeps
+      // ticking while the picture is static.
+      session->texture_frames.fetch_add(1, std::memory_order_relaxed);
+      if (deliver && !has_listeners) {
+        session->frames_delivered.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (now >= next_heartbeat_us) {
+        next_heartbeat_us = now + kTextureHeartbeatIntervalUs;
+        session->heartbeat_due = true;
+        request_delivery(session);
+      }
+    }
+
+    // Snapshot the raw frame for the main thread, which converts and encodes
+    // only the frame it actually sends. Frames overwritten before then cost a
+    // copy, not a conversion.
+    if (has_listeners && deliver) {
+      frame_count++;
+
+      usb_video::FrameSlot& raw = session->frame_buffer.write_slot();
+      raw.size = size;
+      raw.published_us = now;
+      raw.captured_us = frame.timestamp_us;
+      memcpy(raw.data, yuyv, raw.size);
+
+      if (frame_count % 30 == 1) {  // Log every 30th frame to avoid spam
+        usb_video::LatencyStats::Snapshot latency = session->dequeue_latency.Read();
+        g_print("[USB Video] Queueing frame %d, YUYV size=%zu bytes, "
+                "dequeue latency mean=%" G_GINT64_FORMAT "us max=%" G_GINT64_FORMAT "us\n",
+                frame_count, raw.size, latency.mean_us, latency.max_us);
+      }
+
+      session->frame_buffer.Publish();
+      request_delivery(session);
+    }
+
+    if (!backend->Release(frame)) {
+      g_warning("[USB Video] Capture failed, stopping: %s", backend->error().c_str());
+      break;
+    }
+  }
+}
+
+// Picks the backend for |device_path|: a V4L2 node, or a synthetic source.
+static usb_video::CaptureBackend* create_backend(const char* device_path) {
+  const size_t prefix_length = sizeof(kSyntheticDevicePrefix) - 1;
+  if (strncmp(device_path, kSyntheticDevicePrefix, prefix_length) != 0) {
+    return new usb_video::V4l2CaptureBackend(device_path);
+  }
+  usb_video::SyntheticCaptureBackend::Options options;
+  if (!usb_video::SyntheticCaptureBackend::ParseOptions(device_path + prefix_length,
+                                                        &options)) {
+    g_warning("[USB Video] Bad synthetic source: %s", device_path);
+    return nullptr;
+  }
+  return new usb_video::SyntheticCaptureBackend(options);
+}
+
+static bool start_capture(UsbVideoSession* session, const char* device_path,
+                          const UsbVideoStreamOptions& options) {
+  g_print("[USB Video] Starting video stream for device: %s\n", device_path);
+
+  session->backend = create_backend(device_path);
+  if (session->backend == nullptr) {
+    return false;
+  }
+  if (!session->backend->Start(kFrameWidth, kFrameHeight)) {
+    g_warning("[USB Video] Cannot start %s: %s", device_path,
+              session->backend->error().c_str());
+    stop_capture(session);
+    return false;
+  }
+  session->width = session->backend->width();
+  session->height = session->backend->height();
+  g_print("[USB Video] Streaming %ux%u YUYV from %s backend\n", session->width,
+          session->height, session->backend->name());
+  session->rate_controller.Reset(session->backend->frame_intervals(), g_get_monotonic_time());
+  session->pause_requested = false;
+  session->hidden_keep_alive = false;
+  session->capture_paused = false;
+  session->pause_reported = false;
+  session->requested_interval = pack_interval(session->backend->frame_interval());
+  session->pending_interval = 0;
+  session->capture_interval = session->requested_interval;
+
+  session->frame_ready_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (session->frame_ready_fd == -1) {
+    g_warning("[USB Video] Failed to create eventfd: %s", strerror(errno));
+    stop_capture(session);
+    return false;
+  }
+  session->dequeue_latency.Reset();
+  session->telemetry.Reset(g_get_monotonic_time());
+  session->driver_dropped_frames = 0;
+  session->frames_delivered = 0;
+  session->texture_frames = 0;
+  session->texture_offered = 0;
+  session->texture_missed = 0;
+  session->session_id++;
+  session->suppressor.Reset(options.keep_alive_us);
+
+  // Size the frame buffers for this format before the capture thread
+  // starts, so the hot path never allocates.
+  size_t frame_bytes = session->backend->frame_size();
+  session->screenshot_frame.assign(frame_bytes, 0);
+  if (!session->frame_pool.Reserve(kHandoffSlots, frame_bytes) ||
+      !session->encoder.Reset(session->width, session->height, kDeltaKeyframeInterval)) {
+    g_warning("[USB Video] Failed to allocate frame buffers");
+    stop_capture(session);
+    return false;
+  }
+  size_t next_slot = 0;
+  session->frame_buffer.Reset([session, &next_slot, frame_bytes](usb_video::FrameSlot& slot) {
+    slot.data = session->frame_pool.slot(next_slot++);
+    slot.size = 0;
+    slot.published_us = 0;
+    slot.captured_us = 0;
+    memset(slot.data, 0, frame_bytes);
+  });
+  session->device_path = device_path;
+
+  // Start capture thread
+  session->capturing = true;
+  session->capture_thread = new std::thread(capture_frames, session);
+  g_print("[USB Video] Capture thread started\n");
+
+  // Deliver frames to Flutter as the capture thread signals them (only
+  // while capturing); the main loop sleeps while nothing new arrives.
+  session->delivery_source_id =
+      g_unix_fd_add(session->frame_ready_fd, G_IO_IN, on_frame_ready, session);
+
+  return true;
+}
+
+// Registers a texture for |subscriber| with its own engine, then starts
+// feeding it frames.
+static bool attach_texture(UsbVideoSession* session, UsbVideoSubscriber* subscriber) {
+  if (subscriber->texture_registrar == nullptr) {
+    g_warning("[USB Video] Texture delivery requested but no texture registrar");
+    return false;
+  }
+  subscriber->texture = usb_video_texture_new(session->width, session->height);
+  if (!fl_texture_registrar_register_texture(subscriber->texture_registrar,
+                                             FL_TEXTURE(subscriber->texture))) {
+    g_warning("[USB Video] Failed to register video texture");
+    g_clear_object(&subscriber->texture);
+    return false;
+  }
+  subscriber->heartbeat_frames = 0;
+  g_print("[USB Video] Registered video texture id=%" G_GINT64_FORMAT "\n",
+          fl_texture_get_id(FL_TEXTURE(subscriber->texture)));
+
+  {
+    std::lock_guard<std::mutex> lock(session->texture_lock);
+    session->texture_subscribers.push_back(subscriber);
+    session->texture_count = static_cast<int>(session->texture_subscribers.size());
+  }
+  // The texture starts empty; don't leave it so until the keep-alive.
+  session->suppressor.ForceNext();
+  return true;
+}
+
+static void detach_texture(UsbVideoSession* session, UsbVideoSubscriber* subscriber) {
+  if (subscriber->texture == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(session->texture_lock);
+    std::vector<UsbVideoSubscriber*>& list = session->texture_subscribers;
+    list.erase(std::remove(list.begin(), list.end(), subscriber), list.end());
+    session->texture_count = static_cast<int>(list.size());
+  }
+  // Out of the list, so the capture thread no longer writes to it and it
+  // can be handed back to the engine.
+  fl_texture_registrar_unregister_texture(subscriber->texture_registrar,
+                                          FL_TEXTURE(subscriber->texture));
+  g_clear_object(&subscriber->texture);
+}
+
+const char* usb_video_session_get_device() {
+  UsbVideoSession* session = default_session();
+  return session->subscribers.empty() ? nullptr : session->device_path.c_str();
+}
+
+UsbVideoSubscriber* usb_video_session_subscribe(
+    const char* device_path, const UsbVideoStreamOptions* options,
+    FlTextureRegistrar* texture_registrar,
+    const UsbVideoSubscriberCallbacks* callbacks, gpointer user_data) {
+  UsbVideoSession* session = default_session();
+  if (session->subscribers.empty()) {
+    if (!start_capture(session, device_path, *options)) {
+      return nullptr;
+    }
+  } else if (session->device_path != device_path) {
+    g_warning("[USB Video] %s requested while streaming %s", device_path,
+              session->device_path.c_str());
+    return nullptr;
+  } else {
+    g_print("[USB Video] Joining capture session on %s (%zu subscribers)\n",
+            device_path, session->subscribers.size());
+  }
+
+  UsbVideoSubscriber* subscriber = new UsbVideoSubscriber();
+  subscriber->options = *options;
+  subscriber->callbacks = callbacks;
+  subscriber->user_data = user_data;
+  subscriber->active = false;
+  subscriber->wants_telemetry = false;
+  subscriber->focused = true;
+  subscriber->visible = true;
+  subscriber->texture_registrar = texture_registrar;
+  subscriber->texture = nullptr;
+  subscriber->heartbeat_frames = 0;
+  subscriber->frames_sent = 0;
+  subscriber->keyframes_sent = 0;
+  subscriber->bytes_sent = 0;
+  if (options->use_texture && !attach_texture(session, subscriber)) {
+    delete subscriber;
+    if (session->subscribers.empty()) {
+      stop_capture(session);
+    }
+    return nullptr;
+  }
+  session->subscribers.push_back(subscriber);
+  update_keep_alive(session);
+  update_hidden_mode(session);
+  return subscriber;
+}
+
+void usb_video_session_unsubscribe(UsbVideoSubscriber* subscriber) {
+  if (subscriber == nullptr) {
+    return;
+  }
+  UsbVideoSession* session = default_session();
+  usb_video_subscriber_set_active(subscriber, FALSE);
+  detach_texture(session, subscriber);
+  std::vector<UsbVideoSubscriber*>& list = session->subscribers;
+  list.erase(std::remove(list.begin(), list.end(), subscriber), list.end());
+  delete subscriber;
+
+  if (list.empty()) {
+    g_print("[USB Video] Last subscriber left, stopping capture\n");
+    stop_capture(session);
+  } else {
+    update_keep_alive(session);
+    update_hidden_mode(session);
+  }
+}
+
+void usb_video_subscriber_set_active(UsbVideoSubscriber* subscriber,
+                                     gboolean active) {
+  if (subscriber->active == static_cast<bool>(active)) {
+    return;
+  }
+  UsbVideoSession* session = default_session();
+  if (subscriber->texture == nullptr) {
+    session->channel_listeners += active ? 1 : -1;
+  }
+  subscriber->active = active;
+  // A new listener has nothing to show while the picture is static, so the
+  // next frame goes out even if it is unchanged.
+  if (active) {
+    session->suppressor.ForceNext();
+  }
+  // A new listener has no picture to apply deltas to. Everyone else on the
+  // same delta stream gets an extra keyframe, which costs one frame's size.
+  if (active && subscriber->options.delta_frames) {
+    session->encoder.ForceKeyframe(subscriber_format(subscriber));
+  }
+}
+
+void usb_video_subscriber_set_focused(UsbVideoSubscriber* subscriber,
+                                      gboolean focused) {
+  if (subscriber->focused == static_cast<bool>(focused)) {
+    return;
+  }
+  subscriber->focused = focused;
+  update_frame_rate_cap(default_session());
+}
+
+void usb_video_subscriber_set_visible(UsbVideoSubscriber* subscriber,
+                                      gboolean visible) {
+  if (subscriber->visible == static_cast<bool>(visible)) {
+    return;
+  }
+  subscriber->visible = visible;
+  update_hidden_mode(default_session());
+}
+
+void usb_video_subscriber_set_telemetry(UsbVideoSubscriber* subscriber,
+                                        gboolean wanted) {
+  subscriber->wants_telemetry = wanted;
+}
+
+int64_t usb_video_subscriber_get_texture_id(UsbVideoSubscriber* subscriber) {
+  return subscriber->texture != nullptr
+             ? fl_texture_get_id(FL_TEXTURE(subscriber->texture))
+             : -1;
+}
+
+int64_t usb_video_session_set_telemetry_interval_us(int64_t interval_us) {
+  usb_video::PipelineTelemetry* telemetry = &default_session()->telemetry;
+  telemetry->set_interval_us(interval_us);
+  return telemetry->interval_us();
+}
+
+gboolean usb_video_session_start_recording(const char* path, gboolean gray4) {
+  UsbVideoSession* session = default_session();
+  if (!session->capturing || session->recorder != nullptr) {
+    return FALSE;
+  }
+  usb_video::RecordingWriter* recorder = new usb_video::RecordingWriter();
+  if (!recorder->Open(path, gray4 ? usb_video::kRecordingGray4 : usb_video::kRecordingYuyv,
+                      session->width, session->height)) {
+    g_warning("[USB Video] Cannot record to %s", path);
+    delete recorder;
+    return FALSE;
+  }
+  {
+    std::lock_guard<std::mutex> lock(session->recording_lock);
+    session->recorder = recorder;
+  }
+  session->recording = true;
+  g_print("[USB Video] Recording to %s\n", path);
+  return TRUE;
+}
+
+gboolean usb_video_session_stop_recording(FlValue* result) {
+  UsbVideoSession* session = default_session();
+  usb_video::RecordingWriter* recorder;
+  session->recording = false;
+  {
+    std::lock_guard<std::mutex> lock(session->recording_lock);
+    recorder = session->recorder;
+    session->recorder = nullptr;
+  }
+  if (recorder == nullptr) {
+    return FALSE;
+  }
+  // Drains the queue and writes the index on this thread; the capture
+  // thread has already let go of the recorder.
+  gboolean ok = recorder->Close();
+  g_print("[USB Video] Recording stopped: %" G_GUINT64_FORMAT " frames, %" G_GUINT64_FORMAT
+          " dropped, %" G_GUINT64_FORMAT " bytes\n",
+          recorder->frames_written(), recorder->frames_dropped(), recorder->bytes_written());
+  if (result != nullptr) {
+    fl_value_set_string_take(result, "framesWritten",
+                             fl_value_new_int(static_cast<int64_t>(recorder->frames_written())));
+    fl_value_set_string_take(result, "framesDropped",
+                             fl_value_new_int(static_cast<int64_t>(recorder->frames_dropped())));
+    fl_value_set_string_take(result, "bytesWritten",
+                             fl_value_new_int(static_cast<int64_t>(recorder->bytes_written())));
+  }
+  delete recorder;
+  return ok;
+}
+
+gboolean usb_video_session_request_screenshot(UsbVideoScreenshotCallback callback,
+                                              gpointer user_data) {
+  UsbVideoSession* session = default_session();
+  if (!session->capturing || session->pause_requested) {
+    return FALSE;
+  }
+  // Drop a frame left over from requests that were failed while the
+  // capture thread was copying it.
+  if (session->screenshot_requests.empty()) {
+    session->screenshot_ready = false;
+  }
+  session->screenshot_requests.emplace_back(callback, user_data);
+  session->screenshot_wanted = true;
+  return TRUE;
+}
+
+gboolean usb_video_session_start_export(const char* name, FlValue* result) {
+  UsbVideoSession* session = default_session();
+  if (!session->capturing || session->frame_export != nullptr) {
+    return FALSE;
+  }
+  if (name == nullptr) {
+    name = NTV_SHM_DEFAULT_NAME;
+  }
+  // Maps and touches the whole ring here, so publishing never faults.
+  usb_video::SharedFrameRing* ring = new usb_video::SharedFrameRing();
+  if (!ring->Create(name, session->width, session->height)) {
+    g_warning("[USB Video] Cannot export frames to %s: %s", name, ring->error().c_str());
+    delete ring;
+    return FALSE;
+  }
+  {
+    std::lock_guard<std::mutex> lock(session->export_lock);
+    session->frame_export = ring;
+  }
+  session->exporting = true;
+  g_print("[USB Video] Exporting frames to shared memory %s (%u slots, %zu bytes)\n", name,
+          ring->slot_count(), ring->mapped_size());
+  if (result != nullptr) {
+    fl_value_set_string_take(result, "name", fl_value_new_string(name));
+    fl_value_set_string_take(result, "width", fl_value_new_int(session->width));
+    fl_value_set_string_take(result, "height", fl_value_new_int(session->height));
+    fl_value_set_string_take(result, "slots", fl_value_new_int(ring->slot_count()));
+  }
+  return TRUE;
+}
+
+gboolean usb_video_session_stop_export(FlValue* result) {
+  UsbVideoSession* session = default_session();
+  usb_video::SharedFrameRing* ring;
+  session->exporting = false;
+  {
+    // The capture thread never holds this for longer than one publish.
+    std::lock_guard<std::mutex> lock(session->export_lock);
+    ring = session->frame_export;
+    session->frame_export = nullptr;
+  }
+  if (ring == nullptr) {
+    return FALSE;
+  }
+  g_print("[USB Video] Frame export stopped after %" G_GUINT64_FORMAT " frames\n",
+          ring->frames_published());
+  if (result != nullptr) {
+    fl_value_set_string_take(result, "framesExported",
+                             fl_value_new_int(static_cast<int64_t>(ring->frames_published())));
+  }
+  ring->Close();
+  delete ring;
+  return TRUE;
+}
+
+void usb_video_session_add_statistics(UsbVideoSubscriber* subscriber,
+                                      FlValue* result) {
+  UsbVideoSession* session = default_session();
+  usb_video::LatencyStats::Snapshot latency = session->dequeue_latency.Read();
+  fl_value_set_string_take(result, "capturing",
+                           fl_value_new_bool(subscriber != nullptr && session->capturing));
+  fl_value_set_string_take(result, "subscribers",
+                           fl_value_new_int(static_cast<int64_t>(session->subscribers.size())));
+  fl_value_set_string_take(result, "dequeueLatencySamples",
+                           fl_value_new_int(static_cast<int64_t>(latency.count)));
+  fl_value_set_string_take(result, "dequeueLatencyLastUs", fl_value_new_int(latency.last_us));
+  fl_value_set_string_take(result, "dequeueLatencyMinUs", fl_value_new_int(latency.min_us));
+  fl_value_set_string_take(result, "dequeueLatencyMaxUs", fl_value_new_int(latency.max_us));
+  fl_value_set_string_take(result, "dequeueLatencyMeanUs", fl_value_new_int(latency.mean_us));
+  fl_value_set_string_take(result, "framesProduced",
+                           fl_value_new_int(static_cast<int64_t>(session->frame_buffer.produced())));
+  fl_value_set_string_take(result, "framesDelivered",
+                           fl_value_new_int(static_cast<int64_t>(session->frame_buffer.delivered())));
+  fl_value_set_string_take(result, "framesOverwritten",
+                           fl_value_new_int(static_cast<int64_t>(session->frame_buffer.overwritten())));
+  fl_value_set_string_take(result, "framesSeen",
+                           fl_value_new_int(static_cast<int64_t>(session->suppressor.frames_seen())));
+  fl_value_set_string_take(result, "framesSuppressed",
+                           fl_value_new_int(static_cast<int64_t>(session->suppressor.frames_suppressed())));
+  fl_value_set_string_take(result, "keepAliveFrames",
+                           fl_value_new_int(static_cast<int64_t>(session->suppressor.keep_alive_frames())));
+  fl_value_set_string_take(result, "suppressionRatio",
+                           fl_value_new_float(session->suppressor.suppression_ratio()));
+  fl_value_set_string_take(result, "recording", fl_value_new_bool(session->recording));
+  fl_value_set_string_take(result, "exporting", fl_value_new_bool(session->exporting));
+  fl_value_set_string_take(result, "paused", fl_value_new_bool(session->capture_paused));
+  fl_value_set_string_take(result, "hiddenKeepAlive",
+                           fl_value_new_bool(session->hidden_keep_alive));
+
+  // The rates on offer are fixed by the backend until it stops, and the
+  // backend only goes away on this thread.
+  FlValue* rates = fl_value_new_list();
+  if (session->backend != nullptr) {
+    for (const usb_video::FrameInterval& interval : session->backend->frame_intervals()) {
+      fl_value_append_take(rates, fl_value_new_float(interval.fps()));
+    }
+  }
+  fl_value_set_string_take(result, "frameRates", rates);
+  fl_value_set_string_take(
+      result, "frameRate",
+      fl_value_new_float(unpack_interval(session->capture_interval.load()).fps()));
+  fl_value_set_string_take(result, "frameRateCap",
+                           fl_value_new_float(session->rate_controller.max_fps()));
+  fl_value_set_string_take(result, "frameRateStepDown",
+                           fl_value_new_int(session->rate_controller.step_down()));
+
+  bool delta = subscriber != nullptr && subscriber->options.delta_frames;
+  bool gray4 = subscriber != nullptr && subscriber->options.gray4;
+  uint64_t keyframes = subscriber != nullptr ? subscriber->keyframes_sent : 0;
+  uint64_t bytes = subscriber != nullptr ? subscriber->bytes_sent : 0;
+  fl_value_set_string_take(result, "deltaFrames", fl_value_new_bool(delta));
+  fl_value_set_string_take(result, "format", fl_value_new_string(gray4 ? "gray4" : "bmp"));
+  fl_value_set_string_take(result, "keyframesSent",
+                           fl_value_new_int(static_cast<int64_t>(keyframes)));
+  fl_value_set_string_take(result, "bytesSent", fl_value_new_int(static_cast<int64_t>(bytes)));
+}
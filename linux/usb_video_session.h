@@ -0,0 +1,259 @@
+#ifndef FLUTTER_USB_VIDEO_SESSION_H_
+#define FLUTTER_USB_VIDEO_SESSION_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Per-subscriber options from the startVideoStream arguments.
+struct UsbVideoStreamOptions {
+  // Render into a Flutter texture instead of sending BMP frames.
+  bool use_texture;
+  // Longest gap between deliveries while the picture is unchanged; zero or
+  // less sends every frame. The session uses the shortest any subscriber
+  // wants, and sends every frame while any subscriber asks for that.
+  int64_t keep_alive_us;
+  // Send dirty-row deltas against the previous frame instead of a full
+  // frame every time (see delta_frame.h).
+  bool delta_frames;
+  // Send packed 4-bit luma (see gray4.h) instead of 24-bit BMPs; the Dart
+  // side colours it through a palette. Ignored for texture delivery.
+  bool gray4;
+  // Highest frame rate this subscriber wants; zero or less takes whatever
+  // the device offers. The device runs at the fastest rate any subscriber
+  // wants, and slower while the receivers cannot keep up (see
+  // FrameRateController).
+  double max_fps;
+  // What to do while no subscriber's window can be seen: stop the device
+  // streaming altogether, or carry on at one frame a second. Capture
+  // pauses only if every subscriber agrees.
+  bool pause_when_hidden;
+};
+
+typedef struct _UsbVideoSubscriber UsbVideoSubscriber;
+
+/**
+ * UsbVideoSubscriberCallbacks:
+ * @frame: an encoded frame in the subscriber's format. The bytes are only
+ *   valid for the duration of the call.
+ * @heartbeat: texture subscribers only: the number of frames captured so
+ *   far, about once a second while it changes.
+ * @telemetry: a pipeline telemetry report (see PipelineTelemetry), for
+ *   subscribers that asked for them.
+ * @paused: capture paused or resumed because no subscriber's window can be
+ *   seen. Nothing arrives while paused, not even heartbeats.
+ *
+ * All callbacks run on the main thread, and only while the subscriber is
+ * active. Any of them may be %NULL.
+ */
+typedef struct {
+  void (*frame)(const uint8_t* data, size_t size, gpointer user_data);
+  void (*heartbeat)(uint64_t frames, gpointer user_data);
+  void (*telemetry)(FlValue* report, gpointer user_data);
+  void (*paused)(gboolean paused, gpointer user_data);
+} UsbVideoSubscriberCallbacks;
+
+/**
+ * UsbVideoScreenshotCallback:
+ * @png: the screenshot as a PNG file, or %NULL if capture stopped or paused
+ *   before a frame arrived.
+ * @user_data: what was passed to usb_video_session_request_screenshot().
+ */
+typedef void (*UsbVideoScreenshotCallback)(GBytes* png, gpointer user_data);
+
+/**
+ * usb_video_session_get_device:
+ *
+ * Returns: the device path the process-wide capture session is streaming
+ * from, or %NULL while nobody is subscribed.
+ */
+const char* usb_video_session_get_device();
+
+/**
+ * usb_video_session_subscribe:
+ * @device_path: the V4L2 node to stream from, or "synthetic:" followed by
+ *   a SyntheticCaptureBackend spec for a generated or replayed stream.
+ * @options: how this subscriber wants its frames.
+ * @texture_registrar: the subscriber's engine registrar; required for
+ *   texture delivery, since textures belong to one engine.
+ * @callbacks: where frames go; must outlive the subscription.
+ * @user_data: passed to @callbacks.
+ *
+ * Joins the process-wide capture session, opening @device_path and starting
+ * the capture thread if this is the first subscriber. Every window shares
+ * the one device, capture thread and conversion; each frame is encoded once
+ * per format and fanned out to the subscribers that want it. The caller
+ * must check usb_video_session_get_device() first: subscribing to a
+ * different device while the session is streaming fails.
+ *
+ * The new subscriber starts inactive; see usb_video_subscriber_set_active().
+ *
+ * Returns: a new subscription, or %NULL if the device could not be started.
+ */
+UsbVideoSubscriber* usb_video_session_subscribe(
+    const char* device_path, const UsbVideoStreamOptions* options,
+    FlTextureRegistrar* texture_registrar,
+    const UsbVideoSubscriberCallbacks* callbacks, gpointer user_data);
+
+/**
+ * usb_video_session_unsubscribe:
+ * @subscriber: a #UsbVideoSubscriber, or %NULL.
+ *
+ * Leaves the session; no callback runs for @subscriber after this returns.
+ * The last subscriber to leave stops capture and closes the device.
+ */
+void usb_video_session_unsubscribe(UsbVideoSubscriber* subscriber);
+
+/**
+ * usb_video_subscriber_set_active:
+ * @subscriber: a #UsbVideoSubscriber.
+ * @active: whether Dart is listening for this subscriber's frames.
+ *
+ * Frames are only encoded for active subscribers. Becoming active restarts
+ * a delta stream with a keyframe.
+ */
+void usb_video_subscriber_set_active(UsbVideoSubscriber* subscriber,
+                                     gboolean active);
+
+/**
+ * usb_video_subscriber_set_focused:
+ * @subscriber: a #UsbVideoSubscriber.
+ * @focused: whether the subscriber's window has the keyboard focus.
+ *
+ * Subscribers start out focused. An unfocused one is content with a few
+ * frames a second, so while no focused subscriber is left the device is
+ * asked for a slower rate.
+ */
+void usb_video_subscriber_set_focused(UsbVideoSubscriber* subscriber,
+                                      gboolean focused);
+
+/**
+ * usb_video_subscriber_set_visible:
+ * @subscriber: a #UsbVideoSubscriber.
+ * @visible: whether the subscriber's window can be seen, i.e. is mapped,
+ *   not minimized and not covered.
+ *
+ * Subscribers start out visible. Once none is left, capture pauses or
+ * drops to one frame a second (see UsbVideoStreamOptions), and picks up
+ * again as soon as one becomes visible.
+ */
+void usb_video_subscriber_set_visible(UsbVideoSubscriber* subscriber,
+                                      gboolean visible);
+
+/**
+ * usb_video_subscriber_set_telemetry:
+ * @subscriber: a #UsbVideoSubscriber.
+ * @wanted: whether to pass telemetry reports to @subscriber.
+ *
+ * Reports are only built while at least one subscriber wants them.
+ */
+void usb_video_subscriber_set_telemetry(UsbVideoSubscriber* subscriber,
+                                        gboolean wanted);
+
+/**
+ * usb_video_subscriber_get_texture_id:
+ * @subscriber: a #UsbVideoSubscriber.
+ *
+ * Returns: the id of the texture frames are rendered into, or -1 if
+ * @subscriber does not use texture delivery.
+ */
+int64_t usb_video_subscriber_get_texture_id(UsbVideoSubscriber* subscriber);
+
+/**
+ * usb_video_session_set_telemetry_interval_us:
+ * @interval_us: the shortest gap between telemetry reports; zero or less
+ *   turns them off.
+ *
+ * Applies to every subscriber and is kept across sessions.
+ *
+ * Returns: the interval actually used.
+ */
+int64_t usb_video_session_set_telemetry_interval_us(int64_t interval_us);
+
+/**
+ * usb_video_session_start_recording:
+ * @path: the recording file to create.
+ * @gray4: store packed 4-bit frames (see gray4.h) instead of raw YUYV.
+ *
+ * Records every captured frame, with its capture timestamp, to @path (see
+ * recording_format.h) until usb_video_session_stop_recording() or the end
+ * of the session. The capture thread only copies each frame into the
+ * recorder's bounded queue; compression and disk writes happen on the
+ * recorder's own thread, and frames it cannot keep up with are dropped
+ * from the recording rather than delaying the live picture.
+ *
+ * Returns: %FALSE if nothing is streaming, a recording is already running
+ * or @path cannot be created.
+ */
+gboolean usb_video_session_start_recording(const char* path, gboolean gray4);
+
+/**
+ * usb_video_session_stop_recording:
+ * @result: a map #FlValue to receive the recording's totals, or %NULL.
+ *
+ * Finishes the file, writing its keyframe index.
+ *
+ * Returns: %FALSE if nothing was recording or the file could not be
+ * written completely.
+ */
+gboolean usb_video_session_stop_recording(FlValue* result);
+
+/**
+ * usb_video_session_start_export:
+ * @name: the shared-memory object to create (a shm_open() name), or %NULL
+ *   for NTV_SHM_DEFAULT_NAME.
+ * @result: a map #FlValue to receive the export's name and geometry, or
+ *   %NULL.
+ *
+ * Publishes every captured frame, raw, into a ring in shared memory that
+ * other processes can map and read in place (see shared_frame_format.h)
+ * until usb_video_session_stop_export() or the end of the session. The
+ * capture thread only copies each frame into memory mapped in advance; it
+ * never waits on readers or on this call's counterpart.
+ *
+ * Returns: %FALSE if nothing is streaming, frames are already being
+ * exported or the object cannot be created.
+ */
+gboolean usb_video_session_start_export(const char* name, FlValue* result);
+
+/**
+ * usb_video_session_stop_export:
+ * @result: a map #FlValue to receive the export's totals, or %NULL.
+ *
+ * Marks the ring closed for its readers and removes its name.
+ *
+ * Returns: %FALSE if nothing was being exported.
+ */
+gboolean usb_video_session_stop_export(FlValue* result);
+
+/**
+ * usb_video_session_request_screenshot:
+ * @callback: called on the main thread with the screenshot.
+ * @user_data: passed to @callback.
+ *
+ * Renders the next captured frame as a screenshot (see screenshot.h), so
+ * the picture comes from the live stream rather than a SysEx round trip.
+ * The capture thread only copies the frame; it is encoded on the main
+ * thread, once for all the requests waiting on it.
+ *
+ * Returns: %FALSE, without calling @callback, if nothing is being captured
+ * or capture is paused.
+ */
+gboolean usb_video_session_request_screenshot(UsbVideoScreenshotCallback callback,
+                                              gpointer user_data);
+
+/**
+ * usb_video_session_add_statistics:
+ * @subscriber: a #UsbVideoSubscriber, or %NULL when not subscribed.
+ * @result: a map #FlValue.
+ *
+ * Adds the getStreamStatistics entries to @result: counters for the shared
+ * session (or the last one, when it has stopped), the frame rates the
+ * device offers and the one in use, and the format and byte counts of
+ * @subscriber.
+ */
+void usb_video_session_add_statistics(UsbVideoSubscriber* subscriber,
+                                      FlValue* result);
+
+#endif  // FLUTTER_USB_VIDEO_SESSION_H_
@@ -0,0 +1,134 @@
+#include "usb_video_texture.h"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "yuyv_convert.h"
+
+struct _UsbVideoTexture {
+  FlPixelBufferTexture parent_instance;
+
+  uint32_t width;
+  uint32_t height;
+
+  // Three raw YUYV buffers rotate between the capture thread (staging), the
+  // latest published frame (ready) and the one last converted on the raster
+  // thread (converted). Swapping pointers under the lock means neither side
+  // ever copies a frame or waits on the other for longer than a swap.
+  std::mutex* lock;
+  std::vector<uint8_t>* staging;
+  std::vector<uint8_t>* ready;
+  std::vector<uint8_t>* converted;
+  bool ready_is_fresh;
+
+  // RGBA8888 the engine uploads. Only touched on the raster thread, and only
+  // rewritten when a fresh frame is picked up, so frames the engine never
+  // draws are never converted.
+  std::vector<uint8_t>* rgba;
+};
+
+G_DEFINE_TYPE(UsbVideoTexture, usb_video_texture, fl_pixel_buffer_texture_get_type())
+
+// Called by the engine on the raster thread whenever the texture was marked
+// as having a new frame available.
+static gboolean usb_video_texture_copy_pixels(FlPixelBufferTexture* texture,
+                                              const uint8_t** out_buffer,
+                                              uint32_t* width,
+                                              uint32_t* height,
+                                              GError** error) {
+  UsbVideoTexture* self = USB_VIDEO_TEXTURE(texture);
+
+  bool fresh = false;
+  {
+    std::lock_guard<std::mutex> lock(*self->lock);
+    if (self->ready_is_fresh) {
+      std::swap(self->ready, self->converted);
+      self->ready_is_fresh = false;
+      fresh = true;
+    }
+  }
+  if (fresh) {
+    usb_video::ConvertYuyvToRgba(self->converted->data(),
+                                 static_cast<size_t>(self->width) * self->height,
+                                 self->rgba->data());
+  }
+
+  // The RGBA buffer is only rewritten by the next copy_pixels call, so it
+  // stays valid for the engine's upload after we return.
+  *out_buffer = self->rgba->data();
+  *width = self->width;
+  *height = self->height;
+  return TRUE;
+}
+
+static void usb_video_texture_dispose(GObject* object) {
+  UsbVideoTexture* self = USB_VIDEO_TEXTURE(object);
+
+  delete self->staging;
+  self->staging = nullptr;
+  delete self->ready;
+  self->ready = nullptr;
+  delete self->converted;
+  self->converted = nullptr;
+  delete self->rgba;
+  self->rgba = nullptr;
+  delete self->lock;
+  self->lock = nullptr;
+
+  G_OBJECT_CLASS(usb_video_texture_parent_class)->dispose(object);
+}
+
+static void usb_video_texture_class_init(UsbVideoTextureClass* klass) {
+  G_OBJECT_CLASS(klass)->dispose = usb_video_texture_dispose;
+  FL_PIXEL_BUFFER_TEXTURE_CLASS(klass)->copy_pixels =
+      usb_video_texture_copy_pixels;
+}
+
+static void usb_video_texture_init(UsbVideoTexture* self) {
+  self->width = 0;
+  self->height = 0;
+  self->lock = new std::mutex();
+  self->staging = new std::vector<uint8_t>();
+  self->ready = new std::vector<uint8_t>();
+  self->converted = new std::vector<uint8_t>();
+  self->ready_is_fresh = false;
+  self->rgba = new std::vector<uint8_t>();
+}
+
+UsbVideoTexture* usb_video_texture_new(uint32_t width, uint32_t height) {
+  UsbVideoTexture* self = USB_VIDEO_TEXTURE(
+      g_object_new(usb_video_texture_get_type(), nullptr));
+  self->width = width;
+  self->height = height;
+
+  // Allocate every buffer up front so neither thread allocates per frame.
+  // Start black (Y=16, U=V=128; opaque RGBA) so the first upload before any
+  // frame arrives matches the in-app overlay's background.
+  const size_t pixels = static_cast<size_t>(width) * height;
+  for (std::vector<uint8_t>* buffer :
+       {self->staging, self->ready, self->converted}) {
+    buffer->resize(pixels * 2);
+    for (size_t i = 0; i < buffer->size(); i += 2) {
+      (*buffer)[i] = 16;
+      (*buffer)[i + 1] = 128;
+    }
+  }
+  self->rgba->assign(pixels * 4, 0);
+  for (size_t i = 3; i < self->rgba->size(); i += 4) {
+    (*self->rgba)[i] = 0xFF;
+  }
+  return self;
+}
+
+uint8_t* usb_video_texture_begin_write(UsbVideoTexture* self) {
+  return self->staging->data();
+}
+
+gboolean usb_video_texture_end_write(UsbVideoTexture* self) {
+  std::lock_guard<std::mutex> lock(*self->lock);
+  std::swap(self->staging, self->ready);
+  gboolean replaced = self->ready_is_fresh;
+  self->ready_is_fresh = true;
+  return replaced;
+}
@@ -0,0 +1,45 @@
+#ifndef FLUTTER_USB_VIDEO_TEXTURE_H_
+#define FLUTTER_USB_VIDEO_TEXTURE_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include <cstdint>
+
+G_DECLARE_FINAL_TYPE(UsbVideoTexture, usb_video_texture, USB_VIDEO, TEXTURE,
+                     FlPixelBufferTexture)
+
+/**
+ * usb_video_texture_new:
+ * @width: frame width in pixels.
+ * @height: frame height in pixels.
+ *
+ * Creates a pixel buffer texture that the Flutter engine samples directly,
+ * so captured frames never cross the platform channel.
+ *
+ * Returns: a new #UsbVideoTexture.
+ */
+UsbVideoTexture* usb_video_texture_new(uint32_t width, uint32_t height);
+
+/**
+ * usb_video_texture_begin_write:
+ * @texture: a #UsbVideoTexture.
+ *
+ * Returns the staging buffer (width * height * 2 bytes) the capture thread
+ * copies the next raw YUYV frame into. Must be paired with
+ * usb_video_texture_end_write(). Safe to call from the capture thread.
+ */
+uint8_t* usb_video_texture_begin_write(UsbVideoTexture* texture);
+
+/**
+ * usb_video_texture_end_write:
+ * @texture: a #UsbVideoTexture.
+ *
+ * Publishes the staging buffer as the latest frame. It is converted to RGBA
+ * the next time copy_pixels runs on the raster thread; frames replaced
+ * before then are never converted.
+ *
+ * Returns: %TRUE if this replaced a frame the engine never picked up.
+ */
+gboolean usb_video_texture_end_write(UsbVideoTexture* texture);
+
+#endif  // FLUTTER_USB_VIDEO_TEXTURE_H_
@@ -0,0 +1,366 @@
+#include "alsa_seq_transport.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace nt_midi {
+
+namespace {
+
+// Enough for any channel or system message the decoder produces; SysEx
+// arrives as its own event type and skips the decoder.
+const size_t kDecodeBufferSize = 256;
+// SysEx is sent in events of at most this many bytes, which the sequencer
+// delivers back to back.
+const size_t kEncodeBufferSize = 256;
+// Room for a burst of file upload chunks while the I/O thread is busy
+// elsewhere; the sequencer drops input that does not fit.
+const size_t kInputBufferSize = 256 * 1024;
+
+const char kClientName[] = "nt_helper";
+
+void Wake(int fd) {
+  const uint64_t one = 1;
+  ssize_t unused = write(fd, &one, sizeof(one));
+  (void)unused;
+}
+
+}  // namespace
+
+std::vector<SeqPortInfo> ListSeqPorts() {
+  std::vector<SeqPortInfo> ports;
+  snd_seq_t* seq = nullptr;
+  if (snd_seq_open(&seq, "default", SND_SEQ_OPEN_DUPLEX, SND_SEQ_NONBLOCK) < 0) {
+    return ports;
+  }
+  snd_seq_client_info_t* client_info;
+  snd_seq_port_info_t* port_info;
+  snd_seq_client_info_alloca(&client_info);
+  snd_seq_port_info_alloca(&port_info);
+
+  const unsigned int kRead = SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_SUBS_READ;
+  const unsigned int kWrite = SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_SUBS_WRITE;
+  snd_seq_client_info_set_client(client_info, -1);
+  while (snd_seq_query_next_client(seq, client_info) >= 0) {
+    const int client = snd_seq_client_info_get_client(client_info);
+    if (client == SND_SEQ_CLIENT_SYSTEM) {
+      continue;
+    }
+    snd_seq_port_info_set_client(port_info, client);
+    snd_seq_port_info_set_port(port_info, -1);
+    while (snd_seq_query_next_port(seq, port_info) >= 0) {
+      const unsigned int caps = snd_seq_port_info_get_capability(port_info);
+      if (caps & SND_SEQ_PORT_CAP_NO_EXPORT) {
+        continue;
+      }
+      SeqPortInfo info;
+      info.client = client;
+      info.port = snd_seq_port_info_get_port(port_info);
+      info.client_name = snd_seq_client_info_get_name(client_info);
+      info.port_name = snd_seq_port_info_get_name(port_info);
+      info.readable = (caps & kRead) == kRead;
+      info.writable = (caps & kWrite) == kWrite;
+      if (info.readable || info.writable) {
+        ports.push_back(info);
+      }
+    }
+  }
+  snd_seq_close(seq);
+  return ports;
+}
+
+// Counts what the framer finds and passes it on to the listener.
+class AlsaSeqTransport::FramerSink : public MidiMessageSink {
+ public:
+  explicit FramerSink(AlsaSeqTransport* transport) : transport_(transport) {}
+
+  void OnMessage(const uint8_t* data, size_t size) override {
+    transport_->messages_received_.fetch_add(1, std::memory_order_relaxed);
+    transport_->listener_->OnMessage(data, size);
+  }
+
+ private:
+  AlsaSeqTransport* const transport_;
+};
+
+AlsaSeqTransport::AlsaSeqTransport()
+    : seq_(nullptr),
+      decoder_(nullptr),
+      encoder_(nullptr),
+      local_port_(-1),
+      input_client_(-1),
+      input_port_(-1),
+      output_client_(-1),
+      output_port_(-1),
+      wake_fd_(-1),
+      listener_(nullptr),
+      stop_(false),
+      writing_offset_(0),
+      pending_event_(),
+      event_pending_(false),
+      decode_buffer_(kDecodeBufferSize),
+      bytes_sent_(0),
+      messages_received_(0) {}
+
+AlsaSeqTransport::~AlsaSeqTransport() { Close(); }
+
+bool AlsaSeqTransport::Fail(const char* what, int err) {
+  error_ = std::string(what) + ": " + snd_strerror(err);
+  Close();
+  return false;
+}
+
+bool AlsaSeqTransport::Open(int input_client, int input_port, int output_client,
+                            int output_port, Listener* listener) {
+  Close();
+  error_.clear();
+  input_client_ = input_client;
+  input_port_ = input_port;
+  output_client_ = output_client;
+  output_port_ = output_port;
+  listener_ = listener;
+
+  int err = snd_seq_open(&seq_, "default", SND_SEQ_OPEN_DUPLEX, SND_SEQ_NONBLOCK);
+  if (err < 0) {
+    seq_ = nullptr;
+    return Fail("snd_seq_open", err);
+  }
+  snd_seq_set_client_name(seq_, kClientName);
+  snd_seq_set_input_buffer_size(seq_, kInputBufferSize);
+
+  // Private to this client: other programs should not see it in their
+  // port lists.
+  err = snd_seq_create_simple_port(
+      seq_, "Disting NT",
+      SND_SEQ_PORT_CAP_READ | SND_SEQ_PORT_CAP_WRITE | SND_SEQ_PORT_CAP_NO_EXPORT,
+      SND_SEQ_PORT_TYPE_MIDI_GENERIC | SND_SEQ_PORT_TYPE_APPLICATION);
+  if (err < 0) {
+    return Fail("snd_seq_create_simple_port", err);
+  }
+  local_port_ = err;
+
+  if ((err = snd_seq_connect_from(seq_, local_port_, input_client, input_port)) < 0) {
+    return Fail("snd_seq_connect_from", err);
+  }
+  if ((err = snd_seq_connect_to(seq_, local_port_, output_client, output_port)) < 0) {
+    return Fail("snd_seq_connect_to", err);
+  }
+  // Announcements tell us when the device's client goes away.
+  if ((err = snd_seq_connect_from(seq_, local_port_, SND_SEQ_CLIENT_SYSTEM,
+                                  SND_SEQ_PORT_SYSTEM_ANNOUNCE)) < 0) {
+    return Fail("snd_seq_connect_from(announce)", err);
+  }
+
+  if ((err = snd_midi_event_new(kDecodeBufferSize, &decoder_)) < 0) {
+    decoder_ = nullptr;
+    return Fail("snd_midi_event_new", err);
+  }
+  // Whole messages with their status byte, as the framer expects them.
+  snd_midi_event_no_status(decoder_, 1);
+  if ((err = snd_midi_event_new(kEncodeBufferSize, &encoder_)) < 0) {
+    encoder_ = nullptr;
+    return Fail("snd_midi_event_new", err);
+  }
+
+  wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (wake_fd_ < 0) {
+    return Fail("eventfd", -errno);
+  }
+
+  framer_.Reset();
+  stop_.store(false);
+  thread_ = std::thread(&AlsaSeqTransport::Run, this);
+  return true;
+}
+
+bool AlsaSeqTransport::Send(const uint8_t* data, size_t size) {
+  if (!is_open()) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    send_queue_.emplace_back(data, data + size);
+  }
+  Wake(wake_fd_);
+  return true;
+}
+
+void AlsaSeqTransport::Close() {
+  if (thread_.joinable()) {
+    stop_.store(true);
+    Wake(wake_fd_);
+    thread_.join();
+  }
+  if (encoder_ != nullptr) {
+    snd_midi_event_free(encoder_);
+    encoder_ = nullptr;
+  }
+  if (decoder_ != nullptr) {
+    snd_midi_event_free(decoder_);
+    decoder_ = nullptr;
+  }
+  if (seq_ != nullptr) {
+    snd_seq_close(seq_);
+    seq_ = nullptr;
+  }
+  if (wake_fd_ >= 0) {
+    close(wake_fd_);
+    wake_fd_ = -1;
+  }
+  local_port_ = -1;
+  {
+    std::lock_guard<std::mutex> lock(send_mutex_);
+    send_queue_.clear();
+  }
+  writing_.clear();
+  writing_offset_ = 0;
+  event_pending_ = false;
+}
+
+void AlsaSeqTransport::Run() {
+  FramerSink sink(this);
+  const int input_count = snd_seq_poll_descriptors_count(seq_, POLLIN);
+  const int output_count = snd_seq_poll_descriptors_count(seq_, POLLOUT);
+  std::vector<pollfd> fds(input_count + output_count + 1);
+  bool blocked = false;
+
+  while (!stop_.load()) {
+    // The sequencer's output is only worth watching while it is full.
+    int count = snd_seq_poll_descriptors(seq_, fds.data(), input_count, POLLIN);
+    fds[count].fd = wake_fd_;
+    fds[count].events = POLLIN;
+    fds[count].revents = 0;
+    ++count;
+    if (blocked) {
+      count += snd_seq_poll_descriptors(seq_, fds.data() + count, output_count, POLLOUT);
+    }
+    if (poll(fds.data(), count, -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    uint64_t wakes;
+    while (read(wake_fd_, &wakes, sizeof(wakes)) > 0) {
+    }
+    if (stop_.load()) {
+      break;
+    }
+    if (!ReadEvents(&sink)) {
+      listener_->OnDisconnected();
+      break;
+    }
+    blocked = false;
+    if (!WriteQueued(&blocked)) {
+      listener_->OnDisconnected();
+      break;
+    }
+  }
+}
+
+bool AlsaSeqTransport::ReadEvents(FramerSink* sink) {
+  for (;;) {
+    snd_seq_event_t* event = nullptr;
+    const int err = snd_seq_event_input(seq_, &event);
+    if (err == -EAGAIN) {
+      return true;
+    }
+    if (err == -ENOSPC) {
+      // The input buffer overran and events were lost; whatever was being
+      // put together is incomplete.
+      framer_.Reset();
+      continue;
+    }
+    if (err < 0) {
+      error_ = std::string("snd_seq_event_input: ") + snd_strerror(err);
+      return false;
+    }
+    if (event == nullptr) {
+      continue;
+    }
+
+    if (event->source.client == SND_SEQ_CLIENT_SYSTEM) {
+      const snd_seq_addr_t& addr = event->data.addr;
+      if (event->type == SND_SEQ_EVENT_CLIENT_EXIT &&
+          (addr.client == input_client_ || addr.client == output_client_)) {
+        return false;
+      }
+      if (event->type == SND_SEQ_EVENT_PORT_EXIT &&
+          ((addr.client == input_client_ && addr.port == input_port_) ||
+           (addr.client == output_client_ && addr.port == output_port_))) {
+        return false;
+      }
+      continue;
+    }
+    if (event->source.client != input_client_ || event->source.port != input_port_) {
+      continue;
+    }
+
+    if (event->type == SND_SEQ_EVENT_SYSEX) {
+      framer_.Feed(static_cast<const uint8_t*>(event->data.ext.ptr), event->data.ext.len,
+                   sink);
+    } else {
+      const long size =
+          snd_midi_event_decode(decoder_, decode_buffer_.data(), decode_buffer_.size(), event);
+      if (size > 0) {
+        framer_.Feed(decode_buffer_.data(), static_cast<size_t>(size), sink);
+      }
+    }
+  }
+}
+
+bool AlsaSeqTransport::WriteQueued(bool* blocked) {
+  for (;;) {
+    if (event_pending_) {
+      const int err = snd_seq_event_output_direct(seq_, &pending_event_);
+      if (err == -EAGAIN) {
+        *blocked = true;
+        return true;
+      }
+      if (err < 0) {
+        error_ = std::string("snd_seq_event_output_direct: ") + snd_strerror(err);
+        return false;
+      }
+      event_pending_ = false;
+    }
+
+    if (writing_offset_ == writing_.size()) {
+      std::lock_guard<std::mutex> lock(send_mutex_);
+      if (send_queue_.empty()) {
+        writing_.clear();
+        writing_offset_ = 0;
+        return true;
+      }
+      writing_.swap(send_queue_.front());
+      send_queue_.pop_front();
+      writing_offset_ = 0;
+    }
+
+    // The encoder keeps SysEx in its own buffer, which pending_event_ then
+    // points into; nothing is encoded again until that event is out.
+    snd_seq_ev_clear(&pending_event_);
+    const long used = snd_midi_event_encode(encoder_, writing_.data() + writing_offset_,
+                                            writing_.size() - writing_offset_, &pending_event_);
+    if (used <= 0) {
+      // Not MIDI the encoder understands; drop the rest of this buffer.
+      snd_midi_event_reset_encode(encoder_);
+      writing_offset_ = writing_.size();
+      continue;
+    }
+    writing_offset_ += static_cast<size_t>(used);
+    bytes_sent_.fetch_add(static_cast<uint64_t>(used), std::memory_order_relaxed);
+    if (pending_event_.type == SND_SEQ_EVENT_NONE) {
+      continue;  // The message continues in the next bytes.
+    }
+    snd_seq_ev_set_source(&pending_event_, local_port_);
+    snd_seq_ev_set_subs(&pending_event_);
+    snd_seq_ev_set_direct(&pending_event_);
+    event_pending_ = true;
+  }
+}
+
+}  // namespace nt_midi
@@ -0,0 +1,130 @@
+#ifndef NT_MIDI_ALSA_SEQ_TRANSPORT_H_
+#define NT_MIDI_ALSA_SEQ_TRANSPORT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <alsa/asoundlib.h>
+
+#include "midi_stream_framer.h"
+
+namespace nt_midi {
+
+// A port another ALSA sequencer client offers, such as the Disting NT's
+// USB MIDI port.
+struct SeqPortInfo {
+  int client;
+  int port;
+  std::string client_name;
+  std::string port_name;
+  bool readable;  // We can subscribe to what it sends.
+  bool writable;  // We can send to it.
+};
+
+// Lists the sequencer ports other clients offer, leaving out the System
+// client and ports nobody may subscribe to. Empty if the sequencer cannot
+// be opened.
+std::vector<SeqPortInfo> ListSeqPorts();
+
+// Talks to one MIDI device through the ALSA sequencer, with a dedicated
+// I/O thread.
+//
+// The sequencer rather than rawmidi: a rawmidi device can be open only
+// once, and the sequencer already holds it whenever any other program (or
+// flutter_midi_command) is subscribed, while any number of sequencer
+// clients can subscribe to the same port.
+//
+// Everything received is put back together into whole messages
+// (midi_stream_framer.h) on the I/O thread and handed to the Listener
+// there. Send() only queues, so the caller never waits on the device; the
+// I/O thread writes the queue out in order.
+class AlsaSeqTransport {
+ public:
+  class Listener {
+   public:
+    virtual ~Listener() {}
+    // A complete message from the device; see MidiMessageSink.
+    virtual void OnMessage(const uint8_t* data, size_t size) = 0;
+    // The device's client went away (unplugged). No more messages follow.
+    virtual void OnDisconnected() = 0;
+  };
+
+  AlsaSeqTransport();
+  ~AlsaSeqTransport();
+
+  AlsaSeqTransport(const AlsaSeqTransport&) = delete;
+  AlsaSeqTransport& operator=(const AlsaSeqTransport&) = delete;
+
+  // Subscribes to |input| and to |output| (client:port addresses, often
+  // the same port) and starts the I/O thread, which calls |listener| until
+  // Close(). Returns false, with error() set, on failure.
+  bool Open(int input_client, int input_port, int output_client,
+            int output_port, Listener* listener);
+
+  // Queues |size| bytes of complete MIDI messages for the device. Any
+  // thread. Returns false if the transport is not open.
+  bool Send(const uint8_t* data, size_t size);
+
+  // Stops the I/O thread, dropping anything still queued, and closes the
+  // sequencer. Does not call the listener.
+  void Close();
+
+  bool is_open() const { return thread_.joinable(); }
+  const std::string& error() const { return error_; }
+
+  // Counters, readable from any thread.
+  uint64_t bytes_sent() const { return bytes_sent_.load(std::memory_order_relaxed); }
+  uint64_t messages_received() const {
+    return messages_received_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  class FramerSink;
+
+  bool Fail(const char* what, int err);
+  void Run();
+  // Both return false when the device is gone or the sequencer failed.
+  bool ReadEvents(FramerSink* sink);
+  // Sets |blocked| when the sequencer's output pool is full.
+  bool WriteQueued(bool* blocked);
+
+  snd_seq_t* seq_;
+  snd_midi_event_t* decoder_;
+  snd_midi_event_t* encoder_;
+  int local_port_;
+  int input_client_;
+  int input_port_;
+  int output_client_;
+  int output_port_;
+  int wake_fd_;
+  Listener* listener_;
+  std::string error_;
+  std::thread thread_;
+  std::atomic<bool> stop_;
+
+  // Bytes waiting for the I/O thread.
+  std::mutex send_mutex_;
+  std::deque<std::vector<uint8_t>> send_queue_;
+
+  // I/O thread only: the bytes being written, and an encoded event the
+  // sequencer had no room for, to retry before encoding more.
+  std::vector<uint8_t> writing_;
+  size_t writing_offset_;
+  snd_seq_event_t pending_event_;
+  bool event_pending_;
+
+  MidiStreamFramer framer_;
+  std::vector<uint8_t> decode_buffer_;
+  std::atomic<uint64_t> bytes_sent_;
+  std::atomic<uint64_t> messages_received_;
+};
+
+}  // namespace nt_midi
+
+#endif  // NT_MIDI_ALSA_SEQ_TRANSPORT_H_
@@ -0,0 +1,99 @@
+// Throughput of the SysEx reassembler on Disting NT traffic: file download
+// responses (about 600 bytes each) delivered whole, in USB-sized pieces
+// and with realtime clock bytes in between. Each reports bytes per second
+// of input. Examples:
+//
+//   nt_midi_benchmark
+//   nt_midi_benchmark --benchmark_filter=Fragmented
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "nt_sysex_ffi.h"
+#include "nt_sysex_reassembler.h"
+
+namespace nt_midi {
+namespace {
+
+const int kMessages = 64;
+const size_t kPayloadSize = 600;
+
+std::vector<uint8_t> ResponseStream(bool with_clock) {
+  std::mt19937 random(3);
+  std::vector<uint8_t> stream;
+  for (int m = 0; m < kMessages; ++m) {
+    const uint8_t header[] = {0xF0, 0x00, 0x21, 0x27, 0x6D, 0x00, 0x7A};
+    stream.insert(stream.end(), header, header + sizeof(header));
+    for (size_t i = 0; i < kPayloadSize; ++i) {
+      if (with_clock && i % 97 == 0) {
+        stream.push_back(0xF8);
+      }
+      stream.push_back(static_cast<uint8_t>(random() & 0x7F));
+    }
+    stream.push_back(0xF7);
+  }
+  return stream;
+}
+
+class CountingSink : public NtSysExSink {
+ public:
+  void OnNtSysEx(const NtSysExView& message) override { bytes += message.payload_size; }
+  void OnOtherMessage(const uint8_t*, size_t) override {}
+  void OnTruncated() override {}
+  size_t bytes = 0;
+};
+
+void Run(benchmark::State& state, const std::vector<uint8_t>& stream, size_t piece) {
+  NtSysExReassembler reassembler;
+  CountingSink sink;
+  for (auto _ : state) {
+    for (size_t offset = 0; offset < stream.size(); offset += piece) {
+      reassembler.Feed(stream.data() + offset, std::min(piece, stream.size() - offset), &sink);
+    }
+    benchmark::DoNotOptimize(sink.bytes);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+}
+
+// One message per buffer, the way CoreMIDI and WinMM tend to deliver it:
+// the in-place path.
+void BM_WholeMessages(benchmark::State& state) {
+  Run(state, ResponseStream(false), kPayloadSize + 8);
+}
+BENCHMARK(BM_WholeMessages);
+
+// USB-MIDI endpoint sized pieces, so every message is assembled.
+void BM_Fragmented(benchmark::State& state) {
+  Run(state, ResponseStream(false), static_cast<size_t>(state.range(0)));
+}
+BENCHMARK(BM_Fragmented)->Arg(3)->Arg(64)->Arg(512);
+
+void BM_FragmentedWithClock(benchmark::State& state) {
+  Run(state, ResponseStream(true), 64);
+}
+BENCHMARK(BM_FragmentedWithClock);
+
+// The FFI entry points, copying into the input buffer as Dart does.
+void BM_FfiFeed(benchmark::State& state) {
+  const std::vector<uint8_t> stream = ResponseStream(false);
+  const size_t piece = static_cast<size_t>(state.range(0));
+  NtSysExParser* parser = nt_sysex_create();
+  for (auto _ : state) {
+    for (size_t offset = 0; offset < stream.size(); offset += piece) {
+      const size_t size = std::min(piece, stream.size() - offset);
+      uint8_t* input = nt_sysex_input(parser, static_cast<int64_t>(size));
+      std::copy(stream.begin() + offset, stream.begin() + offset + size, input);
+      benchmark::DoNotOptimize(nt_sysex_feed(parser, static_cast<int64_t>(size)));
+    }
+  }
+  nt_sysex_destroy(parser);
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * stream.size()));
+}
+BENCHMARK(BM_FfiFeed)->Arg(64)->Arg(kPayloadSize + 8);
+
+}  // namespace
+}  // namespace nt_midi
@@ -0,0 +1,135 @@
+// Throughput of the SysEx field codec: nybble encoding of file upload
+// chunks, nybble decoding of downloads, and the 21-bit parameter values
+// of an All Parameter Values response. Each reports bytes per second of
+// input. Example:
+//
+//   nt_midi_benchmark --benchmark_filter=Nybbles
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "nt_sysex_codec.h"
+#include "nt_sysex_codec_ffi.h"
+
+namespace nt_midi {
+namespace {
+
+std::vector<uint8_t> RandomBytes(size_t size, uint8_t mask) {
+  std::mt19937 random(7);
+  std::vector<uint8_t> bytes(size);
+  for (uint8_t& byte : bytes) {
+    byte = static_cast<uint8_t>(random() & mask);
+  }
+  return bytes;
+}
+
+// Encodes one upload chunk and its checksum, by chunk size.
+void BM_EncodeNybbles(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  const std::vector<uint8_t> bytes = RandomBytes(size, 0xFF);
+  std::vector<uint8_t> nybbles(2 * size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(EncodeNybbles(bytes.data(), size, nybbles.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_EncodeNybbles)->Arg(512)->Arg(4096)->Arg(65536);
+
+void BM_DecodeNybbles(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  const std::vector<uint8_t> nybbles = RandomBytes(size, 0x0F);
+  std::vector<uint8_t> bytes(size / 2);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DecodeNybbles(nybbles.data(), size, bytes.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_DecodeNybbles)->Arg(1024)->Arg(65536);
+
+// A large algorithm's worth of parameters.
+void BM_DecodeParameterValues(benchmark::State& state) {
+  const size_t count = static_cast<size_t>(state.range(0));
+  const std::vector<uint8_t> data = RandomBytes(3 * count, 0x7F);
+  std::vector<int16_t> values(count);
+  std::vector<uint8_t> flags(count);
+  for (auto _ : state) {
+    DecodeParameterValues(data.data(), count, values.data(), flags.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_DecodeParameterValues)->Arg(256)->Arg(4096);
+
+// Where the native path starts to win. sysex_utils.dart sends buffers of
+// kNativeSysExCodecThreshold bytes and up to libnt_sysex; below that it
+// runs the byte loop below. Dart does not vectorise that loop, so it is
+// built here without vectorisation too. Dart's bounds checks make the
+// real loop slower still, which makes this a lower bound on the Dart
+// side. The native side is what NativeSysExCodec does per call: copy in,
+// call the exported entry point, copy out. Compare the two by size:
+//
+//   nt_midi_benchmark --benchmark_filter=Crossover
+#if defined(__GNUC__) && !defined(__clang__)
+__attribute__((optimize("no-tree-vectorize")))
+#endif
+__attribute__((noinline)) uint64_t EncodeNybblesByteLoop(const uint8_t* bytes, size_t size,
+                                                        uint8_t* nybbles) {
+  uint64_t sum = 0;
+#if defined(__clang__)
+#pragma clang loop vectorize(disable) interleave(disable)
+#endif
+  for (size_t i = 0; i < size; ++i) {
+    const uint8_t high = bytes[i] >> 4;
+    const uint8_t low = bytes[i] & 0x0F;
+    nybbles[2 * i] = high;
+    nybbles[2 * i + 1] = low;
+    sum += high + low;
+  }
+  return sum;
+}
+
+void BM_CrossoverByteLoop(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  const std::vector<uint8_t> bytes = RandomBytes(size, 0xFF);
+  std::vector<uint8_t> nybbles(2 * size);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(EncodeNybblesByteLoop(bytes.data(), size, nybbles.data()));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_CrossoverByteLoop)->RangeMultiplier(2)->Range(16, 1024);
+
+void BM_CrossoverNative(benchmark::State& state) {
+  const size_t size = static_cast<size_t>(state.range(0));
+  const std::vector<uint8_t> bytes = RandomBytes(size, 0xFF);
+  std::vector<uint8_t> scratch(3 * size);
+  std::vector<uint8_t> nybbles(2 * size);
+  for (auto _ : state) {
+    std::memcpy(scratch.data(), bytes.data(), size);
+    benchmark::DoNotOptimize(nt_sysex_encode_nybbles(
+        scratch.data(), static_cast<int64_t>(size), scratch.data() + size));
+    std::memcpy(nybbles.data(), scratch.data() + size, 2 * size);
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+BENCHMARK(BM_CrossoverNative)->RangeMultiplier(2)->Range(16, 1024);
+
+void BM_Checksum(benchmark::State& state) {
+  const std::vector<uint8_t> data = RandomBytes(static_cast<size_t>(state.range(0)), 0x7F);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(SysExChecksum(data.data(), data.size()));
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_Checksum)->Arg(1024)->Arg(65536);
+
+}  // namespace
+}  // namespace nt_midi
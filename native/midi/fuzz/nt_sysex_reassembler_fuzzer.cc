@@ -0,0 +1,107 @@
+// libFuzzer harness for NtSysExReassembler. The input is fed twice, whole
+// and in pieces whose sizes come from the input itself; both must produce
+// the same events, and every event must be well formed. With Clang:
+//
+//   CC=clang CXX=clang++ cmake -S native/midi -B build/midi-fuzz -DNT_MIDI_BUILD_FUZZERS=ON
+//   build/midi-fuzz/nt_sysex_reassembler_fuzzer -max_total_time=60
+//
+// Other compilers build it against fuzz/standalone_fuzz_main.cc instead,
+// which replays files or random inputs; ctest runs that.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "midi_stream_framer.h"
+#include "nt_sysex_reassembler.h"
+
+namespace {
+
+// Small enough that the size limit is reached often.
+const size_t kMaxSysExSize = 96;
+
+void Check(bool condition) {
+  if (!condition) {
+    abort();
+  }
+}
+
+struct Event {
+  int kind;
+  std::vector<uint8_t> bytes;
+
+  bool operator==(const Event& other) const {
+    return kind == other.kind && bytes == other.bytes;
+  }
+};
+
+class Recorder : public nt_midi::NtSysExSink {
+ public:
+  void OnNtSysEx(const nt_midi::NtSysExView& message) override {
+    Check(message.raw_size >= 8);
+    Check(message.raw[0] == 0xF0 && message.raw[message.raw_size - 1] == 0xF7);
+    Check(message.raw[4] == 0x6D);
+    Check(message.payload == message.raw + 7);
+    Check(message.payload_size == message.raw_size - 8);
+    Check(message.raw_size <= kMaxSysExSize);
+    for (size_t i = 1; i + 1 < message.raw_size; ++i) {
+      Check(message.raw[i] < 0x80);
+    }
+    events.push_back({0, std::vector<uint8_t>(message.raw, message.raw + message.raw_size)});
+  }
+
+  void OnOtherMessage(const uint8_t* data, size_t size) override {
+    Check(size > 0 && data[0] >= 0x80 && data[0] < 0xF8);
+    if (data[0] == 0xF0) {
+      Check(data[size - 1] == 0xF7 && size <= kMaxSysExSize);
+    } else {
+      Check(size == nt_midi::MidiMessageLength(data[0]));
+    }
+    for (size_t i = 1; i < size; ++i) {
+      Check(data[i] < 0x80 || (i + 1 == size && data[i] == 0xF7));
+    }
+    events.push_back({1, std::vector<uint8_t>(data, data + size)});
+  }
+
+  void OnTruncated() override { events.push_back({2, {}}); }
+
+  std::vector<Event> events;
+};
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  if (size == 0) {
+    return 0;
+  }
+  // The first byte seeds the piece sizes; the rest is the stream.
+  const uint8_t seed = data[0];
+  const uint8_t* stream = data + 1;
+  const size_t length = size - 1;
+
+  Recorder whole;
+  nt_midi::NtSysExReassembler whole_parser(kMaxSysExSize);
+  whole_parser.Feed(stream, length, &whole);
+
+  Recorder pieces;
+  nt_midi::NtSysExReassembler pieces_parser(kMaxSysExSize);
+  size_t offset = 0;
+  size_t n = 0;
+  while (offset < length) {
+    // Copy each piece so that views into the caller's buffer cannot
+    // outlive it unnoticed under ASan.
+    const size_t piece = std::min(length - offset, static_cast<size_t>(1 + (seed + n * 7) % 13));
+    std::vector<uint8_t> copy(stream + offset, stream + offset + piece);
+    pieces_parser.Feed(copy.data(), copy.size(), &pieces);
+    offset += piece;
+    ++n;
+  }
+
+  Check(whole.events == pieces.events);
+  Check(whole_parser.in_sysex() == pieces_parser.in_sysex());
+  Check(whole_parser.truncated() == pieces_parser.truncated());
+  Check(whole_parser.stray_bytes() == pieces_parser.stray_bytes());
+  return 0;
+}
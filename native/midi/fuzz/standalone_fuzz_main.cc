@@ -0,0 +1,71 @@
+// Runs a libFuzzer harness without libFuzzer: over each file named on the
+// command line, or else over random inputs, for compilers without
+// -fsanitize=fuzzer. Usage:
+//
+//   nt_sysex_reassembler_fuzz_replay [FILE...]
+//   nt_sysex_reassembler_fuzz_replay --random=ITERATIONS
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+// Mostly the bytes that matter to the parser, so random inputs hold whole
+// messages often enough to be interesting.
+uint8_t RandomByte(std::mt19937* random) {
+  static const uint8_t kInteresting[] = {0xF0, 0xF7, 0x00, 0x21, 0x27, 0x6D,
+                                         0xB0, 0xC0, 0xF8, 0xFE, 0xF2, 0xF6};
+  const uint32_t roll = (*random)() % 100;
+  if (roll < 40) {
+    return kInteresting[(*random)() % sizeof(kInteresting)];
+  }
+  if (roll < 90) {
+    return static_cast<uint8_t>((*random)() % 0x80);
+  }
+  return static_cast<uint8_t>((*random)());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  long iterations = 0;
+  int files = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--random=", 9) == 0) {
+      iterations = strtol(argv[i] + 9, nullptr, 10);
+      continue;
+    }
+    std::ifstream file(argv[i], std::ios::binary);
+    if (!file) {
+      fprintf(stderr, "cannot read %s\n", argv[i]);
+      return 1;
+    }
+    const std::vector<uint8_t> input((std::istreambuf_iterator<char>(file)),
+                                     std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+    ++files;
+  }
+  if (files == 0 && iterations == 0) {
+    iterations = 10000;
+  }
+
+  std::mt19937 random(1);
+  std::vector<uint8_t> input;
+  for (long i = 0; i < iterations; ++i) {
+    input.resize(random() % 512);
+    for (uint8_t& byte : input) {
+      byte = RandomByte(&random);
+    }
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  printf("%d files, %ld random inputs\n", files, iterations);
+  return 0;
+}
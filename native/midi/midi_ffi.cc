@@ -0,0 +1,128 @@
+#include "midi_ffi.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "alsa_seq_transport.h"
+#include "dart_api_dl.h"
+
+namespace {
+
+// Messages up to this size are copied into the Dart heap by the VM; larger
+// ones (file chunks, parameter dumps) are handed over as external typed
+// data so they are copied only once, out of the framer's buffer.
+const size_t kCopyThreshold = 64;
+
+thread_local std::string last_error;
+
+void FreePeer(void* isolate_callback_data, void* peer) {
+  (void)isolate_callback_data;
+  free(peer);
+}
+
+class PortListener : public nt_midi::AlsaSeqTransport::Listener {
+ public:
+  explicit PortListener(Dart_Port port) : port_(port) {}
+
+  void OnMessage(const uint8_t* data, size_t size) override {
+    Dart_CObject message;
+    if (size <= kCopyThreshold) {
+      message.type = Dart_CObject_kTypedData;
+      message.value.as_typed_data.type = Dart_TypedData_kUint8;
+      message.value.as_typed_data.length = static_cast<intptr_t>(size);
+      message.value.as_typed_data.values = data;
+      Dart_PostCObject_DL(port_, &message);
+      return;
+    }
+    uint8_t* copy = static_cast<uint8_t*>(malloc(size));
+    if (copy == nullptr) {
+      return;
+    }
+    memcpy(copy, data, size);
+    message.type = Dart_CObject_kExternalTypedData;
+    message.value.as_external_typed_data.type = Dart_TypedData_kUint8;
+    message.value.as_external_typed_data.length = static_cast<intptr_t>(size);
+    message.value.as_external_typed_data.data = copy;
+    message.value.as_external_typed_data.peer = copy;
+    message.value.as_external_typed_data.callback = FreePeer;
+    // The VM owns the copy only if the post succeeds.
+    if (!Dart_PostCObject_DL(port_, &message)) {
+      free(copy);
+    }
+  }
+
+  void OnDisconnected() override {
+    Dart_CObject message;
+    message.type = Dart_CObject_kNull;
+    Dart_PostCObject_DL(port_, &message);
+  }
+
+ private:
+  const Dart_Port port_;
+};
+
+// Keeps printing simple: names end up between tabs and newlines.
+void AppendField(std::string* out, const std::string& text) {
+  for (char c : text) {
+    out->push_back(c == '\t' || c == '\n' || c == '\r' ? ' ' : c);
+  }
+}
+
+}  // namespace
+
+struct NtMidiTransport {
+  explicit NtMidiTransport(Dart_Port port) : listener(port) {}
+
+  PortListener listener;
+  nt_midi::AlsaSeqTransport transport;
+};
+
+intptr_t nt_midi_initialize(void* dart_api_data) { return Dart_InitializeApiDL(dart_api_data); }
+
+int64_t nt_midi_list_ports(char* buffer, int64_t capacity) {
+  std::string text;
+  for (const nt_midi::SeqPortInfo& port : nt_midi::ListSeqPorts()) {
+    text += std::to_string(port.client);
+    text += '\t';
+    text += std::to_string(port.port);
+    text += '\t';
+    if (port.readable) text += 'r';
+    if (port.writable) text += 'w';
+    text += '\t';
+    AppendField(&text, port.client_name);
+    text += '\t';
+    AppendField(&text, port.port_name);
+    text += '\n';
+  }
+  if (buffer != nullptr && capacity > 0) {
+    const size_t n = std::min(text.size(), static_cast<size_t>(capacity - 1));
+    memcpy(buffer, text.data(), n);
+    buffer[n] = '\0';
+  }
+  return static_cast<int64_t>(text.size());
+}
+
+NtMidiTransport* nt_midi_open(int32_t input_client, int32_t input_port, int32_t output_client,
+                              int32_t output_port, int64_t dart_port) {
+  NtMidiTransport* handle = new NtMidiTransport(static_cast<Dart_Port>(dart_port));
+  if (!handle->transport.Open(input_client, input_port, output_client, output_port,
+                              &handle->listener)) {
+    last_error = handle->transport.error();
+    delete handle;
+    return nullptr;
+  }
+  return handle;
+}
+
+int32_t nt_midi_send(NtMidiTransport* transport, const uint8_t* data, int64_t size) {
+  if (transport == nullptr || data == nullptr || size <= 0) {
+    return -1;
+  }
+  return transport->transport.Send(data, static_cast<size_t>(size)) ? 0 : -1;
+}
+
+void nt_midi_close(NtMidiTransport* transport) { delete transport; }
+
+const char* nt_midi_last_error(void) { return last_error.c_str(); }
@@ -0,0 +1,57 @@
+#ifndef NT_MIDI_MIDI_FFI_H_
+#define NT_MIDI_MIDI_FFI_H_
+
+/*
+ * C entry points of libnt_midi, the native MIDI transport the Linux app
+ * loads over dart:ffi (lib/domain/alsa_midi_transport.dart); see
+ * alsa_seq_transport.h.
+ *
+ * Received messages are posted to a Dart port from the transport's I/O
+ * thread, one Uint8List per complete message (SysEx F0 ... F7 or a channel
+ * message), without passing through the platform thread. null is posted
+ * once if the device goes away.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NT_MIDI_EXPORT __attribute__((visibility("default")))
+
+typedef struct NtMidiTransport NtMidiTransport;
+
+/* Initializes the Dart API for posting; pass NativeApi.initializeApiDLData.
+ * Returns 0 on success. Call once before nt_midi_open(). */
+NT_MIDI_EXPORT intptr_t nt_midi_initialize(void* dart_api_data);
+
+/* Writes one line per sequencer port into |buffer|:
+ *   client \t port \t flags \t client name \t port name \n
+ * where flags holds 'r' if the port can be read from and 'w' if it can be
+ * written to. Returns the length the full list needs (without a
+ * terminator), which may exceed |capacity|; the text written is always
+ * NUL-terminated when |capacity| > 0. */
+NT_MIDI_EXPORT int64_t nt_midi_list_ports(char* buffer, int64_t capacity);
+
+/* Connects to the device's ports and starts posting to |dart_port|. Returns
+ * NULL on failure; nt_midi_last_error() says why. */
+NT_MIDI_EXPORT NtMidiTransport* nt_midi_open(int32_t input_client, int32_t input_port,
+                                             int32_t output_client, int32_t output_port,
+                                             int64_t dart_port);
+
+/* Queues |size| bytes of complete MIDI messages. Returns 0 on success. */
+NT_MIDI_EXPORT int32_t nt_midi_send(NtMidiTransport* transport, const uint8_t* data,
+                                    int64_t size);
+
+/* Stops posting and frees |transport|. */
+NT_MIDI_EXPORT void nt_midi_close(NtMidiTransport* transport);
+
+/* Why the last nt_midi_open() on this thread failed. */
+NT_MIDI_EXPORT const char* nt_midi_last_error(void);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif /* NT_MIDI_MIDI_FFI_H_ */
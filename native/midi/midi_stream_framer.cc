@@ -0,0 +1,172 @@
+#include "midi_stream_framer.h"
+
+#include <cstring>
+
+namespace nt_midi {
+
+constexpr size_t MidiStreamFramer::kDefaultMaxSysExSize;
+
+size_t MidiMessageLength(uint8_t status) {
+  switch (status & 0xF0) {
+    case 0x80:  // Note off
+    case 0x90:  // Note on
+    case 0xA0:  // Poly pressure
+    case 0xB0:  // Control change
+    case 0xE0:  // Pitch bend
+      return 3;
+    case 0xC0:  // Program change
+    case 0xD0:  // Channel pressure
+      return 2;
+    default:
+      break;
+  }
+  switch (status) {
+    case 0xF1:  // MTC quarter frame
+    case 0xF3:  // Song select
+      return 2;
+    case 0xF2:  // Song position
+      return 3;
+    case 0xF6:  // Tune request
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+size_t FindStatusByte(const uint8_t* data, size_t begin, size_t end) {
+  // SysEx bodies are long runs of data bytes; test eight at a time.
+  const uint64_t kHighBits = 0x8080808080808080ull;
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if (word & kHighBits) {
+      break;
+    }
+  }
+  while (i < end && data[i] < 0x80) {
+    ++i;
+  }
+  return i;
+}
+
+MidiStreamFramer::MidiStreamFramer(size_t max_sysex_size)
+    : max_sysex_size_(max_sysex_size),
+      in_sysex_(false),
+      sysex_overflowed_(false),
+      message_(),
+      message_size_(0),
+      message_length_(0),
+      running_status_(0),
+      messages_(0),
+      sysex_discarded_(0),
+      stray_bytes_(0) {}
+
+void MidiStreamFramer::Reset() {
+  sysex_.clear();
+  in_sysex_ = false;
+  sysex_overflowed_ = false;
+  message_size_ = 0;
+  message_length_ = 0;
+  running_status_ = 0;
+}
+
+void MidiStreamFramer::Emit(const uint8_t* data, size_t size, MidiMessageSink* sink) {
+  ++messages_;
+  sink->OnMessage(data, size);
+}
+
+void MidiStreamFramer::DiscardSysEx(MidiMessageSink* sink) {
+  ++sysex_discarded_;
+  sink->OnSysExDiscarded();
+}
+
+void MidiStreamFramer::StartStatus(uint8_t status, MidiMessageSink* sink) {
+  // Channel messages set running status; system common messages clear it.
+  running_status_ = status < 0xF0 ? status : 0;
+  message_[0] = status;
+  message_size_ = 1;
+  message_length_ = MidiMessageLength(status);
+  if (message_length_ == 1) {
+    Emit(message_, 1, sink);
+    message_length_ = 0;
+  }
+}
+
+void MidiStreamFramer::Feed(const uint8_t* data, size_t size, MidiMessageSink* sink) {
+  for (size_t i = 0; i < size; ++i) {
+    const uint8_t byte = data[i];
+    if (byte >= 0xF8) {
+      continue;  // Realtime: clock, start/stop, active sensing.
+    }
+
+    if (in_sysex_) {
+      if (byte < 0x80) {
+        // Take the whole run of data bytes at once.
+        const size_t end = FindStatusByte(data, i + 1, size);
+        if (!sysex_overflowed_) {
+          // Leave room for the F7.
+          if (sysex_.size() + (end - i) + 1 > max_sysex_size_) {
+            sysex_overflowed_ = true;
+            DiscardSysEx(sink);
+            sysex_.clear();
+          } else {
+            sysex_.insert(sysex_.end(), data + i, data + end);
+          }
+        }
+        i = end - 1;
+        continue;
+      }
+      in_sysex_ = false;
+      if (byte == 0xF7) {
+        if (!sysex_overflowed_) {
+          sysex_.push_back(byte);
+          Emit(sysex_.data(), sysex_.size(), sink);
+        }
+        sysex_.clear();
+        continue;
+      }
+      // Any other status cuts the SysEx short.
+      if (!sysex_overflowed_) {
+        DiscardSysEx(sink);
+      }
+      sysex_.clear();
+    }
+
+    if (byte == 0xF0) {
+      running_status_ = 0;
+      message_length_ = 0;
+      // A SysEx entirely inside this buffer needs no copy.
+      const size_t end = FindStatusByte(data, i + 1, size);
+      if (end < size && data[end] == 0xF7 && end - i + 1 <= max_sysex_size_) {
+        Emit(data + i, end - i + 1, sink);
+        i = end;
+        continue;
+      }
+      in_sysex_ = true;
+      sysex_overflowed_ = false;
+      sysex_.push_back(byte);
+    } else if (byte == 0xF7) {
+      ++stray_bytes_;  // An end with no start.
+    } else if (byte >= 0x80) {
+      StartStatus(byte, sink);
+    } else {
+      if (message_length_ == 0) {
+        if (running_status_ == 0) {
+          ++stray_bytes_;
+          continue;
+        }
+        message_[0] = running_status_;
+        message_size_ = 1;
+        message_length_ = MidiMessageLength(running_status_);
+      }
+      message_[message_size_++] = byte;
+      if (message_size_ == message_length_) {
+        Emit(message_, message_size_, sink);
+        message_length_ = 0;
+      }
+    }
+  }
+}
+
+}  // namespace nt_midi
@@ -0,0 +1,88 @@
+#ifndef NT_MIDI_MIDI_STREAM_FRAMER_H_
+#define NT_MIDI_MIDI_STREAM_FRAMER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace nt_midi {
+
+// Receives the complete messages a MidiStreamFramer finds.
+class MidiMessageSink {
+ public:
+  virtual ~MidiMessageSink() {}
+
+  // |data| is one whole message: F0 ... F7, or a channel or system common
+  // message with its status byte. Valid only for the duration of the call.
+  virtual void OnMessage(const uint8_t* data, size_t size) = 0;
+
+  // A SysEx was cut short by another status byte or the size limit, so
+  // whatever it carried is lost.
+  virtual void OnSysExDiscarded() {}
+};
+
+// Splits a raw MIDI byte stream, in whatever pieces the driver hands it
+// over, into complete messages.
+//
+// SysEx is gathered from F0 to F7 across any number of Feed() calls; one
+// that arrives whole in a single Feed() is passed on in place, without
+// being copied. Realtime bytes (F8..FF) may appear anywhere, including
+// inside SysEx, and are dropped. Any other status byte ends an unfinished SysEx, which is
+// discarded, as the MIDI spec says. Channel messages are emitted whole with
+// their status byte even when the sender used running status.
+class MidiStreamFramer {
+ public:
+  // SysEx longer than this, F0 and F7 included, is discarded rather than
+  // buffered without limit.
+  static constexpr size_t kDefaultMaxSysExSize = 1 << 20;
+
+  explicit MidiStreamFramer(size_t max_sysex_size = kDefaultMaxSysExSize);
+
+  MidiStreamFramer(const MidiStreamFramer&) = delete;
+  MidiStreamFramer& operator=(const MidiStreamFramer&) = delete;
+
+  // Consumes |size| bytes, calling |sink| for each message they complete.
+  void Feed(const uint8_t* data, size_t size, MidiMessageSink* sink);
+
+  // Forgets any partial message, e.g. after the device reconnects.
+  void Reset();
+
+  // Whether a SysEx has started and not yet ended.
+  bool in_sysex() const { return in_sysex_; }
+
+  uint64_t messages() const { return messages_; }
+  // SysEx cut short by another status byte or the size limit.
+  uint64_t sysex_discarded() const { return sysex_discarded_; }
+  // Data bytes with no status to belong to.
+  uint64_t stray_bytes() const { return stray_bytes_; }
+
+ private:
+  void Emit(const uint8_t* data, size_t size, MidiMessageSink* sink);
+  void DiscardSysEx(MidiMessageSink* sink);
+  void StartStatus(uint8_t status, MidiMessageSink* sink);
+
+  const size_t max_sysex_size_;
+  std::vector<uint8_t> sysex_;
+  bool in_sysex_;
+  bool sysex_overflowed_;
+  // The message being assembled outside SysEx.
+  uint8_t message_[3];
+  size_t message_size_;
+  size_t message_length_;  // 0 when there is no status to continue.
+  uint8_t running_status_;
+  uint64_t messages_;
+  uint64_t sysex_discarded_;
+  uint64_t stray_bytes_;
+};
+
+// Index of the first byte at or after |begin| with the high bit set (a
+// status byte), or |end| if there is none.
+size_t FindStatusByte(const uint8_t* data, size_t begin, size_t end);
+
+// Total length, status byte included, of a message starting with |status|
+// (0x80..0xF6, not F0), or 0 for a status with no fixed length.
+size_t MidiMessageLength(uint8_t status);
+
+}  // namespace nt_midi
+
+#endif  // NT_MIDI_MIDI_STREAM_FRAMER_H_
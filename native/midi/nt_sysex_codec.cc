@@ -0,0 +1,162 @@
+#include "nt_sysex_codec.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define NT_MIDI_CODEC_SSE2 1  // Part of the x86-64 baseline.
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define NT_MIDI_CODEC_NEON 1  // Mandatory on AArch64.
+#endif
+
+namespace nt_midi {
+
+// The nybble codecs and the byte sum work sixteen bytes at a time. The
+// 3- and 5-byte groups of Encode16() and friends do not line up with the
+// vector width, so those stay scalar: they handle a few hundred values
+// per message, and the compiler unrolls them.
+
+uint64_t EncodeNybbles(const uint8_t* bytes, size_t size, uint8_t* nybbles) {
+  uint64_t sum = 0;
+  size_t i = 0;
+#if defined(NT_MIDI_CODEC_SSE2)
+  const __m128i low_mask = _mm_set1_epi8(0x0F);
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sums = zero;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+    const __m128i high = _mm_and_si128(_mm_srli_epi16(v, 4), low_mask);
+    const __m128i low = _mm_and_si128(v, low_mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(nybbles + 2 * i),
+                     _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(nybbles + 2 * i + 16),
+                     _mm_unpackhi_epi8(high, low));
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_add_epi8(high, low), zero));
+  }
+  sum += static_cast<uint64_t>(_mm_cvtsi128_si64(sums)) +
+         static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+#elif defined(NT_MIDI_CODEC_NEON)
+  const uint8x16_t low_mask = vdupq_n_u8(0x0F);
+  uint64x2_t sums = vdupq_n_u64(0);
+  for (; i + 16 <= size; i += 16) {
+    const uint8x16_t v = vld1q_u8(bytes + i);
+    uint8x16x2_t pair;
+    pair.val[0] = vshrq_n_u8(v, 4);
+    pair.val[1] = vandq_u8(v, low_mask);
+    vst2q_u8(nybbles + 2 * i, pair);
+    sums = vpadalq_u32(sums, vpaddlq_u16(vpaddlq_u8(vaddq_u8(pair.val[0], pair.val[1]))));
+  }
+  sum += vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+#endif
+  for (; i < size; ++i) {
+    const uint8_t high = bytes[i] >> 4;
+    const uint8_t low = bytes[i] & 0x0F;
+    nybbles[2 * i] = high;
+    nybbles[2 * i + 1] = low;
+    sum += high + low;
+  }
+  return sum;
+}
+
+size_t DecodeNybbles(const uint8_t* nybbles, size_t size, uint8_t* bytes) {
+  const size_t count = size / 2;
+  size_t i = 0;
+#if defined(NT_MIDI_CODEC_SSE2)
+  // Each 16-bit lane holds a pair, high nybble in its low byte.
+  const __m128i pair_mask = _mm_set1_epi16(0x0F0F);
+  const __m128i high_mask = _mm_set1_epi16(0x000F);
+  for (; i + 16 <= count; i += 16) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nybbles + 2 * i));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(nybbles + 2 * i + 16));
+    a = _mm_and_si128(a, pair_mask);
+    b = _mm_and_si128(b, pair_mask);
+    a = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(a, high_mask), 4), _mm_srli_epi16(a, 8));
+    b = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(b, high_mask), 4), _mm_srli_epi16(b, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(bytes + i), _mm_packus_epi16(a, b));
+  }
+#elif defined(NT_MIDI_CODEC_NEON)
+  const uint8x16_t low_mask = vdupq_n_u8(0x0F);
+  for (; i + 16 <= count; i += 16) {
+    const uint8x16x2_t pair = vld2q_u8(nybbles + 2 * i);
+    vst1q_u8(bytes + i, vorrq_u8(vshlq_n_u8(pair.val[0], 4), vandq_u8(pair.val[1], low_mask)));
+  }
+#endif
+  for (; i < count; ++i) {
+    bytes[i] = static_cast<uint8_t>(((nybbles[2 * i] & 0x0F) << 4) | (nybbles[2 * i + 1] & 0x0F));
+  }
+  return count;
+}
+
+void Encode16(const uint16_t* values, size_t count, uint8_t* out) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint16_t v = values[i];
+    out[0] = static_cast<uint8_t>((v >> 14) & 0x03);
+    out[1] = static_cast<uint8_t>((v >> 7) & 0x7F);
+    out[2] = static_cast<uint8_t>(v & 0x7F);
+    out += 3;
+  }
+}
+
+void Encode32(const uint32_t* values, size_t count, uint8_t* out) {
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t v = values[i];
+    out[0] = static_cast<uint8_t>((v >> 28) & 0x0F);
+    out[1] = static_cast<uint8_t>((v >> 21) & 0x7F);
+    out[2] = static_cast<uint8_t>((v >> 14) & 0x7F);
+    out[3] = static_cast<uint8_t>((v >> 7) & 0x7F);
+    out[4] = static_cast<uint8_t>(v & 0x7F);
+    out += 5;
+  }
+}
+
+namespace {
+
+inline int16_t Value16(const uint8_t* data) {
+  return static_cast<int16_t>(static_cast<uint16_t>(((data[0] & 0x03) << 14) |
+                                                    ((data[1] & 0x7F) << 7) |
+                                                    (data[2] & 0x7F)));
+}
+
+}  // namespace
+
+void Decode16(const uint8_t* data, size_t count, int16_t* values) {
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = Value16(data);
+    data += 3;
+  }
+}
+
+void DecodeParameterValues(const uint8_t* data, size_t count, int16_t* values,
+                           uint8_t* flags) {
+  for (size_t i = 0; i < count; ++i) {
+    values[i] = Value16(data);
+    flags[i] = (data[0] >> 2) & 0x1F;
+    data += 3;
+  }
+}
+
+uint64_t SumBytes(const uint8_t* data, size_t size) {
+  uint64_t sum = 0;
+  size_t i = 0;
+#if defined(NT_MIDI_CODEC_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sums = zero;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    sums = _mm_add_epi64(sums, _mm_sad_epu8(v, zero));
+  }
+  sum += static_cast<uint64_t>(_mm_cvtsi128_si64(sums)) +
+         static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+#elif defined(NT_MIDI_CODEC_NEON)
+  uint64x2_t sums = vdupq_n_u64(0);
+  for (; i + 16 <= size; i += 16) {
+    sums = vpadalq_u32(sums, vpaddlq_u16(vpaddlq_u8(vld1q_u8(data + i))));
+  }
+  sum += vgetq_lane_u64(sums, 0) + vgetq_lane_u64(sums, 1);
+#endif
+  for (; i < size; ++i) {
+    sum += data[i];
+  }
+  return sum;
+}
+
+}  // namespace nt_midi
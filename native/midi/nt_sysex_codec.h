@@ -0,0 +1,56 @@
+#ifndef NT_MIDI_NT_SYSEX_CODEC_H_
+#define NT_MIDI_NT_SYSEX_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nt_midi {
+
+// Batch versions of the Disting NT's SysEx field encodings, matching
+// lib/domain/sysex/sysex_utils.dart byte for byte on well-formed input.
+// SysEx data bytes carry 7 bits, so the protocol sends 8-bit file data as
+// two nybbles, 16-bit values as three 7-bit groups (2 + 7 + 7 bits) and
+// 32-bit values as five (4 + 7 + 7 + 7 + 7 bits), most significant first.
+//
+// Output buffers are the caller's and must hold the sizes given; none may
+// overlap its input.
+
+// Writes each of |size| bytes as its high then low nybble, 2 * |size|
+// bytes in all, as bytesToNybbles(). Returns the sum of the nybbles
+// written, for the message checksum.
+uint64_t EncodeNybbles(const uint8_t* bytes, size_t size, uint8_t* nybbles);
+
+// Joins |size| nybbles pairwise into |size| / 2 bytes, as nybblesToBytes();
+// an odd last nybble is ignored. Only the low four bits of each count.
+// Returns the number of bytes written.
+size_t DecodeNybbles(const uint8_t* nybbles, size_t size, uint8_t* bytes);
+
+// Writes |count| values as encode16() does, 3 * |count| bytes.
+void Encode16(const uint16_t* values, size_t count, uint8_t* out);
+
+// Writes |count| values as encode32() does, 5 * |count| bytes.
+void Encode32(const uint32_t* values, size_t count, uint8_t* out);
+
+// Reads |count| signed values from 3 * |count| bytes, as decode16(). Only
+// the low two bits of each first byte belong to the value.
+void Decode16(const uint8_t* data, size_t count, int16_t* values);
+
+// Reads |count| parameter values in the 21-bit layout of the All
+// Parameter Values response: a 16-bit value as for Decode16(), with a
+// 5-bit flag field above it (1 means the parameter is disabled), which is
+// written to |flags|.
+void DecodeParameterValues(const uint8_t* data, size_t count, int16_t* values,
+                           uint8_t* flags);
+
+// The sum of |size| bytes.
+uint64_t SumBytes(const uint8_t* data, size_t size);
+
+// The Disting NT checksum of |size| bytes, as calculateChecksum(): the
+// 7-bit value that brings their sum to a multiple of 128.
+inline uint8_t SysExChecksum(const uint8_t* data, size_t size) {
+  return static_cast<uint8_t>((0 - SumBytes(data, size)) & 0x7F);
+}
+
+}  // namespace nt_midi
+
+#endif  // NT_MIDI_NT_SYSEX_CODEC_H_
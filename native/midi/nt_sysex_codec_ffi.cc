@@ -0,0 +1,51 @@
+#include "nt_sysex_codec_ffi.h"
+
+#include "nt_sysex_codec.h"
+
+int64_t nt_sysex_encode_nybbles(const uint8_t* bytes, int64_t size, uint8_t* nybbles) {
+  if (size <= 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(
+      nt_midi::EncodeNybbles(bytes, static_cast<size_t>(size), nybbles));
+}
+
+int64_t nt_sysex_decode_nybbles(const uint8_t* nybbles, int64_t size, uint8_t* bytes) {
+  if (size <= 0) {
+    return 0;
+  }
+  return static_cast<int64_t>(
+      nt_midi::DecodeNybbles(nybbles, static_cast<size_t>(size), bytes));
+}
+
+void nt_sysex_encode16(const uint16_t* values, int64_t count, uint8_t* out) {
+  if (count > 0) {
+    nt_midi::Encode16(values, static_cast<size_t>(count), out);
+  }
+}
+
+void nt_sysex_encode32(const uint32_t* values, int64_t count, uint8_t* out) {
+  if (count > 0) {
+    nt_midi::Encode32(values, static_cast<size_t>(count), out);
+  }
+}
+
+void nt_sysex_decode16(const uint8_t* data, int64_t count, int16_t* values) {
+  if (count > 0) {
+    nt_midi::Decode16(data, static_cast<size_t>(count), values);
+  }
+}
+
+void nt_sysex_decode_parameter_values(const uint8_t* data, int64_t count,
+                                      int16_t* values, uint8_t* flags) {
+  if (count > 0) {
+    nt_midi::DecodeParameterValues(data, static_cast<size_t>(count), values, flags);
+  }
+}
+
+int32_t nt_sysex_checksum(const uint8_t* data, int64_t size) {
+  if (size <= 0) {
+    return 0;
+  }
+  return nt_midi::SysExChecksum(data, static_cast<size_t>(size));
+}
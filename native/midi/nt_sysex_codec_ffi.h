@@ -0,0 +1,47 @@
+#ifndef NT_MIDI_NT_SYSEX_CODEC_FFI_H_
+#define NT_MIDI_NT_SYSEX_CODEC_FFI_H_
+
+/*
+ * C entry points of the SysEx field codec in libnt_sysex, which the app
+ * loads over dart:ffi (lib/services/platform_channels/native_sysex_codec.dart)
+ * to encode file uploads and decode bulk responses; see nt_sysex_codec.h
+ * for the formats.
+ *
+ * The functions keep no state: Dart passes its own native buffers, and
+ * outputs must hold the sizes given without overlapping the inputs.
+ * Negative sizes and counts do nothing.
+ */
+
+#include <stdint.h>
+
+#include "nt_sysex_ffi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Writes 2 * |size| nybbles; returns their sum, for the checksum. */
+NT_SYSEX_EXPORT int64_t nt_sysex_encode_nybbles(const uint8_t* bytes, int64_t size,
+                                                uint8_t* nybbles);
+
+/* Writes |size| / 2 bytes; returns that count. */
+NT_SYSEX_EXPORT int64_t nt_sysex_decode_nybbles(const uint8_t* nybbles, int64_t size,
+                                                uint8_t* bytes);
+
+/* Write 3 and 5 bytes per value. */
+NT_SYSEX_EXPORT void nt_sysex_encode16(const uint16_t* values, int64_t count, uint8_t* out);
+NT_SYSEX_EXPORT void nt_sysex_encode32(const uint32_t* values, int64_t count, uint8_t* out);
+
+/* Read 3 bytes per value; the second also writes each value's flags. */
+NT_SYSEX_EXPORT void nt_sysex_decode16(const uint8_t* data, int64_t count, int16_t* values);
+NT_SYSEX_EXPORT void nt_sysex_decode_parameter_values(const uint8_t* data, int64_t count,
+                                                      int16_t* values, uint8_t* flags);
+
+/* The 7-bit checksum of |size| bytes. */
+NT_SYSEX_EXPORT int32_t nt_sysex_checksum(const uint8_t* data, int64_t size);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif /* NT_MIDI_NT_SYSEX_CODEC_FFI_H_ */
@@ -0,0 +1,123 @@
+#include "nt_sysex_ffi.h"
+
+#include <new>
+#include <vector>
+
+#include "nt_sysex_reassembler.h"
+
+namespace {
+
+// Collects one Feed()'s events. Messages the framer assembled from several
+// packets live in its buffer, which the next partial message overwrites,
+// so those are copied aside; messages that arrived whole point straight
+// into the input.
+class EventCollector : public nt_midi::NtSysExSink {
+ public:
+  void Begin(const uint8_t* input, size_t size) {
+    input_ = input;
+    input_size_ = size;
+    events_.clear();
+    copies_.clear();
+    copied_.clear();
+  }
+
+  void OnNtSysEx(const nt_midi::NtSysExView& message) override {
+    NtSysExEvent& event = Add(NT_SYSEX_EVENT_MESSAGE, message.raw, message.raw_size);
+    event.sysex_id = message.sysex_id;
+    event.message_type = message.message_type;
+    event.payload_offset = static_cast<int32_t>(message.payload - message.raw);
+  }
+
+  void OnOtherMessage(const uint8_t* data, size_t size) override {
+    Add(NT_SYSEX_EVENT_OTHER, data, size);
+  }
+
+  void OnTruncated() override { Add(NT_SYSEX_EVENT_TRUNCATED, nullptr, 0); }
+
+  // Points the copied events at their bytes, now that the copy buffer has
+  // stopped growing.
+  void Finish() {
+    for (size_t i = 0; i < copied_.size(); ++i) {
+      events_[copied_[i].event].data = copies_.data() + copied_[i].offset;
+    }
+  }
+
+  const NtSysExEvent* data() const { return events_.data(); }
+  size_t size() const { return events_.size(); }
+
+ private:
+  struct Copied {
+    size_t event;
+    size_t offset;
+  };
+
+  NtSysExEvent& Add(int32_t kind, const uint8_t* data, size_t size) {
+    NtSysExEvent event = {};
+    event.kind = kind;
+    event.size = static_cast<int64_t>(size);
+    if (data != nullptr && !(data >= input_ && data + size <= input_ + input_size_)) {
+      copied_.push_back({events_.size(), copies_.size()});
+      copies_.insert(copies_.end(), data, data + size);
+    } else {
+      event.data = data;
+    }
+    events_.push_back(event);
+    return events_.back();
+  }
+
+  const uint8_t* input_ = nullptr;
+  size_t input_size_ = 0;
+  std::vector<NtSysExEvent> events_;
+  std::vector<uint8_t> copies_;
+  std::vector<Copied> copied_;
+};
+
+}  // namespace
+
+struct NtSysExParser {
+  nt_midi::NtSysExReassembler reassembler;
+  EventCollector events;
+  std::vector<uint8_t> input;
+};
+
+NtSysExParser* nt_sysex_create(void) { return new (std::nothrow) NtSysExParser(); }
+
+void nt_sysex_destroy(NtSysExParser* parser) { delete parser; }
+
+uint8_t* nt_sysex_input(NtSysExParser* parser, int64_t capacity) {
+  if (parser == nullptr || capacity < 0) {
+    return nullptr;
+  }
+  if (parser->input.size() < static_cast<size_t>(capacity)) {
+    try {
+      parser->input.resize(static_cast<size_t>(capacity));
+    } catch (const std::bad_alloc&) {
+      return nullptr;
+    }
+  }
+  return parser->input.data();
+}
+
+int64_t nt_sysex_feed(NtSysExParser* parser, int64_t size) {
+  if (parser == nullptr || size < 0 || static_cast<size_t>(size) > parser->input.size()) {
+    return 0;
+  }
+  parser->events.Begin(parser->input.data(), static_cast<size_t>(size));
+  parser->reassembler.Feed(parser->input.data(), static_cast<size_t>(size), &parser->events);
+  parser->events.Finish();
+  return static_cast<int64_t>(parser->events.size());
+}
+
+const NtSysExEvent* nt_sysex_events(NtSysExParser* parser) {
+  return parser == nullptr ? nullptr : parser->events.data();
+}
+
+int32_t nt_sysex_in_sysex(NtSysExParser* parser) {
+  return parser != nullptr && parser->reassembler.in_sysex() ? 1 : 0;
+}
+
+void nt_sysex_reset(NtSysExParser* parser) {
+  if (parser != nullptr) {
+    parser->reassembler.Reset();
+  }
+}
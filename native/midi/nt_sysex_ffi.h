@@ -0,0 +1,66 @@
+#ifndef NT_MIDI_NT_SYSEX_FFI_H_
+#define NT_MIDI_NT_SYSEX_FFI_H_
+
+/*
+ * C entry points of libnt_sysex, the SysEx reassembler the app loads over
+ * dart:ffi (lib/services/platform_channels/native_sysex_parser.dart) to
+ * split flutter_midi_command packets into Disting NT messages; see
+ * nt_sysex_reassembler.h.
+ *
+ * Dart writes each packet into the parser's input buffer, calls
+ * nt_sysex_feed() and reads the events it returns. Event data points into
+ * the input buffer where a message arrived whole, and into the parser
+ * otherwise; either way it stays valid until the next call on the parser.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define NT_SYSEX_EXPORT __declspec(dllexport)
+#else
+#define NT_SYSEX_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* Event kinds. */
+#define NT_SYSEX_EVENT_MESSAGE 0   /* A Disting NT SysEx message. */
+#define NT_SYSEX_EVENT_OTHER 1     /* Any other complete message. */
+#define NT_SYSEX_EVENT_TRUNCATED 2 /* A SysEx was cut short; no data. */
+
+typedef struct NtSysExEvent {
+  int32_t kind;
+  int32_t sysex_id;     /* MESSAGE only. */
+  int32_t message_type; /* MESSAGE only. */
+  int32_t payload_offset; /* MESSAGE only: payload start within |data|. */
+  const uint8_t* data;  /* The whole message. */
+  int64_t size;
+} NtSysExEvent;
+
+typedef struct NtSysExParser NtSysExParser;
+
+NT_SYSEX_EXPORT NtSysExParser* nt_sysex_create(void);
+NT_SYSEX_EXPORT void nt_sysex_destroy(NtSysExParser* parser);
+
+/* The input buffer, grown to hold at least |capacity| bytes. NULL if that
+ * much cannot be allocated. */
+NT_SYSEX_EXPORT uint8_t* nt_sysex_input(NtSysExParser* parser, int64_t capacity);
+
+/* Parses the first |size| bytes of the input buffer. Returns the number of
+ * events, which nt_sysex_events() then points to. */
+NT_SYSEX_EXPORT int64_t nt_sysex_feed(NtSysExParser* parser, int64_t size);
+NT_SYSEX_EXPORT const NtSysExEvent* nt_sysex_events(NtSysExParser* parser);
+
+/* Whether a SysEx has started and not yet ended. */
+NT_SYSEX_EXPORT int32_t nt_sysex_in_sysex(NtSysExParser* parser);
+
+/* Forgets any partial message. */
+NT_SYSEX_EXPORT void nt_sysex_reset(NtSysExParser* parser);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif /* NT_MIDI_NT_SYSEX_FFI_H_ */
@@ -0,0 +1,63 @@
+#include "nt_sysex_reassembler.h"
+
+namespace nt_midi {
+
+namespace {
+
+const uint8_t kHeader[] = {0xF0, 0x00, 0x21, 0x27, 0x6D};
+const size_t kHeaderSize = sizeof(kHeader);
+// Header, SysEx ID, message type and F7.
+const size_t kMinimumSize = kHeaderSize + 3;
+
+}  // namespace
+
+bool ParseNtSysEx(const uint8_t* data, size_t size, NtSysExView* view) {
+  if (size < kMinimumSize || data[size - 1] != 0xF7) {
+    return false;
+  }
+  for (size_t i = 0; i < kHeaderSize; ++i) {
+    if (data[i] != kHeader[i]) {
+      return false;
+    }
+  }
+  view->sysex_id = data[kHeaderSize] & 0x7F;
+  view->message_type = data[kHeaderSize + 1] & 0x7F;
+  view->payload = data + kHeaderSize + 2;
+  view->payload_size = size - kMinimumSize;
+  view->raw = data;
+  view->raw_size = size;
+  return true;
+}
+
+// Sorts the framer's messages into Disting NT SysEx and everything else.
+class NtSysExReassembler::Adapter : public MidiMessageSink {
+ public:
+  Adapter(NtSysExReassembler* owner, NtSysExSink* sink) : owner_(owner), sink_(sink) {}
+
+  void OnMessage(const uint8_t* data, size_t size) override {
+    NtSysExView view;
+    if (ParseNtSysEx(data, size, &view)) {
+      ++owner_->nt_messages_;
+      sink_->OnNtSysEx(view);
+    } else {
+      ++owner_->other_messages_;
+      sink_->OnOtherMessage(data, size);
+    }
+  }
+
+  void OnSysExDiscarded() override { sink_->OnTruncated(); }
+
+ private:
+  NtSysExReassembler* const owner_;
+  NtSysExSink* const sink_;
+};
+
+NtSysExReassembler::NtSysExReassembler(size_t max_sysex_size)
+    : framer_(max_sysex_size), nt_messages_(0), other_messages_(0) {}
+
+void NtSysExReassembler::Feed(const uint8_t* data, size_t size, NtSysExSink* sink) {
+  Adapter adapter(this, sink);
+  framer_.Feed(data, size, &adapter);
+}
+
+}  // namespace nt_midi
@@ -0,0 +1,83 @@
+#ifndef NT_MIDI_NT_SYSEX_REASSEMBLER_H_
+#define NT_MIDI_NT_SYSEX_REASSEMBLER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "midi_stream_framer.h"
+
+namespace nt_midi {
+
+// A Disting NT SysEx message:
+//   F0 00 21 27 6D <sysex id> <message type> <payload...> F7
+// All pointers are into the buffer the message was found in; nothing is
+// copied.
+struct NtSysExView {
+  uint8_t sysex_id;
+  uint8_t message_type;
+  const uint8_t* payload;
+  size_t payload_size;
+  const uint8_t* raw;  // The whole message, F0 to F7.
+  size_t raw_size;
+};
+
+// Fills |view| if |data| is exactly one Disting NT SysEx message, with the
+// Expert Sleepers manufacturer ID, the 6D prefix and at least a message
+// type. The same checks as decodeDistingNTSysEx() in
+// lib/domain/sysex/sysex_parser.dart.
+bool ParseNtSysEx(const uint8_t* data, size_t size, NtSysExView* view);
+
+// Receives what an NtSysExReassembler finds. Everything passed is valid only
+// for the duration of the call.
+class NtSysExSink {
+ public:
+  virtual ~NtSysExSink() {}
+
+  virtual void OnNtSysEx(const NtSysExView& message) = 0;
+
+  // Any other complete message: channel messages, such as the CCs of
+  // mapped parameters, and SysEx that is not from a Disting NT.
+  virtual void OnOtherMessage(const uint8_t* data, size_t size) = 0;
+
+  // A SysEx was cut short (a status byte inside it, or the size limit), so
+  // a response was lost. Reported as it happens, rather than left to a
+  // timeout.
+  virtual void OnTruncated() = 0;
+};
+
+// Turns USB-MIDI input, in whatever pieces the driver delivers it, into
+// Disting NT messages. Fragments are joined across Feed() calls, a buffer
+// may hold any number of messages, and realtime bytes are dropped wherever
+// they appear (see MidiStreamFramer).
+class NtSysExReassembler {
+ public:
+  explicit NtSysExReassembler(
+      size_t max_sysex_size = MidiStreamFramer::kDefaultMaxSysExSize);
+
+  NtSysExReassembler(const NtSysExReassembler&) = delete;
+  NtSysExReassembler& operator=(const NtSysExReassembler&) = delete;
+
+  void Feed(const uint8_t* data, size_t size, NtSysExSink* sink);
+
+  // Forgets any partial message, e.g. after input was lost.
+  void Reset() { framer_.Reset(); }
+
+  // Whether a SysEx has started and not yet ended.
+  bool in_sysex() const { return framer_.in_sysex(); }
+
+  uint64_t nt_messages() const { return nt_messages_; }
+  uint64_t other_messages() const { return other_messages_; }
+  uint64_t truncated() const { return framer_.sysex_discarded(); }
+  uint64_t stray_bytes() const { return framer_.stray_bytes(); }
+
+ private:
+  class Adapter;
+
+  MidiStreamFramer framer_;
+  uint64_t nt_messages_;
+  uint64_t other_messages_;
+};
+
+}  // namespace nt_midi
+
+#endif  // NT_MIDI_NT_SYSEX_REASSEMBLER_H_
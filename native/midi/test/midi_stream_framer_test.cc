@@ -0,0 +1,202 @@
+#include "midi_stream_framer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace nt_midi {
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+class CollectingSink : public MidiMessageSink {
+ public:
+  void OnMessage(const uint8_t* data, size_t size) override {
+    messages.emplace_back(data, data + size);
+  }
+
+  std::vector<Bytes> messages;
+};
+
+std::vector<Bytes> Frame(MidiStreamFramer* framer, const Bytes& bytes) {
+  CollectingSink sink;
+  framer->Feed(bytes.data(), bytes.size(), &sink);
+  return sink.messages;
+}
+
+TEST(MidiStreamFramerTest, EmitsWholeSysEx) {
+  MidiStreamFramer framer;
+  const Bytes sysex = {0xF0, 0x00, 0x21, 0x27, 0x6D, 0x00, 0x22, 0xF7};
+  const std::vector<Bytes> messages = Frame(&framer, sysex);
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0], sysex);
+  EXPECT_FALSE(framer.in_sysex());
+  EXPECT_EQ(framer.messages(), 1u);
+}
+
+TEST(MidiStreamFramerTest, JoinsSysExSplitAcrossFeeds) {
+  MidiStreamFramer framer;
+  const Bytes sysex = {0xF0, 0x00, 0x21, 0x27, 0x6D, 0x00, 0x11, 0x22, 0x33, 0xF7};
+  CollectingSink sink;
+  for (uint8_t byte : sysex) {
+    framer.Feed(&byte, 1, &sink);
+  }
+  ASSERT_EQ(sink.messages.size(), 1u);
+  EXPECT_EQ(sink.messages[0], sysex);
+}
+
+TEST(MidiStreamFramerTest, SplitsSeveralMessagesInOneFeed) {
+  MidiStreamFramer framer;
+  const std::vector<Bytes> messages =
+      Frame(&framer, {0xF0, 0x01, 0xF7, 0xB0, 0x07, 0x64, 0xF0, 0x02, 0x03, 0xF7});
+  ASSERT_EQ(messages.size(), 3u);
+  EXPECT_EQ(messages[0], Bytes({0xF0, 0x01, 0xF7}));
+  EXPECT_EQ(messages[1], Bytes({0xB0, 0x07, 0x64}));
+  EXPECT_EQ(messages[2], Bytes({0xF0, 0x02, 0x03, 0xF7}));
+}
+
+TEST(MidiStreamFramerTest, DropsRealtimeBytesInsideSysEx) {
+  MidiStreamFramer framer;
+  const std::vector<Bytes> messages = Frame(&framer, {0xF0, 0x01, 0xF8, 0x02, 0xFE, 0xF7});
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0], Bytes({0xF0, 0x01, 0x02, 0xF7}));
+}
+
+TEST(MidiStreamFramerTest, StatusByteDiscardsUnfinishedSysEx) {
+  MidiStreamFramer framer;
+  const std::vector<Bytes> messages =
+      Frame(&framer, {0xF0, 0x01, 0x02, 0xB1, 0x10, 0x20, 0xF0, 0x05, 0xF7});
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0], Bytes({0xB1, 0x10, 0x20}));
+  EXPECT_EQ(messages[1], Bytes({0xF0, 0x05, 0xF7}));
+  EXPECT_EQ(framer.sysex_discarded(), 1u);
+}
+
+TEST(MidiStreamFramerTest, NewSysExStartDiscardsUnfinishedOne) {
+  MidiStreamFramer framer;
+  const std::vector<Bytes> messages = Frame(&framer, {0xF0, 0x01, 0xF0, 0x02, 0xF7});
+  ASSERT_EQ(messages.size(), 1u);
+  EXPECT_EQ(messages[0], Bytes({0xF0, 0x02, 0xF7}));
+  EXPECT_EQ(framer.sysex_discarded(), 1u);
+}
+
+TEST(MidiStreamFramerTest, ExpandsRunningStatus) {
+  MidiStreamFramer framer;
+  const std::vector<Bytes> messages = Frame(&framer, {0xB0, 0x01, 0x02, 0x03, 0x04, 0x05});
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0], Bytes({0xB0, 0x01, 0x02}));
+  EXPECT_EQ(messages[1], Bytes({0xB0, 0x03, 0x04}));
+  // The trailing data byte waits for its partner.
+  EXPECT_EQ(Frame(&framer, {0x06}), std::vector<Bytes>({Bytes({0xB0, 0x05, 0x06})}));
+}
+
+TEST(MidiStreamFramerTest, SysExClearsRunningStatus) {
+  MidiStreamFramer framer;
+  const std::vector<Bytes> messages = Frame(&framer, {0xC0, 0x01, 0xF0, 0xF7, 0x02});
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0], Bytes({0xC0, 0x01}));
+  EXPECT_EQ(messages[1], Bytes({0xF0, 0xF7}));
+  EXPECT_EQ(framer.stray_bytes(), 1u);
+}
+
+TEST(MidiStreamFramerTest, CountsStrayBytes) {
+  MidiStreamFramer framer;
+  EXPECT_TRUE(Frame(&framer, {0x01, 0x02, 0xF7}).empty());
+  EXPECT_EQ(framer.stray_bytes(), 3u);
+}
+
+TEST(MidiStreamFramerTest, EmitsSingleByteSystemMessages) {
+  MidiStreamFramer framer;
+  const std::vector<Bytes> messages = Frame(&framer, {0xF6, 0xF2, 0x01, 0x02});
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0], Bytes({0xF6}));
+  EXPECT_EQ(messages[1], Bytes({0xF2, 0x01, 0x02}));
+}
+
+TEST(MidiStreamFramerTest, DiscardsOversizedSysEx) {
+  MidiStreamFramer framer(8);
+  EXPECT_TRUE(Frame(&framer, {0xF0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0xF7}).empty());
+  EXPECT_EQ(framer.sysex_discarded(), 1u);
+  // The next one still gets through.
+  EXPECT_EQ(Frame(&framer, {0xF0, 1, 0xF7}).size(), 1u);
+}
+
+TEST(MidiStreamFramerTest, SizeLimitIncludesTheEndByte) {
+  MidiStreamFramer framer(4);
+  const Bytes fits = {0xF0, 1, 2, 0xF7};
+  const Bytes too_long = {0xF0, 1, 2, 3, 0xF7};
+  EXPECT_EQ(Frame(&framer, fits).size(), 1u);
+  EXPECT_TRUE(Frame(&framer, too_long).empty());
+  // The same when the message is assembled across feeds.
+  CollectingSink sink;
+  for (uint8_t byte : fits) {
+    framer.Feed(&byte, 1, &sink);
+  }
+  for (uint8_t byte : too_long) {
+    framer.Feed(&byte, 1, &sink);
+  }
+  EXPECT_EQ(sink.messages.size(), 1u);
+  EXPECT_EQ(framer.sysex_discarded(), 2u);
+}
+
+TEST(MidiStreamFramerTest, WholeSysExIsPassedInPlace) {
+  MidiStreamFramer framer;
+  const Bytes input = {0xB0, 0x01, 0x02, 0xF0, 0x10, 0x20, 0xF7};
+  class PointerSink : public MidiMessageSink {
+   public:
+    void OnMessage(const uint8_t* data, size_t size) override {
+      if (data[0] == 0xF0) {
+        sysex = data;
+      }
+    }
+    const uint8_t* sysex = nullptr;
+  } sink;
+  framer.Feed(input.data(), input.size(), &sink);
+  EXPECT_EQ(sink.sysex, input.data() + 3);
+}
+
+TEST(MidiStreamFramerTest, ReportsDiscardedSysExToTheSink) {
+  MidiStreamFramer framer;
+  class DiscardSink : public MidiMessageSink {
+   public:
+    void OnMessage(const uint8_t*, size_t) override {}
+    void OnSysExDiscarded() override { ++discarded; }
+    int discarded = 0;
+  } sink;
+  const Bytes input = {0xF0, 0x01, 0x90, 0x40, 0x7F, 0xF0, 0x02, 0xF0, 0x03, 0xF7};
+  framer.Feed(input.data(), input.size(), &sink);
+  EXPECT_EQ(sink.discarded, 2);
+}
+
+TEST(MidiStreamFramerTest, FindsStatusBytesPastWordBoundaries) {
+  Bytes data(40, 0x11);
+  for (size_t at = 0; at < data.size(); ++at) {
+    data[at] = 0xF7;
+    EXPECT_EQ(FindStatusByte(data.data(), 0, data.size()), at);
+    EXPECT_EQ(FindStatusByte(data.data(), at + 1, data.size()), data.size());
+    data[at] = 0x11;
+  }
+}
+
+TEST(MidiStreamFramerTest, ResetForgetsPartialMessages) {
+  MidiStreamFramer framer;
+  Frame(&framer, {0xF0, 0x01});
+  EXPECT_TRUE(framer.in_sysex());
+  framer.Reset();
+  EXPECT_FALSE(framer.in_sysex());
+  EXPECT_TRUE(Frame(&framer, {0x02, 0xF7}).empty());
+}
+
+TEST(MidiStreamFramerTest, MessageLengths) {
+  EXPECT_EQ(MidiMessageLength(0x90), 3u);
+  EXPECT_EQ(MidiMessageLength(0xBF), 3u);
+  EXPECT_EQ(MidiMessageLength(0xC3), 2u);
+  EXPECT_EQ(MidiMessageLength(0xD0), 2u);
+  EXPECT_EQ(MidiMessageLength(0xF1), 2u);
+  EXPECT_EQ(MidiMessageLength(0xF2), 3u);
+  EXPECT_EQ(MidiMessageLength(0xF6), 1u);
+  EXPECT_EQ(MidiMessageLength(0xF4), 0u);
+}
+
+}  // namespace
+}  // namespace nt_midi
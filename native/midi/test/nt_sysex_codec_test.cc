@@ -0,0 +1,221 @@
+#include "nt_sysex_codec.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "nt_sysex_codec_ffi.h"
+
+namespace nt_midi {
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+// Straight ports of lib/domain/sysex/sysex_utils.dart, which the codec
+// must match byte for byte.
+Bytes DartBytesToNybbles(const Bytes& bytes) {
+  Bytes nybbles;
+  for (int byte : bytes) {
+    nybbles.push_back((byte >> 4) & 0x0F);
+    nybbles.push_back(byte & 0x0F);
+  }
+  return nybbles;
+}
+
+Bytes DartNybblesToBytes(const Bytes& nybbles) {
+  Bytes bytes;
+  for (size_t i = 0; i + 1 < nybbles.size(); i += 2) {
+    bytes.push_back(static_cast<uint8_t>(((nybbles[i] & 0x0F) << 4) | (nybbles[i + 1] & 0x0F)));
+  }
+  return bytes;
+}
+
+Bytes DartEncode16(int value) {
+  const int v = value & 0xFFFF;
+  return {static_cast<uint8_t>((v >> 14) & 0x03), static_cast<uint8_t>((v >> 7) & 0x7F),
+          static_cast<uint8_t>(v & 0x7F)};
+}
+
+Bytes DartEncode32(int64_t value) {
+  const int64_t v = value & 0xFFFFFFFF;
+  return {static_cast<uint8_t>((v >> 28) & 0x0F), static_cast<uint8_t>((v >> 21) & 0x7F),
+          static_cast<uint8_t>((v >> 14) & 0x7F), static_cast<uint8_t>((v >> 7) & 0x7F),
+          static_cast<uint8_t>(v & 0x7F)};
+}
+
+int DartDecode16(const uint8_t* data) {
+  int v = (data[0] << 14) | (data[1] << 7) | data[2];
+  if (v & 0x8000) {
+    v -= 0x10000;
+  }
+  return v;
+}
+
+int DartChecksum(const Bytes& payload) {
+  int sum = 0;
+  for (int byte : payload) {
+    sum += byte;
+  }
+  return (-sum) & 0x7F;
+}
+
+Bytes RandomBytes(size_t size, uint8_t max, unsigned seed) {
+  std::mt19937 random(seed);
+  Bytes bytes(size);
+  for (uint8_t& byte : bytes) {
+    byte = static_cast<uint8_t>(random() % (max + 1u));
+  }
+  return bytes;
+}
+
+// Sizes on both sides of the sixteen-byte vector width, so every length
+// of scalar tail is covered.
+const size_t kSizes[] = {0, 1, 2, 7, 15, 16, 17, 31, 32, 33, 63, 64, 100, 511, 512, 4099};
+
+TEST(NtSysExCodecTest, EncodeNybblesMatchesDart) {
+  for (size_t size : kSizes) {
+    const Bytes bytes = RandomBytes(size, 0xFF, static_cast<unsigned>(size));
+    Bytes nybbles(2 * size, 0xAA);
+    const uint64_t sum = EncodeNybbles(bytes.data(), size, nybbles.data());
+    const Bytes expected = DartBytesToNybbles(bytes);
+    EXPECT_EQ(expected, nybbles) << "size " << size;
+    uint64_t expected_sum = 0;
+    for (uint8_t n : expected) expected_sum += n;
+    EXPECT_EQ(expected_sum, sum) << "size " << size;
+  }
+}
+
+TEST(NtSysExCodecTest, EncodeNybblesCoversEveryByteValue) {
+  Bytes bytes(256);
+  for (int i = 0; i < 256; ++i) bytes[i] = static_cast<uint8_t>(i);
+  Bytes nybbles(512);
+  EXPECT_EQ(256u * 15, EncodeNybbles(bytes.data(), bytes.size(), nybbles.data()));
+  EXPECT_EQ(DartBytesToNybbles(bytes), nybbles);
+}
+
+TEST(NtSysExCodecTest, DecodeNybblesMatchesDart) {
+  for (size_t size : kSizes) {
+    // Full 7-bit data bytes, so the masking is checked too.
+    const Bytes nybbles = RandomBytes(size, 0x7F, static_cast<unsigned>(size) + 1);
+    Bytes bytes(size / 2 + 1, 0xAA);
+    EXPECT_EQ(size / 2, DecodeNybbles(nybbles.data(), size, bytes.data()));
+    bytes.resize(size / 2);
+    EXPECT_EQ(DartNybblesToBytes(nybbles), bytes) << "size " << size;
+  }
+}
+
+TEST(NtSysExCodecTest, NybblesRoundTrip) {
+  const Bytes bytes = RandomBytes(1000, 0xFF, 5);
+  Bytes nybbles(2000);
+  Bytes decoded(1000);
+  EncodeNybbles(bytes.data(), bytes.size(), nybbles.data());
+  DecodeNybbles(nybbles.data(), nybbles.size(), decoded.data());
+  EXPECT_EQ(bytes, decoded);
+}
+
+TEST(NtSysExCodecTest, Encode16MatchesDart) {
+  std::vector<uint16_t> values;
+  Bytes expected;
+  for (int value = -32768; value <= 65535; value += 97) {
+    values.push_back(static_cast<uint16_t>(value));
+    const Bytes encoded = DartEncode16(value);
+    expected.insert(expected.end(), encoded.begin(), encoded.end());
+  }
+  Bytes out(3 * values.size());
+  Encode16(values.data(), values.size(), out.data());
+  EXPECT_EQ(expected, out);
+}
+
+TEST(NtSysExCodecTest, Encode32MatchesDart) {
+  const int64_t samples[] = {0, 1, 127, 128, 0x3FFF, 0x4000, 0x0FFFFFFF, 0x10000000,
+                             0x7FFFFFFF, 0x80000000, 0xFFFFFFFF, 1234567890};
+  std::vector<uint32_t> values;
+  Bytes expected;
+  for (int64_t value : samples) {
+    values.push_back(static_cast<uint32_t>(value));
+    const Bytes encoded = DartEncode32(value);
+    expected.insert(expected.end(), encoded.begin(), encoded.end());
+  }
+  Bytes out(5 * values.size());
+  Encode32(values.data(), values.size(), out.data());
+  EXPECT_EQ(expected, out);
+}
+
+TEST(NtSysExCodecTest, Decode16MatchesDartOnEveryValue) {
+  std::vector<uint16_t> values(65536);
+  for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<uint16_t>(i);
+  Bytes encoded(3 * values.size());
+  Encode16(values.data(), values.size(), encoded.data());
+
+  std::vector<int16_t> decoded(values.size());
+  Decode16(encoded.data(), values.size(), decoded.data());
+  for (size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(DartDecode16(&encoded[3 * i]), decoded[i]) << "value " << i;
+  }
+}
+
+TEST(NtSysExCodecTest, DecodeParameterValuesSplitsOffTheFlags) {
+  // As AllParameterValuesResponse: the flag field sits above the value in
+  // the first byte and is masked off before decode16().
+  const Bytes data = RandomBytes(3 * 300, 0x7F, 9);
+  std::vector<int16_t> values(300);
+  Bytes flags(300);
+  DecodeParameterValues(data.data(), 300, values.data(), flags.data());
+  for (size_t i = 0; i < 300; ++i) {
+    const uint8_t masked[] = {static_cast<uint8_t>(data[3 * i] & 0x03), data[3 * i + 1],
+                              data[3 * i + 2]};
+    ASSERT_EQ(DartDecode16(masked), values[i]) << "parameter " << i;
+    ASSERT_EQ((data[3 * i] >> 2) & 0x1F, flags[i]) << "parameter " << i;
+  }
+}
+
+TEST(NtSysExCodecTest, ChecksumMatchesDart) {
+  for (size_t size : kSizes) {
+    const Bytes payload = RandomBytes(size, 0x7F, static_cast<unsigned>(size) + 2);
+    EXPECT_EQ(DartChecksum(payload), SysExChecksum(payload.data(), size)) << "size " << size;
+  }
+}
+
+TEST(NtSysExCodecFfiTest, WrapsTheCodec) {
+  const Bytes bytes = RandomBytes(50, 0xFF, 11);
+  Bytes nybbles(100);
+  Bytes decoded(50);
+  const int64_t sum = nt_sysex_encode_nybbles(bytes.data(), 50, nybbles.data());
+  EXPECT_EQ(DartBytesToNybbles(bytes), nybbles);
+  EXPECT_EQ(50, nt_sysex_decode_nybbles(nybbles.data(), 100, decoded.data()));
+  EXPECT_EQ(bytes, decoded);
+  EXPECT_EQ(static_cast<int32_t>((0 - sum) & 0x7F),
+            nt_sysex_checksum(nybbles.data(), 100));
+
+  const uint16_t values[] = {0, 0xFFFF, 0x8000};
+  uint8_t encoded[9];
+  int16_t round_trip[3];
+  uint8_t flags[3];
+  nt_sysex_encode16(values, 3, encoded);
+  nt_sysex_decode16(encoded, 3, round_trip);
+  EXPECT_EQ(0, round_trip[0]);
+  EXPECT_EQ(-1, round_trip[1]);
+  EXPECT_EQ(-32768, round_trip[2]);
+  encoded[0] |= 1 << 2;
+  nt_sysex_decode_parameter_values(encoded, 3, round_trip, flags);
+  EXPECT_EQ(1, flags[0]);
+  EXPECT_EQ(0, round_trip[0]);
+
+  const uint32_t big[] = {0xFFFFFFFF};
+  uint8_t encoded32[5];
+  nt_sysex_encode32(big, 1, encoded32);
+  EXPECT_EQ(DartEncode32(0xFFFFFFFF), Bytes(encoded32, encoded32 + 5));
+}
+
+TEST(NtSysExCodecFfiTest, IgnoresNegativeSizes) {
+  uint8_t out[4] = {1, 2, 3, 4};
+  EXPECT_EQ(0, nt_sysex_encode_nybbles(out, -1, out));
+  EXPECT_EQ(0, nt_sysex_decode_nybbles(out, -4, out));
+  EXPECT_EQ(0, nt_sysex_checksum(out, -1));
+  nt_sysex_encode16(nullptr, -1, out);
+  EXPECT_EQ(1, out[0]);
+}
+
+}  // namespace
+}  // namespace nt_midi
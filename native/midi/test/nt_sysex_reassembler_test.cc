@@ -0,0 +1,223 @@
+#include "nt_sysex_reassembler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "nt_sysex_ffi.h"
+
+namespace nt_midi {
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+Bytes NtSysEx(uint8_t sysex_id, uint8_t type, const Bytes& payload) {
+  Bytes message(payload.size() + 8);
+  const uint8_t header[] = {0xF0, 0x00, 0x21, 0x27, 0x6D, sysex_id, type};
+  std::copy(header, header + 7, message.begin());
+  std::copy(payload.begin(), payload.end(), message.begin() + 7);
+  message.back() = 0xF7;
+  return message;
+}
+
+Bytes Concat(const std::vector<Bytes>& parts) {
+  Bytes out;
+  for (const Bytes& part : parts) {
+    out.insert(out.end(), part.begin(), part.end());
+  }
+  return out;
+}
+
+struct Message {
+  uint8_t sysex_id;
+  uint8_t type;
+  Bytes payload;
+};
+
+class RecordingSink : public NtSysExSink {
+ public:
+  void OnNtSysEx(const NtSysExView& message) override {
+    messages.push_back({message.sysex_id, message.message_type,
+                        Bytes(message.payload, message.payload + message.payload_size)});
+    last_raw = message.raw;
+  }
+  void OnOtherMessage(const uint8_t* data, size_t size) override {
+    others.emplace_back(data, data + size);
+  }
+  void OnTruncated() override { ++truncated; }
+
+  std::vector<Message> messages;
+  std::vector<Bytes> others;
+  int truncated = 0;
+  const uint8_t* last_raw = nullptr;
+};
+
+TEST(ParseNtSysExTest, AcceptsTheDistingHeader) {
+  const Bytes message = NtSysEx(3, 0x32, {1, 2, 3});
+  NtSysExView view;
+  ASSERT_TRUE(ParseNtSysEx(message.data(), message.size(), &view));
+  EXPECT_EQ(view.sysex_id, 3);
+  EXPECT_EQ(view.message_type, 0x32);
+  EXPECT_EQ(view.payload, message.data() + 7);
+  EXPECT_EQ(view.payload_size, 3u);
+  EXPECT_EQ(view.raw_size, message.size());
+}
+
+TEST(ParseNtSysExTest, RejectsOtherMessages) {
+  NtSysExView view;
+  Bytes message = NtSysEx(0, 0x32, {});
+  EXPECT_TRUE(ParseNtSysEx(message.data(), message.size(), &view));
+  EXPECT_FALSE(ParseNtSysEx(message.data(), message.size() - 1, &view));
+
+  Bytes wrong_maker = message;
+  wrong_maker[3] = 0x28;
+  EXPECT_FALSE(ParseNtSysEx(wrong_maker.data(), wrong_maker.size(), &view));
+
+  Bytes wrong_prefix = message;
+  wrong_prefix[4] = 0x6C;
+  EXPECT_FALSE(ParseNtSysEx(wrong_prefix.data(), wrong_prefix.size(), &view));
+
+  const Bytes no_type = {0xF0, 0x00, 0x21, 0x27, 0x6D, 0x00, 0xF7};
+  EXPECT_FALSE(ParseNtSysEx(no_type.data(), no_type.size(), &view));
+}
+
+TEST(NtSysExReassemblerTest, JoinsFragmentsAndSplitsBuffers) {
+  const Bytes first = NtSysEx(0, 0x11, {1, 2, 3, 4, 5, 6, 7, 8, 9});
+  const Bytes second = NtSysEx(0, 0x12, {});
+  const Bytes stream = Concat({first, {0xB0, 0x05, 0x06}, second});
+
+  // Every way of cutting the stream in two gives the same messages.
+  for (size_t cut = 0; cut <= stream.size(); ++cut) {
+    NtSysExReassembler reassembler;
+    RecordingSink sink;
+    reassembler.Feed(stream.data(), cut, &sink);
+    reassembler.Feed(stream.data() + cut, stream.size() - cut, &sink);
+    ASSERT_EQ(sink.messages.size(), 2u) << cut;
+    EXPECT_EQ(sink.messages[0].type, 0x11);
+    EXPECT_EQ(sink.messages[0].payload, Bytes({1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(sink.messages[1].type, 0x12);
+    EXPECT_TRUE(sink.messages[1].payload.empty());
+    EXPECT_EQ(sink.others, std::vector<Bytes>({{0xB0, 0x05, 0x06}}));
+    EXPECT_EQ(sink.truncated, 0);
+  }
+}
+
+TEST(NtSysExReassemblerTest, PayloadViewsPointIntoWholeBuffers) {
+  const Bytes message = NtSysEx(0, 0x11, {1, 2});
+  NtSysExReassembler reassembler;
+  RecordingSink sink;
+  reassembler.Feed(message.data(), message.size(), &sink);
+  EXPECT_EQ(sink.last_raw, message.data());
+}
+
+TEST(NtSysExReassemblerTest, SkipsRealtimeBytes) {
+  Bytes stream = NtSysEx(0, 0x11, {1, 2, 3});
+  stream.insert(stream.begin() + 4, 0xF8);
+  stream.insert(stream.begin() + 9, 0xFE);
+  NtSysExReassembler reassembler;
+  RecordingSink sink;
+  reassembler.Feed(stream.data(), stream.size(), &sink);
+  ASSERT_EQ(sink.messages.size(), 1u);
+  EXPECT_EQ(sink.messages[0].payload, Bytes({1, 2, 3}));
+}
+
+TEST(NtSysExReassemblerTest, ReportsTruncatedMessages) {
+  const Bytes message = NtSysEx(0, 0x11, {1, 2, 3});
+  // The start of one response, then a whole one: the first is lost.
+  const Bytes stream = Concat({Bytes(message.begin(), message.begin() + 6), message});
+  NtSysExReassembler reassembler;
+  RecordingSink sink;
+  reassembler.Feed(stream.data(), stream.size(), &sink);
+  EXPECT_EQ(sink.truncated, 1);
+  EXPECT_EQ(sink.messages.size(), 1u);
+  EXPECT_EQ(reassembler.truncated(), 1u);
+}
+
+TEST(NtSysExReassemblerTest, PassesForeignSysExOn) {
+  const Bytes foreign = {0xF0, 0x7E, 0x7F, 0x06, 0x02, 0xF7};
+  NtSysExReassembler reassembler;
+  RecordingSink sink;
+  reassembler.Feed(foreign.data(), foreign.size(), &sink);
+  EXPECT_TRUE(sink.messages.empty());
+  EXPECT_EQ(sink.others, std::vector<Bytes>({foreign}));
+  EXPECT_EQ(reassembler.other_messages(), 1u);
+}
+
+TEST(NtSysExReassemblerTest, InSysExUntilTheEnd) {
+  const Bytes message = NtSysEx(0, 0x11, {1});
+  NtSysExReassembler reassembler;
+  RecordingSink sink;
+  reassembler.Feed(message.data(), 4, &sink);
+  EXPECT_TRUE(reassembler.in_sysex());
+  reassembler.Reset();
+  EXPECT_FALSE(reassembler.in_sysex());
+  reassembler.Feed(message.data() + 4, message.size() - 4, &sink);
+  EXPECT_TRUE(sink.messages.empty());
+}
+
+class SysExFfiTest : public ::testing::Test {
+ protected:
+  void SetUp() override { parser_ = nt_sysex_create(); }
+  void TearDown() override { nt_sysex_destroy(parser_); }
+
+  int64_t Feed(const Bytes& bytes) {
+    uint8_t* input = nt_sysex_input(parser_, static_cast<int64_t>(bytes.size()));
+    memcpy(input, bytes.data(), bytes.size());
+    return nt_sysex_feed(parser_, static_cast<int64_t>(bytes.size()));
+  }
+
+  NtSysExParser* parser_;
+};
+
+TEST_F(SysExFfiTest, ReturnsEventsInOrder) {
+  const Bytes first = NtSysEx(1, 0x11, {1, 2, 3});
+  const Bytes second = NtSysEx(1, 0x12, {4});
+  // The end of |first|, a CC, all of |second|, the start of another.
+  ASSERT_EQ(Feed(Bytes(first.begin(), first.begin() + 5)), 0);
+  EXPECT_EQ(nt_sysex_in_sysex(parser_), 1);
+  const Bytes rest = Concat({Bytes(first.begin() + 5, first.end()), {0xB0, 1, 2}, second,
+                             Bytes(first.begin(), first.begin() + 3)});
+  ASSERT_EQ(Feed(rest), 3);
+  const NtSysExEvent* events = nt_sysex_events(parser_);
+
+  EXPECT_EQ(events[0].kind, NT_SYSEX_EVENT_MESSAGE);
+  EXPECT_EQ(events[0].sysex_id, 1);
+  EXPECT_EQ(events[0].message_type, 0x11);
+  EXPECT_EQ(Bytes(events[0].data, events[0].data + events[0].size), first);
+  EXPECT_EQ(events[0].payload_offset, 7);
+
+  EXPECT_EQ(events[1].kind, NT_SYSEX_EVENT_OTHER);
+  EXPECT_EQ(Bytes(events[1].data, events[1].data + events[1].size), Bytes({0xB0, 1, 2}));
+
+  EXPECT_EQ(events[2].kind, NT_SYSEX_EVENT_MESSAGE);
+  EXPECT_EQ(Bytes(events[2].data, events[2].data + events[2].size), second);
+  // A message that arrived whole is not copied.
+  const uint8_t* input = nt_sysex_input(parser_, 0);
+  EXPECT_GE(events[2].data, input);
+  EXPECT_LT(events[2].data, input + rest.size());
+  EXPECT_EQ(nt_sysex_in_sysex(parser_), 1);
+}
+
+TEST_F(SysExFfiTest, ReportsTruncation) {
+  const Bytes message = NtSysEx(0, 0x11, {1, 2});
+  ASSERT_EQ(Feed(Concat({Bytes(message.begin(), message.begin() + 6), {0xC0, 0x05}})), 2);
+  const NtSysExEvent* events = nt_sysex_events(parser_);
+  EXPECT_EQ(events[0].kind, NT_SYSEX_EVENT_TRUNCATED);
+  EXPECT_EQ(events[0].size, 0);
+  EXPECT_EQ(events[1].kind, NT_SYSEX_EVENT_OTHER);
+
+  Feed(Bytes(message.begin(), message.begin() + 3));
+  nt_sysex_reset(parser_);
+  EXPECT_EQ(nt_sysex_in_sysex(parser_), 0);
+}
+
+TEST_F(SysExFfiTest, RejectsFeedingMoreThanTheInput) {
+  nt_sysex_input(parser_, 4);
+  EXPECT_EQ(nt_sysex_feed(parser_, 1 << 20), 0);
+  EXPECT_EQ(nt_sysex_feed(nullptr, 0), 0);
+}
+
+}  // namespace
+}  // namespace nt_midi
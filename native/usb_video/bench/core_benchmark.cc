@@ -0,0 +1,219 @@
+// Microbenchmarks of the per-frame work in usb_video_core, on Disting NT
+// sized frames (256x64 YUYV). Each reports bytes per second of input, so
+// kernels with different outputs compare directly. Examples:
+//
+//   usb_video_core_benchmark
+//   usb_video_core_benchmark --benchmark_filter='Yuyv|Bmp'
+//   usb_video_core_benchmark --benchmark_repetitions=10 --benchmark_report_aggregates_only=true
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "bmp_encoder.h"
+#include "delta_frame.h"
+#include "frame_encoder.h"
+#include "frame_hash.h"
+#include "frame_pool.h"
+#include "gray4.h"
+#include "lz_codec.h"
+#include "screenshot.h"
+#include "yuyv_convert.h"
+
+namespace usb_video {
+namespace {
+
+const int kWidth = 256;
+const int kHeight = 64;
+const size_t kPixels = kWidth * kHeight;
+const size_t kYuyvSize = kPixels * 2;
+
+// A mostly dark display with a few lines of "text", like the module's
+// screens; |frame| shifts the text so consecutive frames differ a little.
+std::vector<uint8_t> DisplayFrame(int frame) {
+  std::vector<uint8_t> yuyv(kYuyvSize);
+  for (size_t i = 0; i < kPixels; ++i) {
+    yuyv[i * 2] = 16;
+    yuyv[i * 2 + 1] = 128;
+  }
+  std::mt19937 random(7);
+  for (int y = 8; y < kHeight - 8; y += 10) {
+    for (int x = 16; x < kWidth - 16; ++x) {
+      const uint8_t luma = static_cast<uint8_t>(16 + random() % 220);
+      const int row = y + (x + frame) % 6;
+      yuyv[(row * kWidth + x) * 2] = luma;
+    }
+  }
+  return yuyv;
+}
+
+// Fresh noise: the worst case for deltas and compression.
+std::vector<uint8_t> NoiseFrame() {
+  std::vector<uint8_t> yuyv(kYuyvSize);
+  std::mt19937 random(11);
+  for (uint8_t& byte : yuyv) {
+    byte = static_cast<uint8_t>(random());
+  }
+  return yuyv;
+}
+
+void SetInputBytes(benchmark::State& state, size_t bytes) {
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+}
+
+// One run per kernel the CPU supports; the argument indexes
+// AvailableYuyvKernels().
+const YuyvKernel* KernelOrSkip(benchmark::State& state) {
+  const YuyvKernel* kernels[8];
+  const size_t count = AvailableYuyvKernels(kernels, 8);
+  const size_t index = static_cast<size_t>(state.range(0));
+  if (index >= count) {
+    state.SkipWithError("kernel not supported on this CPU");
+    return nullptr;
+  }
+  state.SetLabel(kernels[index]->name);
+  return kernels[index];
+}
+
+void BM_YuyvToRgb24(benchmark::State& state) {
+  const YuyvKernel* kernel = KernelOrSkip(state);
+  if (kernel == nullptr) return;
+  const std::vector<uint8_t> yuyv = NoiseFrame();
+  std::vector<uint8_t> rgb(kPixels * 3);
+  for (auto _ : state) {
+    kernel->to_rgb24(yuyv.data(), kPixels, rgb.data());
+    benchmark::DoNotOptimize(rgb.data());
+    benchmark::ClobberMemory();
+  }
+  SetInputBytes(state, kYuyvSize);
+}
+BENCHMARK(BM_YuyvToRgb24)->DenseRange(0, 2);
+
+void BM_YuyvToRgba(benchmark::State& state) {
+  const YuyvKernel* kernel = KernelOrSkip(state);
+  if (kernel == nullptr) return;
+  const std::vector<uint8_t> yuyv = NoiseFrame();
+  std::vector<uint8_t> rgba(kPixels * 4);
+  for (auto _ : state) {
+    kernel->to_rgba(yuyv.data(), kPixels, rgba.data());
+    benchmark::DoNotOptimize(rgba.data());
+    benchmark::ClobberMemory();
+  }
+  SetInputBytes(state, kYuyvSize);
+}
+BENCHMARK(BM_YuyvToRgba)->DenseRange(0, 2);
+
+void BM_EncodeBmp24(benchmark::State& state) {
+  std::vector<uint8_t> rgb(kPixels * 3);
+  ConvertYuyvToRgb24(DisplayFrame(0).data(), kPixels, rgb.data());
+  std::vector<uint8_t> bmp(BmpFileSize(kWidth, kHeight));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(EncodeBmp24(rgb.data(), kWidth, kHeight, bmp.data()));
+    benchmark::ClobberMemory();
+  }
+  SetInputBytes(state, rgb.size());
+}
+BENCHMARK(BM_EncodeBmp24);
+
+void BM_PackYuyvToGray4(benchmark::State& state) {
+  const std::vector<uint8_t> yuyv = DisplayFrame(0);
+  std::vector<uint8_t> gray4(Gray4FrameSize(kWidth, kHeight));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PackYuyvToGray4(yuyv.data(), kWidth, kHeight, gray4.data()));
+    benchmark::ClobberMemory();
+  }
+  SetInputBytes(state, kYuyvSize);
+}
+BENCHMARK(BM_PackYuyvToGray4);
+
+void BM_HashFrame(benchmark::State& state) {
+  const std::vector<uint8_t> yuyv = DisplayFrame(0);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(HashFrame(yuyv.data(), yuyv.size()));
+  }
+  SetInputBytes(state, kYuyvSize);
+}
+BENCHMARK(BM_HashFrame);
+
+// Alternates two BMP frames that differ in a few rows, as a changing
+// display does; a keyframe is never due.
+void BM_DeltaEncodeBmp(benchmark::State& state) {
+  const FrameLayout layout = BmpFrameLayout(kWidth, kHeight);
+  std::vector<uint8_t> frames[2];
+  std::vector<uint8_t> rgb(kPixels * 3);
+  for (int i = 0; i < 2; ++i) {
+    ConvertYuyvToRgb24(DisplayFrame(i).data(), kPixels, rgb.data());
+    frames[i].resize(layout.frame_size());
+    EncodeBmp24(rgb.data(), kWidth, kHeight, frames[i].data());
+  }
+  std::vector<uint8_t> scratch(MaxDeltaFrameSize(layout));
+  DeltaFrameEncoder encoder;
+  encoder.Reset(layout, 1 << 30);
+  int n = 0;
+  for (auto _ : state) {
+    DeltaFrameEncoder::Output out = encoder.Encode(frames[n++ & 1].data(), scratch.data());
+    benchmark::DoNotOptimize(out.size);
+  }
+  SetInputBytes(state, layout.frame_size());
+}
+BENCHMARK(BM_DeltaEncodeBmp);
+
+// Everything the main loop does to a new frame for one BMP delta receiver
+// and one gray4 delta receiver.
+void BM_FrameEncoder(benchmark::State& state) {
+  const std::vector<uint8_t> frames[2] = {DisplayFrame(0), DisplayFrame(1)};
+  FrameEncoder encoder;
+  if (!encoder.Reset(kWidth, kHeight, 1 << 30)) {
+    state.SkipWithError("allocation failed");
+    return;
+  }
+  FrameEncoder::Request request = {};
+  request.delta[FrameEncoder::kBmp] = true;
+  request.delta[FrameEncoder::kGray4] = true;
+  int n = 0;
+  for (auto _ : state) {
+    FrameEncoder::Timing timing = encoder.Encode(frames[n++ & 1].data(), kYuyvSize, request);
+    benchmark::DoNotOptimize(timing.encoded);
+  }
+  SetInputBytes(state, kYuyvSize);
+}
+BENCHMARK(BM_FrameEncoder);
+
+// Restarting a stream of the same size reuses the pool's block.
+void BM_FramePoolReserve(benchmark::State& state) {
+  FramePool pool;
+  pool.Reserve(8, kYuyvSize);
+  size_t n = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(pool.Reserve(8 - (n++ & 1), kYuyvSize));
+  }
+}
+BENCHMARK(BM_FramePoolReserve);
+
+void BM_LzCompress(benchmark::State& state) {
+  std::vector<uint8_t> gray4(Gray4FrameSize(kWidth, kHeight));
+  PackYuyvToGray4(DisplayFrame(0).data(), kWidth, kHeight, gray4.data());
+  std::vector<uint8_t> out(LzCompressBound(gray4.size()));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LzCompress(gray4.data(), gray4.size(), out.data()));
+    benchmark::ClobberMemory();
+  }
+  SetInputBytes(state, gray4.size());
+}
+BENCHMARK(BM_LzCompress);
+
+void BM_ScreenshotFromYuyv(benchmark::State& state) {
+  const std::vector<uint8_t> yuyv = DisplayFrame(0);
+  ScreenshotEncoder encoder;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(encoder.EncodeYuyv(yuyv.data(), kWidth, kHeight));
+  }
+  SetInputBytes(state, kYuyvSize);
+}
+BENCHMARK(BM_ScreenshotFromYuyv);
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,337 @@
+// Runs the capture pipeline headless, from a SyntheticCaptureBackend through
+// suppression, the triple-buffer handoff and encoding, and reports
+// throughput, latency percentiles and heap allocations per frame.
+//
+// The two threads do what linux/usb_video_session.cc does on the capture
+// thread and the main loop, with the event channel send replaced by a copy
+// into a preallocated buffer. Examples:
+//
+//   usb_video_pipeline_bench                        # unpaced, BMP
+//   usb_video_pipeline_bench --format=gray4 --delta --frames=20000
+//   usb_video_pipeline_bench --source=fps=60,jitter=2000 --frames=600
+//   usb_video_pipeline_bench --source=replay=session.ntrec,fps=0
+//   usb_video_pipeline_bench --keep-alive-ms=1000 --source=pattern=bar,hold=8
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "capture_backend.h"
+#include "frame_encoder.h"
+#include "frame_pool.h"
+#include "frame_suppressor.h"
+#include "latency_histogram.h"
+#include "pipeline_telemetry.h"
+#include "synthetic_capture_backend.h"
+#include "triple_buffer.h"
+#include "yuyv_convert.h"
+
+// Counts every global operator new per thread, so each side of the pipeline
+// can report its own allocations without seeing the other's.
+namespace {
+thread_local uint64_t t_allocations = 0;
+}  // namespace
+
+void* operator new(size_t size) {
+  ++t_allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace usb_video {
+namespace {
+
+const size_t kHandoffSlots = 3;
+const int kDeltaKeyframeInterval = 60;
+
+struct BenchOptions {
+  BenchOptions()
+      : frames(5000), gray4(false), delta(false), keep_alive_us(0) {
+    source.fps = 0;
+  }
+
+  uint64_t frames;
+  SyntheticCaptureBackend::Options source;
+  bool gray4;
+  bool delta;
+  int64_t keep_alive_us;
+};
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// The pipeline state shared by the two threads, laid out like
+// UsbVideoSession.
+struct Pipeline {
+  CaptureBackend* backend;
+  FramePool frame_pool;
+  TripleBuffer<FrameSlot> frame_buffer;
+  FrameSuppressor suppressor;
+  FrameEncoder encoder;
+  FrameEncoder::Request request;
+  PipelineTelemetry telemetry;
+  // Capture to the payload being handed over, per delivered frame.
+  LatencyHistogram end_to_end;
+  std::vector<uint8_t> sent;
+
+  int frame_ready_fd;
+  std::atomic<bool> delivery_pending;
+  std::atomic<bool> capturing;
+
+  uint64_t frames_captured;
+  uint64_t frames_delivered;
+  uint64_t bytes_delivered;
+  uint64_t capture_allocations;
+  uint64_t deliver_allocations;
+};
+
+void RequestDelivery(Pipeline* pipeline) {
+  if (!pipeline->delivery_pending.exchange(true)) {
+    eventfd_write(pipeline->frame_ready_fd, 1);
+  }
+}
+
+void CaptureThread(Pipeline* pipeline, uint64_t frames) {
+  CaptureBackend* backend = pipeline->backend;
+  CapturedFrame frame;
+  const uint64_t allocations = t_allocations;
+  while (pipeline->frames_captured < frames) {
+    CaptureBackend::Result result = backend->Next(&frame);
+    if (result == CaptureBackend::kRetry) {
+      continue;
+    }
+    if (result != CaptureBackend::kFrame) {
+      std::fprintf(stderr, "capture failed: %s\n", backend->error().c_str());
+      break;
+    }
+    const int64_t now = NowUs();
+    if (frame.timestamp_us > 0 && now >= frame.timestamp_us) {
+      pipeline->telemetry.Record(PipelineTelemetry::kDequeue, now - frame.timestamp_us);
+    }
+    pipeline->frames_captured++;
+    const size_t size = std::min(frame.size, backend->frame_size());
+    if (pipeline->suppressor.ShouldDeliver(frame.data, size, now)) {
+      FrameSlot& raw = pipeline->frame_buffer.write_slot();
+      raw.size = size;
+      raw.published_us = now;
+      raw.captured_us = frame.timestamp_us;
+      std::memcpy(raw.data, frame.data, size);
+      pipeline->frame_buffer.Publish();
+      RequestDelivery(pipeline);
+    }
+    backend->Release(frame);
+  }
+  pipeline->capture_allocations = t_allocations - allocations;
+  pipeline->capturing = false;
+  eventfd_write(pipeline->frame_ready_fd, 1);
+}
+
+// The main loop's on_frame_ready and send_pending_frames.
+void DeliverThread(Pipeline* pipeline) {
+  const uint64_t allocations = t_allocations;
+  const FrameEncoder::Format format =
+      pipeline->request.full[FrameEncoder::kGray4] ||
+              pipeline->request.delta[FrameEncoder::kGray4]
+          ? FrameEncoder::kGray4
+          : FrameEncoder::kBmp;
+  const bool delta = pipeline->request.delta[format];
+  struct pollfd fds = {pipeline->frame_ready_fd, POLLIN, 0};
+  for (;;) {
+    const bool capturing = pipeline->capturing;
+    poll(&fds, 1, capturing ? -1 : 0);
+    pipeline->delivery_pending = false;
+    eventfd_t count;
+    eventfd_read(pipeline->frame_ready_fd, &count);
+    if (!pipeline->frame_buffer.TakeLatest()) {
+      if (!capturing) {
+        break;
+      }
+      continue;
+    }
+    const FrameSlot& raw = pipeline->frame_buffer.read_slot();
+    const int64_t picked_up = NowUs();
+    pipeline->telemetry.Record(PipelineTelemetry::kQueueWait, picked_up - raw.published_us);
+    FrameEncoder::Timing timing =
+        pipeline->encoder.Encode(raw.data, raw.size, pipeline->request);
+    pipeline->telemetry.Record(PipelineTelemetry::kConvert, timing.convert_us);
+    if (timing.encoded) {
+      pipeline->telemetry.Record(PipelineTelemetry::kEncode, timing.encode_us);
+    }
+    const int64_t encoded = NowUs();
+    DeltaFrameEncoder::Output payload =
+        delta ? pipeline->encoder.delta(format) : pipeline->encoder.full(format);
+    std::memcpy(pipeline->sent.data(), payload.data, payload.size);
+    const int64_t sent = NowUs();
+    pipeline->telemetry.Record(PipelineTelemetry::kSend, sent - encoded);
+    if (raw.captured_us > 0) {
+      pipeline->end_to_end.Record(sent - raw.captured_us);
+    }
+    pipeline->frames_delivered++;
+    pipeline->bytes_delivered += payload.size;
+  }
+  pipeline->deliver_allocations = t_allocations - allocations;
+}
+
+void PrintHistogram(const char* name, const LatencyHistogram& histogram) {
+  LatencyHistogram::Summary summary = histogram.Summarize();
+  std::printf("  %-12s %8llu %8lld %8lld %8lld %8lld %8lld\n", name,
+              static_cast<unsigned long long>(summary.count),
+              static_cast<long long>(summary.mean_us),
+              static_cast<long long>(summary.p50_us),
+              static_cast<long long>(summary.p90_us),
+              static_cast<long long>(summary.p99_us),
+              static_cast<long long>(summary.max_us));
+}
+
+bool ParseArguments(int argc, char** argv, BenchOptions* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t equals = arg.find('=');
+    const std::string key = arg.substr(0, equals);
+    const std::string value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+    if (key == "--frames") {
+      options->frames = std::strtoull(value.c_str(), nullptr, 10);
+      if (options->frames == 0) {
+        return false;
+      }
+    } else if (key == "--source") {
+      if (!SyntheticCaptureBackend::ParseOptions(value, &options->source)) {
+        return false;
+      }
+    } else if (key == "--format") {
+      if (value != "bmp" && value != "gray4") {
+        return false;
+      }
+      options->gray4 = value == "gray4";
+    } else if (key == "--delta") {
+      options->delta = true;
+    } else if (key == "--keep-alive-ms") {
+      options->keep_alive_us = std::strtoll(value.c_str(), nullptr, 10) * 1000;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+int Run(const BenchOptions& options) {
+  SyntheticCaptureBackend backend(options.source);
+  if (!backend.Start(256, 64)) {
+    std::fprintf(stderr, "cannot start source: %s\n", backend.error().c_str());
+    return 1;
+  }
+
+  Pipeline pipeline;
+  pipeline.backend = &backend;
+  const size_t frame_bytes = backend.frame_size();
+  if (!pipeline.frame_pool.Reserve(kHandoffSlots, frame_bytes) ||
+      !pipeline.encoder.Reset(backend.width(), backend.height(), kDeltaKeyframeInterval)) {
+    std::fprintf(stderr, "cannot allocate frame buffers\n");
+    return 1;
+  }
+  size_t next_slot = 0;
+  pipeline.frame_buffer.Reset([&](FrameSlot& slot) {
+    slot.data = pipeline.frame_pool.slot(next_slot++);
+    slot.size = 0;
+    slot.published_us = 0;
+    slot.captured_us = 0;
+    std::memset(slot.data, 0, frame_bytes);
+  });
+  pipeline.suppressor.Reset(options.keep_alive_us);
+  const FrameEncoder::Format format = options.gray4 ? FrameEncoder::kGray4 : FrameEncoder::kBmp;
+  pipeline.request = FrameEncoder::Request();
+  (options.delta ? pipeline.request.delta : pipeline.request.full)[format] = true;
+  pipeline.sent.assign(MaxDeltaFrameSize(BmpFrameLayout(backend.width(), backend.height())), 0);
+  pipeline.frame_ready_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (pipeline.frame_ready_fd == -1) {
+    std::perror("eventfd");
+    return 1;
+  }
+  pipeline.delivery_pending = false;
+  pipeline.capturing = true;
+  pipeline.frames_captured = 0;
+  pipeline.frames_delivered = 0;
+  pipeline.bytes_delivered = 0;
+  pipeline.capture_allocations = 0;
+  pipeline.deliver_allocations = 0;
+  // Resolve the kernel up front; its one-time selection is not per-frame
+  // work.
+  const char* kernel = ActiveYuyvKernel().name;
+
+  const int64_t start = NowUs();
+  pipeline.telemetry.Reset(start);
+  std::thread deliver(DeliverThread, &pipeline);
+  std::thread capture(CaptureThread, &pipeline, options.frames);
+  capture.join();
+  deliver.join();
+  const double seconds = (NowUs() - start) / 1e6;
+  close(pipeline.frame_ready_fd);
+  backend.Stop();
+
+  const uint64_t captured = pipeline.frames_captured;
+  const uint64_t delivered = pipeline.frames_delivered;
+  std::printf("source     %dx%d %s, fps %s, jitter %lld us, %s kernel\n", backend.width(),
+              backend.height(),
+              options.source.replay_path.empty() ? "pattern" : options.source.replay_path.c_str(),
+              options.source.fps > 0 ? std::to_string(options.source.fps).c_str() : "unpaced",
+              static_cast<long long>(options.source.jitter_us), kernel);
+  std::printf("output     %s%s, keep-alive %lld ms\n", options.gray4 ? "gray4" : "bmp",
+              options.delta ? " delta" : "",
+              static_cast<long long>(options.keep_alive_us / 1000));
+  std::printf("frames     %llu captured, %llu suppressed, %llu overwritten, "
+              "%llu delivered, %llu dropped by source\n",
+              static_cast<unsigned long long>(captured),
+              static_cast<unsigned long long>(pipeline.suppressor.frames_suppressed()),
+              static_cast<unsigned long long>(pipeline.frame_buffer.overwritten()),
+              static_cast<unsigned long long>(delivered),
+              static_cast<unsigned long long>(backend.frames_dropped()));
+  std::printf("throughput %.1f captured/s, %.1f delivered/s, %.2f MB/s sent over %.2f s\n",
+              captured / seconds, delivered / seconds,
+              pipeline.bytes_delivered / seconds / 1e6, seconds);
+  std::printf("allocs     %.3f per captured frame (capture thread), "
+              "%.3f per delivered frame (delivery thread)\n",
+              captured ? static_cast<double>(pipeline.capture_allocations) / captured : 0.0,
+              delivered ? static_cast<double>(pipeline.deliver_allocations) / delivered : 0.0);
+  std::printf("latency us %8s %8s %8s %8s %8s %8s\n", "count", "mean", "p50", "p90", "p99",
+              "max");
+  for (int i = 0; i < PipelineTelemetry::kStageCount; ++i) {
+    PipelineTelemetry::Stage stage = static_cast<PipelineTelemetry::Stage>(i);
+    PrintHistogram(PipelineTelemetry::StageName(stage), pipeline.telemetry.histogram(stage));
+  }
+  PrintHistogram("endToEnd", pipeline.end_to_end);
+  return 0;
+}
+
+}  // namespace
+}  // namespace usb_video
+
+int main(int argc, char** argv) {
+  usb_video::BenchOptions options;
+  if (!usb_video::ParseArguments(argc, argv, &options)) {
+    std::fprintf(stderr,
+                 "usage: %s [--frames=N] [--source=SPEC] [--format=bmp|gray4] [--delta]\n"
+                 "          [--keep-alive-ms=MS]\n"
+                 "SPEC is a synthetic source, e.g. fps=60,jitter=2000,pattern=noise\n"
+                 "or replay=file.ntrec (see SyntheticCaptureBackend::ParseOptions).\n",
+                 argv[0]);
+    return 2;
+  }
+  return usb_video::Run(options);
+}
@@ -0,0 +1,230 @@
+// Measures the shared-memory frame export: what SharedFrameRing::Publish()
+// costs the capture thread, and how many frames readers using the
+// reference reader (tools/shared_frame_reader.h) get, miss and lose to the
+// writer overtaking them. Readers work in place unless --copy is given.
+// Examples:
+//
+//   usb_video_shared_frame_bench                      # unpaced, one reader
+//   usb_video_shared_frame_bench --readers=4 --slots=2
+//   usb_video_shared_frame_bench --fps=60 --frames=600 --copy
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "shared_frame_ring.h"
+#include "tools/shared_frame_reader.h"
+
+namespace usb_video {
+namespace {
+
+struct BenchOptions {
+  BenchOptions()
+      : frames(200000), readers(1), slots(SharedFrameRing::kDefaultSlots),
+        fps(0), width(256), height(64), copy(false) {}
+
+  uint64_t frames;
+  int readers;
+  uint32_t slots;
+  double fps;
+  int width;
+  int height;
+  bool copy;
+};
+
+struct ReaderResult {
+  ReaderResult() : frames(0), skipped(0), overtaken(0), checksum(0) {}
+
+  uint64_t frames;
+  uint64_t skipped;
+  uint64_t overtaken;
+  uint64_t checksum;
+};
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Stands in for a consumer touching the whole frame.
+uint64_t Checksum(const uint8_t* data, size_t size) {
+  uint64_t sum = 0;
+  for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data + i, std::min(sizeof(word), size - i));
+    sum += word;
+  }
+  return sum;
+}
+
+void ReaderThread(const std::string& name, bool copy, const std::atomic<bool>* done,
+                  ReaderResult* result) {
+  ntv_shm_reader* reader = nullptr;
+  if (ntv_shm_reader_open(name.c_str(), &reader) != 0) {
+    return;
+  }
+  std::vector<uint8_t> buffer(ntv_shm_reader_header(reader)->frame_size);
+  uint64_t last = 0;
+  while (!done->load(std::memory_order_relaxed)) {
+    ntv_shm_frame frame;
+    ntv_shm_status status =
+        copy ? ntv_shm_reader_copy(reader, last, buffer.data(), buffer.size(), &frame)
+             : ntv_shm_reader_peek(reader, last, &frame);
+    if (status == NTV_SHM_NONE) {
+      continue;
+    }
+    if (status == NTV_SHM_BUSY) {
+      result->overtaken++;
+      continue;
+    }
+    const uint64_t sum = Checksum(frame.data, frame.size);
+    if (!copy && !ntv_shm_reader_valid(reader, &frame)) {
+      result->overtaken++;
+      continue;
+    }
+    result->checksum += sum;
+    if (last != 0) {
+      result->skipped += frame.frame_number - last - 1;
+    }
+    last = frame.frame_number;
+    result->frames++;
+  }
+  ntv_shm_reader_close(reader);
+}
+
+int64_t Percentile(const std::vector<int64_t>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  return sorted[std::min(sorted.size() - 1, static_cast<size_t>(sorted.size() * fraction))];
+}
+
+bool ParseArguments(int argc, char** argv, BenchOptions* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const size_t equals = arg.find('=');
+    const std::string key = arg.substr(0, equals);
+    const std::string value = equals == std::string::npos ? "" : arg.substr(equals + 1);
+    if (key == "--frames") {
+      options->frames = std::strtoull(value.c_str(), nullptr, 10);
+      if (options->frames == 0) {
+        return false;
+      }
+    } else if (key == "--readers") {
+      options->readers = std::atoi(value.c_str());
+      if (options->readers < 0) {
+        return false;
+      }
+    } else if (key == "--slots") {
+      options->slots = static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (key == "--fps") {
+      options->fps = std::strtod(value.c_str(), nullptr);
+    } else if (key == "--size") {
+      if (std::sscanf(value.c_str(), "%dx%d", &options->width, &options->height) != 2) {
+        return false;
+      }
+    } else if (key == "--copy") {
+      options->copy = true;
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+int Run(const BenchOptions& options) {
+  const std::string name = "/usb_video_bench_" + std::to_string(getpid());
+  SharedFrameRing ring;
+  if (!ring.Create(name, options.width, options.height, options.slots)) {
+    std::fprintf(stderr, "cannot create ring: %s\n", ring.error().c_str());
+    return 1;
+  }
+
+  std::atomic<bool> done(false);
+  std::vector<ReaderResult> results(options.readers);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < options.readers; ++i) {
+    readers.emplace_back(ReaderThread, name, options.copy, &done, &results[i]);
+  }
+
+  // A few distinct frames, so readers cannot get away with stale data.
+  std::vector<std::vector<uint8_t>> frames(4, std::vector<uint8_t>(ring.frame_size()));
+  for (size_t i = 0; i < frames.size(); ++i) {
+    for (size_t j = 0; j < frames[i].size(); ++j) {
+      frames[i][j] = static_cast<uint8_t>(i * 31 + j);
+    }
+  }
+  std::vector<int64_t> publish_ns;
+  publish_ns.reserve(options.frames);
+  const int64_t period_ns = options.fps > 0 ? static_cast<int64_t>(1e9 / options.fps) : 0;
+
+  const int64_t start = NowNs();
+  for (uint64_t i = 0; i < options.frames; ++i) {
+    if (period_ns > 0) {
+      std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+          std::chrono::nanoseconds(start + static_cast<int64_t>(i) * period_ns)));
+    }
+    const std::vector<uint8_t>& frame = frames[i % frames.size()];
+    const int64_t before = NowNs();
+    ring.Publish(frame.data(), frame.size(), before / 1000, static_cast<uint32_t>(i));
+    publish_ns.push_back(NowNs() - before);
+  }
+  const double seconds = (NowNs() - start) / 1e9;
+  done = true;
+  for (std::thread& reader : readers) {
+    reader.join();
+  }
+  const size_t mapped_size = ring.mapped_size();
+  ring.Close();
+
+  std::sort(publish_ns.begin(), publish_ns.end());
+  int64_t total_ns = 0;
+  for (int64_t ns : publish_ns) {
+    total_ns += ns;
+  }
+  std::printf("ring       %dx%d YUYV, %u slots, %zu bytes mapped, %d %s reader(s)\n",
+              options.width, options.height, ring.slot_count(), mapped_size,
+              options.readers, options.copy ? "copying" : "in-place");
+  std::printf("writer     %llu frames in %.2f s (%s), %.1f MB/s\n",
+              static_cast<unsigned long long>(ring.frames_published()), seconds,
+              period_ns > 0 ? (std::to_string(options.fps) + " fps").c_str() : "unpaced",
+              ring.frames_published() * ring.frame_size() / seconds / 1e6);
+  std::printf("publish ns %8s %8s %8s %8s %8s\n", "mean", "p50", "p99", "p99.9", "max");
+  std::printf("           %8lld %8lld %8lld %8lld %8lld\n",
+              static_cast<long long>(publish_ns.empty() ? 0 : total_ns / publish_ns.size()),
+              static_cast<long long>(Percentile(publish_ns, 0.5)),
+              static_cast<long long>(Percentile(publish_ns, 0.99)),
+              static_cast<long long>(Percentile(publish_ns, 0.999)),
+              static_cast<long long>(publish_ns.empty() ? 0 : publish_ns.back()));
+  for (int i = 0; i < options.readers; ++i) {
+    std::printf("reader %-3d %llu frames, %llu skipped, %llu reads overtaken\n", i,
+                static_cast<unsigned long long>(results[i].frames),
+                static_cast<unsigned long long>(results[i].skipped),
+                static_cast<unsigned long long>(results[i].overtaken));
+  }
+  return 0;
+}
+
+}  // namespace
+}  // namespace usb_video
+
+int main(int argc, char** argv) {
+  usb_video::BenchOptions options;
+  if (!usb_video::ParseArguments(argc, argv, &options)) {
+    std::fprintf(stderr,
+                 "usage: %s [--frames=N] [--readers=N] [--slots=N] [--fps=F]\n"
+                 "          [--size=WxH] [--copy]\n",
+                 argv[0]);
+    return 2;
+  }
+  return usb_video::Run(options);
+}
@@ -0,0 +1,64 @@
+#include "bmp_encoder.h"
+
+#include <cstring>
+
+namespace usb_video {
+
+namespace {
+
+constexpr size_t kHeaderSize = 54;
+
+size_t RowSize(int width) {
+  return static_cast<size_t>(((width * 3 + 3) / 4) * 4);
+}
+
+void PutLe32(uint8_t* out, uint32_t value) {
+  out[0] = value & 0xFF;
+  out[1] = (value >> 8) & 0xFF;
+  out[2] = (value >> 16) & 0xFF;
+  out[3] = (value >> 24) & 0xFF;
+}
+
+}  // namespace
+
+size_t BmpFileSize(int width, int height) {
+  return kHeaderSize + RowSize(width) * height;
+}
+
+size_t EncodeBmp24(const uint8_t* rgb, int width, int height, uint8_t* out) {
+  const size_t row_size = RowSize(width);
+  const size_t file_size = BmpFileSize(width, height);
+
+  // BITMAPFILEHEADER
+  std::memset(out, 0, kHeaderSize);
+  out[0] = 'B';
+  out[1] = 'M';
+  PutLe32(out + 2, static_cast<uint32_t>(file_size));
+  PutLe32(out + 10, kHeaderSize);  // Offset to pixel data
+
+  // BITMAPINFOHEADER
+  PutLe32(out + 14, 40);
+  PutLe32(out + 18, static_cast<uint32_t>(width));
+  PutLe32(out + 22, static_cast<uint32_t>(-height));  // Negative: top-down
+  out[26] = 1;   // Planes
+  out[28] = 24;  // Bits per pixel; compression and the rest stay zero
+
+  // Pixel rows (BMP uses BGR order)
+  uint8_t* row = out + kHeaderSize;
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* src = rgb + static_cast<size_t>(y) * width * 3;
+    uint8_t* dst = row;
+    for (int x = 0; x < width; ++x) {
+      dst[0] = src[2];
+      dst[1] = src[1];
+      dst[2] = src[0];
+      src += 3;
+      dst += 3;
+    }
+    std::memset(dst, 0, row_size - static_cast<size_t>(width) * 3);
+    row += row_size;
+  }
+  return file_size;
+}
+
+}  // namespace usb_video
@@ -0,0 +1,20 @@
+#ifndef USB_VIDEO_BMP_ENCODER_H_
+#define USB_VIDEO_BMP_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// Size of the file EncodeBmp24 produces: a 54-byte header followed by
+// bottom-up-flagged (top-down) BGR rows padded to four bytes.
+size_t BmpFileSize(int width, int height);
+
+// Encodes interleaved RGB24 pixels as an uncompressed top-down 24-bit BMP
+// into |out|, which must hold BmpFileSize(width, height) bytes. Returns the
+// number of bytes written.
+size_t EncodeBmp24(const uint8_t* rgb, int width, int height, uint8_t* out);
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_BMP_ENCODER_H_
@@ -0,0 +1,124 @@
+#ifndef USB_VIDEO_CAPTURE_BACKEND_H_
+#define USB_VIDEO_CAPTURE_BACKEND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace usb_video {
+
+// Seconds per frame as a fraction, the way V4L2 states frame rates.
+struct FrameInterval {
+  uint32_t numerator;
+  uint32_t denominator;
+
+  double fps() const {
+    return numerator == 0 ? 0.0 : static_cast<double>(denominator) / numerator;
+  }
+};
+
+inline bool operator==(const FrameInterval& a, const FrameInterval& b) {
+  return static_cast<uint64_t>(a.numerator) * b.denominator ==
+         static_cast<uint64_t>(b.numerator) * a.denominator;
+}
+
+inline bool operator!=(const FrameInterval& a, const FrameInterval& b) {
+  return !(a == b);
+}
+
+// A frame on loan from a CaptureBackend until Release().
+struct CapturedFrame {
+  const uint8_t* data;  // Packed YUYV.
+  size_t size;          // Bytes actually captured.
+  // CLOCK_MONOTONIC time the frame was captured, or 0 if unknown.
+  int64_t timestamp_us;
+  uint32_t sequence;
+  uint32_t buffer_index;  // Backend-private.
+};
+
+// Where raw frames come from: a V4L2 device (V4l2CaptureBackend) or a
+// generated or replayed stream (SyntheticCaptureBackend), so the capture
+// pipeline runs the same way with or without a Disting NT attached.
+//
+// Start() and Stop() belong to the owner; Next() and Release() to the one
+// capture thread in between. Wake() may be called from anywhere.
+class CaptureBackend {
+ public:
+  enum Result {
+    kFrame,  // |frame| is filled in; Release() it when done.
+    kRetry,  // Nothing this time (spurious wakeup); call Next() again.
+    kWoken,  // Wake() was called.
+    kError,  // The source failed; see error().
+  };
+
+  virtual ~CaptureBackend() {}
+
+  CaptureBackend(const CaptureBackend&) = delete;
+  CaptureBackend& operator=(const CaptureBackend&) = delete;
+
+  // Opens the source and starts streaming, asking for |width| x |height|
+  // YUYV. The source may settle on another size; see width() and height().
+  virtual bool Start(int width, int height) = 0;
+
+  // Blocks until a frame is captured, Wake() is called or the source fails.
+  virtual Result Next(CapturedFrame* frame) = 0;
+
+  // Hands a frame's buffer back for capturing into.
+  virtual bool Release(const CapturedFrame& frame) = 0;
+
+  // Switches to |interval|, normally one of frame_intervals(). Capture
+  // thread only, between frames. May restart streaming, dropping whatever
+  // the source had queued.
+  virtual bool SetFrameInterval(const FrameInterval& interval) = 0;
+
+  // Stops the flow of frames without giving up the device, and starts it
+  // again. While paused the source does no capture work at all and Next()
+  // only returns once woken. Capture thread only, between frames; sequence
+  // numbers may restart on Resume().
+  virtual bool Pause() = 0;
+  virtual bool Resume() = 0;
+
+  // Makes a blocked Next() return kWoken, or the next one if none is
+  // blocked. Safe from any thread.
+  virtual void Wake() = 0;
+
+  // Stops streaming and frees everything Start() set up. The capture thread
+  // must have finished first. Safe to call more than once.
+  virtual void Stop() = 0;
+
+  // Short name for logs, e.g. "v4l2".
+  virtual const char* name() const = 0;
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  size_t frame_size() const { return static_cast<size_t>(width_) * height_ * 2; }
+
+  // Intervals the source offers at the negotiated size, fastest first;
+  // empty if its rate cannot be changed. Fixed by Start().
+  const std::vector<FrameInterval>& frame_intervals() const {
+    return frame_intervals_;
+  }
+  // The interval in use, or zero if unknown. Changed by SetFrameInterval(),
+  // so read it from the capture thread or while that is stopped.
+  FrameInterval frame_interval() const { return frame_interval_; }
+
+  bool paused() const { return paused_; }
+
+  // Why Start() or Next() last failed.
+  const std::string& error() const { return error_; }
+
+ protected:
+  CaptureBackend() : width_(0), height_(0), frame_interval_(), paused_(false) {}
+
+  int width_;
+  int height_;
+  std::vector<FrameInterval> frame_intervals_;
+  FrameInterval frame_interval_;
+  bool paused_;
+  std::string error_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_CAPTURE_BACKEND_H_
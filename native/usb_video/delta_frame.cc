@@ -0,0 +1,115 @@
+#include "delta_frame.h"
+
+#include <cstring>
+
+#include "bmp_encoder.h"
+#include "gray4.h"
+
+namespace usb_video {
+
+namespace {
+
+void PutLe16(uint8_t* out, uint32_t value) {
+  out[0] = value & 0xFF;
+  out[1] = (value >> 8) & 0xFF;
+}
+
+}  // namespace
+
+FrameLayout BmpFrameLayout(int width, int height) {
+  FrameLayout layout;
+  layout.width = width;
+  layout.height = height;
+  layout.pixel_offset = BmpFileSize(width, 0);  // Header only
+  layout.row_stride = BmpFileSize(width, 1) - BmpFileSize(width, 0);
+  return layout;
+}
+
+FrameLayout Gray4FrameLayout(int width, int height) {
+  FrameLayout layout;
+  layout.width = width;
+  layout.height = height;
+  layout.pixel_offset = kGray4HeaderSize;
+  layout.row_stride = Gray4RowBytes(width);
+  return layout;
+}
+
+size_t MaxDeltaFrameSize(const FrameLayout& layout) {
+  // Worst case is every other row changed: one span per changed row.
+  const size_t spans = static_cast<size_t>(layout.height + 1) / 2;
+  return kDeltaFrameHeaderSize + spans * kDeltaSpanHeaderSize +
+         layout.row_stride * layout.height;
+}
+
+DeltaFrameEncoder::DeltaFrameEncoder()
+    : layout_(), keyframe_interval_(1), frames_until_keyframe_(0) {}
+
+void DeltaFrameEncoder::Reset(const FrameLayout& layout,
+                              int keyframe_interval) {
+  layout_ = layout;
+  keyframe_interval_ = keyframe_interval > 0 ? keyframe_interval : 1;
+  frames_until_keyframe_ = 0;
+  reference_.assign(layout.row_stride * layout.height, 0);
+}
+
+DeltaFrameEncoder::Output DeltaFrameEncoder::Encode(const uint8_t* frame,
+                                                    uint8_t* scratch) {
+  const uint8_t* pixels = frame + layout_.pixel_offset;
+  const size_t stride = layout_.row_stride;
+  const int height = layout_.height;
+  const size_t frame_size = layout_.frame_size();
+
+  Output keyframe = {frame, frame_size, true};
+  if (frames_until_keyframe_ <= 0) {
+    std::memcpy(reference_.data(), pixels, stride * height);
+    frames_until_keyframe_ = keyframe_interval_ - 1;
+    return keyframe;
+  }
+
+  uint8_t* out = scratch + kDeltaFrameHeaderSize;
+  uint32_t span_count = 0;
+  int y = 0;
+  while (y < height) {
+    const size_t offset = stride * y;
+    if (std::memcmp(pixels + offset, reference_.data() + offset, stride) == 0) {
+      ++y;
+      continue;
+    }
+    int end = y + 1;
+    while (end < height &&
+           std::memcmp(pixels + stride * end, reference_.data() + stride * end,
+                       stride) != 0) {
+      ++end;
+    }
+    const size_t span_bytes = stride * (end - y);
+    PutLe16(out, static_cast<uint32_t>(y));
+    PutLe16(out + 2, static_cast<uint32_t>(end - y));
+    std::memcpy(out + kDeltaSpanHeaderSize, pixels + offset, span_bytes);
+    std::memcpy(reference_.data() + offset, pixels + offset, span_bytes);
+    out += kDeltaSpanHeaderSize + span_bytes;
+    ++span_count;
+    y = end;
+  }
+
+  const size_t delta_size = static_cast<size_t>(out - scratch);
+  if (delta_size * 4 >= frame_size * 3) {
+    // Most of the picture changed (a page switch): the delta would save
+    // little, and a keyframe resynchronises the receiver for free. The
+    // reference already matches this frame.
+    frames_until_keyframe_ = keyframe_interval_ - 1;
+    return keyframe;
+  }
+
+  scratch[0] = 'N';
+  scratch[1] = 'D';
+  scratch[2] = kDeltaFrameVersion;
+  scratch[3] = 0;
+  PutLe16(scratch + 4, static_cast<uint32_t>(layout_.width));
+  PutLe16(scratch + 6, static_cast<uint32_t>(height));
+  PutLe16(scratch + 8, span_count);
+  --frames_until_keyframe_;
+  Output delta = {scratch, delta_size, false};
+  return delta;
+}
+
+}  // namespace usb_video
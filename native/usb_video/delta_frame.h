@@ -0,0 +1,88 @@
+#ifndef USB_VIDEO_DELTA_FRAME_H_
+#define USB_VIDEO_DELTA_FRAME_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace usb_video {
+
+// Dirty-row delta frames for the video event channel.
+//
+// A keyframe is a complete frame in the stream's wire format (a BMP from
+// EncodeBmp24, or a gray4 frame). A delta frame carries only the pixel rows
+// that differ from the previous delivered frame, grouped into spans of
+// consecutive rows. All integers are little-endian:
+//
+//   offset 0   'N' 'D'            magic (a BMP starts with 'B' 'M')
+//          2   u8  version        kDeltaFrameVersion
+//          3   u8  reserved       0
+//          4   u16 width          must match the last keyframe
+//          6   u16 height
+//          8   u16 span_count
+//         10   spans, each:
+//                u16 first_row    top-down row index
+//                u16 row_count
+//                row_count * row_stride bytes of keyframe row data
+//
+// row_stride is the keyframe format's row size: the padded BMP row,
+// ((width * 3 + 3) / 4) * 4, or the gray4 row, (width + 1) / 2. A delta with
+// no spans means "unchanged" and doubles as a keep-alive.
+constexpr uint8_t kDeltaFrameVersion = 1;
+constexpr size_t kDeltaFrameHeaderSize = 10;
+constexpr size_t kDeltaSpanHeaderSize = 4;
+
+// Where the top-down pixel rows sit inside a keyframe.
+struct FrameLayout {
+  int width;
+  int height;
+  size_t pixel_offset;  // Bytes of header before the first row.
+  size_t row_stride;
+
+  size_t frame_size() const { return pixel_offset + row_stride * height; }
+};
+
+FrameLayout BmpFrameLayout(int width, int height);
+FrameLayout Gray4FrameLayout(int width, int height);
+
+// Largest delta DeltaFrameEncoder can produce for this layout.
+size_t MaxDeltaFrameSize(const FrameLayout& layout);
+
+// Turns a sequence of full frames into keyframes and deltas. Lives on the
+// thread that sends frames; only Reset() allocates.
+class DeltaFrameEncoder {
+ public:
+  struct Output {
+    const uint8_t* data;  // Either the input frame or the caller's buffer.
+    size_t size;
+    bool keyframe;
+  };
+
+  DeltaFrameEncoder();
+
+  DeltaFrameEncoder(const DeltaFrameEncoder&) = delete;
+  DeltaFrameEncoder& operator=(const DeltaFrameEncoder&) = delete;
+
+  // Starts a new stream of frames with |layout|. Every |keyframe_interval|
+  // frames, and whenever a delta would be at least three quarters of a full
+  // frame, the full frame is sent instead of a delta.
+  void Reset(const FrameLayout& layout, int keyframe_interval);
+
+  // Makes the next frame a keyframe, e.g. when a new listener attaches.
+  void ForceKeyframe() { frames_until_keyframe_ = 0; }
+
+  // |frame| is a complete frame with the layout given to Reset().
+  // |scratch| must hold MaxDeltaFrameSize() bytes.
+  Output Encode(const uint8_t* frame, uint8_t* scratch);
+
+ private:
+  FrameLayout layout_;
+  int keyframe_interval_;
+  int frames_until_keyframe_;
+  // Pixel rows of the last frame sent, which the receiver now holds.
+  std::vector<uint8_t> reference_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_DELTA_FRAME_H_
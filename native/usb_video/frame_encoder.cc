@@ -0,0 +1,88 @@
+#include "frame_encoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "bmp_encoder.h"
+#include "gray4.h"
+#include "yuyv_convert.h"
+
+namespace usb_video {
+
+constexpr size_t FrameEncoder::kRgbSlot;
+constexpr size_t FrameEncoder::kEncodedSlots;
+constexpr size_t FrameEncoder::kDeltaSlots;
+constexpr size_t FrameEncoder::kSlotCount;
+
+namespace {
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+FrameEncoder::FrameEncoder() : width_(0), height_(0), encoded_size_(), delta_() {}
+
+bool FrameEncoder::Reset(int width, int height, int keyframe_interval) {
+  // The worst-case delta is slightly larger than the BMP, which in turn is
+  // larger than the RGB24 scratch and the gray4 frame.
+  if (!pool_.Reserve(kSlotCount, MaxDeltaFrameSize(BmpFrameLayout(width, height)))) {
+    return false;
+  }
+  width_ = width;
+  height_ = height;
+  std::memset(pool_.slot(kRgbSlot), 0, static_cast<size_t>(width) * height * 3);
+  delta_encoders_[kBmp].Reset(BmpFrameLayout(width, height), keyframe_interval);
+  delta_encoders_[kGray4].Reset(Gray4FrameLayout(width, height), keyframe_interval);
+  std::fill(encoded_size_, encoded_size_ + kFormatCount, 0);
+  std::fill(delta_, delta_ + kFormatCount, DeltaFrameEncoder::Output());
+  return true;
+}
+
+FrameEncoder::Timing FrameEncoder::Encode(const uint8_t* yuyv, size_t size,
+                                          const Request& request) {
+  Timing timing = {};
+  const int64_t start = NowUs();
+  const bool bmp = request.full[kBmp] || request.delta[kBmp];
+  const bool gray4 = request.full[kGray4] || request.delta[kGray4];
+  size = std::min(size, static_cast<size_t>(width_) * height_ * 2);
+
+  // Packing gray4 is its whole conversion; BMP still needs encoding after.
+  if (gray4) {
+    encoded_size_[kGray4] =
+        PackYuyvToGray4(yuyv, width_, height_, pool_.slot(kEncodedSlots + kGray4));
+  }
+  if (bmp) {
+    ConvertYuyvToRgb24(yuyv, size / 2, pool_.slot(kRgbSlot));
+  }
+  const int64_t converted = NowUs();
+  timing.convert_us = converted - start;
+
+  if (bmp) {
+    encoded_size_[kBmp] = EncodeBmp24(pool_.slot(kRgbSlot), width_, height_,
+                                      pool_.slot(kEncodedSlots + kBmp));
+  }
+  for (int format = 0; format < kFormatCount; ++format) {
+    if (request.delta[format]) {
+      delta_[format] = delta_encoders_[format].Encode(
+          pool_.slot(kEncodedSlots + format), pool_.slot(kDeltaSlots + format));
+    }
+  }
+  timing.encoded = bmp || request.delta[kGray4];
+  timing.encode_us = NowUs() - converted;
+  return timing;
+}
+
+DeltaFrameEncoder::Output FrameEncoder::full(Format format) const {
+  DeltaFrameEncoder::Output output;
+  output.data = pool_.slot(kEncodedSlots + format);
+  output.size = encoded_size_[format];
+  output.keyframe = true;
+  return output;
+}
+
+}  // namespace usb_video
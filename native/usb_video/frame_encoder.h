@@ -0,0 +1,85 @@
+#ifndef USB_VIDEO_FRAME_ENCODER_H_
+#define USB_VIDEO_FRAME_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "delta_frame.h"
+#include "frame_pool.h"
+
+namespace usb_video {
+
+// Turns raw YUYV frames into the event channel's wire formats: 24-bit BMP
+// (bmp_encoder.h) and packed gray4 (gray4.h), each either whole or as a
+// delta stream (delta_frame.h). Each format is converted and encoded at
+// most once per frame, however many receivers want it.
+//
+// Lives on the thread that sends frames; only Reset() allocates.
+class FrameEncoder {
+ public:
+  enum Format {
+    kBmp,
+    kGray4,
+    kFormatCount,
+  };
+
+  // Which encodings of the next frame are needed.
+  struct Request {
+    bool full[kFormatCount];
+    bool delta[kFormatCount];
+  };
+
+  // Time spent in each step of the last Encode(), in microseconds.
+  struct Timing {
+    int64_t convert_us;
+    int64_t encode_us;
+    // False when Encode() had nothing to encode (converting only).
+    bool encoded;
+  };
+
+  FrameEncoder();
+
+  FrameEncoder(const FrameEncoder&) = delete;
+  FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+  // Sizes the buffers for |width| x |height| frames and restarts both delta
+  // streams, which resend the whole picture at least every
+  // |keyframe_interval| frames. Returns false if allocation fails.
+  bool Reset(int width, int height, int keyframe_interval);
+
+  // Encodes the |size| bytes captured into |yuyv| as |request| asks. The
+  // buffer must span a full frame even when |size| is short: gray4 packs
+  // all of it, while BMP keeps the previous picture past |size|.
+  Timing Encode(const uint8_t* yuyv, size_t size, const Request& request);
+
+  // The last frame in |format|, whole or as a delta. Valid until the next
+  // Encode() or Reset().
+  DeltaFrameEncoder::Output full(Format format) const;
+  const DeltaFrameEncoder::Output& delta(Format format) const {
+    return delta_[format];
+  }
+
+  // Makes the next delta in |format| a keyframe, e.g. for a new listener.
+  void ForceKeyframe(Format format) { delta_encoders_[format].ForceKeyframe(); }
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+
+ private:
+  // RGB scratch, then the encoded frame and delta frame per format.
+  static constexpr size_t kRgbSlot = 0;
+  static constexpr size_t kEncodedSlots = 1;
+  static constexpr size_t kDeltaSlots = kEncodedSlots + kFormatCount;
+  static constexpr size_t kSlotCount = kDeltaSlots + kFormatCount;
+
+  int width_;
+  int height_;
+  FramePool pool_;
+  DeltaFrameEncoder delta_encoders_[kFormatCount];
+  size_t encoded_size_[kFormatCount];
+  DeltaFrameEncoder::Output delta_[kFormatCount];
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_FRAME_ENCODER_H_
@@ -0,0 +1,77 @@
+#include "frame_hash.h"
+
+#include <cstring>
+
+namespace usb_video {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+  uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+  acc += input * kPrime2;
+  acc = RotateLeft(acc, 31);
+  return acc * kPrime1;
+}
+
+inline uint64_t MergeRound(uint64_t acc, uint64_t lane) {
+  acc ^= Round(0, lane);
+  return acc * kPrime1 + kPrime4;
+}
+
+}  // namespace
+
+uint64_t HashFrame(const uint8_t* data, size_t size) {
+  const uint8_t* p = data;
+  const uint8_t* const end = data + size;
+  uint64_t hash;
+
+  if (size >= 32) {
+    uint64_t lanes[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+    for (; p + 32 <= end; p += 32) {
+      for (int i = 0; i < 4; ++i) {
+        lanes[i] = Round(lanes[i], Load64(p + i * 8));
+      }
+    }
+    hash = RotateLeft(lanes[0], 1) + RotateLeft(lanes[1], 7) +
+           RotateLeft(lanes[2], 12) + RotateLeft(lanes[3], 18);
+    for (int i = 0; i < 4; ++i) {
+      hash = MergeRound(hash, lanes[i]);
+    }
+  } else {
+    hash = kPrime5;
+  }
+  hash += size;
+
+  for (; p + 8 <= end; p += 8) {
+    hash ^= Round(0, Load64(p));
+    hash = RotateLeft(hash, 27) * kPrime1 + kPrime4;
+  }
+  for (; p < end; ++p) {
+    hash ^= *p * kPrime5;
+    hash = RotateLeft(hash, 11) * kPrime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+}  // namespace usb_video
@@ -0,0 +1,17 @@
+#ifndef USB_VIDEO_FRAME_HASH_H_
+#define USB_VIDEO_FRAME_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// Fast non-cryptographic 64-bit hash of a frame, used to spot frames that are
+// byte-for-byte identical to the previous one. Four independent 64-bit lanes
+// consume 32 bytes per step (the xxHash64 round), which keeps a 32 KB YUYV
+// frame to a few microseconds and lets the compiler vectorise the lanes.
+uint64_t HashFrame(const uint8_t* data, size_t size);
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_FRAME_HASH_H_
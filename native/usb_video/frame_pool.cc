@@ -0,0 +1,64 @@
+#include "frame_pool.h"
+
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace usb_video {
+
+namespace {
+
+void* AllocateAligned(size_t alignment, size_t size) {
+#if defined(_WIN32)
+  return _aligned_malloc(size, alignment);
+#else
+  void* block = nullptr;
+  return posix_memalign(&block, alignment, size) == 0 ? block : nullptr;
+#endif
+}
+
+void FreeAligned(void* block) {
+#if defined(_WIN32)
+  _aligned_free(block);
+#else
+  free(block);
+#endif
+}
+
+}  // namespace
+
+constexpr size_t FramePool::kAlignment;
+
+FramePool::FramePool()
+    : block_(nullptr), capacity_(0), stride_(0), slot_count_(0),
+      slot_bytes_(0) {}
+
+FramePool::~FramePool() { FreeAligned(block_); }
+
+bool FramePool::Reserve(size_t slot_count, size_t slot_bytes) {
+  const size_t stride = (slot_bytes + kAlignment - 1) / kAlignment * kAlignment;
+  const size_t needed = stride * slot_count;
+
+  if (needed > capacity_) {
+    FreeAligned(block_);
+    block_ = nullptr;
+    capacity_ = 0;
+    slot_count_ = 0;
+    slot_bytes_ = 0;
+    void* block = AllocateAligned(kAlignment, needed);
+    if (block == nullptr) {
+      return false;
+    }
+    block_ = static_cast<uint8_t*>(block);
+    capacity_ = needed;
+  }
+
+  stride_ = stride;
+  slot_count_ = slot_count;
+  slot_bytes_ = slot_bytes;
+  return true;
+}
+
+}  // namespace usb_video
@@ -0,0 +1,59 @@
+#ifndef USB_VIDEO_FRAME_POOL_H_
+#define USB_VIDEO_FRAME_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// A pool slot plus the number of bytes currently valid in it. This is what
+// the capture thread hands across a TripleBuffer.
+struct FrameSlot {
+  uint8_t* data;
+  size_t size;
+  // Monotonic time the producer published the frame, for queue-wait timing.
+  int64_t published_us;
+  // Monotonic time the frame was captured, or 0 if unknown, for end-to-end
+  // latency.
+  int64_t captured_us;
+};
+
+// Fixed set of equally sized frame buffers carved from one allocation.
+//
+// Every slot starts on a cache-line boundary so the capture thread writing
+// one slot never shares a line with the main thread reading another. The
+// block survives Reserve() calls that fit within it, so a plugin that stops
+// and restarts the same stream reuses its memory instead of reallocating.
+class FramePool {
+ public:
+  static constexpr size_t kAlignment = 64;
+
+  FramePool();
+  ~FramePool();
+
+  FramePool(const FramePool&) = delete;
+  FramePool& operator=(const FramePool&) = delete;
+
+  // Makes |slot_count| slots of at least |slot_bytes| each available.
+  // Allocates only when the request outgrows the current block; returns
+  // false if that allocation fails, leaving the pool empty.
+  bool Reserve(size_t slot_count, size_t slot_bytes);
+
+  uint8_t* slot(size_t index) const { return block_ + index * stride_; }
+  size_t slot_count() const { return slot_count_; }
+  size_t slot_bytes() const { return slot_bytes_; }
+
+  // Bytes currently held, including alignment padding.
+  size_t capacity() const { return capacity_; }
+
+ private:
+  uint8_t* block_;
+  size_t capacity_;
+  size_t stride_;
+  size_t slot_count_;
+  size_t slot_bytes_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_FRAME_POOL_H_
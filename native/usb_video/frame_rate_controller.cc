@@ -0,0 +1,110 @@
+#include "frame_rate_controller.h"
+
+#include <algorithm>
+
+namespace usb_video {
+
+constexpr int64_t FrameRateController::kWindowUs;
+constexpr uint64_t FrameRateController::kMinOfferedFrames;
+constexpr double FrameRateController::kSlowMissRatio;
+constexpr double FrameRateController::kHealthyMissRatio;
+constexpr int64_t FrameRateController::kRecoveryUs;
+constexpr int64_t FrameRateController::kMaxRecoveryUs;
+
+void SortFrameIntervals(std::vector<FrameInterval>* intervals) {
+  intervals->erase(std::remove_if(intervals->begin(), intervals->end(),
+                                  [](const FrameInterval& interval) {
+                                    return interval.numerator == 0 ||
+                                           interval.denominator == 0;
+                                  }),
+                   intervals->end());
+  // Compare as fractions so nothing is lost to rounding.
+  std::sort(intervals->begin(), intervals->end(),
+            [](const FrameInterval& a, const FrameInterval& b) {
+              return static_cast<uint64_t>(a.numerator) * b.denominator <
+                     static_cast<uint64_t>(b.numerator) * a.denominator;
+            });
+  intervals->erase(std::unique(intervals->begin(), intervals->end()),
+                   intervals->end());
+}
+
+FrameRateController::FrameRateController()
+    : max_fps_(0),
+      step_down_(0),
+      window_start_us_(0),
+      window_offered_(0),
+      window_missed_(0),
+      last_change_us_(0),
+      last_step_up_us_(0),
+      recovery_us_(kRecoveryUs) {}
+
+void FrameRateController::Reset(const std::vector<FrameInterval>& supported,
+                                int64_t now_us) {
+  supported_ = supported;
+  SortFrameIntervals(&supported_);
+  step_down_ = 0;
+  window_start_us_ = now_us;
+  window_offered_ = 0;
+  window_missed_ = 0;
+  last_change_us_ = now_us;
+  last_step_up_us_ = now_us - kMaxRecoveryUs;
+  recovery_us_ = kRecoveryUs;
+}
+
+size_t FrameRateController::BaseIndex() const {
+  if (max_fps_ <= 0) {
+    return 0;
+  }
+  // A little slack so 30000/1001 still counts as 30.
+  for (size_t i = 0; i < supported_.size(); ++i) {
+    if (supported_[i].fps() <= max_fps_ * 1.01) {
+      return i;
+    }
+  }
+  return supported_.size() - 1;
+}
+
+FrameInterval FrameRateController::target() const {
+  if (supported_.empty()) {
+    return FrameInterval();
+  }
+  return supported_[std::min(BaseIndex() + step_down_, supported_.size() - 1)];
+}
+
+bool FrameRateController::Update(uint64_t offered, uint64_t missed, int64_t now_us) {
+  if (supported_.empty() || now_us - window_start_us_ < kWindowUs) {
+    return false;
+  }
+  const uint64_t window_offered = offered - window_offered_;
+  const uint64_t window_missed = missed - window_missed_;
+  window_start_us_ = now_us;
+  window_offered_ = offered;
+  window_missed_ = missed;
+  if (window_offered < kMinOfferedFrames) {
+    return false;
+  }
+
+  // A lower cap may have left fewer intervals to step through.
+  const int max_step = static_cast<int>(supported_.size() - 1 - BaseIndex());
+  step_down_ = std::min(step_down_, max_step);
+  const double miss_ratio = static_cast<double>(window_missed) / window_offered;
+  if (miss_ratio >= kSlowMissRatio && step_down_ < max_step) {
+    // Undoing a recent step back: wait longer before the next one.
+    if (now_us - last_step_up_us_ < recovery_us_) {
+      recovery_us_ = std::min(recovery_us_ * 2, kMaxRecoveryUs);
+    }
+    step_down_++;
+    last_change_us_ = now_us;
+    return true;
+  }
+  if (miss_ratio <= kHealthyMissRatio && step_down_ > 0 &&
+      now_us - last_change_us_ >= recovery_us_) {
+    step_down_--;
+    last_change_us_ = now_us;
+    last_step_up_us_ = now_us;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace usb_video
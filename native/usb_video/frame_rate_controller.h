@@ -0,0 +1,79 @@
+#ifndef USB_VIDEO_FRAME_RATE_CONTROLLER_H_
+#define USB_VIDEO_FRAME_RATE_CONTROLLER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "capture_backend.h"
+
+namespace usb_video {
+
+// Orders |intervals| fastest first and drops duplicates and zeroes.
+void SortFrameIntervals(std::vector<FrameInterval>* intervals);
+
+// Chooses the capture frame interval, so capture costs no more than the
+// receivers can show.
+//
+// The starting point is the fastest supported interval no faster than
+// max_fps(). From there it steps one interval slower whenever the receivers
+// miss too many of the frames offered to them over an evaluation window,
+// and one interval back after they have kept up for a while. The wait
+// before stepping back doubles each time a step back has to be undone soon
+// after, so a consumer that only just copes does not make the rate
+// oscillate.
+//
+// Not thread-safe; the session drives it from the main thread.
+class FrameRateController {
+ public:
+  // Length of an evaluation window.
+  static constexpr int64_t kWindowUs = 1000000;
+  // Windows with fewer offered frames say nothing (e.g. a static picture
+  // being suppressed) and are skipped.
+  static constexpr uint64_t kMinOfferedFrames = 5;
+  // Missing this share of the offered frames steps the rate down ...
+  static constexpr double kSlowMissRatio = 0.25;
+  // ... and missing no more than this share counts as keeping up.
+  static constexpr double kHealthyMissRatio = 0.05;
+  static constexpr int64_t kRecoveryUs = 10000000;
+  static constexpr int64_t kMaxRecoveryUs = 80000000;
+
+  FrameRateController();
+
+  // Starts over with the intervals a source supports (see
+  // SortFrameIntervals()), leaving max_fps() as it is.
+  void Reset(const std::vector<FrameInterval>& supported, int64_t now_us);
+
+  // Caps the rate; zero or less leaves it uncapped.
+  void set_max_fps(double fps) { max_fps_ = fps; }
+  double max_fps() const { return max_fps_; }
+
+  // Feeds running totals of the frames offered to receivers and of those
+  // replaced before a receiver took them. Returns true when target()
+  // changed.
+  bool Update(uint64_t offered, uint64_t missed, int64_t now_us);
+
+  // False when the source offers no intervals to choose from.
+  bool has_target() const { return !supported_.empty(); }
+  FrameInterval target() const;
+
+  // Intervals stepped down from the max_fps() starting point.
+  int step_down() const { return step_down_; }
+
+ private:
+  size_t BaseIndex() const;
+
+  std::vector<FrameInterval> supported_;
+  double max_fps_;
+  int step_down_;
+  int64_t window_start_us_;
+  uint64_t window_offered_;
+  uint64_t window_missed_;
+  int64_t last_change_us_;
+  int64_t last_step_up_us_;
+  int64_t recovery_us_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_FRAME_RATE_CONTROLLER_H_
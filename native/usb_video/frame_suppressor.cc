@@ -0,0 +1,54 @@
+#include "frame_suppressor.h"
+
+#include "frame_hash.h"
+
+namespace usb_video {
+
+constexpr int64_t FrameSuppressor::kDefaultKeepAliveUs;
+
+void FrameSuppressor::Reset(int64_t keep_alive_us) {
+  keep_alive_us_.store(keep_alive_us, std::memory_order_relaxed);
+  have_last_ = false;
+  last_hash_ = 0;
+  last_delivered_us_ = 0;
+  force_next_.store(false, std::memory_order_relaxed);
+  frames_seen_.store(0, std::memory_order_relaxed);
+  frames_suppressed_.store(0, std::memory_order_relaxed);
+  keep_alive_frames_.store(0, std::memory_order_relaxed);
+}
+
+bool FrameSuppressor::ShouldDeliver(const uint8_t* frame, size_t size,
+                                    int64_t now_us) {
+  frames_seen_.store(frames_seen_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+  const int64_t keep_alive_us = keep_alive_us_.load(std::memory_order_relaxed);
+  if (keep_alive_us <= 0) {
+    return true;
+  }
+
+  const uint64_t hash = HashFrame(frame, size);
+  const bool forced = force_next_.exchange(false, std::memory_order_relaxed);
+  if (have_last_ && hash == last_hash_ && !forced) {
+    if (now_us - last_delivered_us_ < keep_alive_us) {
+      frames_suppressed_.store(
+          frames_suppressed_.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+      return false;
+    }
+    keep_alive_frames_.store(
+        keep_alive_frames_.load(std::memory_order_relaxed) + 1,
+        std::memory_order_relaxed);
+  }
+
+  have_last_ = true;
+  last_hash_ = hash;
+  last_delivered_us_ = now_us;
+  return true;
+}
+
+double FrameSuppressor::suppression_ratio() const {
+  const uint64_t seen = frames_seen();
+  return seen == 0 ? 0.0 : static_cast<double>(frames_suppressed()) / seen;
+}
+
+}  // namespace usb_video
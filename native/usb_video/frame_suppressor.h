@@ -0,0 +1,71 @@
+#ifndef USB_VIDEO_FRAME_SUPPRESSOR_H_
+#define USB_VIDEO_FRAME_SUPPRESSOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// Decides, per captured frame, whether it is worth delivering. A frame whose
+// hash matches the last delivered one is suppressed, except that an
+// unchanged frame still goes out once |keep_alive_us| has passed since the
+// last delivery so downstream stall detection keeps seeing traffic.
+//
+// ShouldDeliver() runs on the capture thread; SetKeepAlive(), ForceNext()
+// and the counters may be used from any thread.
+class FrameSuppressor {
+ public:
+  FrameSuppressor() { Reset(kDefaultKeepAliveUs); }
+
+  FrameSuppressor(const FrameSuppressor&) = delete;
+  FrameSuppressor& operator=(const FrameSuppressor&) = delete;
+
+  static constexpr int64_t kDefaultKeepAliveUs = 1000000;
+
+  // Starts a new session. A |keep_alive_us| of zero or less disables
+  // suppression entirely: every frame is delivered.
+  void Reset(int64_t keep_alive_us);
+
+  // Changes the keep-alive mid-session, e.g. as subscribers come and go,
+  // without clearing the counters or the last delivered frame.
+  void SetKeepAlive(int64_t keep_alive_us) {
+    keep_alive_us_.store(keep_alive_us, std::memory_order_relaxed);
+  }
+  int64_t keep_alive_us() const {
+    return keep_alive_us_.load(std::memory_order_relaxed);
+  }
+
+  bool ShouldDeliver(const uint8_t* frame, size_t size, int64_t now_us);
+
+  // Delivers the next frame whatever its hash, for a subscriber that joins
+  // while the picture is static and has nothing to show yet.
+  void ForceNext() { force_next_.store(true, std::memory_order_relaxed); }
+
+  uint64_t frames_seen() const {
+    return frames_seen_.load(std::memory_order_relaxed);
+  }
+  uint64_t frames_suppressed() const {
+    return frames_suppressed_.load(std::memory_order_relaxed);
+  }
+  // Unchanged frames delivered only because the keep-alive interval expired.
+  uint64_t keep_alive_frames() const {
+    return keep_alive_frames_.load(std::memory_order_relaxed);
+  }
+  // Fraction of frames seen this session that were suppressed.
+  double suppression_ratio() const;
+
+ private:
+  std::atomic<int64_t> keep_alive_us_;
+  bool have_last_;
+  uint64_t last_hash_;
+  int64_t last_delivered_us_;
+  std::atomic<bool> force_next_;
+  std::atomic<uint64_t> frames_seen_;
+  std::atomic<uint64_t> frames_suppressed_;
+  std::atomic<uint64_t> keep_alive_frames_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_FRAME_SUPPRESSOR_H_
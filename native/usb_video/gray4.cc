@@ -0,0 +1,59 @@
+#include "gray4.h"
+
+namespace usb_video {
+
+namespace {
+
+struct Gray4Table {
+  // Both nibble positions precomputed, so packing a pixel pair is two loads
+  // and an OR.
+  uint8_t high[256];
+  uint8_t low[256];
+
+  Gray4Table() {
+    for (int y = 0; y < 256; ++y) {
+      const uint8_t level = QuantizeLumaToGray4(static_cast<uint8_t>(y));
+      high[y] = static_cast<uint8_t>(level << 4);
+      low[y] = level;
+    }
+  }
+};
+
+const Gray4Table& Table() {
+  static const Gray4Table table;
+  return table;
+}
+
+}  // namespace
+
+uint8_t QuantizeLumaToGray4(uint8_t luma) {
+  int value = luma - 16;
+  if (value < 0) value = 0;
+  if (value > 219) value = 219;
+  return static_cast<uint8_t>((value * 15 + 109) / 219);
+}
+
+size_t PackYuyvToGray4(const uint8_t* yuyv, int width, int height,
+                       uint8_t* out) {
+  const Gray4Table& table = Table();
+
+  out[0] = 'G';
+  out[1] = '4';
+  out[2] = kGray4Version;
+  out[3] = 0;
+  out[4] = width & 0xFF;
+  out[5] = (width >> 8) & 0xFF;
+  out[6] = height & 0xFF;
+  out[7] = (height >> 8) & 0xFF;
+
+  // One YUYV macropixel (Y0 U Y1 V) becomes exactly one output byte.
+  const size_t pairs = static_cast<size_t>(width / 2) * height;
+  uint8_t* dst = out + kGray4HeaderSize;
+  for (size_t i = 0; i < pairs; ++i) {
+    dst[i] = table.high[yuyv[0]] | table.low[yuyv[2]];
+    yuyv += 4;
+  }
+  return Gray4FrameSize(width, height);
+}
+
+}  // namespace usb_video
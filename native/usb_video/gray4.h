@@ -0,0 +1,44 @@
+#ifndef USB_VIDEO_GRAY4_H_
+#define USB_VIDEO_GRAY4_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// Packed 4-bit grayscale frames. The Disting NT display has 16 intensity
+// levels, so luma quantised to 4 bits loses nothing visible and a 256x64
+// frame shrinks from a 49 KB BMP to 8 KB. Colour is applied by the receiver
+// through a 16-entry palette.
+//
+//   offset 0   'G' '4'       magic
+//          2   u8  version   kGray4Version
+//          3   u8  reserved  0
+//          4   u16 width     little-endian
+//          6   u16 height
+//          8   rows, top-down, (width + 1) / 2 bytes each; the left pixel of
+//              each pair is the high nibble
+constexpr uint8_t kGray4Version = 1;
+constexpr size_t kGray4HeaderSize = 8;
+
+inline size_t Gray4RowBytes(int width) {
+  return static_cast<size_t>(width + 1) / 2;
+}
+
+inline size_t Gray4FrameSize(int width, int height) {
+  return kGray4HeaderSize + Gray4RowBytes(width) * height;
+}
+
+// Maps a studio-range luma sample (16..235) to a 0..15 level, rounding to
+// nearest and clamping out-of-range values.
+uint8_t QuantizeLumaToGray4(uint8_t luma);
+
+// Quantises the luma of |yuyv| (width must be even) and writes a complete
+// gray4 frame into |out|, which must hold Gray4FrameSize() bytes. Chroma is
+// ignored. Returns the number of bytes written.
+size_t PackYuyvToGray4(const uint8_t* yuyv, int width, int height,
+                       uint8_t* out);
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_GRAY4_H_
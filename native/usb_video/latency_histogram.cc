@@ -0,0 +1,111 @@
+#include "latency_histogram.h"
+
+#include <algorithm>
+
+namespace usb_video {
+
+namespace {
+
+// Index of the highest set bit of a non-zero value.
+inline int HighestBit(uint64_t value) {
+#if defined(__GNUC__)
+  return 63 - __builtin_clzll(value);
+#else
+  int bit = 0;
+  while ((value >> (bit + 1)) != 0) {
+    ++bit;
+  }
+  return bit;
+#endif
+}
+
+}  // namespace
+
+constexpr int LatencyHistogram::kSubBucketBits;
+constexpr int LatencyHistogram::kSubBuckets;
+constexpr int64_t LatencyHistogram::kMaxValueUs;
+constexpr size_t LatencyHistogram::kBucketCount;
+
+size_t LatencyHistogram::BucketIndex(int64_t value_us) {
+  const int64_t value = std::min(std::max<int64_t>(value_us, 0), kMaxValueUs);
+  // Below 2 * kSubBuckets every value has its own bucket.
+  if (value < 2 * kSubBuckets) {
+    return static_cast<size_t>(value);
+  }
+  const int shift = HighestBit(static_cast<uint64_t>(value)) - kSubBucketBits;
+  const int64_t sub_bucket = (value >> shift) - kSubBuckets;
+  return static_cast<size_t>(kSubBuckets + shift * kSubBuckets + sub_bucket);
+}
+
+int64_t LatencyHistogram::BucketUpperBound(size_t index) {
+  if (index < 2 * kSubBuckets) {
+    return static_cast<int64_t>(index);
+  }
+  const int shift = static_cast<int>(index / kSubBuckets) - 1;
+  const int64_t sub_bucket = static_cast<int64_t>(index % kSubBuckets);
+  return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(int64_t value_us) {
+  const int64_t value = std::min(std::max<int64_t>(value_us, 0), kMaxValueUs);
+  std::atomic<uint64_t>& bucket = counts_[BucketIndex(value)];
+  bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+               std::memory_order_relaxed);
+
+  const uint64_t count = total_count_.load(std::memory_order_relaxed);
+  if (count == 0 || value < min_us_.load(std::memory_order_relaxed)) {
+    min_us_.store(value, std::memory_order_relaxed);
+  }
+  if (count == 0 || value > max_us_.load(std::memory_order_relaxed)) {
+    max_us_.store(value, std::memory_order_relaxed);
+  }
+  total_us_.store(total_us_.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  total_count_.store(count + 1, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Summary LatencyHistogram::Summarize() const {
+  Summary summary = {};
+  uint64_t counts[kBucketCount];
+  uint64_t count = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    counts[i] = counts_[i].load(std::memory_order_relaxed);
+    count += counts[i];
+  }
+  if (count == 0) {
+    return summary;
+  }
+  summary.count = count;
+  summary.min_us = min_us_.load(std::memory_order_relaxed);
+  summary.max_us = max_us_.load(std::memory_order_relaxed);
+  const uint64_t recorded = total_count_.load(std::memory_order_relaxed);
+  summary.mean_us = recorded == 0 ? 0
+                                  : total_us_.load(std::memory_order_relaxed) /
+                                        static_cast<int64_t>(recorded);
+
+  // One pass over the buckets finds all three percentiles in order.
+  const uint64_t ranks[] = {(count * 50 + 99) / 100, (count * 90 + 99) / 100,
+                            (count * 99 + 99) / 100};
+  int64_t* targets[] = {&summary.p50_us, &summary.p90_us, &summary.p99_us};
+  size_t next = 0;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount && next < 3; ++i) {
+    seen += counts[i];
+    while (next < 3 && seen >= std::max<uint64_t>(ranks[next], 1)) {
+      *targets[next++] = std::min(BucketUpperBound(i), summary.max_us);
+    }
+  }
+  return summary;
+}
+
+void LatencyHistogram::Reset() {
+  for (std::atomic<uint64_t>& bucket : counts_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  total_count_.store(0, std::memory_order_relaxed);
+  total_us_.store(0, std::memory_order_relaxed);
+  min_us_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace usb_video
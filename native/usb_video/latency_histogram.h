@@ -0,0 +1,68 @@
+#ifndef USB_VIDEO_LATENCY_HISTOGRAM_H_
+#define USB_VIDEO_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// Log-linear latency histogram in the style of HdrHistogram: every power of
+// two is split into kSubBuckets equal buckets, so any recorded value is
+// reported to within 1/kSubBuckets (12.5%) of itself from 1 us up to
+// kMaxValueUs, in a fixed 2 KB of counters.
+//
+// Like LatencyStats, there is one writer and any number of readers; the
+// counters are relaxed atomics, so Summarize() taken mid-update may miss the
+// newest sample but never sees a torn count.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 3;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // Larger samples are clamped; about 71 minutes.
+  static constexpr int64_t kMaxValueUs = (int64_t{1} << 32) - 1;
+  static constexpr size_t kBucketCount =
+      2 * kSubBuckets + (32 - kSubBucketBits - 1) * kSubBuckets;
+
+  struct Summary {
+    uint64_t count;
+    int64_t min_us;
+    int64_t max_us;
+    int64_t mean_us;
+    int64_t p50_us;
+    int64_t p90_us;
+    int64_t p99_us;
+  };
+
+  LatencyHistogram() { Reset(); }
+
+  LatencyHistogram(const LatencyHistogram&) = delete;
+  LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+  // Adds one sample; negative values count as zero. Only one thread may call
+  // this at a time.
+  void Record(int64_t value_us);
+
+  // Percentiles are the highest value equivalent to the bucket they fall in,
+  // capped at the recorded maximum.
+  Summary Summarize() const;
+
+  // Not synchronised with Record(); call while the writer is stopped.
+  void Reset();
+
+  // Exposed for tests: the bucket |value_us| lands in and the largest value
+  // that bucket holds.
+  static size_t BucketIndex(int64_t value_us);
+  static int64_t BucketUpperBound(size_t index);
+
+ private:
+  std::atomic<uint64_t> counts_[kBucketCount];
+  std::atomic<uint64_t> total_count_;
+  std::atomic<int64_t> total_us_;
+  std::atomic<int64_t> min_us_;
+  std::atomic<int64_t> max_us_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_LATENCY_HISTOGRAM_H_
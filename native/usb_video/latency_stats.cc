@@ -0,0 +1,39 @@
+#include "latency_stats.h"
+
+namespace usb_video {
+
+void LatencyStats::Record(int64_t latency_us) {
+  const uint64_t count = count_.load(std::memory_order_relaxed);
+  if (count == 0 || latency_us < min_us_.load(std::memory_order_relaxed)) {
+    min_us_.store(latency_us, std::memory_order_relaxed);
+  }
+  if (count == 0 || latency_us > max_us_.load(std::memory_order_relaxed)) {
+    max_us_.store(latency_us, std::memory_order_relaxed);
+  }
+  last_us_.store(latency_us, std::memory_order_relaxed);
+  total_us_.store(total_us_.load(std::memory_order_relaxed) + latency_us,
+                  std::memory_order_relaxed);
+  count_.store(count + 1, std::memory_order_relaxed);
+}
+
+LatencyStats::Snapshot LatencyStats::Read() const {
+  Snapshot snapshot;
+  snapshot.count = count_.load(std::memory_order_relaxed);
+  snapshot.last_us = last_us_.load(std::memory_order_relaxed);
+  snapshot.min_us = min_us_.load(std::memory_order_relaxed);
+  snapshot.max_us = max_us_.load(std::memory_order_relaxed);
+  const int64_t total = total_us_.load(std::memory_order_relaxed);
+  snapshot.mean_us =
+      snapshot.count == 0 ? 0 : total / static_cast<int64_t>(snapshot.count);
+  return snapshot;
+}
+
+void LatencyStats::Reset() {
+  count_.store(0, std::memory_order_relaxed);
+  total_us_.store(0, std::memory_order_relaxed);
+  last_us_.store(0, std::memory_order_relaxed);
+  min_us_.store(0, std::memory_order_relaxed);
+  max_us_.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace usb_video
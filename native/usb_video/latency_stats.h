@@ -0,0 +1,47 @@
+#ifndef USB_VIDEO_LATENCY_STATS_H_
+#define USB_VIDEO_LATENCY_STATS_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace usb_video {
+
+// Running latency summary with one writer (the capture thread) and any number
+// of readers (the platform thread answering a statistics request). Every
+// field is an independent relaxed atomic, so a snapshot taken mid-update may
+// mix two samples; that is fine for a diagnostic counter and keeps Record()
+// wait-free on the hot path.
+class LatencyStats {
+ public:
+  struct Snapshot {
+    uint64_t count;
+    int64_t last_us;
+    int64_t min_us;
+    int64_t max_us;
+    int64_t mean_us;
+  };
+
+  LatencyStats() { Reset(); }
+
+  LatencyStats(const LatencyStats&) = delete;
+  LatencyStats& operator=(const LatencyStats&) = delete;
+
+  // Adds one sample. Only one thread may call this at a time.
+  void Record(int64_t latency_us);
+
+  Snapshot Read() const;
+
+  // Not synchronised with Record(); call while the writer is stopped.
+  void Reset();
+
+ private:
+  std::atomic<uint64_t> count_;
+  std::atomic<int64_t> total_us_;
+  std::atomic<int64_t> last_us_;
+  std::atomic<int64_t> min_us_;
+  std::atomic<int64_t> max_us_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_LATENCY_STATS_H_
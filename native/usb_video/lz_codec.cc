@@ -0,0 +1,176 @@
+#include "lz_codec.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace usb_video {
+
+namespace {
+
+constexpr int kHashBits = 12;
+constexpr size_t kMaxOffset = 65535;
+constexpr size_t kNibbleMax = 15;
+// After this many positions without a match the search starts skipping
+// ahead, so incompressible input costs little.
+constexpr int kSkipShift = 5;
+
+inline uint32_t Load32(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t Hash(uint32_t value) {
+  return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+// Length of the common prefix of |a| and |b|, stopping at |limit|.
+inline size_t MatchLength(const uint8_t* a, const uint8_t* b,
+                          const uint8_t* limit) {
+  const uint8_t* start = a;
+  while (a + sizeof(uint64_t) <= limit) {
+    uint64_t x, y;
+    std::memcpy(&x, a, sizeof(x));
+    std::memcpy(&y, b, sizeof(y));
+    if (x != y) {
+      break;
+    }
+    a += sizeof(uint64_t);
+    b += sizeof(uint64_t);
+  }
+  while (a < limit && *a == *b) {
+    ++a;
+    ++b;
+  }
+  return static_cast<size_t>(a - start);
+}
+
+uint8_t* PutLength(uint8_t* out, size_t length) {
+  while (length >= 255) {
+    *out++ = 255;
+    length -= 255;
+  }
+  *out++ = static_cast<uint8_t>(length);
+  return out;
+}
+
+bool GetLength(const uint8_t** in, const uint8_t* end, size_t* length) {
+  uint8_t byte;
+  do {
+    if (*in == end) {
+      return false;
+    }
+    byte = *(*in)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+uint8_t* PutSequence(uint8_t* out, const uint8_t* literals,
+                     size_t literal_count) {
+  uint8_t* token = out++;
+  *token = static_cast<uint8_t>(std::min(literal_count, kNibbleMax) << 4);
+  if (literal_count >= kNibbleMax) {
+    out = PutLength(out, literal_count - kNibbleMax);
+  }
+  std::memcpy(out, literals, literal_count);
+  return out + literal_count;
+}
+
+}  // namespace
+
+size_t LzCompressBound(size_t size) {
+  return size + size / 255 + 16;
+}
+
+size_t LzCompress(const uint8_t* src, size_t size, uint8_t* dst) {
+  uint32_t table[1 << kHashBits];
+  std::fill(table, table + (1 << kHashBits), 0);
+
+  const uint8_t* const end = src + size;
+  const uint8_t* anchor = src;
+  const uint8_t* p = src;
+  uint8_t* out = dst;
+  int misses = 0;
+  while (size >= kLzMinMatch && p <= end - kLzMinMatch) {
+    const uint32_t sequence = Load32(p);
+    const uint32_t hash = Hash(sequence);
+    const uint8_t* candidate = src + table[hash];
+    table[hash] = static_cast<uint32_t>(p - src);
+    const size_t offset = static_cast<size_t>(p - candidate);
+    if (offset == 0 || offset > kMaxOffset || Load32(candidate) != sequence) {
+      p += 1 + (misses++ >> kSkipShift);
+      continue;
+    }
+    misses = 0;
+
+    const size_t match = kLzMinMatch + MatchLength(p + kLzMinMatch,
+                                                   candidate + kLzMinMatch, end);
+    uint8_t* token = out;
+    out = PutSequence(out, anchor, static_cast<size_t>(p - anchor));
+    const size_t extra = match - kLzMinMatch;
+    *token |= static_cast<uint8_t>(std::min(extra, kNibbleMax));
+    *out++ = static_cast<uint8_t>(offset & 0xFF);
+    *out++ = static_cast<uint8_t>(offset >> 8);
+    if (extra >= kNibbleMax) {
+      out = PutLength(out, extra - kNibbleMax);
+    }
+    p += match;
+    anchor = p;
+  }
+  out = PutSequence(out, anchor, static_cast<size_t>(end - anchor));
+  return static_cast<size_t>(out - dst);
+}
+
+bool LzDecompress(const uint8_t* src, size_t size, uint8_t* dst,
+                  size_t dst_size) {
+  const uint8_t* in = src;
+  const uint8_t* const in_end = src + size;
+  uint8_t* out = dst;
+  uint8_t* const out_end = dst + dst_size;
+  while (in < in_end) {
+    const uint8_t token = *in++;
+    size_t literals = token >> 4;
+    if (literals == kNibbleMax && !GetLength(&in, in_end, &literals)) {
+      return false;
+    }
+    if (literals > static_cast<size_t>(in_end - in) ||
+        literals > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    std::memcpy(out, in, literals);
+    in += literals;
+    out += literals;
+    if (in == in_end) {
+      break;
+    }
+
+    if (in_end - in < 2) {
+      return false;
+    }
+    const size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t match = token & 0x0F;
+    if (match == kNibbleMax && !GetLength(&in, in_end, &match)) {
+      return false;
+    }
+    match += kLzMinMatch;
+    if (offset == 0 || offset > static_cast<size_t>(out - dst) ||
+        match > static_cast<size_t>(out_end - out)) {
+      return false;
+    }
+    const uint8_t* from = out - offset;
+    if (offset >= match) {
+      std::memcpy(out, from, match);
+      out += match;
+    } else {
+      // Overlapping copy: repeats the last |offset| bytes.
+      for (size_t i = 0; i < match; ++i) {
+        *out++ = *from++;
+      }
+    }
+  }
+  return out == out_end;
+}
+
+}  // namespace usb_video
@@ -0,0 +1,41 @@
+#ifndef USB_VIDEO_LZ_CODEC_H_
+#define USB_VIDEO_LZ_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// A small LZ77 block codec in the style of LZ4, tuned for recording frames
+// that are mostly zero after delta coding. One hash probe per position and
+// no entropy stage, so it compresses a 32 KB frame in microseconds.
+//
+// A block is a series of sequences:
+//
+//   u8  token            high nibble: literal count, low nibble: match
+//                        length - kLzMinMatch; 15 in either means "plus the
+//                        extension bytes that follow"
+//   [extension bytes]    literal count: 255s and a final byte < 255, summed
+//   literals
+//   u16 offset           little-endian distance back to the match, 1..65535
+//   [extension bytes]    match length, as for the literal count
+//
+// The last sequence stops after its literals (which may be none).
+constexpr size_t kLzMinMatch = 4;
+
+// Largest block LzCompress() can produce for |size| input bytes.
+size_t LzCompressBound(size_t size);
+
+// Compresses |size| bytes of |src| into |dst|, which must hold
+// LzCompressBound(size) bytes. Returns the block size.
+size_t LzCompress(const uint8_t* src, size_t size, uint8_t* dst);
+
+// Decompresses a block into exactly |dst_size| bytes. Returns false, with
+// |dst| partly written, if the block is malformed or does not decode to
+// exactly that size; never reads or writes out of bounds.
+bool LzDecompress(const uint8_t* src, size_t size, uint8_t* dst,
+                  size_t dst_size);
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_LZ_CODEC_H_
@@ -0,0 +1,61 @@
+#include "pipeline_telemetry.h"
+
+#include <algorithm>
+
+namespace usb_video {
+
+constexpr int64_t PipelineTelemetry::kDefaultIntervalUs;
+constexpr int64_t PipelineTelemetry::kMinIntervalUs;
+
+const char* PipelineTelemetry::StageName(Stage stage) {
+  switch (stage) {
+    case kDequeue:
+      return "dequeue";
+    case kConvert:
+      return "convert";
+    case kEncode:
+      return "encode";
+    case kQueueWait:
+      return "queueWait";
+    case kSend:
+      return "send";
+    case kStageCount:
+      break;
+  }
+  return "unknown";
+}
+
+void PipelineTelemetry::Reset(int64_t now_us) {
+  for (LatencyHistogram& histogram : histograms_) {
+    histogram.Reset();
+  }
+  std::fill(window_start_totals_, window_start_totals_ + kCounterCount, 0);
+  session_start_us_ = now_us;
+  window_start_us_ = now_us;
+  window_us_ = 0;
+}
+
+void PipelineTelemetry::set_interval_us(int64_t interval_us) {
+  interval_us_ = interval_us <= 0 ? 0 : std::max(interval_us, kMinIntervalUs);
+}
+
+bool PipelineTelemetry::StartNextWindow(int64_t now_us) {
+  if (!enabled() || now_us - window_start_us_ < interval_us_) {
+    return false;
+  }
+  window_us_ = now_us - window_start_us_;
+  window_start_us_ = now_us;
+  return true;
+}
+
+double PipelineTelemetry::WindowRate(Counter counter, uint64_t total) {
+  const uint64_t start = window_start_totals_[counter];
+  window_start_totals_[counter] = total;
+  if (window_us_ <= 0 || total < start) {
+    return 0.0;
+  }
+  return static_cast<double>(total - start) * 1e6 /
+         static_cast<double>(window_us_);
+}
+
+}  // namespace usb_video
@@ -0,0 +1,90 @@
+#ifndef USB_VIDEO_PIPELINE_TELEMETRY_H_
+#define USB_VIDEO_PIPELINE_TELEMETRY_H_
+
+#include <cstdint>
+
+#include "latency_histogram.h"
+
+namespace usb_video {
+
+// Per-session timing of every stage a frame passes through, plus the
+// bookkeeping for emitting it as a rate-limited report.
+//
+// Histograms cover the whole session; rates (fps, CPU share) are computed
+// over the window since the previous report. The dequeue histogram is
+// written by the capture thread, everything else by the main thread.
+class PipelineTelemetry {
+ public:
+  enum Stage {
+    // Driver timestamp to VIDIOC_DQBUF returning.
+    kDequeue,
+    // YUYV to RGB24 or packed gray.
+    kConvert,
+    // BMP and/or delta encoding.
+    kEncode,
+    // Publish on the capture thread to pickup on the main thread.
+    kQueueWait,
+    // fl_event_channel_send.
+    kSend,
+    kStageCount,
+  };
+
+  // Running totals whose per-second rate is reported for each window.
+  enum Counter {
+    kFramesCaptured,
+    kFramesDelivered,
+    kCaptureCpuUs,
+    kCounterCount,
+  };
+
+  static constexpr int64_t kDefaultIntervalUs = 1000000;
+  static constexpr int64_t kMinIntervalUs = 100000;
+
+  // Short camelCase name used as the report key prefix.
+  static const char* StageName(Stage stage);
+
+  PipelineTelemetry() { Reset(0); }
+
+  PipelineTelemetry(const PipelineTelemetry&) = delete;
+  PipelineTelemetry& operator=(const PipelineTelemetry&) = delete;
+
+  // Starts a new session at |now_us|. Not synchronised with Record().
+  void Reset(int64_t now_us);
+
+  // Reports are emitted at most every |interval_us| (raised to
+  // kMinIntervalUs); zero or less turns them off. Keeps the session data.
+  void set_interval_us(int64_t interval_us);
+  int64_t interval_us() const { return interval_us_; }
+  bool enabled() const { return interval_us_ > 0; }
+
+  void Record(Stage stage, int64_t value_us) {
+    histograms_[stage].Record(value_us);
+  }
+  const LatencyHistogram& histogram(Stage stage) const {
+    return histograms_[stage];
+  }
+
+  // Returns true when a report is due at |now_us|, closing the current
+  // window and opening the next. Always false while disabled.
+  bool StartNextWindow(int64_t now_us);
+  // Length of the window StartNextWindow() just closed.
+  int64_t window_us() const { return window_us_; }
+  int64_t session_us(int64_t now_us) const { return now_us - session_start_us_; }
+
+  // Per-second rate of |total| over the window just closed. Remembers
+  // |total| as the start of the next window, so call once per counter per
+  // report.
+  double WindowRate(Counter counter, uint64_t total);
+
+ private:
+  LatencyHistogram histograms_[kStageCount];
+  uint64_t window_start_totals_[kCounterCount];
+  int64_t interval_us_ = 0;
+  int64_t session_start_us_ = 0;
+  int64_t window_start_us_ = 0;
+  int64_t window_us_ = 0;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_PIPELINE_TELEMETRY_H_
@@ -0,0 +1,340 @@
+#include "png_encoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace usb_video {
+
+namespace {
+
+const uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+const size_t kChunkOverhead = 12;  // length, type, CRC
+const size_t kIhdrSize = 13;
+const uint8_t kFilterSub = 1;
+
+// The LZ77 pass hashes four bytes at a time, so that is its shortest match
+// (deflate's own minimum is three).
+const int kHashBits = 14;
+const size_t kMinMatch = 4;
+const size_t kMaxMatch = 258;
+const size_t kWindowSize = 32768;
+const size_t kMatchTailIndexed = 8;
+const int kEndOfBlock = 256;
+
+const uint16_t kLengthBase[29] = {3,  4,  5,  6,   7,   8,   9,   10,  11,  13,
+                                  15, 17, 19, 23,  27,  31,  35,  43,  51,  59,
+                                  67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t kDistanceBase[30] = {1,    2,    3,    4,    5,    7,     9,     13,
+                                    17,   25,   33,   49,   65,   97,    129,   193,
+                                    257,  385,  513,  769,  1025, 1537,  2049,  3073,
+                                    4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t kDistanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                    6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+uint32_t ReverseBits(uint32_t code, int length) {
+  uint32_t reversed = 0;
+  for (int i = 0; i < length; ++i) {
+    reversed = (reversed << 1) | ((code >> i) & 1);
+  }
+  return reversed;
+}
+
+// Deflate's fixed Huffman codes (RFC 1951 3.2.6), bit-reversed ready for an
+// LSB-first writer, and the length symbol for every match length.
+struct FixedCodes {
+  FixedCodes() {
+    for (int symbol = 0; symbol < 288; ++symbol) {
+      uint32_t code;
+      int length;
+      if (symbol < 144) {
+        code = 0x30 + symbol;
+        length = 8;
+      } else if (symbol < 256) {
+        code = 0x190 + symbol - 144;
+        length = 9;
+      } else if (symbol < 280) {
+        code = symbol - 256;
+        length = 7;
+      } else {
+        code = 0xC0 + symbol - 280;
+        length = 8;
+      }
+      literal_code[symbol] = static_cast<uint16_t>(ReverseBits(code, length));
+      literal_length[symbol] = static_cast<uint8_t>(length);
+    }
+    for (int symbol = 0; symbol < 30; ++symbol) {
+      distance_code[symbol] = static_cast<uint8_t>(ReverseBits(symbol, 5));
+    }
+    int index = 0;
+    for (size_t length = kMinMatch - 1; length <= kMaxMatch; ++length) {
+      while (index < 28 && kLengthBase[index + 1] <= length) {
+        index++;
+      }
+      length_index[length] = static_cast<uint8_t>(index);
+    }
+  }
+
+  uint16_t literal_code[288];
+  uint8_t literal_length[288];
+  uint8_t distance_code[30];
+  uint8_t length_index[kMaxMatch + 1];
+};
+
+const FixedCodes& fixed_codes() {
+  static const FixedCodes codes;
+  return codes;
+}
+
+struct CrcTable {
+  CrcTable() {
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      }
+      entries[n] = c;
+    }
+  }
+
+  uint32_t entries[256];
+};
+
+uint32_t Crc32(const uint8_t* data, size_t size) {
+  static const CrcTable table;
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < size; ++i) {
+    crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return crc ^ 0xFFFFFFFFu;
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size) {
+  const uint32_t kModulus = 65521;
+  // Sixteen lanes, each a running byte sum and a sum of those sums, so the
+  // inner loop is plain element-wise adds the compiler can vectorise; the
+  // usual form has a dependent add per byte. A block of kBlock bytes keeps
+  // the lanes from overflowing.
+  const size_t kLanes = 16;
+  const size_t kBlock = 5552 / kLanes * kLanes;
+  uint32_t a = 1;
+  uint32_t b = 0;
+  while (size >= kLanes) {
+    const size_t block = std::min(size, kBlock) / kLanes * kLanes;
+    uint32_t lane_sum[kLanes] = {};
+    uint32_t lane_prefix[kLanes] = {};
+    for (size_t i = 0; i < block; i += kLanes) {
+      for (size_t k = 0; k < kLanes; ++k) {
+        lane_prefix[k] += lane_sum[k];
+        lane_sum[k] += data[i + k];
+      }
+    }
+    // Byte k of group g counts (groups - g) * 16 - k times towards b.
+    uint64_t sum = 0;
+    uint64_t weighted = 0;
+    for (size_t k = 0; k < kLanes; ++k) {
+      sum += lane_sum[k];
+      weighted += static_cast<uint64_t>(lane_prefix[k] + lane_sum[k]) * kLanes -
+                  static_cast<uint64_t>(k) * lane_sum[k];
+    }
+    b = static_cast<uint32_t>((b + static_cast<uint64_t>(block) * a + weighted) % kModulus);
+    a = static_cast<uint32_t>((a + sum) % kModulus);
+    data += block;
+    size -= block;
+  }
+  for (size_t i = 0; i < size; ++i) {
+    a = (a + data[i]) % kModulus;
+    b = (b + a) % kModulus;
+  }
+  return (b << 16) | a;
+}
+
+void PutBigEndian32(uint8_t* out, uint32_t value) {
+  out[0] = static_cast<uint8_t>(value >> 24);
+  out[1] = static_cast<uint8_t>(value >> 16);
+  out[2] = static_cast<uint8_t>(value >> 8);
+  out[3] = static_cast<uint8_t>(value);
+}
+
+uint32_t Load32(const uint8_t* p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint64_t Load64(const uint8_t* p) {
+  uint64_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t Hash(uint32_t value) {
+  return (value * 2654435761u) >> (32 - kHashBits);
+}
+
+// Fills in the length, type and CRC around |length| bytes of chunk data
+// already written at |chunk| + 8. Returns the size of the whole chunk.
+size_t FinishChunk(uint8_t* chunk, const char* type, size_t length) {
+  PutBigEndian32(chunk, static_cast<uint32_t>(length));
+  memcpy(chunk + 4, type, 4);
+  PutBigEndian32(chunk + 8 + length, Crc32(chunk + 4, length + 4));
+  return length + kChunkOverhead;
+}
+
+class BitWriter {
+ public:
+  explicit BitWriter(uint8_t* out) : out_(out), size_(0), bits_(0), count_(0) {}
+
+  // Appends the low |count| bits of |value|, least significant first.
+  void Put(uint32_t value, int count) {
+    bits_ |= static_cast<uint64_t>(value) << count_;
+    count_ += count;
+    while (count_ >= 8) {
+      out_[size_++] = static_cast<uint8_t>(bits_);
+      bits_ >>= 8;
+      count_ -= 8;
+    }
+  }
+
+  void PutLiteral(int symbol) {
+    const FixedCodes& codes = fixed_codes();
+    Put(codes.literal_code[symbol], codes.literal_length[symbol]);
+  }
+
+  void PutMatch(size_t length, size_t distance) {
+    const FixedCodes& codes = fixed_codes();
+    const int length_index = codes.length_index[length];
+    PutLiteral(257 + length_index);
+    Put(static_cast<uint32_t>(length - kLengthBase[length_index]), kLengthExtra[length_index]);
+    int distance_index = 0;
+    while (distance_index < 29 && kDistanceBase[distance_index + 1] <= distance) {
+      distance_index++;
+    }
+    Put(codes.distance_code[distance_index], 5);
+    Put(static_cast<uint32_t>(distance - kDistanceBase[distance_index]),
+        kDistanceExtra[distance_index]);
+  }
+
+  // Pads to a whole byte. Returns the bytes written.
+  size_t Finish() {
+    if (count_ > 0) {
+      out_[size_++] = static_cast<uint8_t>(bits_);
+      bits_ = 0;
+      count_ = 0;
+    }
+    return size_;
+  }
+
+ private:
+  uint8_t* out_;
+  size_t size_;
+  uint64_t bits_;
+  int count_;
+};
+
+// One final fixed-Huffman deflate block for |data|. Returns the bytes
+// written to |out|.
+size_t Deflate(const uint8_t* data, size_t size, int32_t* hash_table, uint8_t* out) {
+  BitWriter writer(out);
+  writer.Put(1, 1);  // BFINAL
+  writer.Put(1, 2);  // BTYPE: fixed Huffman codes
+  std::fill(hash_table, hash_table + (1 << kHashBits), -1);
+  size_t i = 0;
+  while (i + kMinMatch <= size) {
+    const uint32_t value = Load32(data + i);
+    int32_t* bucket = &hash_table[Hash(value)];
+    const int32_t candidate = *bucket;
+    *bucket = static_cast<int32_t>(i);
+    if (candidate < 0 || i - candidate > kWindowSize || Load32(data + candidate) != value) {
+      writer.PutLiteral(data[i++]);
+      continue;
+    }
+    const size_t limit = std::min(kMaxMatch, size - i);
+    size_t length = kMinMatch;
+    // Eight bytes at a time, then the last few one by one.
+    while (length + 8 <= limit &&
+           Load64(data + candidate + length) == Load64(data + i + length)) {
+      length += 8;
+    }
+    while (length < limit && data[candidate + length] == data[i + length]) {
+      length++;
+    }
+    writer.PutMatch(length, i - candidate);
+    // Index the tail of what the match covered, so a run can carry on
+    // from there; indexing all of it would cost as much as not matching.
+    const size_t end = i + length;
+    for (i = std::max(i + 1, end - kMatchTailIndexed); i < end && i + kMinMatch <= size; ++i) {
+      hash_table[Hash(Load32(data + i))] = static_cast<int32_t>(i);
+    }
+    i = end;
+  }
+  while (i < size) {
+    writer.PutLiteral(data[i++]);
+  }
+  writer.PutLiteral(kEndOfBlock);
+  return writer.Finish();
+}
+
+}  // namespace
+
+size_t PngMaxSize(int width, int height, int channels) {
+  const size_t raw = (static_cast<size_t>(width) * channels + 1) * height;
+  // Nine bits a literal at worst (a match never costs more than the
+  // literals it replaces), plus the block header, end code and padding.
+  const size_t deflate = raw + raw / 8 + 3;
+  // zlib header and Adler-32, then the IHDR, IDAT and IEND chunks.
+  const size_t zlib = 2 + deflate + 4;
+  return sizeof(kPngSignature) + (kChunkOverhead + kIhdrSize) + (kChunkOverhead + zlib) +
+         kChunkOverhead;
+}
+
+PngEncoder::PngEncoder() : hash_table_(1 << kHashBits), size_(0) {}
+
+bool PngEncoder::Encode(const uint8_t* pixels, int width, int height, int channels) {
+  if ((channels != 3 && channels != 4) || width <= 0 || height <= 0) {
+    return false;
+  }
+  const size_t stride = static_cast<size_t>(width) * channels;
+  filtered_.resize((stride + 1) * height);
+  for (int y = 0; y < height; ++y) {
+    const uint8_t* row = pixels + y * stride;
+    uint8_t* out = &filtered_[y * (stride + 1)];
+    *out++ = kFilterSub;
+    memcpy(out, row, channels);
+    for (size_t x = channels; x < stride; ++x) {
+      out[x] = static_cast<uint8_t>(row[x] - row[x - channels]);
+    }
+  }
+
+  png_.resize(PngMaxSize(width, height, channels));
+  uint8_t* out = png_.data();
+  memcpy(out, kPngSignature, sizeof(kPngSignature));
+  size_t size = sizeof(kPngSignature);
+
+  uint8_t* ihdr = out + size + 8;
+  PutBigEndian32(ihdr, static_cast<uint32_t>(width));
+  PutBigEndian32(ihdr + 4, static_cast<uint32_t>(height));
+  ihdr[8] = 8;                         // bit depth
+  ihdr[9] = channels == 4 ? 6 : 2;     // colour type: RGBA or RGB
+  ihdr[10] = 0;                        // deflate
+  ihdr[11] = 0;                        // adaptive filtering
+  ihdr[12] = 0;                        // no interlace
+  size += FinishChunk(out + size, "IHDR", kIhdrSize);
+
+  // zlib: 32K window, fastest level, no dictionary; header % 31 == 0.
+  uint8_t* zlib = out + size + 8;
+  zlib[0] = 0x78;
+  zlib[1] = 0x01;
+  size_t zlib_size = 2;
+  zlib_size += Deflate(filtered_.data(), filtered_.size(), hash_table_.data(), zlib + 2);
+  PutBigEndian32(zlib + zlib_size, Adler32(filtered_.data(), filtered_.size()));
+  zlib_size += 4;
+  size += FinishChunk(out + size, "IDAT", zlib_size);
+
+  size += FinishChunk(out + size, "IEND", 0);
+  size_ = size;
+  return true;
+}
+
+}  // namespace usb_video
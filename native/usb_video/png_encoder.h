@@ -0,0 +1,48 @@
+#ifndef USB_VIDEO_PNG_ENCODER_H_
+#define USB_VIDEO_PNG_ENCODER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace usb_video {
+
+// Encodes 8-bit RGB or RGBA pixels as PNG, fast rather than small.
+//
+// Every row uses the Sub filter, which turns the flat areas of a display
+// picture into runs of zeroes, and the image data is compressed in a single
+// greedy LZ77 pass (one hash table probe per position) written with
+// deflate's fixed Huffman codes, so there are no code tables to build. A
+// 266x74 screenshot takes about a tenth of a millisecond.
+//
+// Buffers are kept between calls; only growing them allocates.
+class PngEncoder {
+ public:
+  PngEncoder();
+
+  PngEncoder(const PngEncoder&) = delete;
+  PngEncoder& operator=(const PngEncoder&) = delete;
+
+  // Encodes |width| x |height| top-down pixels of |channels| bytes (3 for
+  // RGB, 4 for RGBA). Returns false for any other channel count or an
+  // empty image.
+  bool Encode(const uint8_t* pixels, int width, int height, int channels);
+
+  // The last PNG file. Valid until the next Encode().
+  const uint8_t* data() const { return png_.data(); }
+  size_t size() const { return size_; }
+
+ private:
+  std::vector<uint8_t> filtered_;
+  std::vector<int32_t> hash_table_;
+  std::vector<uint8_t> png_;
+  size_t size_;
+};
+
+// Upper bound on the size of a PNG PngEncoder produces for |width| x
+// |height| pixels of |channels| bytes.
+size_t PngMaxSize(int width, int height, int channels);
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_PNG_ENCODER_H_
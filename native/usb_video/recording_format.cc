@@ -0,0 +1,98 @@
+#include "recording_format.h"
+
+#include <cstring>
+
+#include "gray4.h"
+
+namespace usb_video {
+
+size_t RecordingFrameSize(RecordingPixelFormat format, int width, int height) {
+  if (format == kRecordingGray4) {
+    return Gray4FrameSize(width, height);
+  }
+  return static_cast<size_t>(width) * height * 2;
+}
+
+void PutRecordingLe16(uint8_t* out, uint16_t value) {
+  out[0] = value & 0xFF;
+  out[1] = (value >> 8) & 0xFF;
+}
+
+void PutRecordingLe32(uint8_t* out, uint32_t value) {
+  PutRecordingLe16(out, static_cast<uint16_t>(value));
+  PutRecordingLe16(out + 2, static_cast<uint16_t>(value >> 16));
+}
+
+void PutRecordingLe64(uint8_t* out, uint64_t value) {
+  PutRecordingLe32(out, static_cast<uint32_t>(value));
+  PutRecordingLe32(out + 4, static_cast<uint32_t>(value >> 32));
+}
+
+uint16_t GetRecordingLe16(const uint8_t* in) {
+  return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+uint32_t GetRecordingLe32(const uint8_t* in) {
+  return GetRecordingLe16(in) |
+         (static_cast<uint32_t>(GetRecordingLe16(in + 2)) << 16);
+}
+
+uint64_t GetRecordingLe64(const uint8_t* in) {
+  return GetRecordingLe32(in) |
+         (static_cast<uint64_t>(GetRecordingLe32(in + 4)) << 32);
+}
+
+void WriteRecordingHeader(const RecordingHeader& header, uint8_t* out) {
+  std::memset(out, 0, kRecordingHeaderSize);
+  std::memcpy(out, "NTRC", 4);
+  out[4] = kRecordingVersion;
+  out[5] = header.pixel_format;
+  PutRecordingLe16(out + 6, static_cast<uint16_t>(header.width));
+  PutRecordingLe16(out + 8, static_cast<uint16_t>(header.height));
+  PutRecordingLe32(out + 12, header.frame_size);
+  PutRecordingLe32(out + 16, header.keyframe_interval);
+  PutRecordingLe64(out + 24, static_cast<uint64_t>(header.created_us));
+}
+
+bool ReadRecordingHeader(const uint8_t* data, size_t size,
+                         RecordingHeader* header) {
+  if (size < kRecordingHeaderSize || std::memcmp(data, "NTRC", 4) != 0 ||
+      data[4] != kRecordingVersion ||
+      (data[5] != kRecordingYuyv && data[5] != kRecordingGray4)) {
+    return false;
+  }
+  header->pixel_format = static_cast<RecordingPixelFormat>(data[5]);
+  header->width = GetRecordingLe16(data + 6);
+  header->height = GetRecordingLe16(data + 8);
+  header->frame_size = GetRecordingLe32(data + 12);
+  header->keyframe_interval = GetRecordingLe32(data + 16);
+  header->created_us = static_cast<int64_t>(GetRecordingLe64(data + 24));
+  return header->keyframe_interval > 0 &&
+         header->frame_size == RecordingFrameSize(header->pixel_format,
+                                                  header->width,
+                                                  header->height);
+}
+
+void WriteRecordingFrameHeader(const RecordingFrameHeader& header,
+                               uint8_t* out) {
+  std::memset(out, 0, kRecordingFrameHeaderSize);
+  out[0] = 'F';
+  out[1] = header.flags;
+  PutRecordingLe32(out + 4, header.payload_size);
+  PutRecordingLe32(out + 8, header.sequence);
+  PutRecordingLe64(out + 16, static_cast<uint64_t>(header.timestamp_us));
+}
+
+bool ReadRecordingFrameHeader(const uint8_t* data, size_t size,
+                              RecordingFrameHeader* header) {
+  if (size < kRecordingFrameHeaderSize || data[0] != 'F') {
+    return false;
+  }
+  header->flags = data[1];
+  header->payload_size = GetRecordingLe32(data + 4);
+  header->sequence = GetRecordingLe32(data + 8);
+  header->timestamp_us = static_cast<int64_t>(GetRecordingLe64(data + 16));
+  return true;
+}
+
+}  // namespace usb_video
@@ -0,0 +1,103 @@
+#ifndef USB_VIDEO_RECORDING_FORMAT_H_
+#define USB_VIDEO_RECORDING_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// Display recordings (.ntrec): an append-only file of compressed raw frames.
+// All integers are little-endian.
+//
+//   file header, kRecordingHeaderSize bytes:
+//     offset 0   'N' 'T' 'R' 'C'   magic
+//            4   u8  version       kRecordingVersion
+//            5   u8  pixel format  RecordingPixelFormat
+//            6   u16 width
+//            8   u16 height
+//           10   u16 reserved      0
+//           12   u32 frame_size    bytes of one decoded frame
+//           16   u32 keyframe_interval
+//           20   u32 reserved      0
+//           24   i64 created_us    wall clock, microseconds since the epoch
+//
+//   frames, back to back, each a kRecordingFrameHeaderSize header:
+//     offset 0   'F'               tag
+//            1   u8  flags         kRecordingKeyframe, kRecordingRepeat
+//            2   u16 reserved      0
+//            4   u32 payload_size
+//            8   u32 sequence      V4L2 sequence number
+//           12   u32 reserved      0
+//           16   i64 timestamp_us  V4L2 (CLOCK_MONOTONIC) capture time
+//     then payload_size bytes: an LZ block (lz_codec.h) of the frame for a
+//     keyframe, or of the frame XOR the previous one otherwise. A repeat has
+//     no payload and means "same as the previous frame".
+//
+//   once closed, the keyframe index and a trailer:
+//     'N' 'T' 'I' 'X', u32 count, then count entries of
+//       u64 file offset of the keyframe's header
+//       i64 timestamp_us
+//     u64 index offset, u32 frame count, 'N' 'T' 'E' 'N'   (trailer)
+//
+// Frame k is a keyframe exactly when k % keyframe_interval == 0, so it is
+// decoded from index entry k / keyframe_interval plus at most
+// keyframe_interval - 1 records: seeking costs the same anywhere in the
+// file. A recording cut short by a crash has no index; readers rebuild it
+// by scanning the frames.
+enum RecordingPixelFormat : uint8_t {
+  kRecordingYuyv = 0,
+  kRecordingGray4 = 1,  // Complete gray4 frames, header included (gray4.h).
+};
+
+constexpr uint8_t kRecordingVersion = 1;
+constexpr size_t kRecordingHeaderSize = 32;
+constexpr size_t kRecordingFrameHeaderSize = 24;
+constexpr size_t kRecordingIndexHeaderSize = 8;
+constexpr size_t kRecordingIndexEntrySize = 16;
+constexpr size_t kRecordingTrailerSize = 16;
+
+constexpr uint8_t kRecordingKeyframe = 1 << 0;
+constexpr uint8_t kRecordingRepeat = 1 << 1;
+
+struct RecordingHeader {
+  RecordingPixelFormat pixel_format;
+  int width;
+  int height;
+  uint32_t frame_size;
+  uint32_t keyframe_interval;
+  int64_t created_us;
+};
+
+struct RecordingFrameHeader {
+  uint8_t flags;
+  uint32_t payload_size;
+  uint32_t sequence;
+  int64_t timestamp_us;
+};
+
+// Bytes of one decoded frame in |format|.
+size_t RecordingFrameSize(RecordingPixelFormat format, int width, int height);
+
+void WriteRecordingHeader(const RecordingHeader& header, uint8_t* out);
+// False unless |data| starts with a supported header.
+bool ReadRecordingHeader(const uint8_t* data, size_t size,
+                         RecordingHeader* header);
+
+void WriteRecordingFrameHeader(const RecordingFrameHeader& header,
+                               uint8_t* out);
+// False unless |data| holds a whole frame header; does not check the
+// payload fits.
+bool ReadRecordingFrameHeader(const uint8_t* data, size_t size,
+                              RecordingFrameHeader* header);
+
+// Little-endian field access shared by the writer and reader.
+void PutRecordingLe16(uint8_t* out, uint16_t value);
+void PutRecordingLe32(uint8_t* out, uint32_t value);
+void PutRecordingLe64(uint8_t* out, uint64_t value);
+uint16_t GetRecordingLe16(const uint8_t* in);
+uint32_t GetRecordingLe32(const uint8_t* in);
+uint64_t GetRecordingLe64(const uint8_t* in);
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_RECORDING_FORMAT_H_
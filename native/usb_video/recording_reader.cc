@@ -0,0 +1,234 @@
+#include "recording_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "lz_codec.h"
+
+namespace usb_video {
+
+RecordingReader::RecordingReader()
+    : data_(nullptr),
+      size_(0),
+      records_end_(0),
+      header_(),
+      frame_count_(0),
+      recovered_(false),
+      next_index_(0),
+      next_offset_(0),
+      current_info_() {}
+
+RecordingReader::~RecordingReader() { Close(); }
+
+bool RecordingReader::Open(const std::string& path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kRecordingHeaderSize)) {
+    close(fd);
+    return false;
+  }
+  void* map = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                   MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+  data_ = static_cast<const uint8_t*>(map);
+  size_ = static_cast<size_t>(st.st_size);
+  if (!ReadRecordingHeader(data_, size_, &header_)) {
+    Close();
+    return false;
+  }
+  // Playback walks the file front to back.
+  madvise(map, size_, MADV_SEQUENTIAL);
+
+  if (!LoadIndex()) {
+    ScanFrames();
+    recovered_ = true;
+  }
+  current_.assign(header_.frame_size, 0);
+  scratch_.assign(header_.frame_size, 0);
+  return true;
+}
+
+void RecordingReader::Close() {
+  if (data_ != nullptr) {
+    munmap(const_cast<uint8_t*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  records_end_ = 0;
+  keyframes_.clear();
+  frame_count_ = 0;
+  recovered_ = false;
+  next_index_ = 0;
+  next_offset_ = 0;
+}
+
+bool RecordingReader::LoadIndex() {
+  if (size_ < kRecordingHeaderSize + kRecordingIndexHeaderSize +
+                  kRecordingTrailerSize) {
+    return false;
+  }
+  const uint8_t* trailer = data_ + size_ - kRecordingTrailerSize;
+  if (std::memcmp(trailer + 12, "NTEN", 4) != 0) {
+    return false;
+  }
+  const uint64_t index_offset = GetRecordingLe64(trailer);
+  const uint32_t frame_count = GetRecordingLe32(trailer + 8);
+  if (index_offset < kRecordingHeaderSize ||
+      index_offset > size_ - kRecordingTrailerSize - kRecordingIndexHeaderSize) {
+    return false;
+  }
+  const uint8_t* index = data_ + index_offset;
+  const uint32_t count = GetRecordingLe32(index + 4);
+  const uint64_t expected =
+      (static_cast<uint64_t>(frame_count) + header_.keyframe_interval - 1) /
+      header_.keyframe_interval;
+  if (std::memcmp(index, "NTIX", 4) != 0 || count != expected ||
+      index_offset + kRecordingIndexHeaderSize +
+              static_cast<uint64_t>(count) * kRecordingIndexEntrySize +
+              kRecordingTrailerSize !=
+          size_) {
+    return false;
+  }
+
+  keyframes_.resize(count);
+  const uint8_t* entry = index + kRecordingIndexHeaderSize;
+  for (uint32_t i = 0; i < count; ++i, entry += kRecordingIndexEntrySize) {
+    keyframes_[i].offset = GetRecordingLe64(entry);
+    keyframes_[i].timestamp_us = static_cast<int64_t>(GetRecordingLe64(entry + 8));
+    if (keyframes_[i].offset < kRecordingHeaderSize ||
+        keyframes_[i].offset >= index_offset) {
+      keyframes_.clear();
+      return false;
+    }
+  }
+  records_end_ = index_offset;
+  frame_count_ = frame_count;
+  return true;
+}
+
+void RecordingReader::ScanFrames() {
+  const size_t max_payload = LzCompressBound(header_.frame_size);
+  uint64_t offset = kRecordingHeaderSize;
+  size_t count = 0;
+  RecordingFrameHeader record;
+  while (ReadRecordingFrameHeader(data_ + offset, size_ - offset, &record) &&
+         record.payload_size <= max_payload &&
+         record.payload_size <= size_ - offset - kRecordingFrameHeaderSize) {
+    const bool keyframe = count % header_.keyframe_interval == 0;
+    if (keyframe != ((record.flags & kRecordingKeyframe) != 0)) {
+      break;
+    }
+    if (keyframe) {
+      keyframes_.push_back(Keyframe{offset, record.timestamp_us});
+    }
+    offset += kRecordingFrameHeaderSize + record.payload_size;
+    count++;
+  }
+  records_end_ = offset;
+  frame_count_ = count;
+}
+
+bool RecordingReader::DecodeRecord(bool keyframe) {
+  RecordingFrameHeader record;
+  if (next_offset_ >= records_end_ ||
+      !ReadRecordingFrameHeader(data_ + next_offset_, records_end_ - next_offset_,
+                                &record) ||
+      record.payload_size >
+          records_end_ - next_offset_ - kRecordingFrameHeaderSize ||
+      keyframe != ((record.flags & kRecordingKeyframe) != 0)) {
+    return false;
+  }
+  const uint8_t* payload = data_ + next_offset_ + kRecordingFrameHeaderSize;
+  if (keyframe) {
+    if (!LzDecompress(payload, record.payload_size, current_.data(),
+                      current_.size())) {
+      return false;
+    }
+  } else if ((record.flags & kRecordingRepeat) == 0) {
+    if (!LzDecompress(payload, record.payload_size, scratch_.data(),
+                      scratch_.size())) {
+      return false;
+    }
+    for (size_t i = 0; i < current_.size(); ++i) {
+      current_[i] ^= scratch_[i];
+    }
+  }
+  current_info_.timestamp_us = record.timestamp_us;
+  current_info_.sequence = record.sequence;
+  current_info_.keyframe = keyframe;
+  next_offset_ += kRecordingFrameHeaderSize + record.payload_size;
+  return true;
+}
+
+bool RecordingReader::ReadFrame(size_t index, uint8_t* out, FrameInfo* info) {
+  if (index >= frame_count_) {
+    return false;
+  }
+  const size_t interval = header_.keyframe_interval;
+  // current_ holds frame next_index_ - 1. Carry on from it when |index| is
+  // at or after it within the same keyframe group; otherwise start over
+  // from |index|'s keyframe.
+  const bool reusable = next_index_ != 0 && index + 1 >= next_index_ &&
+                        index / interval == (next_index_ - 1) / interval;
+  const bool continues = next_index_ != 0 && index >= next_index_ &&
+                         index / interval == next_index_ / interval;
+  if (!reusable && !continues) {
+    next_index_ = index / interval * interval;
+    next_offset_ = keyframes_[index / interval].offset;
+  }
+  while (next_index_ <= index) {
+    if (!DecodeRecord(next_index_ % interval == 0)) {
+      next_index_ = 0;
+      return false;
+    }
+    next_index_++;
+  }
+
+  std::memcpy(out, current_.data(), current_.size());
+  if (info != nullptr) {
+    *info = current_info_;
+  }
+  return true;
+}
+
+size_t RecordingReader::FrameAtTime(int64_t timestamp_us) const {
+  if (keyframes_.empty()) {
+    return 0;
+  }
+  auto later = std::upper_bound(
+      keyframes_.begin(), keyframes_.end(), timestamp_us,
+      [](int64_t value, const Keyframe& keyframe) {
+        return value < keyframe.timestamp_us;
+      });
+  if (later == keyframes_.begin()) {
+    return 0;
+  }
+  const size_t group = static_cast<size_t>(later - keyframes_.begin()) - 1;
+  size_t index = group * header_.keyframe_interval;
+  size_t found = index;
+  uint64_t offset = keyframes_[group].offset;
+  RecordingFrameHeader record;
+  while (index < frame_count_ &&
+         index < (group + 1) * header_.keyframe_interval && offset < records_end_ &&
+         ReadRecordingFrameHeader(data_ + offset, records_end_ - offset, &record) &&
+         record.timestamp_us <= timestamp_us) {
+    found = index;
+    offset += kRecordingFrameHeaderSize + record.payload_size;
+    index++;
+  }
+  return found;
+}
+
+}  // namespace usb_video
@@ -0,0 +1,84 @@
+#ifndef USB_VIDEO_RECORDING_READER_H_
+#define USB_VIDEO_RECORDING_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "recording_format.h"
+
+namespace usb_video {
+
+// Plays back a recording (recording_format.h) from a read-only memory map,
+// for export and in-app playback.
+//
+// Any frame decodes from its keyframe plus at most keyframe_interval - 1
+// records, and stepping forward from the last frame read decodes just one.
+// Not thread-safe; use one reader per thread.
+class RecordingReader {
+ public:
+  struct FrameInfo {
+    int64_t timestamp_us;
+    uint32_t sequence;
+    bool keyframe;
+  };
+
+  RecordingReader();
+  ~RecordingReader();
+
+  RecordingReader(const RecordingReader&) = delete;
+  RecordingReader& operator=(const RecordingReader&) = delete;
+
+  // Maps |path| and loads its keyframe index, rebuilding it by scanning if
+  // the recording was never closed. Returns false if it is not a recording.
+  bool Open(const std::string& path);
+  void Close();
+
+  const RecordingHeader& header() const { return header_; }
+  size_t frame_count() const { return frame_count_; }
+  // True when the index was rebuilt because the file has no trailer, e.g.
+  // after a crash; the frames up to the first damaged record are kept.
+  bool recovered() const { return recovered_; }
+
+  // Decodes frame |index| into |out| (header().frame_size bytes). Returns
+  // false if |index| is out of range or the data is corrupt.
+  bool ReadFrame(size_t index, uint8_t* out, FrameInfo* info = nullptr);
+
+  // Index of the last frame captured at or before |timestamp_us|, or 0 if
+  // the first frame is later. Binary searches the keyframes, then walks at
+  // most one keyframe interval of record headers.
+  size_t FrameAtTime(int64_t timestamp_us) const;
+
+ private:
+  struct Keyframe {
+    uint64_t offset;
+    int64_t timestamp_us;
+  };
+
+  bool LoadIndex();
+  void ScanFrames();
+  // Applies the record at next_offset_ to current_ and moves past it.
+  bool DecodeRecord(bool keyframe);
+
+  const uint8_t* data_;
+  size_t size_;
+  // End of the frame records: the index, or the end of the last intact
+  // record in a recovered file.
+  uint64_t records_end_;
+  RecordingHeader header_;
+  std::vector<Keyframe> keyframes_;
+  size_t frame_count_;
+  bool recovered_;
+
+  // Frame next_index_ - 1, so sequential reads apply one record each.
+  std::vector<uint8_t> current_;
+  std::vector<uint8_t> scratch_;
+  size_t next_index_;
+  uint64_t next_offset_;
+  FrameInfo current_info_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_RECORDING_READER_H_
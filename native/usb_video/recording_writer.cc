@@ -0,0 +1,232 @@
+#include "recording_writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "gray4.h"
+#include "lz_codec.h"
+
+namespace usb_video {
+
+constexpr size_t RecordingWriter::kDefaultQueueFrames;
+constexpr uint32_t RecordingWriter::kDefaultKeyframeInterval;
+
+RecordingWriter::RecordingWriter()
+    : file_(nullptr),
+      thread_(nullptr),
+      header_(),
+      input_size_(0),
+      head_(0),
+      tail_(0),
+      closing_(false),
+      frame_index_(0),
+      offset_(0),
+      failed_(false),
+      frames_written_(0),
+      frames_dropped_(0),
+      bytes_written_(0) {}
+
+RecordingWriter::~RecordingWriter() { Close(); }
+
+bool RecordingWriter::Open(const std::string& path, RecordingPixelFormat format,
+                           int width, int height, uint32_t keyframe_interval,
+                           size_t queue_frames) {
+  Close();
+  if (width <= 0 || height <= 0 || width > 0xFFFF || height > 0xFFFF ||
+      keyframe_interval == 0 || queue_frames == 0) {
+    return false;
+  }
+  input_size_ = static_cast<size_t>(width) * height * 2;
+  if (!queue_.Reserve(queue_frames, input_size_)) {
+    return false;
+  }
+  file_ = std::fopen(path.c_str(), "wb");
+  if (file_ == nullptr) {
+    return false;
+  }
+
+  header_.pixel_format = format;
+  header_.width = width;
+  header_.height = height;
+  header_.frame_size =
+      static_cast<uint32_t>(RecordingFrameSize(format, width, height));
+  header_.keyframe_interval = keyframe_interval;
+  header_.created_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+  frame_.assign(header_.frame_size, 0);
+  previous_.assign(header_.frame_size, 0);
+  delta_.assign(header_.frame_size, 0);
+  compressed_.assign(LzCompressBound(header_.frame_size), 0);
+  index_.clear();
+  pending_.assign(queue_frames, Pending());
+  head_ = 0;
+  tail_ = 0;
+  closing_ = false;
+  frame_index_ = 0;
+  offset_ = 0;
+  failed_ = false;
+  frames_written_ = 0;
+  frames_dropped_ = 0;
+  bytes_written_ = 0;
+
+  uint8_t file_header[kRecordingHeaderSize];
+  WriteRecordingHeader(header_, file_header);
+  if (!WriteBytes(file_header, sizeof(file_header))) {
+    std::fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+  thread_ = new std::thread(&RecordingWriter::Run, this);
+  return true;
+}
+
+bool RecordingWriter::Submit(const uint8_t* yuyv, size_t size,
+                             int64_t timestamp_us, uint32_t sequence) {
+  if (thread_ == nullptr) {
+    frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  const size_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail - head_.load(std::memory_order_acquire) == pending_.size()) {
+    frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  const size_t slot = tail % pending_.size();
+  uint8_t* data = queue_.slot(slot);
+  const size_t copied = std::min(size, input_size_);
+  std::memcpy(data, yuyv, copied);
+  std::memset(data + copied, 0, input_size_ - copied);
+  pending_[slot].timestamp_us = timestamp_us;
+  pending_[slot].sequence = sequence;
+  tail_.store(tail + 1, std::memory_order_release);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  wake_.notify_one();
+  return true;
+}
+
+bool RecordingWriter::Close() {
+  if (thread_ == nullptr) {
+    return !failed_;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closing_ = true;
+  }
+  wake_.notify_one();
+  thread_->join();
+  delete thread_;
+  thread_ = nullptr;
+
+  if (!failed_) {
+    WriteIndex();
+  }
+  if (std::fclose(file_) != 0) {
+    failed_ = true;
+  }
+  file_ = nullptr;
+  return !failed_;
+}
+
+void RecordingWriter::Run() {
+  for (;;) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      wake_.wait(lock, [this, head] {
+        return closing_ || tail_.load(std::memory_order_acquire) != head;
+      });
+      if (tail_.load(std::memory_order_acquire) == head) {
+        return;  // Closing with nothing left to write.
+      }
+    }
+    const size_t slot = head % pending_.size();
+    WriteFrame(queue_.slot(slot), pending_[slot]);
+    head_.store(head + 1, std::memory_order_release);
+  }
+}
+
+void RecordingWriter::WriteFrame(const uint8_t* yuyv, const Pending& pending) {
+  if (failed_) {
+    frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (header_.pixel_format == kRecordingGray4) {
+    PackYuyvToGray4(yuyv, header_.width, header_.height, frame_.data());
+  } else {
+    std::memcpy(frame_.data(), yuyv, header_.frame_size);
+  }
+
+  RecordingFrameHeader frame_header;
+  frame_header.sequence = pending.sequence;
+  frame_header.timestamp_us = pending.timestamp_us;
+  frame_header.payload_size = 0;
+  const bool keyframe = frame_index_ % header_.keyframe_interval == 0;
+  if (keyframe) {
+    frame_header.flags = kRecordingKeyframe;
+    frame_header.payload_size = static_cast<uint32_t>(
+        LzCompress(frame_.data(), header_.frame_size, compressed_.data()));
+
+    uint8_t entry[kRecordingIndexEntrySize];
+    PutRecordingLe64(entry, offset_);
+    PutRecordingLe64(entry + 8, static_cast<uint64_t>(pending.timestamp_us));
+    index_.insert(index_.end(), entry, entry + sizeof(entry));
+  } else if (std::memcmp(frame_.data(), previous_.data(), header_.frame_size) ==
+             0) {
+    // The display is static most of the time; a repeat costs just a header.
+    frame_header.flags = kRecordingRepeat;
+  } else {
+    frame_header.flags = 0;
+    for (size_t i = 0; i < header_.frame_size; ++i) {
+      delta_[i] = frame_[i] ^ previous_[i];
+    }
+    frame_header.payload_size = static_cast<uint32_t>(
+        LzCompress(delta_.data(), header_.frame_size, compressed_.data()));
+  }
+
+  uint8_t record[kRecordingFrameHeaderSize];
+  WriteRecordingFrameHeader(frame_header, record);
+  if (!WriteBytes(record, sizeof(record)) ||
+      !WriteBytes(compressed_.data(), frame_header.payload_size)) {
+    failed_ = true;
+    return;
+  }
+  frame_.swap(previous_);
+  frame_index_++;
+  frames_written_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool RecordingWriter::WriteBytes(const void* data, size_t size) {
+  if (size != 0 && std::fwrite(data, 1, size, file_) != size) {
+    return false;
+  }
+  offset_ += size;
+  bytes_written_.fetch_add(size, std::memory_order_relaxed);
+  return true;
+}
+
+bool RecordingWriter::WriteIndex() {
+  const uint64_t index_offset = offset_;
+  uint8_t index_header[kRecordingIndexHeaderSize];
+  std::memcpy(index_header, "NTIX", 4);
+  PutRecordingLe32(index_header + 4, static_cast<uint32_t>(
+                                         index_.size() / kRecordingIndexEntrySize));
+
+  uint8_t trailer[kRecordingTrailerSize];
+  PutRecordingLe64(trailer, index_offset);
+  PutRecordingLe32(trailer + 8, static_cast<uint32_t>(frame_index_));
+  std::memcpy(trailer + 12, "NTEN", 4);
+
+  if (!WriteBytes(index_header, sizeof(index_header)) ||
+      !WriteBytes(index_.data(), index_.size()) ||
+      !WriteBytes(trailer, sizeof(trailer))) {
+    failed_ = true;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace usb_video
@@ -0,0 +1,112 @@
+#ifndef USB_VIDEO_RECORDING_WRITER_H_
+#define USB_VIDEO_RECORDING_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "frame_pool.h"
+#include "recording_format.h"
+
+namespace usb_video {
+
+// Writes a recording (recording_format.h) from raw YUYV frames on a thread
+// of its own.
+//
+// The capture thread calls Submit(), which only copies the frame into a
+// fixed queue and never waits on the disk; when the writer falls behind the
+// queue fills and further frames are dropped and counted rather than held.
+// Packing, delta coding, compression and I/O all happen on the writer
+// thread, and everything it needs is allocated by Open().
+class RecordingWriter {
+ public:
+  static constexpr size_t kDefaultQueueFrames = 32;
+  static constexpr uint32_t kDefaultKeyframeInterval = 120;
+
+  RecordingWriter();
+  ~RecordingWriter();
+
+  RecordingWriter(const RecordingWriter&) = delete;
+  RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+  // Creates |path| for |width| x |height| YUYV input stored as |format|,
+  // and starts the writer thread. Returns false if the file cannot be
+  // created or the queue cannot be allocated.
+  bool Open(const std::string& path, RecordingPixelFormat format, int width,
+            int height, uint32_t keyframe_interval = kDefaultKeyframeInterval,
+            size_t queue_frames = kDefaultQueueFrames);
+
+  // Producer side; one thread only. Queues a copy of |yuyv| (frames shorter
+  // than width * height * 2 are zero-padded). Returns false, counting a
+  // drop, when the queue is full or the writer is not open.
+  bool Submit(const uint8_t* yuyv, size_t size, int64_t timestamp_us,
+              uint32_t sequence);
+
+  // Writes out everything queued, then the keyframe index and trailer, and
+  // closes the file. Returns false if any write failed along the way.
+  bool Close();
+
+  bool is_open() const { return thread_ != nullptr; }
+
+  // Counters may be read from any thread.
+  uint64_t frames_written() const {
+    return frames_written_.load(std::memory_order_relaxed);
+  }
+  uint64_t frames_dropped() const {
+    return frames_dropped_.load(std::memory_order_relaxed);
+  }
+  uint64_t bytes_written() const {
+    return bytes_written_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Pending {
+    int64_t timestamp_us;
+    uint32_t sequence;
+  };
+
+  void Run();
+  void WriteFrame(const uint8_t* yuyv, const Pending& pending);
+  bool WriteBytes(const void* data, size_t size);
+  bool WriteIndex();
+
+  std::FILE* file_;
+  std::thread* thread_;
+  RecordingHeader header_;
+  size_t input_size_;
+
+  // Single-producer, single-consumer ring over queue_ slots. head_ is
+  // advanced by the writer, tail_ by Submit(); the mutex only guards the
+  // sleep/wake handshake.
+  FramePool queue_;
+  std::vector<Pending> pending_;
+  std::atomic<size_t> head_;
+  std::atomic<size_t> tail_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool closing_;
+
+  // Writer thread state.
+  std::vector<uint8_t> frame_;
+  std::vector<uint8_t> previous_;
+  std::vector<uint8_t> delta_;
+  std::vector<uint8_t> compressed_;
+  std::vector<uint8_t> index_;
+  uint64_t frame_index_;
+  uint64_t offset_;
+  bool failed_;
+
+  std::atomic<uint64_t> frames_written_;
+  std::atomic<uint64_t> frames_dropped_;
+  std::atomic<uint64_t> bytes_written_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_RECORDING_WRITER_H_
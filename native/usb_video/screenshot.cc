@@ -0,0 +1,70 @@
+#include "screenshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "gray4.h"
+
+namespace usb_video {
+
+const uint8_t kScreenshotGamma[16] = {0,   147, 169, 184, 195, 204, 211, 218,
+                                      224, 229, 234, 239, 243, 247, 251, 255};
+
+void RenderScreenshot(const uint8_t* levels, size_t count, int width, int height,
+                      int border, uint8_t* rgba) {
+  const size_t out_width = static_cast<size_t>(width) + 2 * border;
+  const size_t out_height = static_cast<size_t>(height) + 2 * border;
+  // The border, and anything the levels do not cover, is opaque black.
+  static const uint8_t kBlack[4] = {0, 0, 0, 255};
+  for (size_t i = 0; i < out_width * out_height; ++i) {
+    memcpy(rgba + i * 4, kBlack, 4);
+  }
+
+  // Each level's pixel, looked up once rather than per pixel.
+  uint8_t palette[16][4];
+  for (int level = 0; level < 16; ++level) {
+    palette[level][0] = 0;
+    palette[level][1] = kScreenshotGamma[level];
+    palette[level][2] = kScreenshotGamma[level];
+    palette[level][3] = 255;
+  }
+  count = std::min(count, static_cast<size_t>(width) * height);
+  for (size_t y = 0; y * width < count; ++y) {
+    const uint8_t* row = levels + y * width;
+    const size_t row_pixels = std::min(static_cast<size_t>(width), count - y * width);
+    uint8_t* out = rgba + ((y + border) * out_width + border) * 4;
+    for (size_t x = 0; x < row_pixels; ++x, out += 4) {
+      memcpy(out, palette[std::min<uint8_t>(row[x], 15)], 4);
+    }
+  }
+}
+
+void YuyvToScreenshotLevels(const uint8_t* yuyv, int width, int height, uint8_t* levels) {
+  const size_t pixels = static_cast<size_t>(width) * height;
+  for (size_t i = 0; i < pixels; ++i) {
+    levels[i] = QuantizeLumaToGray4(yuyv[i * 2]);
+  }
+}
+
+bool ScreenshotEncoder::EncodeLevels(const uint8_t* levels, size_t count, int width,
+                                     int height) {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  rgba_.resize((static_cast<size_t>(width) + 2 * kScreenshotBorder) *
+               (height + 2 * kScreenshotBorder) * 4);
+  RenderScreenshot(levels, count, width, height, kScreenshotBorder, rgba_.data());
+  return png_.Encode(rgba_.data(), width + 2 * kScreenshotBorder,
+                     height + 2 * kScreenshotBorder, 4);
+}
+
+bool ScreenshotEncoder::EncodeYuyv(const uint8_t* yuyv, int width, int height) {
+  if (width <= 0 || height <= 0) {
+    return false;
+  }
+  levels_.resize(static_cast<size_t>(width) * height);
+  YuyvToScreenshotLevels(yuyv, width, height, levels_.data());
+  return EncodeLevels(levels_.data(), levels_.size(), width, height);
+}
+
+}  // namespace usb_video
@@ -0,0 +1,63 @@
+#ifndef USB_VIDEO_SCREENSHOT_H_
+#define USB_VIDEO_SCREENSHOT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "png_encoder.h"
+
+namespace usb_video {
+
+// Screenshots of the Disting NT display, as the app shows and saves them:
+// each of the display's 16 brightness levels mapped through the module's
+// gamma curve to a teal pixel, inside a black border.
+//
+// The picture comes either from a SysEx screenshot (one level per byte) or
+// from a captured YUYV video frame, whose luma is quantised to the same
+// levels (gray4.h), so both look alike.
+constexpr int kScreenshotBorder = 5;
+
+// The displayed intensity of each level: x ^ 0.45 ^ 0.45 for x = level / 15,
+// scaled to 0..255 and truncated, exactly as the Dart renderer computes it.
+extern const uint8_t kScreenshotGamma[16];
+
+// Writes the bordered RGBA picture of |count| levels (row-major, |width|
+// per row; levels above 15 show as 15) into |rgba|, which must hold
+// (width + 2 * border) * (height + 2 * border) * 4 bytes. Pixels past
+// |count| stay black.
+void RenderScreenshot(const uint8_t* levels, size_t count, int width, int height,
+                      int border, uint8_t* rgba);
+
+// Quantises the luma of |yuyv| into one level per pixel in |levels|, which
+// must hold width * height bytes.
+void YuyvToScreenshotLevels(const uint8_t* yuyv, int width, int height, uint8_t* levels);
+
+// Renders and PNG-encodes screenshots, reusing its buffers.
+class ScreenshotEncoder {
+ public:
+  ScreenshotEncoder() {}
+
+  ScreenshotEncoder(const ScreenshotEncoder&) = delete;
+  ScreenshotEncoder& operator=(const ScreenshotEncoder&) = delete;
+
+  // Encodes |count| levels of a |width| x |height| display. Returns false
+  // for an empty picture.
+  bool EncodeLevels(const uint8_t* levels, size_t count, int width, int height);
+
+  // Encodes a captured frame (width must be even).
+  bool EncodeYuyv(const uint8_t* yuyv, int width, int height);
+
+  // The last PNG. Valid until the next Encode call.
+  const uint8_t* data() const { return png_.data(); }
+  size_t size() const { return png_.size(); }
+
+ private:
+  std::vector<uint8_t> levels_;
+  std::vector<uint8_t> rgba_;
+  PngEncoder png_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_SCREENSHOT_H_
@@ -0,0 +1,50 @@
+#include "screenshot_ffi.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "screenshot.h"
+
+namespace {
+
+// Dart calls in from whichever thread runs its isolate; one encoder each
+// keeps the buffers warm without sharing them.
+usb_video::ScreenshotEncoder& thread_encoder() {
+  static thread_local usb_video::ScreenshotEncoder encoder;
+  return encoder;
+}
+
+int64_t CopyOut(const usb_video::ScreenshotEncoder& encoder, uint8_t** png) {
+  uint8_t* out = static_cast<uint8_t*>(malloc(encoder.size()));
+  if (out == nullptr) {
+    return 0;
+  }
+  memcpy(out, encoder.data(), encoder.size());
+  *png = out;
+  return static_cast<int64_t>(encoder.size());
+}
+
+}  // namespace
+
+int64_t nt_screenshot_encode_levels(const uint8_t* levels, int64_t length, int32_t width,
+                                    int32_t height, uint8_t** png) {
+  usb_video::ScreenshotEncoder& encoder = thread_encoder();
+  if (levels == nullptr || length < 0 || png == nullptr ||
+      !encoder.EncodeLevels(levels, static_cast<size_t>(length), width, height)) {
+    return 0;
+  }
+  return CopyOut(encoder, png);
+}
+
+int64_t nt_screenshot_encode_yuyv(const uint8_t* yuyv, int64_t length, int32_t width,
+                                  int32_t height, uint8_t** png) {
+  usb_video::ScreenshotEncoder& encoder = thread_encoder();
+  if (yuyv == nullptr || png == nullptr || width <= 0 || height <= 0 || width % 2 != 0 ||
+      length < static_cast<int64_t>(width) * height * 2 ||
+      !encoder.EncodeYuyv(yuyv, width, height)) {
+    return 0;
+  }
+  return CopyOut(encoder, png);
+}
+
+void nt_screenshot_free(uint8_t* png) { free(png); }
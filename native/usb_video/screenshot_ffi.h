@@ -0,0 +1,45 @@
+#ifndef USB_VIDEO_SCREENSHOT_FFI_H_
+#define USB_VIDEO_SCREENSHOT_FFI_H_
+
+/*
+ * C entry points of libnt_screenshot, the shared library the app loads over
+ * dart:ffi (lib/services/platform_channels/native_screenshot.dart) to render
+ * and encode screenshots natively; see screenshot.h.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define NT_SCREENSHOT_EXPORT __declspec(dllexport)
+#else
+#define NT_SCREENSHOT_EXPORT __attribute__((visibility("default")))
+#endif
+
+/* Renders |length| display levels (one per byte, row-major, |width| x
+ * |height|) with the standard border and encodes the result as PNG. On
+ * success stores a buffer in |*png| for nt_screenshot_free() and returns
+ * its size; returns 0 on failure. */
+NT_SCREENSHOT_EXPORT int64_t nt_screenshot_encode_levels(const uint8_t* levels,
+                                                         int64_t length,
+                                                         int32_t width,
+                                                         int32_t height,
+                                                         uint8_t** png);
+
+/* The same for a raw YUYV frame of |width| x |height| pixels. */
+NT_SCREENSHOT_EXPORT int64_t nt_screenshot_encode_yuyv(const uint8_t* yuyv,
+                                                       int64_t length,
+                                                       int32_t width,
+                                                       int32_t height,
+                                                       uint8_t** png);
+
+NT_SCREENSHOT_EXPORT void nt_screenshot_free(uint8_t* png);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif /* USB_VIDEO_SCREENSHOT_FFI_H_ */
@@ -0,0 +1,90 @@
+#ifndef USB_VIDEO_SHARED_FRAME_FORMAT_H_
+#define USB_VIDEO_SHARED_FRAME_FORMAT_H_
+
+/*
+ * Shared-memory frame export: the layout of the POSIX shared-memory object
+ * (shm_open(), so /dev/shm/<name> on Linux) the capture session publishes
+ * raw frames into for other processes. Plain C, so readers need nothing
+ * but this header; see tools/shared_frame_reader.h for one.
+ *
+ * Integers are in host byte order (the reader is on the same machine).
+ *
+ *   offset 0                    struct ntv_shm_header
+ *          header_size          slot 0: struct ntv_shm_slot, then frame data
+ *          header_size + k * slot_stride
+ *                               slot k
+ *
+ * Frames are numbered from 1. Frame n goes into slot (n - 1) % slot_count,
+ * and header.latest is the number of the newest complete frame (0 until
+ * the first). The writer never waits for readers: it overwrites the oldest
+ * slot whether or not anyone is still looking at it.
+ *
+ * Each slot is guarded by a sequence lock. The writer makes slot.seq odd,
+ * fills in the slot, then makes it even again, before advancing latest. A
+ * reader:
+ *
+ *   n  = latest                               (acquire)
+ *   s1 = slot.seq                             (acquire; odd: try again)
+ *   use slot.frame_number, the metadata and data in place
+ *   s2 = slot.seq                             (after an acquire fence)
+ *
+ * and may trust what it used only if s1 == s2 and slot.frame_number == n.
+ * Otherwise the writer got there first; the reader drops what it read and
+ * starts again from latest. With slot_count slots a reader has about
+ * slot_count - 1 frame periods to finish with a frame in place.
+ *
+ * When the writer stops it sets header.closed and unlinks the name; a
+ * writer that starts again creates a new object under the same name, so
+ * readers reopen once they see closed. A writer that crashed never sets
+ * closed: readers that care can check writer_pid.
+ */
+
+#include <stdint.h>
+
+#define NTV_SHM_MAGIC "NTVSHM\0\0"
+#define NTV_SHM_VERSION 1u
+
+/* The object name used when the caller does not pick one. */
+#define NTV_SHM_DEFAULT_NAME "/nt_helper_video"
+
+/* V4L2_PIX_FMT_YUYV: 4:2:2, Y0 U Y1 V, two bytes a pixel. */
+#define NTV_SHM_FOURCC_YUYV 0x56595559u
+
+/* Slots and frame data start on cache-line boundaries. */
+#define NTV_SHM_ALIGNMENT 64u
+
+struct ntv_shm_header {
+  char magic[8];           /* NTV_SHM_MAGIC */
+  uint32_t version;        /* NTV_SHM_VERSION */
+  uint32_t header_size;    /* offset of slot 0 */
+  uint32_t slot_count;
+  uint32_t slot_stride;    /* bytes from one slot to the next */
+  uint32_t width;
+  uint32_t height;
+  uint32_t fourcc;         /* NTV_SHM_FOURCC_YUYV */
+  uint32_t frame_size;     /* most data bytes a slot holds */
+  uint32_t writer_pid;
+  uint32_t closed;         /* nonzero once the writer has stopped */
+  uint64_t latest;         /* newest complete frame number, 0 for none */
+  uint8_t reserved[72];
+};
+
+struct ntv_shm_slot {
+  uint64_t seq;            /* sequence lock; odd while being written */
+  uint64_t frame_number;
+  int64_t timestamp_us;    /* CLOCK_MONOTONIC capture time */
+  uint32_t sequence;       /* driver sequence number */
+  uint32_t size;           /* data bytes in this frame */
+  uint8_t reserved[32];
+  /* size bytes of frame data follow. */
+};
+
+#ifdef __cplusplus
+static_assert(sizeof(struct ntv_shm_header) == 128, "ntv_shm_header layout");
+static_assert(sizeof(struct ntv_shm_slot) == NTV_SHM_ALIGNMENT, "ntv_shm_slot layout");
+#else
+_Static_assert(sizeof(struct ntv_shm_header) == 128, "ntv_shm_header layout");
+_Static_assert(sizeof(struct ntv_shm_slot) == NTV_SHM_ALIGNMENT, "ntv_shm_slot layout");
+#endif
+
+#endif /* USB_VIDEO_SHARED_FRAME_FORMAT_H_ */
@@ -0,0 +1,150 @@
+#include "shared_frame_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace usb_video {
+
+namespace {
+
+size_t AlignUp(size_t size) {
+  return (size + NTV_SHM_ALIGNMENT - 1) & ~static_cast<size_t>(NTV_SHM_ALIGNMENT - 1);
+}
+
+}  // namespace
+
+constexpr uint32_t SharedFrameRing::kDefaultSlots;
+
+SharedFrameRing::SharedFrameRing()
+    : header_(nullptr),
+      slots_(nullptr),
+      mapped_size_(0),
+      frame_size_(0),
+      slot_stride_(0),
+      slot_count_(0),
+      frames_published_(0) {}
+
+SharedFrameRing::~SharedFrameRing() { Close(); }
+
+bool SharedFrameRing::Fail(const char* what) {
+  error_ = std::string(what) + ": " + std::strerror(errno);
+  return false;
+}
+
+bool SharedFrameRing::Create(const std::string& name, int width, int height,
+                             uint32_t slots) {
+  Close();
+  error_.clear();
+  if (name.size() < 2 || name[0] != '/' || name.find('/', 1) != std::string::npos) {
+    error_ = "bad shared memory name: " + name;
+    return false;
+  }
+  // One slot for the writer to fill while readers finish with another.
+  if (width <= 0 || height <= 0 || slots < 2) {
+    error_ = "bad ring geometry";
+    return false;
+  }
+
+  const size_t frame_size = static_cast<size_t>(width) * height * 2;
+  const size_t header_size = AlignUp(sizeof(ntv_shm_header));
+  const size_t slot_stride = AlignUp(sizeof(ntv_shm_slot) + frame_size);
+  const size_t mapped_size = header_size + slot_stride * slots;
+
+  // Start from a fresh object: readers still mapping one left by an
+  // earlier writer keep it until they notice it closed.
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+  if (fd == -1) {
+    return Fail("shm_open");
+  }
+  if (ftruncate(fd, static_cast<off_t>(mapped_size)) == -1) {
+    Fail("ftruncate");
+    close(fd);
+    shm_unlink(name.c_str());
+    return false;
+  }
+  void* mapping = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    Fail("mmap");
+    shm_unlink(name.c_str());
+    return false;
+  }
+  // Writing every page now means Publish() never takes a page fault.
+  memset(mapping, 0, mapped_size);
+
+  header_ = static_cast<ntv_shm_header*>(mapping);
+  slots_ = static_cast<uint8_t*>(mapping) + header_size;
+  name_ = name;
+  mapped_size_ = mapped_size;
+  frame_size_ = frame_size;
+  slot_stride_ = slot_stride;
+  slot_count_ = slots;
+  frames_published_ = 0;
+
+  memcpy(header_->magic, NTV_SHM_MAGIC, sizeof(header_->magic));
+  header_->version = NTV_SHM_VERSION;
+  header_->header_size = static_cast<uint32_t>(header_size);
+  header_->slot_count = slots;
+  header_->slot_stride = static_cast<uint32_t>(slot_stride);
+  header_->width = static_cast<uint32_t>(width);
+  header_->height = static_cast<uint32_t>(height);
+  header_->fourcc = NTV_SHM_FOURCC_YUYV;
+  header_->frame_size = static_cast<uint32_t>(frame_size);
+  header_->writer_pid = static_cast<uint32_t>(getpid());
+  // Readers check latest first; publish the header along with it.
+  __atomic_store_n(&header_->latest, 0, __ATOMIC_RELEASE);
+  return true;
+}
+
+ntv_shm_slot* SharedFrameRing::slot(uint64_t frame_number) const {
+  return reinterpret_cast<ntv_shm_slot*>(
+      slots_ + ((frame_number - 1) % slot_count_) * slot_stride_);
+}
+
+// The fields readers race on are plain integers in a C struct, so this
+// uses the GCC atomic builtins on them rather than std::atomic.
+void SharedFrameRing::Publish(const uint8_t* data, size_t size,
+                              int64_t timestamp_us, uint32_t sequence) {
+  if (header_ == nullptr) {
+    return;
+  }
+  const uint64_t frame_number = frames_published_.load(std::memory_order_relaxed) + 1;
+  ntv_shm_slot* target = slot(frame_number);
+  const uint64_t seq = target->seq;  // Only this thread writes it.
+  size = std::min(size, frame_size_);
+
+  // Odd: readers that got here first will see the change and retry.
+  __atomic_store_n(&target->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  target->frame_number = frame_number;
+  target->timestamp_us = timestamp_us;
+  target->sequence = sequence;
+  target->size = static_cast<uint32_t>(size);
+  memcpy(reinterpret_cast<uint8_t*>(target + 1), data, size);
+  __atomic_store_n(&target->seq, seq + 2, __ATOMIC_RELEASE);
+
+  __atomic_store_n(&header_->latest, frame_number, __ATOMIC_RELEASE);
+  frames_published_.store(frame_number, std::memory_order_relaxed);
+}
+
+void SharedFrameRing::Close() {
+  if (header_ == nullptr) {
+    return;
+  }
+  __atomic_store_n(&header_->closed, 1, __ATOMIC_RELEASE);
+  munmap(header_, mapped_size_);
+  shm_unlink(name_.c_str());
+  header_ = nullptr;
+  slots_ = nullptr;
+  mapped_size_ = 0;
+}
+
+}  // namespace usb_video
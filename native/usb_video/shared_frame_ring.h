@@ -0,0 +1,75 @@
+#ifndef USB_VIDEO_SHARED_FRAME_RING_H_
+#define USB_VIDEO_SHARED_FRAME_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "shared_frame_format.h"
+
+namespace usb_video {
+
+// Publishes raw frames into a POSIX shared-memory ring other processes can
+// map and read in place (shared_frame_format.h).
+//
+// Create() does everything that can block or fail: it creates and sizes the
+// object, maps it and touches every page. Publish() is then a memcpy into
+// memory that is already resident plus a few atomic stores, with no locks
+// and no system calls, so the capture thread can call it for every frame.
+// Readers never hold the writer up; they detect overwritten frames
+// themselves.
+class SharedFrameRing {
+ public:
+  static constexpr uint32_t kDefaultSlots = 4;
+
+  SharedFrameRing();
+  ~SharedFrameRing();
+
+  SharedFrameRing(const SharedFrameRing&) = delete;
+  SharedFrameRing& operator=(const SharedFrameRing&) = delete;
+
+  // Creates the object |name| (a shm_open() name, "/" and no other
+  // slashes) for |width| x |height| YUYV frames, replacing any left behind
+  // under that name. Returns false, with error() set, on failure.
+  bool Create(const std::string& name, int width, int height,
+              uint32_t slots = kDefaultSlots);
+
+  // Producer side; one thread only. Copies |size| bytes of |data| (cut
+  // to frame_size()) into the next slot and makes it the newest frame.
+  void Publish(const uint8_t* data, size_t size, int64_t timestamp_us,
+               uint32_t sequence);
+
+  // Marks the ring closed for readers, unmaps it and unlinks the name.
+  void Close();
+
+  bool is_open() const { return header_ != nullptr; }
+  const std::string& name() const { return name_; }
+  const std::string& error() const { return error_; }
+  uint32_t slot_count() const { return slot_count_; }
+  size_t frame_size() const { return frame_size_; }
+  size_t mapped_size() const { return mapped_size_; }
+
+  // Frames published since Create(); may be read from any thread.
+  uint64_t frames_published() const {
+    return frames_published_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  bool Fail(const char* what);
+  ntv_shm_slot* slot(uint64_t frame_number) const;
+
+  std::string name_;
+  std::string error_;
+  ntv_shm_header* header_;
+  uint8_t* slots_;
+  size_t mapped_size_;
+  size_t frame_size_;
+  size_t slot_stride_;
+  uint32_t slot_count_;
+  std::atomic<uint64_t> frames_published_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_SHARED_FRAME_RING_H_
@@ -0,0 +1,344 @@
+#include "synthetic_capture_backend.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "gray4.h"
+
+namespace usb_video {
+
+constexpr uint64_t SyntheticCaptureBackend::kQueuedFrames;
+
+namespace {
+
+// Studio-range luma for a gray4 level, the inverse of QuantizeLumaToGray4.
+uint8_t Gray4LevelToLuma(int level) {
+  return static_cast<uint8_t>(16 + (level * 219 + 7) / 15);
+}
+
+bool ParseDouble(const std::string& text, double* value) {
+  char* end = nullptr;
+  *value = std::strtod(text.c_str(), &end);
+  return !text.empty() && *end == '\0';
+}
+
+bool ParseInt(const std::string& text, int64_t* value) {
+  char* end = nullptr;
+  *value = std::strtoll(text.c_str(), &end, 10);
+  return !text.empty() && *end == '\0';
+}
+
+}  // namespace
+
+SyntheticCaptureBackend::Options::Options()
+    : fps(60.0), jitter_us(0), pattern(kMovingBar), bar_hold_frames(4), seed(1) {}
+
+bool SyntheticCaptureBackend::ParseOptions(const std::string& spec,
+                                           Options* options) {
+  size_t begin = 0;
+  while (begin < spec.size()) {
+    size_t end = spec.find(',', begin);
+    if (end == std::string::npos) {
+      end = spec.size();
+    }
+    const std::string item = spec.substr(begin, end - begin);
+    begin = end + 1;
+    if (item.empty()) {
+      continue;
+    }
+    const size_t equals = item.find('=');
+    if (equals == std::string::npos) {
+      return false;
+    }
+    const std::string key = item.substr(0, equals);
+    const std::string value = item.substr(equals + 1);
+    int64_t number = 0;
+    if (key == "fps") {
+      if (!ParseDouble(value, &options->fps)) {
+        return false;
+      }
+    } else if (key == "jitter") {
+      if (!ParseInt(value, &number) || number < 0) {
+        return false;
+      }
+      options->jitter_us = number;
+    } else if (key == "pattern") {
+      if (value == "bar") {
+        options->pattern = kMovingBar;
+      } else if (value == "static") {
+        options->pattern = kStatic;
+      } else if (value == "noise") {
+        options->pattern = kNoise;
+      } else {
+        return false;
+      }
+    } else if (key == "hold") {
+      if (!ParseInt(value, &number) || number < 1 || number > 1000000) {
+        return false;
+      }
+      options->bar_hold_frames = static_cast<int>(number);
+    } else if (key == "replay") {
+      if (value.empty()) {
+        return false;
+      }
+      options->replay_path = value;
+    } else if (key == "seed") {
+      if (!ParseInt(value, &number) || number < 0 || number > 0xFFFFFFFF) {
+        return false;
+      }
+      options->seed = static_cast<uint32_t>(number);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+SyntheticCaptureBackend::SyntheticCaptureBackend(const Options& options)
+    : options_(options),
+      rng_(options.seed),
+      noise_state_(options.seed | 1),
+      start_sequence_(0),
+      period_(0),
+      next_sequence_(0),
+      frames_dropped_(0),
+      started_(false),
+      woken_(false) {}
+
+SyntheticCaptureBackend::~SyntheticCaptureBackend() { Stop(); }
+
+bool SyntheticCaptureBackend::Start(int width, int height) {
+  Stop();
+  error_.clear();
+  if (!options_.replay_path.empty()) {
+    reader_.reset(new RecordingReader());
+    if (!reader_->Open(options_.replay_path) || reader_->frame_count() == 0) {
+      error_ = "cannot replay " + options_.replay_path;
+      reader_.reset();
+      return false;
+    }
+    width = reader_->header().width;
+    height = reader_->header().height;
+    replay_.assign(reader_->header().frame_size, 0);
+  }
+  if (width <= 0 || height <= 0 || width % 2 != 0) {
+    error_ = "unsupported frame size";
+    reader_.reset();
+    return false;
+  }
+  width_ = width;
+  height_ = height;
+
+  // A dim block pattern for the bar to move over, so the picture has some
+  // structure for the delta coder without changing on its own.
+  background_.resize(frame_size());
+  for (int y = 0; y < height_; ++y) {
+    uint8_t* row = background_.data() + static_cast<size_t>(y) * width_ * 2;
+    for (int x = 0; x < width_; ++x) {
+      row[x * 2] = Gray4LevelToLuma(((x / 16 + y / 8) % 4) * 2);
+      row[x * 2 + 1] = 128;
+    }
+  }
+  frame_ = background_;
+
+  rng_.seed(options_.seed);
+  noise_state_ = options_.seed | 1;
+  period_ = Clock::duration(0);
+  frame_intervals_.clear();
+  frame_interval_ = FrameInterval();
+  if (options_.fps > 0) {
+    period_ = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / options_.fps));
+    // In millihertz, so fractional rates survive.
+    const uint32_t rate = static_cast<uint32_t>(options_.fps * 1000 + 0.5);
+    for (uint32_t divisor : {1u, 2u, 4u, 8u}) {
+      frame_intervals_.push_back(FrameInterval{1000 * divisor, rate});
+    }
+    frame_interval_ = frame_intervals_.front();
+  }
+  start_time_ = Clock::now();
+  start_sequence_ = 0;
+  next_sequence_ = 0;
+  frames_dropped_ = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    woken_ = false;
+  }
+  started_ = true;
+  return true;
+}
+
+CaptureBackend::Result SyntheticCaptureBackend::Next(CapturedFrame* frame) {
+  if (!started_) {
+    error_ = "not started";
+    return kError;
+  }
+  Clock::time_point captured;
+  uint64_t sequence;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (paused_) {
+      wake_.wait(lock, [this] { return woken_; });
+      woken_ = false;
+      return kWoken;
+    }
+    if (period_.count() > 0) {
+      const Clock::time_point now = Clock::now();
+      const uint64_t current =
+          start_sequence_ +
+          (now > start_time_ ? static_cast<uint64_t>((now - start_time_) / period_) : 0);
+      if (current > next_sequence_ + kQueuedFrames) {
+        frames_dropped_ += current - kQueuedFrames - next_sequence_;
+        next_sequence_ = current - kQueuedFrames;
+      }
+      captured =
+          start_time_ + period_ * static_cast<int64_t>(next_sequence_ - start_sequence_);
+      if (options_.jitter_us > 0) {
+        std::uniform_int_distribution<int64_t> jitter(-options_.jitter_us,
+                                                      options_.jitter_us);
+        captured += std::chrono::microseconds(jitter(rng_));
+      }
+      if (wake_.wait_until(lock, captured, [this] { return woken_; })) {
+        woken_ = false;
+        return kWoken;
+      }
+    } else {
+      if (woken_) {
+        woken_ = false;
+        return kWoken;
+      }
+      captured = Clock::now();
+    }
+    sequence = next_sequence_++;
+  }
+
+  if (!Render(sequence)) {
+    error_ = "cannot decode " + options_.replay_path;
+    return kError;
+  }
+  frame->data = frame_.data();
+  frame->size = frame_.size();
+  // steady_clock is CLOCK_MONOTONIC, the clock V4L2 stamps frames with.
+  frame->timestamp_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(captured.time_since_epoch())
+          .count();
+  frame->sequence = static_cast<uint32_t>(sequence);
+  frame->buffer_index = 0;
+  return kFrame;
+}
+
+bool SyntheticCaptureBackend::Release(const CapturedFrame& frame) {
+  // One buffer, rewritten by the next Next().
+  return true;
+}
+
+bool SyntheticCaptureBackend::SetFrameInterval(const FrameInterval& interval) {
+  if (!started_ || period_.count() <= 0 || interval.fps() <= 0) {
+    error_ = "frame rate is not adjustable";
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  // The new schedule starts now, as a camera's does after S_PARM.
+  period_ = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(1.0 / interval.fps()));
+  start_time_ = Clock::now();
+  start_sequence_ = next_sequence_;
+  frame_interval_ = interval;
+  return true;
+}
+
+bool SyntheticCaptureBackend::Pause() {
+  if (!started_) {
+    error_ = "not started";
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  paused_ = true;
+  return true;
+}
+
+bool SyntheticCaptureBackend::Resume() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (paused_) {
+    // Nothing was due while paused, so nothing counts as dropped.
+    start_time_ = Clock::now();
+    start_sequence_ = next_sequence_;
+    paused_ = false;
+  }
+  return true;
+}
+
+void SyntheticCaptureBackend::Wake() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  woken_ = true;
+  wake_.notify_all();
+}
+
+void SyntheticCaptureBackend::Stop() {
+  started_ = false;
+  paused_ = false;
+  frame_intervals_.clear();
+  reader_.reset();
+}
+
+bool SyntheticCaptureBackend::Render(uint64_t sequence) {
+  if (reader_ == nullptr) {
+    RenderPattern(sequence);
+    return true;
+  }
+
+  const RecordingHeader& header = reader_->header();
+  const size_t index = static_cast<size_t>(sequence % reader_->frame_count());
+  if (header.pixel_format == kRecordingYuyv) {
+    return reader_->ReadFrame(index, frame_.data());
+  }
+  if (!reader_->ReadFrame(index, replay_.data())) {
+    return false;
+  }
+  // Expand gray4 back to YUYV, with neutral chroma.
+  const size_t row_bytes = Gray4RowBytes(width_);
+  for (int y = 0; y < height_; ++y) {
+    const uint8_t* in = replay_.data() + kGray4HeaderSize + y * row_bytes;
+    uint8_t* out = frame_.data() + static_cast<size_t>(y) * width_ * 2;
+    for (int x = 0; x < width_; ++x) {
+      const int level = (x % 2 == 0) ? in[x / 2] >> 4 : in[x / 2] & 0x0F;
+      out[x * 2] = Gray4LevelToLuma(level);
+      out[x * 2 + 1] = 128;
+    }
+  }
+  return true;
+}
+
+void SyntheticCaptureBackend::RenderPattern(uint64_t sequence) {
+  switch (options_.pattern) {
+    case kStatic:
+      // frame_ has held the background since Start().
+      break;
+    case kMovingBar: {
+      std::memcpy(frame_.data(), background_.data(), frame_.size());
+      const size_t x = static_cast<size_t>(
+          (sequence / options_.bar_hold_frames) % (width_ / 2)) * 2;
+      for (int y = 0; y < height_; ++y) {
+        uint8_t* pair = frame_.data() + (static_cast<size_t>(y) * width_ + x) * 2;
+        pair[0] = 235;
+        pair[2] = 235;
+      }
+      break;
+    }
+    case kNoise: {
+      // xorshift32: cheap enough not to dominate a benchmark.
+      uint32_t state = noise_state_;
+      size_t i = 0;
+      for (; i + 4 <= frame_.size(); i += 4) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        std::memcpy(frame_.data() + i, &state, 4);
+      }
+      noise_state_ = state;
+      break;
+    }
+  }
+}
+
+}  // namespace usb_video
@@ -0,0 +1,119 @@
+#ifndef USB_VIDEO_SYNTHETIC_CAPTURE_BACKEND_H_
+#define USB_VIDEO_SYNTHETIC_CAPTURE_BACKEND_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "capture_backend.h"
+#include "recording_reader.h"
+
+namespace usb_video {
+
+// A capture source with no hardware behind it, for benchmarks, tests and
+// working on the pipeline without a Disting NT plugged in.
+//
+// Frames are either generated from a pattern or looped from a recording
+// (recording_format.h), and paced like a camera: frame n is due at
+// n / fps seconds, give or take a random jitter, and carries that time as
+// its capture timestamp. Like a camera it also offers a few slower rates,
+// fps divided by 2, 4 and 8. A consumer that falls behind by more than a
+// driver's worth of queued buffers loses frames, which shows up as a gap in
+// the sequence numbers just as it does from V4L2.
+class SyntheticCaptureBackend : public CaptureBackend {
+ public:
+  enum Pattern {
+    // A bar stepping across a static background, like a mostly idle
+    // display: each frame differs from the last in a few columns, if at all.
+    kMovingBar,
+    // The same picture every frame, so everything after the first is
+    // suppressed.
+    kStatic,
+    // Fresh noise every frame, so nothing is suppressed and deltas and
+    // compression gain nothing.
+    kNoise,
+  };
+
+  struct Options {
+    Options();
+
+    // Frames per second; zero or less hands out frames as fast as Next() is
+    // called, stamped with the time they were made.
+    double fps;
+    // Each frame is due up to this much early or late, uniformly.
+    int64_t jitter_us;
+    Pattern pattern;
+    // Frames the moving bar holds still before each step.
+    int bar_hold_frames;
+    // A recording to loop instead of a pattern. Its frame size overrides
+    // the one passed to Start().
+    std::string replay_path;
+    uint32_t seed;
+  };
+
+  // Frames a late consumer can fall behind before they are dropped, as
+  // with a V4L2 driver queueing into four buffers with one on loan.
+  static constexpr uint64_t kQueuedFrames = 3;
+
+  // Parses a comma-separated list of key=value pairs into |options|, on top
+  // of whatever it already holds: fps, jitter (microseconds),
+  // pattern (bar, static or noise), hold, replay (a path) and seed. Returns
+  // false on an unknown key or a malformed value, e.g. in
+  // "synthetic:fps=30,jitter=2000" everything after the colon.
+  static bool ParseOptions(const std::string& spec, Options* options);
+
+  explicit SyntheticCaptureBackend(const Options& options);
+  ~SyntheticCaptureBackend() override;
+
+  bool Start(int width, int height) override;
+  Result Next(CapturedFrame* frame) override;
+  bool Release(const CapturedFrame& frame) override;
+  bool SetFrameInterval(const FrameInterval& interval) override;
+  bool Pause() override;
+  bool Resume() override;
+  void Wake() override;
+  void Stop() override;
+  const char* name() const override { return "synthetic"; }
+
+  const Options& options() const { return options_; }
+
+  // Frames skipped because the consumer was too slow to take them.
+  uint64_t frames_dropped() const { return frames_dropped_; }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  // Fills frame_ with frame |sequence|.
+  bool Render(uint64_t sequence);
+  void RenderPattern(uint64_t sequence);
+
+  Options options_;
+  std::unique_ptr<RecordingReader> reader_;
+  std::vector<uint8_t> frame_;
+  std::vector<uint8_t> background_;
+  std::vector<uint8_t> replay_;
+  std::mt19937 rng_;
+  uint32_t noise_state_;
+
+  // Frame n is due at start_time_ + (n - start_sequence_) * period_.
+  Clock::time_point start_time_;
+  uint64_t start_sequence_;
+  Clock::duration period_;
+  uint64_t next_sequence_;
+  uint64_t frames_dropped_;
+  bool started_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool woken_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_SYNTHETIC_CAPTURE_BACKEND_H_
@@ -0,0 +1,52 @@
+#include "bmp_encoder.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace usb_video {
+namespace {
+
+uint32_t ReadLe32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+TEST(BmpEncoderTest, DistingFrameSize) {
+  EXPECT_EQ(BmpFileSize(256, 64), 54u + 256u * 3u * 64u);
+}
+
+TEST(BmpEncoderTest, RowsArePaddedToFourBytes) {
+  EXPECT_EQ(BmpFileSize(3, 2), 54u + 12u * 2u);
+  EXPECT_EQ(BmpFileSize(1, 1), 54u + 4u);
+}
+
+TEST(BmpEncoderTest, WritesTopDownBgrWithHeader) {
+  // 3x2 image: row 0 red, green, blue; row 1 white, black, grey.
+  const std::vector<uint8_t> rgb = {
+      255, 0, 0,   0, 255, 0,  0, 0, 255,
+      255, 255, 255, 0, 0, 0, 128, 128, 128,
+  };
+  std::vector<uint8_t> bmp(BmpFileSize(3, 2), 0xEE);
+  ASSERT_EQ(EncodeBmp24(rgb.data(), 3, 2, bmp.data()), bmp.size());
+
+  EXPECT_EQ(bmp[0], 'B');
+  EXPECT_EQ(bmp[1], 'M');
+  EXPECT_EQ(ReadLe32(&bmp[2]), bmp.size());
+  EXPECT_EQ(ReadLe32(&bmp[10]), 54u);
+  EXPECT_EQ(ReadLe32(&bmp[14]), 40u);
+  EXPECT_EQ(static_cast<int32_t>(ReadLe32(&bmp[18])), 3);
+  EXPECT_EQ(static_cast<int32_t>(ReadLe32(&bmp[22])), -2);
+  EXPECT_EQ(bmp[26], 1);
+  EXPECT_EQ(bmp[28], 24);
+  for (int i = 30; i < 54; ++i) EXPECT_EQ(bmp[i], 0) << i;
+
+  const std::vector<uint8_t> pixels(bmp.begin() + 54, bmp.end());
+  const std::vector<uint8_t> expected = {
+      0, 0, 255,   0, 255, 0,  255, 0, 0,       0, 0, 0,
+      255, 255, 255, 0, 0, 0, 128, 128, 128,   0, 0, 0,
+  };
+  EXPECT_EQ(pixels, expected);
+}
+
+}  // namespace
+}  // namespace usb_video
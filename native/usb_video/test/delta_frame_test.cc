@@ -0,0 +1,180 @@
+#include "delta_frame.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "bmp_encoder.h"
+#include "gray4.h"
+
+namespace usb_video {
+namespace {
+
+const int kWidth = 256;
+const int kHeight = 64;
+const size_t kStride = kWidth * 3;
+
+uint32_t ReadLe16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+
+// Reference receiver: applies a keyframe or delta to |canvas| the way the
+// Dart compositor does.
+void Apply(const DeltaFrameEncoder::Output& frame, std::vector<uint8_t>* canvas) {
+  if (frame.keyframe) {
+    canvas->assign(frame.data, frame.data + frame.size);
+    return;
+  }
+  ASSERT_EQ(frame.data[0], 'N');
+  ASSERT_EQ(frame.data[1], 'D');
+  ASSERT_EQ(frame.data[2], kDeltaFrameVersion);
+  ASSERT_EQ(ReadLe16(frame.data + 4), static_cast<uint32_t>(kWidth));
+  ASSERT_EQ(ReadLe16(frame.data + 6), static_cast<uint32_t>(kHeight));
+  const uint32_t spans = ReadLe16(frame.data + 8);
+  const uint8_t* p = frame.data + kDeltaFrameHeaderSize;
+  for (uint32_t i = 0; i < spans; ++i) {
+    const uint32_t first = ReadLe16(p);
+    const uint32_t count = ReadLe16(p + 2);
+    p += kDeltaSpanHeaderSize;
+    std::copy(p, p + count * kStride, canvas->begin() + 54 + first * kStride);
+    p += count * kStride;
+  }
+  ASSERT_EQ(static_cast<size_t>(p - frame.data), frame.size);
+}
+
+class DeltaFrameTest : public ::testing::Test {
+ protected:
+  DeltaFrameTest()
+      : rgb_(kWidth * kHeight * 3, 0),
+        bmp_(BmpFileSize(kWidth, kHeight)),
+        scratch_(MaxDeltaFrameSize(BmpFrameLayout(kWidth, kHeight))) {}
+
+  DeltaFrameEncoder::Output EncodeCurrent() {
+    EncodeBmp24(rgb_.data(), kWidth, kHeight, bmp_.data());
+    return encoder_.Encode(bmp_.data(), scratch_.data());
+  }
+
+  void PaintRow(int y, uint8_t value) {
+    std::fill(rgb_.begin() + y * kWidth * 3, rgb_.begin() + (y + 1) * kWidth * 3,
+              value);
+  }
+
+  std::vector<uint8_t> rgb_;
+  std::vector<uint8_t> bmp_;
+  std::vector<uint8_t> scratch_;
+  DeltaFrameEncoder encoder_;
+};
+
+TEST_F(DeltaFrameTest, FirstFrameIsTheBmpItself) {
+  encoder_.Reset(BmpFrameLayout(kWidth, kHeight), 60);
+  DeltaFrameEncoder::Output out = EncodeCurrent();
+  EXPECT_TRUE(out.keyframe);
+  EXPECT_EQ(out.data, bmp_.data());
+  EXPECT_EQ(out.size, bmp_.size());
+}
+
+TEST_F(DeltaFrameTest, UnchangedFrameIsAnEmptyDelta) {
+  encoder_.Reset(BmpFrameLayout(kWidth, kHeight), 60);
+  EncodeCurrent();
+  DeltaFrameEncoder::Output out = EncodeCurrent();
+  EXPECT_FALSE(out.keyframe);
+  EXPECT_EQ(out.size, kDeltaFrameHeaderSize);
+  EXPECT_EQ(ReadLe16(out.data + 8), 0u);
+}
+
+TEST_F(DeltaFrameTest, ChangedRowsBecomeSpans) {
+  encoder_.Reset(BmpFrameLayout(kWidth, kHeight), 60);
+  EncodeCurrent();
+  // A parameter edit: two separate text lines change.
+  for (int y = 10; y < 18; ++y) PaintRow(y, 0xFF);
+  for (int y = 40; y < 44; ++y) PaintRow(y, 0x80);
+
+  DeltaFrameEncoder::Output out = EncodeCurrent();
+  ASSERT_FALSE(out.keyframe);
+  EXPECT_EQ(ReadLe16(out.data + 8), 2u);
+  EXPECT_EQ(out.size, kDeltaFrameHeaderSize + 2 * kDeltaSpanHeaderSize +
+                          12 * kStride);
+  EXPECT_LT(out.size * 5, bmp_.size());
+}
+
+TEST_F(DeltaFrameTest, KeyframeEveryInterval) {
+  encoder_.Reset(BmpFrameLayout(kWidth, kHeight), 4);
+  std::vector<bool> keyframes;
+  for (int i = 0; i < 9; ++i) keyframes.push_back(EncodeCurrent().keyframe);
+  EXPECT_EQ(keyframes, std::vector<bool>({true, false, false, false, true,
+                                          false, false, false, true}));
+}
+
+TEST_F(DeltaFrameTest, ForceKeyframe) {
+  encoder_.Reset(BmpFrameLayout(kWidth, kHeight), 100);
+  EncodeCurrent();
+  EXPECT_FALSE(EncodeCurrent().keyframe);
+  encoder_.ForceKeyframe();
+  EXPECT_TRUE(EncodeCurrent().keyframe);
+  EXPECT_FALSE(EncodeCurrent().keyframe);
+}
+
+TEST_F(DeltaFrameTest, FullRepaintFallsBackToKeyframe) {
+  encoder_.Reset(BmpFrameLayout(kWidth, kHeight), 100);
+  EncodeCurrent();
+  for (int y = 0; y < kHeight; ++y) PaintRow(y, static_cast<uint8_t>(y + 1));
+  EXPECT_TRUE(EncodeCurrent().keyframe);
+  // The reference followed the keyframe, so an unchanged frame is empty.
+  EXPECT_EQ(EncodeCurrent().size, kDeltaFrameHeaderSize);
+}
+
+TEST_F(DeltaFrameTest, ReceiverReconstructsEveryFrame) {
+  std::mt19937 rng(99);
+  encoder_.Reset(BmpFrameLayout(kWidth, kHeight), 25);
+  std::vector<uint8_t> canvas;
+  for (int frame = 0; frame < 200; ++frame) {
+    const int edits = rng() % 4;
+    for (int i = 0; i < edits; ++i) {
+      const int y = rng() % kHeight;
+      const int x = rng() % kWidth;
+      rgb_[(y * kWidth + x) * 3 + rng() % 3] = static_cast<uint8_t>(rng());
+    }
+    DeltaFrameEncoder::Output out = EncodeCurrent();
+    ASSERT_LE(out.size, out.keyframe ? bmp_.size() : scratch_.size());
+    Apply(out, &canvas);
+    ASSERT_EQ(canvas, bmp_) << "frame " << frame;
+  }
+}
+
+TEST(DeltaFrameLayoutTest, BmpLayoutMatchesEncoder) {
+  FrameLayout layout = BmpFrameLayout(255, 64);
+  EXPECT_EQ(layout.pixel_offset, 54u);
+  EXPECT_EQ(layout.row_stride, 768u);  // 765 padded to four bytes
+  EXPECT_EQ(layout.frame_size(), BmpFileSize(255, 64));
+}
+
+TEST(DeltaFrameLayoutTest, Gray4LayoutMatchesPacker) {
+  FrameLayout layout = Gray4FrameLayout(256, 64);
+  EXPECT_EQ(layout.pixel_offset, kGray4HeaderSize);
+  EXPECT_EQ(layout.row_stride, 128u);
+  EXPECT_EQ(layout.frame_size(), Gray4FrameSize(256, 64));
+}
+
+// Gray4 frames go through the same encoder; one changed text line costs a
+// couple of hundred bytes.
+TEST(DeltaFrameLayoutTest, Gray4RowsDiff) {
+  const FrameLayout layout = Gray4FrameLayout(256, 64);
+  std::vector<uint8_t> yuyv(256 * 64 * 2, 16);
+  std::vector<uint8_t> frame(layout.frame_size());
+  std::vector<uint8_t> scratch(MaxDeltaFrameSize(layout));
+  DeltaFrameEncoder encoder;
+  encoder.Reset(layout, 60);
+
+  PackYuyvToGray4(yuyv.data(), 256, 64, frame.data());
+  EXPECT_TRUE(encoder.Encode(frame.data(), scratch.data()).keyframe);
+
+  yuyv[20 * 512] = 235;  // First pixel of row 20
+  PackYuyvToGray4(yuyv.data(), 256, 64, frame.data());
+  DeltaFrameEncoder::Output out = encoder.Encode(frame.data(), scratch.data());
+  ASSERT_FALSE(out.keyframe);
+  EXPECT_EQ(out.size, kDeltaFrameHeaderSize + kDeltaSpanHeaderSize + 128);
+  EXPECT_EQ(ReadLe16(out.data + kDeltaFrameHeaderSize), 20u);
+  EXPECT_EQ(out.data[kDeltaFrameHeaderSize + kDeltaSpanHeaderSize], 0xF0);
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,114 @@
+#include "frame_encoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "bmp_encoder.h"
+#include "gray4.h"
+#include "yuyv_convert.h"
+
+namespace usb_video {
+namespace {
+
+const int kWidth = 256;
+const int kHeight = 64;
+const size_t kYuyvSize = kWidth * kHeight * 2;
+
+std::vector<uint8_t> Frame(int bar_x) {
+  std::vector<uint8_t> yuyv(kYuyvSize);
+  for (size_t i = 0; i < kYuyvSize; i += 2) {
+    yuyv[i] = static_cast<uint8_t>(16 + (i / 2) % 200);
+    yuyv[i + 1] = 128;
+  }
+  for (int y = 0; y < kHeight; ++y) {
+    yuyv[(static_cast<size_t>(y) * kWidth + bar_x) * 2] = 235;
+  }
+  return yuyv;
+}
+
+std::vector<uint8_t> Bytes(const DeltaFrameEncoder::Output& output) {
+  return std::vector<uint8_t>(output.data, output.data + output.size);
+}
+
+FrameEncoder::Request Wants(FrameEncoder::Format format, bool delta) {
+  FrameEncoder::Request request = {};
+  (delta ? request.delta : request.full)[format] = true;
+  return request;
+}
+
+TEST(FrameEncoderTest, FullFramesMatchTheStandaloneEncoders) {
+  FrameEncoder encoder;
+  ASSERT_TRUE(encoder.Reset(kWidth, kHeight, 60));
+  std::vector<uint8_t> yuyv = Frame(10);
+  FrameEncoder::Request request = {};
+  request.full[FrameEncoder::kBmp] = true;
+  request.full[FrameEncoder::kGray4] = true;
+  FrameEncoder::Timing timing = encoder.Encode(yuyv.data(), yuyv.size(), request);
+  EXPECT_TRUE(timing.encoded);
+
+  std::vector<uint8_t> rgb(kWidth * kHeight * 3);
+  std::vector<uint8_t> bmp(BmpFileSize(kWidth, kHeight));
+  ConvertYuyvToRgb24(yuyv.data(), kWidth * kHeight, rgb.data());
+  bmp.resize(EncodeBmp24(rgb.data(), kWidth, kHeight, bmp.data()));
+  EXPECT_EQ(Bytes(encoder.full(FrameEncoder::kBmp)), bmp);
+
+  std::vector<uint8_t> gray4(Gray4FrameSize(kWidth, kHeight));
+  gray4.resize(PackYuyvToGray4(yuyv.data(), kWidth, kHeight, gray4.data()));
+  EXPECT_EQ(Bytes(encoder.full(FrameEncoder::kGray4)), gray4);
+}
+
+TEST(FrameEncoderTest, DeltaStreamsStartWithAKeyframe) {
+  FrameEncoder encoder;
+  ASSERT_TRUE(encoder.Reset(kWidth, kHeight, 60));
+  const FrameEncoder::Request request = Wants(FrameEncoder::kGray4, true);
+  std::vector<uint8_t> yuyv = Frame(10);
+
+  encoder.Encode(yuyv.data(), yuyv.size(), request);
+  EXPECT_TRUE(encoder.delta(FrameEncoder::kGray4).keyframe);
+  EXPECT_EQ(Bytes(encoder.delta(FrameEncoder::kGray4)),
+            Bytes(encoder.full(FrameEncoder::kGray4)));
+
+  // Unchanged: an empty delta.
+  encoder.Encode(yuyv.data(), yuyv.size(), request);
+  EXPECT_FALSE(encoder.delta(FrameEncoder::kGray4).keyframe);
+  EXPECT_EQ(encoder.delta(FrameEncoder::kGray4).size, kDeltaFrameHeaderSize);
+
+  encoder.ForceKeyframe(FrameEncoder::kGray4);
+  encoder.Encode(yuyv.data(), yuyv.size(), request);
+  EXPECT_TRUE(encoder.delta(FrameEncoder::kGray4).keyframe);
+}
+
+TEST(FrameEncoderTest, GrayAloneSkipsTheBmpEncoder) {
+  FrameEncoder encoder;
+  ASSERT_TRUE(encoder.Reset(kWidth, kHeight, 60));
+  std::vector<uint8_t> yuyv = Frame(3);
+  FrameEncoder::Timing timing =
+      encoder.Encode(yuyv.data(), yuyv.size(), Wants(FrameEncoder::kGray4, false));
+  // Packing is the whole job, so there is no encode step to time.
+  EXPECT_FALSE(timing.encoded);
+  EXPECT_EQ(encoder.full(FrameEncoder::kBmp).size, 0u);
+}
+
+TEST(FrameEncoderTest, ShortFramesKeepThePreviousPictureBeyondThem) {
+  FrameEncoder encoder;
+  ASSERT_TRUE(encoder.Reset(kWidth, kHeight, 60));
+  const FrameEncoder::Request request = Wants(FrameEncoder::kBmp, false);
+  std::vector<uint8_t> first = Frame(0);
+  encoder.Encode(first.data(), first.size(), request);
+  const std::vector<uint8_t> before = Bytes(encoder.full(FrameEncoder::kBmp));
+
+  // Only the top half arrives; the bottom rows must come from |first|.
+  std::vector<uint8_t> second = Frame(100);
+  encoder.Encode(second.data(), second.size() / 2, request);
+  const std::vector<uint8_t> after = Bytes(encoder.full(FrameEncoder::kBmp));
+  ASSERT_EQ(after.size(), before.size());
+  // The BMP is top-down, so the second half of its rows is the bottom.
+  const size_t middle = 54 + (after.size() - 54) / 2;
+  EXPECT_TRUE(std::equal(after.begin() + middle, after.end(), before.begin() + middle));
+  EXPECT_FALSE(std::equal(after.begin() + 54, after.begin() + middle, before.begin() + 54));
+}
+
+}  // namespace
+}  // namespace usb_video
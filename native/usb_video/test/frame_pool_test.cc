@@ -0,0 +1,108 @@
+#include "frame_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "bmp_encoder.h"
+#include "triple_buffer.h"
+#include "yuyv_convert.h"
+
+// Counts every global operator new in the test binary so the hot-path test
+// can assert it makes none.
+namespace {
+std::atomic<size_t> g_allocations(0);
+}  // namespace
+
+void* operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace usb_video {
+namespace {
+
+TEST(FramePoolTest, AllocationCounterSeesHeapAllocations) {
+  const size_t before = g_allocations.load();
+  std::unique_ptr<int> probe(new int(1));
+  EXPECT_EQ(g_allocations.load() - before, 1u);
+}
+
+TEST(FramePoolTest, SlotsAreCacheLineAligned) {
+  FramePool pool;
+  ASSERT_TRUE(pool.Reserve(4, 1000));
+  EXPECT_EQ(pool.slot_count(), 4u);
+  EXPECT_EQ(pool.slot_bytes(), 1000u);
+  for (size_t i = 0; i < pool.slot_count(); ++i) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pool.slot(i)) % FramePool::kAlignment,
+              0u);
+  }
+  EXPECT_GE(pool.slot(1) - pool.slot(0), 1000);
+}
+
+TEST(FramePoolTest, ReusesBlockAcrossCycles) {
+  FramePool pool;
+  ASSERT_TRUE(pool.Reserve(4, BmpFileSize(256, 64)));
+  uint8_t* first = pool.slot(0);
+  size_t capacity = pool.capacity();
+
+  // Restarting with the same or a smaller format keeps the same memory.
+  ASSERT_TRUE(pool.Reserve(4, BmpFileSize(256, 64)));
+  EXPECT_EQ(pool.slot(0), first);
+  ASSERT_TRUE(pool.Reserve(4, BmpFileSize(128, 32)));
+  EXPECT_EQ(pool.slot(0), first);
+  EXPECT_EQ(pool.capacity(), capacity);
+
+  // A larger format grows it.
+  ASSERT_TRUE(pool.Reserve(4, BmpFileSize(512, 128)));
+  EXPECT_GT(pool.capacity(), capacity);
+}
+
+// The per-frame work of the Linux plugin once the stream is set up: convert,
+// encode into the free slot, publish, and take the latest on the other side.
+TEST(FramePoolTest, SteadyStateFrameLoopDoesNotAllocate) {
+  const int width = 256;
+  const int height = 64;
+  std::vector<uint8_t> yuyv(width * height * 2, 0x80);
+
+  FramePool pool;
+  ASSERT_TRUE(pool.Reserve(4, BmpFileSize(width, height)));
+  TripleBuffer<FrameSlot> frames;
+  size_t next_slot = 0;
+  frames.Reset([&](FrameSlot& frame) {
+    frame.data = pool.slot(next_slot++);
+    frame.size = 0;
+  });
+  uint8_t* rgb = pool.slot(3);
+  // Resolve the kernel outside the measured loop; its one-time selection
+  // is not per-frame work.
+  ActiveYuyvKernel();
+
+  size_t delivered_bytes = 0;
+  const size_t before = g_allocations.load();
+  for (int i = 0; i < 240; ++i) {
+    ConvertYuyvToRgb24(yuyv.data(), width * height, rgb);
+    FrameSlot& frame = frames.write_slot();
+    frame.size = EncodeBmp24(rgb, width, height, frame.data);
+    frames.Publish();
+    if (i % 3 == 0 && frames.TakeLatest()) {
+      delivered_bytes += frames.read_slot().size;
+    }
+  }
+  const size_t allocations = g_allocations.load() - before;
+
+  EXPECT_EQ(allocations, 0u);
+  EXPECT_EQ(frames.produced(), 240u);
+  EXPECT_EQ(delivered_bytes, frames.delivered() * BmpFileSize(width, height));
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,162 @@
+#include "frame_rate_controller.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace usb_video {
+namespace {
+
+const int64_t kSecond = 1000000;
+
+// 60, 30, 15 and 7.5 fps, deliberately out of order.
+std::vector<FrameInterval> CameraIntervals() {
+  return {{1, 30}, {2, 15}, {1, 60}, {1, 15}, {1, 30}, {0, 0}};
+}
+
+// Drives |controller| through one evaluation window ending at |*now| in
+// which |offered| frames were offered and |missed| of them missed.
+bool Window(FrameRateController* controller, uint64_t* offered, uint64_t* missed,
+            int64_t* now, uint64_t window_offered, uint64_t window_missed) {
+  *offered += window_offered;
+  *missed += window_missed;
+  *now += FrameRateController::kWindowUs;
+  return controller->Update(*offered, *missed, *now);
+}
+
+TEST(FrameRateControllerTest, SortsAndDedupesIntervals) {
+  std::vector<FrameInterval> intervals = CameraIntervals();
+  SortFrameIntervals(&intervals);
+  ASSERT_EQ(intervals.size(), 4u);
+  EXPECT_DOUBLE_EQ(intervals[0].fps(), 60.0);
+  EXPECT_DOUBLE_EQ(intervals[1].fps(), 30.0);
+  EXPECT_DOUBLE_EQ(intervals[2].fps(), 15.0);
+  EXPECT_DOUBLE_EQ(intervals[3].fps(), 7.5);
+  // 2/60 is the same interval as 1/30.
+  intervals.push_back(FrameInterval{2, 60});
+  SortFrameIntervals(&intervals);
+  EXPECT_EQ(intervals.size(), 4u);
+}
+
+TEST(FrameRateControllerTest, StartsAtTheFastestRateUnderTheCap) {
+  FrameRateController controller;
+  EXPECT_FALSE(controller.has_target());
+  controller.Reset(CameraIntervals(), 0);
+  ASSERT_TRUE(controller.has_target());
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 60.0);
+
+  controller.set_max_fps(30);
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 30.0);
+  // NTSC-style 30000/1001 counts as 30.
+  controller.Reset({{1, 60}, {1001, 30000}, {1, 15}}, 0);
+  EXPECT_EQ(controller.target(), (FrameInterval{1001, 30000}));
+  controller.set_max_fps(20);
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 15.0);
+  // Below everything on offer, the slowest rate will have to do.
+  controller.set_max_fps(1);
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 15.0);
+  controller.set_max_fps(0);
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 60.0);
+}
+
+TEST(FrameRateControllerTest, StepsDownWhileReceiversMissFrames) {
+  FrameRateController controller;
+  int64_t now = 0;
+  uint64_t offered = 0;
+  uint64_t missed = 0;
+  controller.Reset(CameraIntervals(), now);
+
+  // Nothing changes before a full window has gone by.
+  EXPECT_FALSE(controller.Update(60, 60, kSecond / 2));
+  EXPECT_FALSE(Window(&controller, &offered, &missed, &now, 60, 10));
+  EXPECT_TRUE(Window(&controller, &offered, &missed, &now, 60, 30));
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 30.0);
+  EXPECT_EQ(controller.step_down(), 1);
+  EXPECT_TRUE(Window(&controller, &offered, &missed, &now, 30, 10));
+  EXPECT_TRUE(Window(&controller, &offered, &missed, &now, 15, 10));
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 7.5);
+  // Nowhere lower to go.
+  EXPECT_FALSE(Window(&controller, &offered, &missed, &now, 8, 8));
+  EXPECT_EQ(controller.step_down(), 3);
+}
+
+TEST(FrameRateControllerTest, IgnoresWindowsWithTooFewFrames) {
+  FrameRateController controller;
+  int64_t now = 0;
+  uint64_t offered = 0;
+  uint64_t missed = 0;
+  controller.Reset(CameraIntervals(), now);
+  // A static picture offers almost nothing; missing it says little.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_FALSE(Window(&controller, &offered, &missed, &now,
+                        FrameRateController::kMinOfferedFrames - 1,
+                        FrameRateController::kMinOfferedFrames - 1));
+  }
+  EXPECT_EQ(controller.step_down(), 0);
+}
+
+TEST(FrameRateControllerTest, StepsBackUpAfterKeepingUp) {
+  FrameRateController controller;
+  int64_t now = 0;
+  uint64_t offered = 0;
+  uint64_t missed = 0;
+  controller.Reset(CameraIntervals(), now);
+  ASSERT_TRUE(Window(&controller, &offered, &missed, &now, 60, 40));
+  ASSERT_EQ(controller.step_down(), 1);
+
+  // Healthy, but not for long enough yet.
+  const int64_t windows = FrameRateController::kRecoveryUs / kSecond;
+  for (int64_t i = 1; i < windows; ++i) {
+    EXPECT_FALSE(Window(&controller, &offered, &missed, &now, 30, 0)) << i;
+  }
+  // A middling window neither steps up nor down.
+  EXPECT_FALSE(Window(&controller, &offered, &missed, &now, 30, 3));
+  EXPECT_TRUE(Window(&controller, &offered, &missed, &now, 30, 0));
+  EXPECT_EQ(controller.step_down(), 0);
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 60.0);
+}
+
+TEST(FrameRateControllerTest, BacksOffLongerAfterAFailedStepUp) {
+  FrameRateController controller;
+  int64_t now = 0;
+  uint64_t offered = 0;
+  uint64_t missed = 0;
+  controller.Reset(CameraIntervals(), now);
+  ASSERT_TRUE(Window(&controller, &offered, &missed, &now, 60, 40));
+
+  // Step up after the normal recovery time ...
+  int64_t waited = 0;
+  while (!Window(&controller, &offered, &missed, &now, 30, 0)) {
+    waited += FrameRateController::kWindowUs;
+  }
+  ASSERT_EQ(controller.step_down(), 0);
+  // ... fail straight away at the faster rate ...
+  ASSERT_TRUE(Window(&controller, &offered, &missed, &now, 60, 40));
+  ASSERT_EQ(controller.step_down(), 1);
+  // ... and the next step up waits twice as long.
+  int64_t waited_again = 0;
+  while (!Window(&controller, &offered, &missed, &now, 30, 0)) {
+    waited_again += FrameRateController::kWindowUs;
+  }
+  EXPECT_EQ(waited_again + FrameRateController::kWindowUs,
+            2 * (waited + FrameRateController::kWindowUs));
+}
+
+TEST(FrameRateControllerTest, ALowerCapClampsTheStepDown) {
+  FrameRateController controller;
+  int64_t now = 0;
+  uint64_t offered = 0;
+  uint64_t missed = 0;
+  controller.Reset(CameraIntervals(), now);
+  ASSERT_TRUE(Window(&controller, &offered, &missed, &now, 60, 40));
+  ASSERT_TRUE(Window(&controller, &offered, &missed, &now, 30, 20));
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 15.0);
+  controller.set_max_fps(15);
+  // Already at the bottom, starting from 15.
+  EXPECT_DOUBLE_EQ(controller.target().fps(), 7.5);
+  EXPECT_FALSE(Window(&controller, &offered, &missed, &now, 8, 8));
+  EXPECT_EQ(controller.step_down(), 1);
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,160 @@
+#include "frame_suppressor.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+#include "frame_hash.h"
+
+namespace usb_video {
+namespace {
+
+const int64_t kMs = 1000;
+
+std::vector<uint8_t> Frame(uint8_t fill) {
+  return std::vector<uint8_t>(256 * 64 * 2, fill);
+}
+
+TEST(FrameHashTest, IdenticalInputsHashEqual) {
+  std::vector<uint8_t> a = Frame(0x42);
+  std::vector<uint8_t> b = Frame(0x42);
+  EXPECT_EQ(HashFrame(a.data(), a.size()), HashFrame(b.data(), b.size()));
+}
+
+TEST(FrameHashTest, EverySingleByteChangeChangesTheHash) {
+  // A one-pixel edit anywhere in the frame, including the tail bytes after
+  // the last 32-byte block, must never look unchanged.
+  std::vector<uint8_t> frame = Frame(0x10);
+  frame.resize(frame.size() + 13, 0x10);
+  const uint64_t base = HashFrame(frame.data(), frame.size());
+  for (size_t i = 0; i < frame.size(); ++i) {
+    frame[i] ^= 0x01;
+    ASSERT_NE(HashFrame(frame.data(), frame.size()), base) << "byte " << i;
+    frame[i] ^= 0x01;
+  }
+}
+
+TEST(FrameHashTest, LengthIsPartOfTheHash) {
+  std::vector<uint8_t> frame(64, 0);
+  std::set<uint64_t> hashes;
+  for (size_t size = 0; size <= frame.size(); ++size) {
+    hashes.insert(HashFrame(frame.data(), size));
+  }
+  EXPECT_EQ(hashes.size(), frame.size() + 1);
+}
+
+TEST(FrameSuppressorTest, DeliversFirstAndChangedFrames) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(1000 * kMs);
+  std::vector<uint8_t> a = Frame(1);
+  std::vector<uint8_t> b = Frame(2);
+
+  EXPECT_TRUE(suppressor.ShouldDeliver(a.data(), a.size(), 0));
+  EXPECT_TRUE(suppressor.ShouldDeliver(b.data(), b.size(), 16 * kMs));
+  EXPECT_TRUE(suppressor.ShouldDeliver(a.data(), a.size(), 32 * kMs));
+  EXPECT_EQ(suppressor.frames_suppressed(), 0u);
+}
+
+TEST(FrameSuppressorTest, SuppressesRepeatsUntilKeepAlive) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(1000 * kMs);
+  std::vector<uint8_t> frame = Frame(7);
+
+  // 60 fps of a static page for just over two seconds.
+  int delivered = 0;
+  for (int i = 0; i <= 125; ++i) {
+    delivered += suppressor.ShouldDeliver(frame.data(), frame.size(),
+                                          i * 16667) ? 1 : 0;
+  }
+  EXPECT_EQ(delivered, 3);  // First frame plus one keep-alive per second.
+  EXPECT_EQ(suppressor.keep_alive_frames(), 2u);
+  EXPECT_EQ(suppressor.frames_seen(), 126u);
+  EXPECT_EQ(suppressor.frames_suppressed(), 123u);
+  EXPECT_NEAR(suppressor.suppression_ratio(), 123.0 / 126.0, 1e-9);
+}
+
+TEST(FrameSuppressorTest, ChangedFrameRestartsKeepAliveClock) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(100 * kMs);
+  std::vector<uint8_t> a = Frame(1);
+  std::vector<uint8_t> b = Frame(2);
+
+  EXPECT_TRUE(suppressor.ShouldDeliver(a.data(), a.size(), 0));
+  EXPECT_TRUE(suppressor.ShouldDeliver(b.data(), b.size(), 90 * kMs));
+  EXPECT_FALSE(suppressor.ShouldDeliver(b.data(), b.size(), 150 * kMs));
+  EXPECT_TRUE(suppressor.ShouldDeliver(b.data(), b.size(), 190 * kMs));
+}
+
+TEST(FrameSuppressorTest, ForceNextDeliversOneUnchangedFrame) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(1000 * kMs);
+  std::vector<uint8_t> frame = Frame(5);
+
+  EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), 0));
+  EXPECT_FALSE(suppressor.ShouldDeliver(frame.data(), frame.size(), 16 * kMs));
+  suppressor.ForceNext();
+  EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), 32 * kMs));
+  EXPECT_FALSE(suppressor.ShouldDeliver(frame.data(), frame.size(), 48 * kMs));
+  // The forced frame restarted the keep-alive clock and is not counted as
+  // a keep-alive.
+  EXPECT_FALSE(suppressor.ShouldDeliver(frame.data(), frame.size(), 1020 * kMs));
+  EXPECT_EQ(suppressor.keep_alive_frames(), 0u);
+  EXPECT_EQ(suppressor.frames_suppressed(), 3u);
+}
+
+TEST(FrameSuppressorTest, ResetClearsForceNext) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(1000 * kMs);
+  std::vector<uint8_t> frame = Frame(6);
+  suppressor.ForceNext();
+  suppressor.Reset(1000 * kMs);
+  EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), 0));
+  EXPECT_FALSE(suppressor.ShouldDeliver(frame.data(), frame.size(), 1));
+}
+
+TEST(FrameSuppressorTest, NonPositiveKeepAliveDisablesSuppression) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(0);
+  std::vector<uint8_t> frame = Frame(3);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), i));
+  }
+  EXPECT_EQ(suppressor.frames_seen(), 10u);
+  EXPECT_EQ(suppressor.suppression_ratio(), 0.0);
+}
+
+TEST(FrameSuppressorTest, SetKeepAliveKeepsTheSession) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(1000 * kMs);
+  std::vector<uint8_t> frame = Frame(8);
+  EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), 0));
+  EXPECT_FALSE(suppressor.ShouldDeliver(frame.data(), frame.size(), 100 * kMs));
+
+  // A shorter keep-alive applies from the last delivery, not from now.
+  suppressor.SetKeepAlive(200 * kMs);
+  EXPECT_EQ(suppressor.keep_alive_us(), 200 * kMs);
+  EXPECT_FALSE(suppressor.ShouldDeliver(frame.data(), frame.size(), 150 * kMs));
+  EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), 200 * kMs));
+  EXPECT_EQ(suppressor.frames_seen(), 4u);
+  EXPECT_EQ(suppressor.keep_alive_frames(), 1u);
+
+  suppressor.SetKeepAlive(0);
+  EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), 201 * kMs));
+}
+
+TEST(FrameSuppressorTest, ResetStartsANewSession) {
+  FrameSuppressor suppressor;
+  suppressor.Reset(1000 * kMs);
+  std::vector<uint8_t> frame = Frame(4);
+  suppressor.ShouldDeliver(frame.data(), frame.size(), 0);
+  suppressor.ShouldDeliver(frame.data(), frame.size(), 1);
+
+  suppressor.Reset(1000 * kMs);
+  EXPECT_EQ(suppressor.frames_seen(), 0u);
+  EXPECT_EQ(suppressor.frames_suppressed(), 0u);
+  EXPECT_TRUE(suppressor.ShouldDeliver(frame.data(), frame.size(), 2));
+}
+
+}  // namespace
+}  // namespace usb_video
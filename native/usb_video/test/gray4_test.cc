@@ -0,0 +1,52 @@
+#include "gray4.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace usb_video {
+namespace {
+
+TEST(Gray4Test, QuantisesStudioRangeToSixteenLevels) {
+  EXPECT_EQ(QuantizeLumaToGray4(0), 0);
+  EXPECT_EQ(QuantizeLumaToGray4(16), 0);
+  EXPECT_EQ(QuantizeLumaToGray4(235), 15);
+  EXPECT_EQ(QuantizeLumaToGray4(255), 15);
+  // Each of the 16 display levels, encoded at its nominal luma, survives.
+  for (int level = 0; level < 16; ++level) {
+    const int luma = 16 + (level * 219 + 7) / 15;
+    EXPECT_EQ(QuantizeLumaToGray4(static_cast<uint8_t>(luma)), level) << luma;
+  }
+}
+
+TEST(Gray4Test, QuantisationIsMonotonic) {
+  for (int y = 1; y < 256; ++y) {
+    EXPECT_LE(QuantizeLumaToGray4(static_cast<uint8_t>(y - 1)),
+              QuantizeLumaToGray4(static_cast<uint8_t>(y)));
+  }
+}
+
+TEST(Gray4Test, DistingFrameIsEightKilobytes) {
+  EXPECT_EQ(Gray4FrameSize(256, 64), kGray4HeaderSize + 8192);
+}
+
+TEST(Gray4Test, PacksPixelPairsHighNibbleFirst) {
+  // 4x2 frame. Row 0 luma: 16, 235, 128, 16. Row 1: 235, 235, 16, 128.
+  const std::vector<uint8_t> yuyv = {
+      16, 90, 235, 240, 128, 90, 16, 240,
+      235, 128, 235, 128, 16, 128, 128, 128,
+  };
+  std::vector<uint8_t> out(Gray4FrameSize(4, 2), 0xEE);
+  ASSERT_EQ(PackYuyvToGray4(yuyv.data(), 4, 2, out.data()), out.size());
+
+  const uint8_t mid = QuantizeLumaToGray4(128);
+  const std::vector<uint8_t> expected = {
+      'G', '4', kGray4Version, 0, 4, 0, 2, 0,
+      0x0F, static_cast<uint8_t>(mid << 4),
+      0xFF, mid,
+  };
+  EXPECT_EQ(out, expected);
+}
+
+}  // namespace
+}  // namespace usb_video
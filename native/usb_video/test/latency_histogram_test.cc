@@ -0,0 +1,85 @@
+#include "latency_histogram.h"
+
+#include <gtest/gtest.h>
+
+namespace usb_video {
+namespace {
+
+TEST(LatencyHistogramTest, EmptySummaryIsZero) {
+  LatencyHistogram histogram;
+  LatencyHistogram::Summary summary = histogram.Summarize();
+  EXPECT_EQ(summary.count, 0u);
+  EXPECT_EQ(summary.max_us, 0);
+  EXPECT_EQ(summary.p99_us, 0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  for (int64_t value = 0; value < 2 * LatencyHistogram::kSubBuckets; ++value) {
+    size_t index = LatencyHistogram::BucketIndex(value);
+    EXPECT_EQ(LatencyHistogram::BucketUpperBound(index), value);
+  }
+}
+
+TEST(LatencyHistogramTest, BucketsAreContiguousAndWithinPrecision) {
+  int64_t previous_upper = -1;
+  for (size_t index = 0; index < LatencyHistogram::kBucketCount; ++index) {
+    int64_t upper = LatencyHistogram::BucketUpperBound(index);
+    EXPECT_EQ(LatencyHistogram::BucketIndex(previous_upper + 1), index);
+    EXPECT_EQ(LatencyHistogram::BucketIndex(upper), index);
+    // Every value in the bucket is within one sub-bucket of its upper bound.
+    EXPECT_LE(upper - previous_upper - 1,
+              (previous_upper + 1) / LatencyHistogram::kSubBuckets);
+    previous_upper = upper;
+  }
+  EXPECT_EQ(previous_upper, LatencyHistogram::kMaxValueUs);
+}
+
+TEST(LatencyHistogramTest, ClampsOutOfRangeValues) {
+  EXPECT_EQ(LatencyHistogram::BucketIndex(-5), 0u);
+  EXPECT_EQ(LatencyHistogram::BucketIndex(int64_t{1} << 40),
+            LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, SummarizesPercentiles) {
+  LatencyHistogram histogram;
+  for (int64_t value = 1; value <= 1000; ++value) {
+    histogram.Record(value);
+  }
+  LatencyHistogram::Summary summary = histogram.Summarize();
+  EXPECT_EQ(summary.count, 1000u);
+  EXPECT_EQ(summary.min_us, 1);
+  EXPECT_EQ(summary.max_us, 1000);
+  EXPECT_EQ(summary.mean_us, 500);
+  EXPECT_GE(summary.p50_us, 500);
+  EXPECT_LE(summary.p50_us, 500 + 500 / LatencyHistogram::kSubBuckets);
+  EXPECT_GE(summary.p90_us, 900);
+  EXPECT_LE(summary.p90_us, 900 + 900 / LatencyHistogram::kSubBuckets);
+  EXPECT_GE(summary.p99_us, 990);
+  EXPECT_LE(summary.p99_us, 1000);
+}
+
+TEST(LatencyHistogramTest, OutlierOnlyMovesTheTail) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 99; ++i) {
+    histogram.Record(100);
+  }
+  histogram.Record(50000);
+  LatencyHistogram::Summary summary = histogram.Summarize();
+  EXPECT_LE(summary.p90_us, 100 + 100 / LatencyHistogram::kSubBuckets);
+  EXPECT_LE(summary.p99_us, 100 + 100 / LatencyHistogram::kSubBuckets);
+  EXPECT_EQ(summary.max_us, 50000);
+}
+
+TEST(LatencyHistogramTest, ResetStartsANewSeries) {
+  LatencyHistogram histogram;
+  histogram.Record(7000);
+  histogram.Reset();
+  histogram.Record(12);
+  LatencyHistogram::Summary summary = histogram.Summarize();
+  EXPECT_EQ(summary.count, 1u);
+  EXPECT_EQ(summary.min_us, 12);
+  EXPECT_EQ(summary.p99_us, 12);
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,47 @@
+#include "latency_stats.h"
+
+#include <gtest/gtest.h>
+
+namespace usb_video {
+namespace {
+
+TEST(LatencyStatsTest, EmptySnapshotIsZero) {
+  LatencyStats stats;
+  LatencyStats::Snapshot snapshot = stats.Read();
+  EXPECT_EQ(snapshot.count, 0u);
+  EXPECT_EQ(snapshot.last_us, 0);
+  EXPECT_EQ(snapshot.min_us, 0);
+  EXPECT_EQ(snapshot.max_us, 0);
+  EXPECT_EQ(snapshot.mean_us, 0);
+}
+
+TEST(LatencyStatsTest, TracksLastMinMaxAndMean) {
+  LatencyStats stats;
+  stats.Record(300);
+  stats.Record(100);
+  stats.Record(800);
+  stats.Record(200);
+
+  LatencyStats::Snapshot snapshot = stats.Read();
+  EXPECT_EQ(snapshot.count, 4u);
+  EXPECT_EQ(snapshot.last_us, 200);
+  EXPECT_EQ(snapshot.min_us, 100);
+  EXPECT_EQ(snapshot.max_us, 800);
+  EXPECT_EQ(snapshot.mean_us, 350);
+}
+
+TEST(LatencyStatsTest, ResetStartsANewSeries) {
+  LatencyStats stats;
+  stats.Record(5000);
+  stats.Reset();
+  stats.Record(40);
+
+  LatencyStats::Snapshot snapshot = stats.Read();
+  EXPECT_EQ(snapshot.count, 1u);
+  EXPECT_EQ(snapshot.min_us, 40);
+  EXPECT_EQ(snapshot.max_us, 40);
+  EXPECT_EQ(snapshot.mean_us, 40);
+}
+
+}  // namespace
+}  // namespace usb_video
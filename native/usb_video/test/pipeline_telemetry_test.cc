@@ -0,0 +1,84 @@
+#include "pipeline_telemetry.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace usb_video {
+namespace {
+
+TEST(PipelineTelemetryTest, DisabledUntilAnIntervalIsSet) {
+  PipelineTelemetry telemetry;
+  telemetry.Reset(0);
+  EXPECT_FALSE(telemetry.enabled());
+  EXPECT_FALSE(telemetry.StartNextWindow(10000000));
+}
+
+TEST(PipelineTelemetryTest, RateLimitsReports) {
+  PipelineTelemetry telemetry;
+  telemetry.Reset(1000);
+  telemetry.set_interval_us(500000);
+
+  EXPECT_FALSE(telemetry.StartNextWindow(400000));
+  EXPECT_TRUE(telemetry.StartNextWindow(501000));
+  EXPECT_EQ(telemetry.window_us(), 500000);
+  EXPECT_FALSE(telemetry.StartNextWindow(900000));
+  EXPECT_TRUE(telemetry.StartNextWindow(1200000));
+  EXPECT_EQ(telemetry.window_us(), 699000);
+  EXPECT_EQ(telemetry.session_us(1200000), 1199000);
+}
+
+TEST(PipelineTelemetryTest, IntervalHasAFloor) {
+  PipelineTelemetry telemetry;
+  telemetry.set_interval_us(1);
+  EXPECT_EQ(telemetry.interval_us(), PipelineTelemetry::kMinIntervalUs);
+  telemetry.set_interval_us(-1);
+  EXPECT_FALSE(telemetry.enabled());
+}
+
+TEST(PipelineTelemetryTest, RatesCoverOnlyTheLastWindow) {
+  PipelineTelemetry telemetry;
+  telemetry.Reset(0);
+  telemetry.set_interval_us(PipelineTelemetry::kDefaultIntervalUs);
+
+  ASSERT_TRUE(telemetry.StartNextWindow(2000000));
+  EXPECT_DOUBLE_EQ(
+      telemetry.WindowRate(PipelineTelemetry::kFramesCaptured, 120), 60.0);
+
+  ASSERT_TRUE(telemetry.StartNextWindow(3000000));
+  EXPECT_DOUBLE_EQ(
+      telemetry.WindowRate(PipelineTelemetry::kFramesCaptured, 150), 30.0);
+  // Counters are tracked independently.
+  EXPECT_DOUBLE_EQ(
+      telemetry.WindowRate(PipelineTelemetry::kCaptureCpuUs, 50000), 50000.0);
+}
+
+TEST(PipelineTelemetryTest, ResetClearsHistogramsAndTotals) {
+  PipelineTelemetry telemetry;
+  telemetry.Reset(0);
+  telemetry.set_interval_us(PipelineTelemetry::kDefaultIntervalUs);
+  telemetry.Record(PipelineTelemetry::kSend, 250);
+  ASSERT_TRUE(telemetry.StartNextWindow(1000000));
+  telemetry.WindowRate(PipelineTelemetry::kFramesDelivered, 1000);
+
+  telemetry.Reset(5000000);
+  EXPECT_EQ(telemetry.histogram(PipelineTelemetry::kSend).Summarize().count, 0u);
+  EXPECT_TRUE(telemetry.enabled());
+  ASSERT_TRUE(telemetry.StartNextWindow(6000000));
+  EXPECT_DOUBLE_EQ(
+      telemetry.WindowRate(PipelineTelemetry::kFramesDelivered, 30), 30.0);
+}
+
+TEST(PipelineTelemetryTest, StagesHaveDistinctNames) {
+  for (int a = 0; a < PipelineTelemetry::kStageCount; ++a) {
+    for (int b = a + 1; b < PipelineTelemetry::kStageCount; ++b) {
+      EXPECT_NE(std::string(PipelineTelemetry::StageName(
+                    static_cast<PipelineTelemetry::Stage>(a))),
+                PipelineTelemetry::StageName(
+                    static_cast<PipelineTelemetry::Stage>(b)));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,189 @@
+#include "recording_reader.h"
+#include "recording_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gray4.h"
+
+namespace usb_video {
+namespace {
+
+const int kWidth = 256;
+const int kHeight = 64;
+const size_t kYuyvSize = kWidth * kHeight * 2;
+
+class RecordingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char path[] = "/tmp/recording_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_NE(fd, -1);
+    close(fd);
+    path_ = path;
+  }
+
+  void TearDown() override { std::remove(path_.c_str()); }
+
+  // Frame |n|: a bar that moves every 4th frame over a static background,
+  // like a mostly idle display.
+  static std::vector<uint8_t> Frame(int n) {
+    std::vector<uint8_t> yuyv(kYuyvSize);
+    for (size_t i = 0; i < kYuyvSize; i += 2) {
+      yuyv[i] = 16;
+      yuyv[i + 1] = 128;
+    }
+    const int x = (n / 4) % kWidth;
+    for (int y = 10; y < 20; ++y) {
+      yuyv[(static_cast<size_t>(y) * kWidth + x) * 2] = 235;
+    }
+    return yuyv;
+  }
+
+  // Writes |count| frames 16.667 ms apart, with no drops.
+  void Record(RecordingPixelFormat format, int count, uint32_t interval) {
+    RecordingWriter writer;
+    ASSERT_TRUE(writer.Open(path_, format, kWidth, kHeight, interval, 4));
+    for (int n = 0; n < count; ++n) {
+      std::vector<uint8_t> frame = Frame(n);
+      while (!writer.Submit(frame.data(), frame.size(), Timestamp(n),
+                            static_cast<uint32_t>(n))) {
+        usleep(100);
+      }
+    }
+    ASSERT_TRUE(writer.Close());
+    EXPECT_EQ(writer.frames_written(), static_cast<uint64_t>(count));
+  }
+
+  static int64_t Timestamp(int n) { return 1000000 + n * 16667; }
+
+  std::string path_;
+};
+
+TEST_F(RecordingTest, YuyvRoundTripsEveryFrame) {
+  Record(kRecordingYuyv, 250, 60);
+
+  RecordingReader reader;
+  ASSERT_TRUE(reader.Open(path_));
+  EXPECT_FALSE(reader.recovered());
+  EXPECT_EQ(reader.frame_count(), 250u);
+  EXPECT_EQ(reader.header().width, kWidth);
+  EXPECT_EQ(reader.header().frame_size, kYuyvSize);
+
+  std::vector<uint8_t> out(kYuyvSize);
+  RecordingReader::FrameInfo info;
+  for (int n = 0; n < 250; ++n) {
+    ASSERT_TRUE(reader.ReadFrame(n, out.data(), &info)) << n;
+    ASSERT_EQ(out, Frame(n)) << n;
+    EXPECT_EQ(info.timestamp_us, Timestamp(n));
+    EXPECT_EQ(info.sequence, static_cast<uint32_t>(n));
+    EXPECT_EQ(info.keyframe, n % 60 == 0);
+  }
+  EXPECT_FALSE(reader.ReadFrame(250, out.data()));
+}
+
+TEST_F(RecordingTest, StaticFramesCostLittle) {
+  Record(kRecordingYuyv, 240, 120);
+  FILE* file = std::fopen(path_.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  std::fseek(file, 0, SEEK_END);
+  const long size = std::ftell(file);
+  std::fclose(file);
+  // 240 raw frames would be 7.8 MB.
+  EXPECT_LT(size, 40000);
+}
+
+TEST_F(RecordingTest, RandomAccessMatchesSequential) {
+  Record(kRecordingYuyv, 200, 30);
+  RecordingReader reader;
+  ASSERT_TRUE(reader.Open(path_));
+  std::vector<uint8_t> out(kYuyvSize);
+  for (int n : {199, 0, 45, 44, 46, 120, 31, 150, 150, 29}) {
+    ASSERT_TRUE(reader.ReadFrame(n, out.data())) << n;
+    EXPECT_EQ(out, Frame(n)) << n;
+  }
+}
+
+TEST_F(RecordingTest, Gray4StoresPackedFrames) {
+  Record(kRecordingGray4, 70, 32);
+  RecordingReader reader;
+  ASSERT_TRUE(reader.Open(path_));
+  ASSERT_EQ(reader.header().pixel_format, kRecordingGray4);
+  ASSERT_EQ(reader.header().frame_size, Gray4FrameSize(kWidth, kHeight));
+
+  std::vector<uint8_t> out(reader.header().frame_size);
+  std::vector<uint8_t> expected(out.size());
+  for (int n = 0; n < 70; ++n) {
+    ASSERT_TRUE(reader.ReadFrame(n, out.data())) << n;
+    PackYuyvToGray4(Frame(n).data(), kWidth, kHeight, expected.data());
+    ASSERT_EQ(out, expected) << n;
+  }
+}
+
+TEST_F(RecordingTest, FrameAtTimeFindsTheFrameShowing) {
+  Record(kRecordingYuyv, 100, 25);
+  RecordingReader reader;
+  ASSERT_TRUE(reader.Open(path_));
+  EXPECT_EQ(reader.FrameAtTime(0), 0u);
+  EXPECT_EQ(reader.FrameAtTime(Timestamp(0)), 0u);
+  EXPECT_EQ(reader.FrameAtTime(Timestamp(37)), 37u);
+  EXPECT_EQ(reader.FrameAtTime(Timestamp(37) + 5000), 37u);
+  EXPECT_EQ(reader.FrameAtTime(Timestamp(50)), 50u);
+  EXPECT_EQ(reader.FrameAtTime(Timestamp(99) + 1000000), 99u);
+}
+
+TEST_F(RecordingTest, RecoversTruncatedRecording) {
+  Record(kRecordingYuyv, 90, 20);
+  // Cut the index off and half of the last kept frame, as a crash would.
+  FILE* file = std::fopen(path_.c_str(), "rb");
+  ASSERT_NE(file, nullptr);
+  std::vector<uint8_t> bytes;
+  int c;
+  while ((c = std::fgetc(file)) != EOF) {
+    bytes.push_back(static_cast<uint8_t>(c));
+  }
+  std::fclose(file);
+
+  const size_t index_offset =
+      GetRecordingLe64(bytes.data() + bytes.size() - kRecordingTrailerSize);
+  ASSERT_LT(index_offset, bytes.size());
+  bytes.resize(index_offset - 5);
+  file = std::fopen(path_.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fwrite(bytes.data(), 1, bytes.size(), file);
+  std::fclose(file);
+
+  RecordingReader reader;
+  ASSERT_TRUE(reader.Open(path_));
+  EXPECT_TRUE(reader.recovered());
+  EXPECT_EQ(reader.frame_count(), 89u);
+  std::vector<uint8_t> out(kYuyvSize);
+  for (int n : {0, 88, 41, 60}) {
+    ASSERT_TRUE(reader.ReadFrame(n, out.data())) << n;
+    EXPECT_EQ(out, Frame(n)) << n;
+  }
+}
+
+TEST_F(RecordingTest, DropsInsteadOfBlockingWhenNotOpen) {
+  RecordingWriter writer;
+  std::vector<uint8_t> frame = Frame(0);
+  EXPECT_FALSE(writer.Submit(frame.data(), frame.size(), 0, 0));
+  EXPECT_EQ(writer.frames_dropped(), 1u);
+}
+
+TEST_F(RecordingTest, RejectsNonRecordings) {
+  FILE* file = std::fopen(path_.c_str(), "wb");
+  ASSERT_NE(file, nullptr);
+  std::fputs("definitely not a recording, just some text padding it out", file);
+  std::fclose(file);
+  RecordingReader reader;
+  EXPECT_FALSE(reader.Open(path_));
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,214 @@
+#include "screenshot.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "png_encoder.h"
+#include "screenshot_ffi.h"
+
+#ifdef USB_VIDEO_TEST_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace usb_video {
+namespace {
+
+uint32_t BigEndian32(const uint8_t* p) {
+  return static_cast<uint32_t>(p[0]) << 24 | p[1] << 16 | p[2] << 8 | p[3];
+}
+
+struct Chunk {
+  std::string type;
+  const uint8_t* data;
+  uint32_t length;
+  uint32_t crc;
+};
+
+// Splits a PNG into its chunks, after checking the signature.
+std::vector<Chunk> ReadChunks(const uint8_t* png, size_t size) {
+  static const uint8_t kSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  std::vector<Chunk> chunks;
+  if (size < 8 || memcmp(png, kSignature, 8) != 0) {
+    return chunks;
+  }
+  size_t offset = 8;
+  while (offset + 12 <= size) {
+    Chunk chunk;
+    chunk.length = BigEndian32(png + offset);
+    if (offset + 12 + chunk.length > size) {
+      break;
+    }
+    chunk.type.assign(reinterpret_cast<const char*>(png + offset + 4), 4);
+    chunk.data = png + offset + 8;
+    chunk.crc = BigEndian32(png + offset + 8 + chunk.length);
+    chunks.push_back(chunk);
+    offset += 12 + chunk.length;
+  }
+  return chunks;
+}
+
+TEST(ScreenshotTest, GammaTableMatchesTheCurve) {
+  for (int level = 0; level < 16; ++level) {
+    double v = std::pow(level * 0.066666666666667, 0.45);
+    v = std::pow(v, 0.45) * 255;
+    EXPECT_EQ(kScreenshotGamma[level], static_cast<int>(std::min(std::max(v, 0.0), 255.0)))
+        << "level " << level;
+  }
+}
+
+TEST(ScreenshotTest, RendersLevelsInsideABlackBorder) {
+  const int width = 4;
+  const int height = 2;
+  const int border = 1;
+  const uint8_t levels[] = {0, 15, 7, 200, 1, 2, 3};  // one short
+  std::vector<uint8_t> rgba((width + 2) * (height + 2) * 4, 0x55);
+  RenderScreenshot(levels, sizeof(levels), width, height, border, rgba.data());
+
+  auto pixel = [&rgba](int x, int y) {
+    const uint8_t* p = &rgba[(y * (width + 2) + x) * 4];
+    return std::vector<uint8_t>(p, p + 4);
+  };
+  const std::vector<uint8_t> black = {0, 0, 0, 255};
+  EXPECT_EQ(pixel(0, 0), black);
+  EXPECT_EQ(pixel(5, 3), black);
+  EXPECT_EQ(pixel(1, 1), black);  // level 0
+  EXPECT_EQ(pixel(2, 1), (std::vector<uint8_t>{0, 255, 255, 255}));
+  EXPECT_EQ(pixel(3, 1), (std::vector<uint8_t>{0, kScreenshotGamma[7], kScreenshotGamma[7], 255}));
+  EXPECT_EQ(pixel(4, 1), (std::vector<uint8_t>{0, 255, 255, 255}));  // clamped
+  EXPECT_EQ(pixel(1, 2), (std::vector<uint8_t>{0, kScreenshotGamma[1], kScreenshotGamma[1], 255}));
+  EXPECT_EQ(pixel(4, 2), black);  // past the levels given
+}
+
+TEST(ScreenshotTest, QuantisesVideoLuma) {
+  // Y0 U Y1 V: black and white at studio range.
+  const uint8_t yuyv[] = {16, 128, 235, 128};
+  uint8_t levels[2];
+  YuyvToScreenshotLevels(yuyv, 2, 1, levels);
+  EXPECT_EQ(levels[0], 0);
+  EXPECT_EQ(levels[1], 15);
+}
+
+TEST(PngEncoderTest, RejectsBadInput) {
+  PngEncoder encoder;
+  uint8_t pixel[4] = {};
+  EXPECT_FALSE(encoder.Encode(pixel, 1, 1, 2));
+  EXPECT_FALSE(encoder.Encode(pixel, 0, 1, 4));
+}
+
+TEST(PngEncoderTest, WritesAValidHeader) {
+  PngEncoder encoder;
+  std::vector<uint8_t> rgb(7 * 3 * 3, 0x40);
+  ASSERT_TRUE(encoder.Encode(rgb.data(), 7, 3, 3));
+  EXPECT_LE(encoder.size(), PngMaxSize(7, 3, 3));
+
+  std::vector<Chunk> chunks = ReadChunks(encoder.data(), encoder.size());
+  ASSERT_EQ(chunks.size(), 3u);
+  EXPECT_EQ(chunks[0].type, "IHDR");
+  ASSERT_EQ(chunks[0].length, 13u);
+  EXPECT_EQ(BigEndian32(chunks[0].data), 7u);
+  EXPECT_EQ(BigEndian32(chunks[0].data + 4), 3u);
+  EXPECT_EQ(chunks[0].data[8], 8);  // bit depth
+  EXPECT_EQ(chunks[0].data[9], 2);  // RGB
+  EXPECT_EQ(chunks[1].type, "IDAT");
+  EXPECT_EQ(chunks[2].type, "IEND");
+  EXPECT_EQ(chunks[2].length, 0u);
+  // CRC-32 of "IEND".
+  EXPECT_EQ(chunks[2].crc, 0xAE426082u);
+}
+
+#ifdef USB_VIDEO_TEST_HAVE_ZLIB
+// Decodes what PngEncoder writes (Sub-filtered rows in one IDAT) with zlib.
+std::vector<uint8_t> DecodePng(const uint8_t* png, size_t size, int width, int height,
+                               int channels) {
+  std::vector<Chunk> chunks = ReadChunks(png, size);
+  std::vector<uint8_t> pixels;
+  for (const Chunk& chunk : chunks) {
+    std::vector<uint8_t> typed(chunk.type.begin(), chunk.type.end());
+    typed.insert(typed.end(), chunk.data, chunk.data + chunk.length);
+    EXPECT_EQ(crc32(0, typed.data(), typed.size()), chunk.crc) << chunk.type;
+    if (chunk.type != "IDAT") {
+      continue;
+    }
+    const size_t stride = static_cast<size_t>(width) * channels;
+    std::vector<uint8_t> filtered((stride + 1) * height);
+    uLongf filtered_size = filtered.size();
+    EXPECT_EQ(uncompress(filtered.data(), &filtered_size, chunk.data, chunk.length), Z_OK);
+    EXPECT_EQ(filtered_size, filtered.size());
+    for (int y = 0; y < height; ++y) {
+      const uint8_t* row = &filtered[y * (stride + 1)];
+      EXPECT_EQ(row[0], 1) << "Sub filter";
+      for (size_t x = 0; x < stride; ++x) {
+        uint8_t left = x >= static_cast<size_t>(channels) ? pixels[pixels.size() - channels] : 0;
+        pixels.push_back(static_cast<uint8_t>(row[1 + x] + left));
+      }
+    }
+  }
+  return pixels;
+}
+
+TEST(PngEncoderTest, RoundTripsNoise) {
+  const int width = 61;
+  const int height = 17;
+  std::mt19937 random(3);
+  std::vector<uint8_t> rgba(width * height * 4);
+  for (uint8_t& byte : rgba) {
+    byte = static_cast<uint8_t>(random() % 4);  // some matches, mostly literals
+  }
+  PngEncoder encoder;
+  ASSERT_TRUE(encoder.Encode(rgba.data(), width, height, 4));
+  EXPECT_LE(encoder.size(), PngMaxSize(width, height, 4));
+  EXPECT_EQ(DecodePng(encoder.data(), encoder.size(), width, height, 4), rgba);
+}
+
+TEST(PngEncoderTest, CompressesAScreenshot) {
+  // A blank display with a few lines of "text", like most screenshots.
+  std::vector<uint8_t> levels(256 * 64, 0);
+  for (int y = 10; y < 50; y += 8) {
+    for (int x = 20; x < 200; ++x) {
+      levels[y * 256 + x] = static_cast<uint8_t>((x / 3) % 16);
+    }
+  }
+  ScreenshotEncoder encoder;
+  ASSERT_TRUE(encoder.EncodeLevels(levels.data(), levels.size(), 256, 64));
+  const int width = 256 + 2 * kScreenshotBorder;
+  const int height = 64 + 2 * kScreenshotBorder;
+  EXPECT_LT(encoder.size(), static_cast<size_t>(width * height * 4) / 10);
+
+  std::vector<uint8_t> rgba(width * height * 4);
+  RenderScreenshot(levels.data(), levels.size(), 256, 64, kScreenshotBorder, rgba.data());
+  EXPECT_EQ(DecodePng(encoder.data(), encoder.size(), width, height, 4), rgba);
+}
+
+TEST(PngEncoderTest, HandlesRunsLongerThanTheLongestMatch) {
+  std::vector<uint8_t> rgb(1000 * 3, 9);
+  PngEncoder encoder;
+  ASSERT_TRUE(encoder.Encode(rgb.data(), 1000, 1, 3));
+  EXPECT_EQ(DecodePng(encoder.data(), encoder.size(), 1000, 1, 3), rgb);
+}
+#endif  // USB_VIDEO_TEST_HAVE_ZLIB
+
+TEST(ScreenshotFfiTest, EncodesLevelsAndFrames) {
+  std::vector<uint8_t> levels(256 * 64, 15);
+  uint8_t* png = nullptr;
+  int64_t size = nt_screenshot_encode_levels(levels.data(), levels.size(), 256, 64, &png);
+  ASSERT_GT(size, 0);
+  std::vector<Chunk> chunks = ReadChunks(png, size);
+  ASSERT_FALSE(chunks.empty());
+  EXPECT_EQ(BigEndian32(chunks[0].data), 256u + 2 * kScreenshotBorder);
+  EXPECT_EQ(BigEndian32(chunks[0].data + 4), 64u + 2 * kScreenshotBorder);
+  nt_screenshot_free(png);
+
+  std::vector<uint8_t> yuyv(256 * 64 * 2, 128);
+  EXPECT_EQ(nt_screenshot_encode_yuyv(yuyv.data(), yuyv.size() - 1, 256, 64, &png), 0);
+  size = nt_screenshot_encode_yuyv(yuyv.data(), yuyv.size(), 256, 64, &png);
+  ASSERT_GT(size, 0);
+  nt_screenshot_free(png);
+}
+
+}  // namespace
+}  // namespace usb_video
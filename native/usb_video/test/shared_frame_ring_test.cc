@@ -0,0 +1,203 @@
+#include "shared_frame_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "tools/shared_frame_reader.h"
+
+namespace usb_video {
+namespace {
+
+const int kWidth = 16;
+const int kHeight = 4;
+const size_t kFrameBytes = kWidth * kHeight * 2;
+
+// Unique per test process, so parallel ctest runs do not collide.
+std::string TestName() {
+  return "/usb_video_test_" + std::to_string(getpid());
+}
+
+std::vector<uint8_t> Frame(uint8_t value) {
+  return std::vector<uint8_t>(kFrameBytes, value);
+}
+
+TEST(SharedFrameRingTest, ReaderSeesTheGeometry) {
+  SharedFrameRing ring;
+  ASSERT_TRUE(ring.Create(TestName(), kWidth, kHeight, 3)) << ring.error();
+  EXPECT_EQ(ring.frame_size(), kFrameBytes);
+
+  ntv_shm_reader* reader = nullptr;
+  ASSERT_EQ(ntv_shm_reader_open(TestName().c_str(), &reader), 0);
+  const ntv_shm_header* header = ntv_shm_reader_header(reader);
+  EXPECT_EQ(header->width, static_cast<uint32_t>(kWidth));
+  EXPECT_EQ(header->height, static_cast<uint32_t>(kHeight));
+  EXPECT_EQ(header->slot_count, 3u);
+  EXPECT_EQ(header->frame_size, kFrameBytes);
+  EXPECT_EQ(header->fourcc, NTV_SHM_FOURCC_YUYV);
+  EXPECT_EQ(header->writer_pid, static_cast<uint32_t>(getpid()));
+  EXPECT_EQ(header->slot_stride % NTV_SHM_ALIGNMENT, 0u);
+
+  ntv_shm_frame frame;
+  EXPECT_EQ(ntv_shm_reader_peek(reader, 0, &frame), NTV_SHM_NONE);
+  ntv_shm_reader_close(reader);
+}
+
+TEST(SharedFrameRingTest, RejectsBadNames) {
+  SharedFrameRing ring;
+  EXPECT_FALSE(ring.Create("no_slash", kWidth, kHeight));
+  EXPECT_FALSE(ring.Create("/two/slashes", kWidth, kHeight));
+  EXPECT_FALSE(ring.Create(TestName(), kWidth, kHeight, 1));
+  EXPECT_FALSE(ring.is_open());
+}
+
+TEST(SharedFrameRingTest, ReadsTheNewestFrameInPlace) {
+  SharedFrameRing ring;
+  ASSERT_TRUE(ring.Create(TestName(), kWidth, kHeight)) << ring.error();
+  ntv_shm_reader* reader = nullptr;
+  ASSERT_EQ(ntv_shm_reader_open(TestName().c_str(), &reader), 0);
+
+  std::vector<uint8_t> first = Frame(1);
+  std::vector<uint8_t> second = Frame(2);
+  ring.Publish(first.data(), first.size(), 1000, 7);
+  ring.Publish(second.data(), second.size(), 2000, 8);
+  EXPECT_EQ(ring.frames_published(), 2u);
+
+  ntv_shm_frame frame;
+  ASSERT_EQ(ntv_shm_reader_peek(reader, 0, &frame), NTV_SHM_FRAME);
+  EXPECT_EQ(frame.frame_number, 2u);
+  EXPECT_EQ(frame.timestamp_us, 2000);
+  EXPECT_EQ(frame.sequence, 8u);
+  EXPECT_EQ(frame.size, kFrameBytes);
+  EXPECT_EQ(memcmp(frame.data, second.data(), kFrameBytes), 0);
+  EXPECT_TRUE(ntv_shm_reader_valid(reader, &frame));
+
+  // Nothing newer than what was already read.
+  EXPECT_EQ(ntv_shm_reader_peek(reader, 2, &frame), NTV_SHM_NONE);
+  ntv_shm_reader_close(reader);
+}
+
+TEST(SharedFrameRingTest, OverwrittenFramesAreInvalid) {
+  SharedFrameRing ring;
+  ASSERT_TRUE(ring.Create(TestName(), kWidth, kHeight, 2)) << ring.error();
+  ntv_shm_reader* reader = nullptr;
+  ASSERT_EQ(ntv_shm_reader_open(TestName().c_str(), &reader), 0);
+
+  std::vector<uint8_t> data = Frame(1);
+  ring.Publish(data.data(), data.size(), 0, 0);
+  ntv_shm_frame frame;
+  ASSERT_EQ(ntv_shm_reader_peek(reader, 0, &frame), NTV_SHM_FRAME);
+  ASSERT_EQ(frame.frame_number, 1u);
+
+  // Frame 2 takes the other slot; frame 3 reuses frame 1's.
+  ring.Publish(data.data(), data.size(), 0, 0);
+  EXPECT_TRUE(ntv_shm_reader_valid(reader, &frame));
+  ring.Publish(data.data(), data.size(), 0, 0);
+  EXPECT_FALSE(ntv_shm_reader_valid(reader, &frame));
+  ntv_shm_reader_close(reader);
+}
+
+TEST(SharedFrameRingTest, CopiesAndCutsLongFrames) {
+  SharedFrameRing ring;
+  ASSERT_TRUE(ring.Create(TestName(), kWidth, kHeight)) << ring.error();
+  ntv_shm_reader* reader = nullptr;
+  ASSERT_EQ(ntv_shm_reader_open(TestName().c_str(), &reader), 0);
+
+  std::vector<uint8_t> data(kFrameBytes + 100, 9);
+  ring.Publish(data.data(), data.size(), 0, 0);
+  std::vector<uint8_t> buffer(kFrameBytes);
+  ntv_shm_frame frame;
+  ASSERT_EQ(ntv_shm_reader_copy(reader, 0, buffer.data(), buffer.size(), &frame),
+            NTV_SHM_FRAME);
+  EXPECT_EQ(frame.size, kFrameBytes);
+  EXPECT_EQ(frame.data, buffer.data());
+  EXPECT_EQ(buffer, Frame(9));
+  ntv_shm_reader_close(reader);
+}
+
+TEST(SharedFrameRingTest, ReadersSeeTheWriterClose) {
+  SharedFrameRing ring;
+  ASSERT_TRUE(ring.Create(TestName(), kWidth, kHeight)) << ring.error();
+  ntv_shm_reader* reader = nullptr;
+  ASSERT_EQ(ntv_shm_reader_open(TestName().c_str(), &reader), 0);
+  EXPECT_FALSE(ntv_shm_reader_closed(reader));
+
+  ring.Close();
+  EXPECT_TRUE(ntv_shm_reader_closed(reader));
+  ntv_shm_reader_close(reader);
+
+  // The name went with it.
+  EXPECT_EQ(ntv_shm_reader_open(TestName().c_str(), &reader), ENOENT);
+}
+
+TEST(SharedFrameRingTest, ReaderRejectsObjectsThatAreNotRings) {
+  ntv_shm_reader* reader = nullptr;
+  const std::string name = TestName();
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+  ASSERT_NE(fd, -1);
+  ASSERT_EQ(ftruncate(fd, 4096), 0);
+  close(fd);
+  EXPECT_EQ(ntv_shm_reader_open(name.c_str(), &reader), EPROTO);
+  shm_unlink(name.c_str());
+}
+
+// Every frame is filled with one byte value, so a reader that trusts a
+// torn frame sees mixed values.
+TEST(SharedFrameRingTest, ValidatedReadsAreNeverTorn) {
+  SharedFrameRing ring;
+  ASSERT_TRUE(ring.Create(TestName(), kWidth, kHeight, 2)) << ring.error();
+  ntv_shm_reader* reader = nullptr;
+  ASSERT_EQ(ntv_shm_reader_open(TestName().c_str(), &reader), 0);
+
+  std::atomic<bool> done(false);
+  std::thread writer([&ring, &done] {
+    std::vector<uint8_t> data(kFrameBytes);
+    for (int i = 1; i <= 200000; ++i) {
+      memset(data.data(), i & 0xFF, data.size());
+      ring.Publish(data.data(), data.size(), i, static_cast<uint32_t>(i));
+    }
+    done = true;
+  });
+
+  uint64_t valid = 0;
+  uint64_t torn = 0;
+  uint64_t last = 0;
+  std::vector<uint8_t> copy(kFrameBytes);
+  // One last pass after the writer finishes, so there is always a frame.
+  for (bool finished = false; !finished;) {
+    finished = done;
+    ntv_shm_frame frame;
+    if (ntv_shm_reader_peek(reader, last, &frame) != NTV_SHM_FRAME) {
+      continue;
+    }
+    memcpy(copy.data(), frame.data, frame.size);
+    if (!ntv_shm_reader_valid(reader, &frame)) {
+      continue;
+    }
+    valid++;
+    last = frame.frame_number;
+    const uint8_t expected = static_cast<uint8_t>(frame.frame_number);
+    for (uint8_t byte : copy) {
+      if (byte != expected) {
+        torn++;
+        break;
+      }
+    }
+  }
+  writer.join();
+  EXPECT_GT(valid, 0u);
+  EXPECT_EQ(torn, 0u);
+  ntv_shm_reader_close(reader);
+}
+
+}  // namespace
+}  // namespace usb_video
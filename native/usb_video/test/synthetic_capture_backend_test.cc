@@ -0,0 +1,284 @@
+#include "synthetic_capture_backend.h"
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "recording_writer.h"
+
+namespace usb_video {
+namespace {
+
+const int kWidth = 256;
+const int kHeight = 64;
+
+std::vector<uint8_t> Take(CaptureBackend* backend, CapturedFrame* frame) {
+  CaptureBackend::Result result;
+  do {
+    result = backend->Next(frame);
+  } while (result == CaptureBackend::kRetry);
+  EXPECT_EQ(result, CaptureBackend::kFrame);
+  if (result != CaptureBackend::kFrame) {
+    return std::vector<uint8_t>();
+  }
+  std::vector<uint8_t> bytes(frame->data, frame->data + frame->size);
+  EXPECT_TRUE(backend->Release(*frame));
+  return bytes;
+}
+
+SyntheticCaptureBackend::Options Unpaced(SyntheticCaptureBackend::Pattern pattern) {
+  SyntheticCaptureBackend::Options options;
+  options.fps = 0;
+  options.pattern = pattern;
+  return options;
+}
+
+TEST(SyntheticCaptureBackendTest, ParsesSpecs) {
+  SyntheticCaptureBackend::Options options;
+  ASSERT_TRUE(SyntheticCaptureBackend::ParseOptions(
+      "fps=30,jitter=2000,pattern=noise,hold=3,seed=9", &options));
+  EXPECT_DOUBLE_EQ(options.fps, 30.0);
+  EXPECT_EQ(options.jitter_us, 2000);
+  EXPECT_EQ(options.pattern, SyntheticCaptureBackend::kNoise);
+  EXPECT_EQ(options.bar_hold_frames, 3);
+  EXPECT_EQ(options.seed, 9u);
+  ASSERT_TRUE(SyntheticCaptureBackend::ParseOptions("replay=/tmp/a.ntrec", &options));
+  EXPECT_EQ(options.replay_path, "/tmp/a.ntrec");
+  // Earlier settings survive a spec that does not mention them.
+  EXPECT_DOUBLE_EQ(options.fps, 30.0);
+  EXPECT_TRUE(SyntheticCaptureBackend::ParseOptions("", &options));
+
+  for (const char* bad : {"fps", "fps=fast", "jitter=-1", "pattern=plaid", "hold=0",
+                          "colour=red", "replay="}) {
+    EXPECT_FALSE(SyntheticCaptureBackend::ParseOptions(bad, &options)) << bad;
+  }
+}
+
+TEST(SyntheticCaptureBackendTest, MovingBarStepsEveryHoldFrames) {
+  SyntheticCaptureBackend::Options options = Unpaced(SyntheticCaptureBackend::kMovingBar);
+  options.bar_hold_frames = 2;
+  SyntheticCaptureBackend backend(options);
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+  EXPECT_EQ(backend.width(), kWidth);
+  EXPECT_EQ(backend.height(), kHeight);
+
+  CapturedFrame frame;
+  std::vector<uint8_t> frames[4];
+  for (int n = 0; n < 4; ++n) {
+    frames[n] = Take(&backend, &frame);
+    ASSERT_EQ(frames[n].size(), backend.frame_size());
+    EXPECT_EQ(frame.sequence, static_cast<uint32_t>(n));
+    EXPECT_GT(frame.timestamp_us, 0);
+  }
+  EXPECT_EQ(frames[0], frames[1]);
+  EXPECT_NE(frames[1], frames[2]);
+  EXPECT_EQ(frames[2], frames[3]);
+}
+
+TEST(SyntheticCaptureBackendTest, StaticAndNoisePatterns) {
+  CapturedFrame frame;
+  SyntheticCaptureBackend still(Unpaced(SyntheticCaptureBackend::kStatic));
+  ASSERT_TRUE(still.Start(kWidth, kHeight));
+  std::vector<uint8_t> first = Take(&still, &frame);
+  EXPECT_EQ(Take(&still, &frame), first);
+
+  SyntheticCaptureBackend noise(Unpaced(SyntheticCaptureBackend::kNoise));
+  ASSERT_TRUE(noise.Start(kWidth, kHeight));
+  first = Take(&noise, &frame);
+  EXPECT_NE(Take(&noise, &frame), first);
+}
+
+TEST(SyntheticCaptureBackendTest, PacesFramesAtTheRequestedRate) {
+  SyntheticCaptureBackend::Options options;
+  options.fps = 200;
+  SyntheticCaptureBackend backend(options);
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+
+  CapturedFrame frame;
+  const auto start = std::chrono::steady_clock::now();
+  int64_t first_us = 0;
+  for (int n = 0; n < 11; ++n) {
+    Take(&backend, &frame);
+    if (n == 0) {
+      first_us = frame.timestamp_us;
+    }
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  // Ten 5 ms periods or more, stamped exactly on schedule without jitter.
+  // A stall longer than the driver queue drops frames, hence the sequence.
+  EXPECT_GE(elapsed, std::chrono::milliseconds(45));
+  EXPECT_GE(frame.sequence, 10u);
+  EXPECT_NEAR(frame.timestamp_us - first_us, frame.sequence * 5000.0, 2);
+}
+
+TEST(SyntheticCaptureBackendTest, JitterStaysWithinBounds) {
+  SyntheticCaptureBackend::Options options;
+  options.fps = 500;
+  options.jitter_us = 300;
+  SyntheticCaptureBackend backend(options);
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+
+  CapturedFrame frame;
+  Take(&backend, &frame);
+  // Frame 0 is due at the start time, give or take the jitter.
+  const int64_t origin = frame.timestamp_us;
+  bool varied = false;
+  for (int n = 1; n < 30; ++n) {
+    Take(&backend, &frame);
+    const int64_t offset = frame.timestamp_us - origin - frame.sequence * 2000;
+    EXPECT_LE(offset, 600) << n;
+    EXPECT_GE(offset, -600) << n;
+    varied = varied || (offset != 0);
+  }
+  EXPECT_TRUE(varied);
+}
+
+TEST(SyntheticCaptureBackendTest, SlowConsumersLoseFramesLikeADriver) {
+  SyntheticCaptureBackend::Options options;
+  options.fps = 1000;
+  SyntheticCaptureBackend backend(options);
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+
+  CapturedFrame frame;
+  Take(&backend, &frame);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  Take(&backend, &frame);
+  // About 50 periods went by. The oldest of the queued frames comes next,
+  // and everything between it and frame 0 is gone.
+  EXPECT_GT(frame.sequence, 40u);
+  EXPECT_EQ(backend.frames_dropped(), frame.sequence - 1);
+  Take(&backend, &frame);
+  EXPECT_EQ(backend.frames_dropped(), frame.sequence - 2);
+}
+
+TEST(SyntheticCaptureBackendTest, SwitchesBetweenOfferedRates) {
+  SyntheticCaptureBackend::Options options;
+  options.fps = 400;
+  SyntheticCaptureBackend backend(options);
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+  ASSERT_EQ(backend.frame_intervals().size(), 4u);
+  EXPECT_DOUBLE_EQ(backend.frame_intervals()[0].fps(), 400.0);
+  EXPECT_DOUBLE_EQ(backend.frame_intervals()[3].fps(), 50.0);
+  EXPECT_EQ(backend.frame_interval(), backend.frame_intervals()[0]);
+
+  CapturedFrame frame;
+  Take(&backend, &frame);
+  const FrameInterval slower = backend.frame_intervals()[1];
+  ASSERT_TRUE(backend.SetFrameInterval(slower));
+  EXPECT_EQ(backend.frame_interval(), slower);
+
+  // Sequence numbers carry on; the spacing is now 5 ms.
+  Take(&backend, &frame);
+  const uint32_t first_sequence = frame.sequence;
+  const int64_t first_us = frame.timestamp_us;
+  EXPECT_EQ(first_sequence, 1u);
+  for (int n = 0; n < 5; ++n) {
+    Take(&backend, &frame);
+  }
+  EXPECT_NEAR(frame.timestamp_us - first_us,
+              (frame.sequence - first_sequence) * 5000.0, 2);
+
+  backend.Stop();
+  EXPECT_TRUE(backend.frame_intervals().empty());
+  EXPECT_FALSE(backend.SetFrameInterval(slower));
+}
+
+TEST(SyntheticCaptureBackendTest, UnpacedSourcesOfferNoRates) {
+  SyntheticCaptureBackend backend(Unpaced(SyntheticCaptureBackend::kStatic));
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+  EXPECT_TRUE(backend.frame_intervals().empty());
+  EXPECT_FALSE(backend.SetFrameInterval(FrameInterval{1, 30}));
+}
+
+TEST(SyntheticCaptureBackendTest, PausedSourcesWaitForAWake) {
+  SyntheticCaptureBackend::Options options;
+  options.fps = 1000;
+  SyntheticCaptureBackend backend(options);
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+  CapturedFrame frame;
+  Take(&backend, &frame);
+
+  ASSERT_TRUE(backend.Pause());
+  EXPECT_TRUE(backend.paused());
+  std::thread waker([&backend] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    backend.Wake();
+  });
+  EXPECT_EQ(backend.Next(&frame), CaptureBackend::kWoken);
+  waker.join();
+
+  // Thirty periods went by while paused, but none of them count as drops.
+  ASSERT_TRUE(backend.Resume());
+  EXPECT_FALSE(backend.paused());
+  Take(&backend, &frame);
+  EXPECT_EQ(frame.sequence, 1u);
+  EXPECT_EQ(backend.frames_dropped(), 0u);
+}
+
+TEST(SyntheticCaptureBackendTest, WakeInterruptsAWaitingNext) {
+  SyntheticCaptureBackend::Options options;
+  options.fps = 0.2;
+  SyntheticCaptureBackend backend(options);
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+  CapturedFrame frame;
+  Take(&backend, &frame);
+
+  // The next frame is five seconds away.
+  std::thread waker([&backend] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    backend.Wake();
+  });
+  const auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(backend.Next(&frame), CaptureBackend::kWoken);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+  waker.join();
+
+  // A wake with nobody waiting is kept for the next call.
+  backend.Wake();
+  EXPECT_EQ(backend.Next(&frame), CaptureBackend::kWoken);
+}
+
+TEST(SyntheticCaptureBackendTest, ReplaysAndLoopsRecordings) {
+  char path[] = "/tmp/synthetic_replay_XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_NE(fd, -1);
+  close(fd);
+
+  std::vector<std::vector<uint8_t>> recorded;
+  {
+    RecordingWriter writer;
+    ASSERT_TRUE(writer.Open(path, kRecordingYuyv, kWidth, 32, 2, 8));
+    for (int n = 0; n < 5; ++n) {
+      std::vector<uint8_t> yuyv(kWidth * 32 * 2, static_cast<uint8_t>(40 + n * 30));
+      recorded.push_back(yuyv);
+      ASSERT_TRUE(writer.Submit(yuyv.data(), yuyv.size(), n * 1000, n));
+    }
+    ASSERT_TRUE(writer.Close());
+  }
+
+  SyntheticCaptureBackend::Options options = Unpaced(SyntheticCaptureBackend::kMovingBar);
+  options.replay_path = path;
+  SyntheticCaptureBackend backend(options);
+  // The recording's size wins over the one asked for.
+  ASSERT_TRUE(backend.Start(kWidth, kHeight));
+  EXPECT_EQ(backend.height(), 32);
+  CapturedFrame frame;
+  for (int n = 0; n < 12; ++n) {
+    EXPECT_EQ(Take(&backend, &frame), recorded[n % 5]) << n;
+  }
+  backend.Stop();
+  std::remove(path);
+
+  SyntheticCaptureBackend missing(options);
+  EXPECT_FALSE(missing.Start(kWidth, kHeight));
+  EXPECT_FALSE(missing.error().empty());
+}
+
+}  // namespace
+}  // namespace usb_video
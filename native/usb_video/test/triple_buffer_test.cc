@@ -0,0 +1,118 @@
+#include "triple_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace usb_video {
+namespace {
+
+TEST(TripleBufferTest, NothingToTakeBeforeFirstPublish) {
+  TripleBuffer<int> buffer;
+  EXPECT_FALSE(buffer.TakeLatest());
+  EXPECT_EQ(buffer.delivered(), 0u);
+}
+
+TEST(TripleBufferTest, DeliversPublishedValueOnce) {
+  TripleBuffer<int> buffer;
+  buffer.write_slot() = 7;
+  buffer.Publish();
+
+  ASSERT_TRUE(buffer.TakeLatest());
+  EXPECT_EQ(buffer.read_slot(), 7);
+  EXPECT_FALSE(buffer.TakeLatest());
+  EXPECT_EQ(buffer.read_slot(), 7);
+  EXPECT_EQ(buffer.produced(), 1u);
+  EXPECT_EQ(buffer.delivered(), 1u);
+  EXPECT_EQ(buffer.overwritten(), 0u);
+}
+
+TEST(TripleBufferTest, LatestValueWins) {
+  TripleBuffer<int> buffer;
+  for (int i = 1; i <= 5; ++i) {
+    buffer.write_slot() = i;
+    buffer.Publish();
+  }
+
+  ASSERT_TRUE(buffer.TakeLatest());
+  EXPECT_EQ(buffer.read_slot(), 5);
+  EXPECT_EQ(buffer.produced(), 5u);
+  EXPECT_EQ(buffer.delivered(), 1u);
+  EXPECT_EQ(buffer.overwritten(), 4u);
+}
+
+TEST(TripleBufferTest, ProducerNeverWritesTheSlotBeingRead) {
+  TripleBuffer<int> buffer;
+  buffer.write_slot() = 1;
+  buffer.Publish();
+  ASSERT_TRUE(buffer.TakeLatest());
+  const int* reading = &buffer.read_slot();
+
+  for (int i = 2; i < 10; ++i) {
+    EXPECT_NE(&buffer.write_slot(), reading);
+    buffer.write_slot() = i;
+    buffer.Publish();
+  }
+  EXPECT_EQ(*reading, 1);
+}
+
+TEST(TripleBufferTest, ResetDropsPendingFrameAndPreparesSlots) {
+  TripleBuffer<std::vector<int>> buffer;
+  buffer.write_slot().assign(1, 3);
+  buffer.Publish();
+
+  buffer.Reset([](std::vector<int>& slot) { slot.assign(16, 0); });
+  EXPECT_FALSE(buffer.TakeLatest());
+  EXPECT_EQ(buffer.produced(), 0u);
+  EXPECT_EQ(buffer.write_slot().size(), 16u);
+  EXPECT_EQ(buffer.read_slot().size(), 16u);
+}
+
+// One producer and one consumer hammering the buffer: values must arrive in
+// order, intact, and every frame must be accounted for exactly once.
+TEST(TripleBufferTest, ConcurrentProducerAndConsumer) {
+  struct Frame {
+    uint64_t sequence;
+    uint64_t check;
+  };
+  TripleBuffer<Frame> buffer;
+  const uint64_t kFrames = 200000;
+  std::atomic<bool> done(false);
+
+  std::thread producer([&] {
+    for (uint64_t i = 1; i <= kFrames; ++i) {
+      Frame& frame = buffer.write_slot();
+      frame.sequence = i;
+      frame.check = ~i;
+      buffer.Publish();
+    }
+    done = true;
+  });
+
+  uint64_t last = 0;
+  bool ordered = true;
+  bool intact = true;
+  while (true) {
+    const bool finished = done.load();
+    if (buffer.TakeLatest()) {
+      const Frame& frame = buffer.read_slot();
+      ordered &= frame.sequence > last;
+      intact &= frame.check == ~frame.sequence;
+      last = frame.sequence;
+    } else if (finished) {
+      break;
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(intact);
+  EXPECT_EQ(last, kFrames);
+  EXPECT_EQ(buffer.produced(), kFrames);
+  EXPECT_EQ(buffer.delivered() + buffer.overwritten(), kFrames);
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,157 @@
+#include "yuyv_convert.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace usb_video {
+namespace {
+
+// The conversion loop the Linux plugin shipped before the kernels existed,
+// kept verbatim as the bit-exactness oracle.
+void LegacyConvert(const uint8_t* yuyv, size_t yuyv_size, uint8_t* out,
+                   size_t stride) {
+  for (size_t i = 0, j = 0; i < yuyv_size; i += 4, j += stride * 2) {
+    int y0 = yuyv[i];
+    int u = yuyv[i + 1];
+    int y1 = yuyv[i + 2];
+    int v = yuyv[i + 3];
+
+    int c = y0 - 16;
+    int d = u - 128;
+    int e = v - 128;
+
+    out[j] = std::min(255, std::max(0, (298 * c + 409 * e + 128) >> 8));
+    out[j + 1] =
+        std::min(255, std::max(0, (298 * c - 100 * d - 208 * e + 128) >> 8));
+    out[j + 2] = std::min(255, std::max(0, (298 * c + 516 * d + 128) >> 8));
+
+    c = y1 - 16;
+    out[j + stride] = std::min(255, std::max(0, (298 * c + 409 * e + 128) >> 8));
+    out[j + stride + 1] =
+        std::min(255, std::max(0, (298 * c - 100 * d - 208 * e + 128) >> 8));
+    out[j + stride + 2] =
+        std::min(255, std::max(0, (298 * c + 516 * d + 128) >> 8));
+    if (stride == 4) {
+      out[j + 3] = 0xFF;
+      out[j + stride + 3] = 0xFF;
+    }
+  }
+}
+
+std::vector<const YuyvKernel*> Kernels() {
+  const YuyvKernel* kernels[8];
+  size_t count = AvailableYuyvKernels(kernels, 8);
+  return std::vector<const YuyvKernel*>(kernels, kernels + std::min<size_t>(count, 8));
+}
+
+// Converts with |fn| into a buffer with guard bytes on both sides and checks
+// the guards survived, catching the overlapping-store kernels writing past
+// the end.
+std::vector<uint8_t> ConvertGuarded(YuyvConvertFn fn,
+                                    const std::vector<uint8_t>& yuyv,
+                                    size_t stride) {
+  const size_t pixels = yuyv.size() / 2;
+  const size_t guard = 64;
+  std::vector<uint8_t> buffer(pixels * stride + guard * 2, 0xA5);
+  fn(yuyv.data(), pixels, buffer.data() + guard);
+  for (size_t i = 0; i < guard; ++i) {
+    EXPECT_EQ(buffer[i], 0xA5) << "underrun at " << i;
+    EXPECT_EQ(buffer[buffer.size() - 1 - i], 0xA5) << "overrun at " << i;
+  }
+  return std::vector<uint8_t>(buffer.begin() + guard, buffer.end() - guard);
+}
+
+std::vector<uint8_t> LegacyOutput(const std::vector<uint8_t>& yuyv,
+                                  size_t stride) {
+  std::vector<uint8_t> out(yuyv.size() / 2 * stride);
+  LegacyConvert(yuyv.data(), yuyv.size(), out.data(), stride);
+  return out;
+}
+
+TEST(YuyvConvertTest, ScalarKernelIsAlwaysAvailable) {
+  auto kernels = Kernels();
+  ASSERT_FALSE(kernels.empty());
+  EXPECT_EQ(std::string(kernels[0]->name), "scalar");
+}
+
+TEST(YuyvConvertTest, ActiveKernelIsAnAvailableKernel) {
+  const YuyvKernel& active = ActiveYuyvKernel();
+  bool found = false;
+  for (const YuyvKernel* kernel : Kernels()) {
+    found |= kernel == &active;
+  }
+  EXPECT_TRUE(found) << active.name;
+}
+
+// Every (Y, U, V) combination: 256 pixels per (U, V) pair, one per Y value,
+// each macropixel pairing Y with its bitwise complement.
+TEST(YuyvConvertTest, AllKernelsBitExactOverEveryInput) {
+  std::vector<uint8_t> yuyv(256 * 2 * 256 * 256);
+  size_t i = 0;
+  for (int u = 0; u < 256; ++u) {
+    for (int v = 0; v < 256; ++v) {
+      for (int y = 0; y < 256; y += 2) {
+        yuyv[i++] = static_cast<uint8_t>(y);
+        yuyv[i++] = static_cast<uint8_t>(u);
+        yuyv[i++] = static_cast<uint8_t>(255 - y);
+        yuyv[i++] = static_cast<uint8_t>(v);
+      }
+    }
+  }
+  for (size_t stride : {3u, 4u}) {
+    const std::vector<uint8_t> expected = LegacyOutput(yuyv, stride);
+    for (const YuyvKernel* kernel : Kernels()) {
+      SCOPED_TRACE(kernel->name);
+      std::vector<uint8_t> actual(expected.size());
+      (stride == 3 ? kernel->to_rgb24 : kernel->to_rgba)(
+          yuyv.data(), yuyv.size() / 2, actual.data());
+      EXPECT_TRUE(actual == expected) << "stride " << stride;
+    }
+  }
+}
+
+// Sizes around every kernel's vector width exercise the scalar tails and the
+// overlapping stores.
+TEST(YuyvConvertTest, AllKernelsBitExactForOddLengths) {
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> byte(0, 255);
+  for (size_t pixels = 0; pixels <= 72; pixels += 2) {
+    std::vector<uint8_t> yuyv(pixels * 2);
+    for (auto& b : yuyv) b = static_cast<uint8_t>(byte(rng));
+    for (size_t stride : {3u, 4u}) {
+      const std::vector<uint8_t> expected = LegacyOutput(yuyv, stride);
+      for (const YuyvKernel* kernel : Kernels()) {
+        SCOPED_TRACE(std::string(kernel->name) + " pixels=" +
+                     std::to_string(pixels) + " stride=" +
+                     std::to_string(stride));
+        EXPECT_EQ(ConvertGuarded(stride == 3 ? kernel->to_rgb24
+                                             : kernel->to_rgba,
+                                 yuyv, stride),
+                  expected);
+      }
+    }
+  }
+}
+
+TEST(YuyvConvertTest, DistingFrameMatchesLegacyConversion) {
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> byte(0, 255);
+  std::vector<uint8_t> yuyv(256 * 64 * 2);
+  for (auto& b : yuyv) b = static_cast<uint8_t>(byte(rng));
+
+  std::vector<uint8_t> rgb(256 * 64 * 3);
+  ConvertYuyvToRgb24(yuyv.data(), 256 * 64, rgb.data());
+  EXPECT_EQ(rgb, LegacyOutput(yuyv, 3));
+
+  std::vector<uint8_t> rgba(256 * 64 * 4);
+  ConvertYuyvToRgba(yuyv.data(), 256 * 64, rgba.data());
+  EXPECT_EQ(rgba, LegacyOutput(yuyv, 4));
+}
+
+}  // namespace
+}  // namespace usb_video
@@ -0,0 +1,126 @@
+/*
+ * Follows a shared-memory frame export with the reference reader and
+ * reports what arrives, optionally saving the luma of the last frame as a
+ * PGM. Example:
+ *
+ *   usb_video_shared_frame_dump                       # the default name
+ *   usb_video_shared_frame_dump --name=/nt_helper_video --frames=300 \
+ *       --pgm=display.pgm
+ *
+ * Exits once it has read --frames frames, or when the writer stops.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "shared_frame_reader.h"
+
+/* Polling period while no new frame is ready. */
+#define POLL_INTERVAL_NS 2000000L
+
+static int64_t now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* Y0 U Y1 V: the luma is every other byte. */
+static int write_pgm(const char* path, const struct ntv_shm_header* header,
+                     const uint8_t* yuyv) {
+  size_t pixels = (size_t)header->width * header->height;
+  size_t i;
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    return 0;
+  }
+  fprintf(file, "P5\n%u %u\n255\n", header->width, header->height);
+  for (i = 0; i < pixels; ++i) {
+    fputc(yuyv[i * 2], file);
+  }
+  return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+  const char* name = NTV_SHM_DEFAULT_NAME;
+  const char* pgm_path = NULL;
+  uint64_t max_frames = 0;
+  struct ntv_shm_reader* reader;
+  const struct ntv_shm_header* header;
+  struct ntv_shm_frame frame;
+  struct timespec pause = {0, POLL_INTERVAL_NS};
+  uint8_t* buffer;
+  uint64_t last = 0;
+  uint64_t frames = 0;
+  uint64_t skipped = 0;
+  uint64_t overtaken = 0;
+  int64_t latency_total_us = 0;
+  int error;
+  int i;
+
+  for (i = 1; i < argc; ++i) {
+    if (strncmp(argv[i], "--name=", 7) == 0) {
+      name = argv[i] + 7;
+    } else if (strncmp(argv[i], "--frames=", 9) == 0) {
+      max_frames = strtoull(argv[i] + 9, NULL, 10);
+    } else if (strncmp(argv[i], "--pgm=", 6) == 0) {
+      pgm_path = argv[i] + 6;
+    } else {
+      fprintf(stderr, "usage: %s [--name=/shm-name] [--frames=N] [--pgm=file]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  error = ntv_shm_reader_open(name, &reader);
+  if (error != 0) {
+    fprintf(stderr, "cannot open %s: %s\n", name, strerror(error));
+    return 1;
+  }
+  header = ntv_shm_reader_header(reader);
+  printf("%s: %ux%u, %u slots of %u bytes, writer pid %u\n", name, header->width,
+         header->height, header->slot_count, header->frame_size, header->writer_pid);
+  buffer = (uint8_t*)malloc(header->frame_size);
+  if (buffer == NULL) {
+    ntv_shm_reader_close(reader);
+    return 1;
+  }
+
+  while (max_frames == 0 || frames < max_frames) {
+    enum ntv_shm_status status =
+        ntv_shm_reader_copy(reader, last, buffer, header->frame_size, &frame);
+    if (status == NTV_SHM_BUSY) {
+      overtaken++;
+      continue;
+    }
+    if (status == NTV_SHM_NONE) {
+      if (ntv_shm_reader_closed(reader)) {
+        printf("writer stopped\n");
+        break;
+      }
+      nanosleep(&pause, NULL);
+      continue;
+    }
+    if (last != 0) {
+      skipped += frame.frame_number - last - 1;
+    }
+    last = frame.frame_number;
+    frames++;
+    latency_total_us += now_us() - frame.timestamp_us;
+  }
+
+  printf("%llu frames read, %llu skipped, %llu reads overtaken",
+         (unsigned long long)frames, (unsigned long long)skipped,
+         (unsigned long long)overtaken);
+  if (frames != 0) {
+    printf(", mean age %lld us", (long long)(latency_total_us / (int64_t)frames));
+  }
+  printf("\n");
+  if (pgm_path != NULL && frames != 0 && !write_pgm(pgm_path, header, buffer)) {
+    fprintf(stderr, "cannot write %s: %s\n", pgm_path, strerror(errno));
+  }
+  free(buffer);
+  ntv_shm_reader_close(reader);
+  return 0;
+}
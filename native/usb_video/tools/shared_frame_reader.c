@@ -0,0 +1,141 @@
+#include "shared_frame_reader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* How often ntv_shm_reader_copy() tries again after being overtaken. */
+#define NTV_SHM_COPY_ATTEMPTS 4
+
+struct ntv_shm_reader {
+  const struct ntv_shm_header* header;
+  const uint8_t* slots;
+  size_t mapped_size;
+};
+
+int ntv_shm_reader_open(const char* name, struct ntv_shm_reader** reader) {
+  struct stat st;
+  const struct ntv_shm_header* header;
+  void* mapping;
+  int error;
+  int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+  if (fd == -1) {
+    return errno;
+  }
+  if (fstat(fd, &st) == -1) {
+    error = errno;
+    close(fd);
+    return error;
+  }
+  if ((size_t)st.st_size < sizeof(struct ntv_shm_header)) {
+    close(fd);
+    return EPROTO;
+  }
+  mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  error = errno;
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    return error;
+  }
+
+  /* Check everything the accessors rely on before handing it out. */
+  header = (const struct ntv_shm_header*)mapping;
+  if (memcmp(header->magic, NTV_SHM_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != NTV_SHM_VERSION || header->slot_count == 0 ||
+      header->header_size < sizeof(struct ntv_shm_header) ||
+      header->slot_stride < sizeof(struct ntv_shm_slot) + header->frame_size ||
+      (uint64_t)header->header_size +
+              (uint64_t)header->slot_stride * header->slot_count >
+          (uint64_t)st.st_size) {
+    munmap(mapping, (size_t)st.st_size);
+    return EPROTO;
+  }
+
+  *reader = (struct ntv_shm_reader*)malloc(sizeof(struct ntv_shm_reader));
+  if (*reader == NULL) {
+    munmap(mapping, (size_t)st.st_size);
+    return ENOMEM;
+  }
+  (*reader)->header = header;
+  (*reader)->slots = (const uint8_t*)mapping + header->header_size;
+  (*reader)->mapped_size = (size_t)st.st_size;
+  return 0;
+}
+
+void ntv_shm_reader_close(struct ntv_shm_reader* reader) {
+  if (reader == NULL) {
+    return;
+  }
+  munmap((void*)reader->header, reader->mapped_size);
+  free(reader);
+}
+
+const struct ntv_shm_header* ntv_shm_reader_header(const struct ntv_shm_reader* reader) {
+  return reader->header;
+}
+
+int ntv_shm_reader_closed(const struct ntv_shm_reader* reader) {
+  return __atomic_load_n(&reader->header->closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+enum ntv_shm_status ntv_shm_reader_peek(const struct ntv_shm_reader* reader,
+                                        uint64_t after,
+                                        struct ntv_shm_frame* frame) {
+  const struct ntv_shm_header* header = reader->header;
+  const struct ntv_shm_slot* slot;
+  uint64_t latest = __atomic_load_n(&header->latest, __ATOMIC_ACQUIRE);
+  if (latest == 0 || latest <= after) {
+    return NTV_SHM_NONE;
+  }
+  slot = (const struct ntv_shm_slot*)(reader->slots + ((latest - 1) % header->slot_count) *
+                                                          header->slot_stride);
+  frame->slot = slot;
+  frame->seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+  if (frame->seq & 1) {
+    return NTV_SHM_BUSY;
+  }
+  frame->frame_number = slot->frame_number;
+  frame->timestamp_us = slot->timestamp_us;
+  frame->sequence = slot->sequence;
+  frame->size = slot->size;
+  frame->data = (const uint8_t*)(slot + 1);
+  /* Already reused for a later frame, or torn metadata. */
+  if (frame->frame_number != latest || frame->size > header->frame_size) {
+    return NTV_SHM_BUSY;
+  }
+  return NTV_SHM_FRAME;
+}
+
+int ntv_shm_reader_valid(const struct ntv_shm_reader* reader,
+                         const struct ntv_shm_frame* frame) {
+  (void)reader;
+  /* Keeps every read of the frame before the second look at the lock. */
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  return __atomic_load_n(&frame->slot->seq, __ATOMIC_RELAXED) == frame->seq;
+}
+
+enum ntv_shm_status ntv_shm_reader_copy(const struct ntv_shm_reader* reader,
+                                        uint64_t after, void* buffer,
+                                        size_t capacity,
+                                        struct ntv_shm_frame* frame) {
+  int attempt;
+  for (attempt = 0; attempt < NTV_SHM_COPY_ATTEMPTS; ++attempt) {
+    enum ntv_shm_status status = ntv_shm_reader_peek(reader, after, frame);
+    if (status == NTV_SHM_NONE) {
+      return status;
+    }
+    if (status == NTV_SHM_BUSY || frame->size > capacity) {
+      continue;
+    }
+    memcpy(buffer, frame->data, frame->size);
+    if (ntv_shm_reader_valid(reader, frame)) {
+      frame->data = (const uint8_t*)buffer;
+      return NTV_SHM_FRAME;
+    }
+  }
+  return NTV_SHM_BUSY;
+}
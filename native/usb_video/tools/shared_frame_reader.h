@@ -0,0 +1,87 @@
+#ifndef USB_VIDEO_TOOLS_SHARED_FRAME_READER_H_
+#define USB_VIDEO_TOOLS_SHARED_FRAME_READER_H_
+
+/*
+ * Reference reader for the shared-memory frame export
+ * (shared_frame_format.h). C99 plus the GCC/Clang atomic builtins; copy
+ * it, with the format header, into whatever needs the frames.
+ *
+ *   struct ntv_shm_reader* reader;
+ *   if (ntv_shm_reader_open(NTV_SHM_DEFAULT_NAME, &reader) == 0) {
+ *     struct ntv_shm_frame frame;
+ *     uint64_t last = 0;
+ *     for (;;) {
+ *       if (ntv_shm_reader_peek(reader, last, &frame) != NTV_SHM_FRAME) {
+ *         ... sleep a little, or reopen once ntv_shm_reader_closed() ...
+ *         continue;
+ *       }
+ *       ... use frame.data, frame.size in place ...
+ *       if (ntv_shm_reader_valid(reader, &frame)) last = frame.frame_number;
+ *     }
+ *   }
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "shared_frame_format.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct ntv_shm_reader;
+
+/* A frame as the reader found it. data points into the mapping. */
+struct ntv_shm_frame {
+  uint64_t frame_number;
+  int64_t timestamp_us;
+  uint32_t sequence;
+  uint32_t size;
+  const uint8_t* data;
+  /* The slot and its sequence lock value, for ntv_shm_reader_valid(). */
+  const struct ntv_shm_slot* slot;
+  uint64_t seq;
+};
+
+enum ntv_shm_status {
+  NTV_SHM_BUSY = -1, /* the writer overtook this read; try again */
+  NTV_SHM_NONE = 0,  /* nothing newer than asked for */
+  NTV_SHM_FRAME = 1,
+};
+
+/* Maps the object |name| read-only. Returns 0, or an errno value (EPROTO
+ * for an object that is not a frame ring of this version). */
+int ntv_shm_reader_open(const char* name, struct ntv_shm_reader** reader);
+void ntv_shm_reader_close(struct ntv_shm_reader* reader);
+
+/* The ring's geometry, as the writer set it up. */
+const struct ntv_shm_header* ntv_shm_reader_header(const struct ntv_shm_reader* reader);
+
+/* Nonzero once the writer has stopped; reopen to follow the next one. */
+int ntv_shm_reader_closed(const struct ntv_shm_reader* reader);
+
+/* Finds the newest frame, if its number is above |after|, without copying
+ * it. The frame's data may be overwritten at any time: check
+ * ntv_shm_reader_valid() once done with it before trusting the result. */
+enum ntv_shm_status ntv_shm_reader_peek(const struct ntv_shm_reader* reader,
+                                        uint64_t after,
+                                        struct ntv_shm_frame* frame);
+
+/* Nonzero if nothing has touched |frame|'s slot since it was peeked. */
+int ntv_shm_reader_valid(const struct ntv_shm_reader* reader,
+                         const struct ntv_shm_frame* frame);
+
+/* Copies the newest frame above |after| into |buffer| (|capacity| bytes,
+ * at least the header's frame_size) and fills in |frame|, with frame->data
+ * pointing at |buffer|. Retries when overtaken, up to a few times. */
+enum ntv_shm_status ntv_shm_reader_copy(const struct ntv_shm_reader* reader,
+                                        uint64_t after, void* buffer,
+                                        size_t capacity,
+                                        struct ntv_shm_frame* frame);
+
+#ifdef __cplusplus
+}  /* extern "C" */
+#endif
+
+#endif /* USB_VIDEO_TOOLS_SHARED_FRAME_READER_H_ */
@@ -0,0 +1,100 @@
+#ifndef USB_VIDEO_TRIPLE_BUFFER_H_
+#define USB_VIDEO_TRIPLE_BUFFER_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace usb_video {
+
+// Latest-value-wins handoff between exactly one producer thread and one
+// consumer thread over three preallocated slots.
+//
+// The producer fills write_slot() and calls Publish(); the consumer calls
+// TakeLatest() and, if it returns true, reads read_slot(). Each side owns one
+// slot outright and the third sits in the middle, swapped in with a single
+// atomic exchange, so neither side ever blocks, spins or allocates. A frame
+// published before the consumer got to the previous one simply replaces it
+// and is counted as overwritten.
+template <typename T>
+class TripleBuffer {
+ public:
+  TripleBuffer() : back_(0), middle_(1), front_(2) { ResetCounters(); }
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  // Producer side.
+  T& write_slot() { return slots_[back_]; }
+
+  void Publish() {
+    const uint8_t previous =
+        middle_.exchange(static_cast<uint8_t>(back_ | kFresh),
+                         std::memory_order_acq_rel);
+    back_ = previous & kIndexMask;
+    produced_.store(produced_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    if ((previous & kFresh) != 0) {
+      overwritten_.store(overwritten_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    }
+  }
+
+  // Consumer side. Returns false, leaving read_slot() untouched, when nothing
+  // new has been published since the last successful call.
+  bool TakeLatest() {
+    if ((middle_.load(std::memory_order_relaxed) & kFresh) == 0) {
+      return false;
+    }
+    const uint8_t previous = middle_.exchange(static_cast<uint8_t>(front_),
+                                              std::memory_order_acq_rel);
+    front_ = previous & kIndexMask;
+    delivered_.store(delivered_.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+    return true;
+  }
+
+  const T& read_slot() const { return slots_[front_]; }
+
+  // Counters may be read from any thread.
+  uint64_t produced() const { return produced_.load(std::memory_order_relaxed); }
+  uint64_t delivered() const {
+    return delivered_.load(std::memory_order_relaxed);
+  }
+  uint64_t overwritten() const {
+    return overwritten_.load(std::memory_order_relaxed);
+  }
+
+  // Setup while neither side is running: drops any unconsumed frame, zeroes
+  // the counters and lets the caller size every slot up front.
+  template <typename F>
+  void Reset(F&& prepare_slot) {
+    middle_.store(middle_.load(std::memory_order_relaxed) & kIndexMask,
+                  std::memory_order_relaxed);
+    ResetCounters();
+    for (T& slot : slots_) {
+      prepare_slot(slot);
+    }
+  }
+
+ private:
+  static constexpr uint8_t kIndexMask = 0x3;
+  static constexpr uint8_t kFresh = 0x4;
+
+  void ResetCounters() {
+    produced_.store(0, std::memory_order_relaxed);
+    delivered_.store(0, std::memory_order_relaxed);
+    overwritten_.store(0, std::memory_order_relaxed);
+  }
+
+  T slots_[3];
+  uint8_t back_;                  // Producer-owned.
+  std::atomic<uint8_t> middle_;   // Shared: index | kFresh.
+  uint8_t front_;                 // Consumer-owned.
+  std::atomic<uint64_t> produced_;
+  std::atomic<uint64_t> delivered_;
+  std::atomic<uint64_t> overwritten_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_TRIPLE_BUFFER_H_
@@ -0,0 +1,341 @@
+#include "v4l2_capture_backend.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "frame_rate_controller.h"
+
+namespace usb_video {
+
+constexpr unsigned int V4l2CaptureBackend::kBufferCount;
+
+namespace {
+
+// Rates worth offering out of a stepwise or continuous range.
+const uint32_t kCommonRates[] = {120, 60, 50, 30, 25, 20, 15, 10, 5, 1};
+
+}  // namespace
+
+std::vector<FrameInterval> V4l2CaptureBackend::QueryFrameIntervals(int fd, int width,
+                                                                   int height) {
+  std::vector<FrameInterval> intervals;
+  struct v4l2_frmivalenum entry;
+  std::memset(&entry, 0, sizeof(entry));
+  entry.pixel_format = V4L2_PIX_FMT_YUYV;
+  entry.width = width;
+  entry.height = height;
+  while (ioctl(fd, VIDIOC_ENUM_FRAMEINTERVALS, &entry) == 0) {
+    if (entry.type == V4L2_FRMIVAL_TYPE_DISCRETE) {
+      intervals.push_back(
+          FrameInterval{entry.discrete.numerator, entry.discrete.denominator});
+      entry.index++;
+      continue;
+    }
+    // A range comes as a single entry; its minimum interval is the fastest.
+    const FrameInterval fastest{entry.stepwise.min.numerator,
+                                entry.stepwise.min.denominator};
+    const FrameInterval slowest{entry.stepwise.max.numerator,
+                                entry.stepwise.max.denominator};
+    intervals.push_back(fastest);
+    intervals.push_back(slowest);
+    for (uint32_t rate : kCommonRates) {
+      if (rate < fastest.fps() && rate > slowest.fps()) {
+        intervals.push_back(FrameInterval{1, rate});
+      }
+    }
+    break;
+  }
+  SortFrameIntervals(&intervals);
+  return intervals;
+}
+
+V4l2CaptureBackend::V4l2CaptureBackend(const std::string& device_path)
+    : device_path_(device_path), fd_(-1), wake_fd_(-1), streaming_(false) {}
+
+V4l2CaptureBackend::~V4l2CaptureBackend() { Stop(); }
+
+bool V4l2CaptureBackend::Fail(const char* what) {
+  error_ = std::string(what) + ": " + std::strerror(errno);
+  Stop();
+  return false;
+}
+
+bool V4l2CaptureBackend::Start(int width, int height) {
+  Stop();
+  error_.clear();
+
+  // Non-blocking so Next() only ever waits in poll().
+  fd_ = open(device_path_.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+  if (fd_ == -1) {
+    return Fail("cannot open device");
+  }
+
+  struct v4l2_format fmt;
+  std::memset(&fmt, 0, sizeof(fmt));
+  fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (ioctl(fd_, VIDIOC_G_FMT, &fmt) == -1) {
+    return Fail("VIDIOC_G_FMT");
+  }
+  if (fmt.fmt.pix.width != static_cast<uint32_t>(width) ||
+      fmt.fmt.pix.height != static_cast<uint32_t>(height) ||
+      fmt.fmt.pix.pixelformat != V4L2_PIX_FMT_YUYV) {
+    struct v4l2_format wanted = fmt;
+    wanted.fmt.pix.width = width;
+    wanted.fmt.pix.height = height;
+    wanted.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+    wanted.fmt.pix.field = V4L2_FIELD_ANY;
+    // Some gadgets refuse S_FMT but already stream what we want, so carry
+    // on with the current format rather than fail.
+    if (ioctl(fd_, VIDIOC_S_FMT, &wanted) == 0) {
+      fmt = wanted;
+    }
+  }
+  width_ = static_cast<int>(fmt.fmt.pix.width);
+  height_ = static_cast<int>(fmt.fmt.pix.height);
+
+  // Rate control needs both the list and S_PARM; without either the device
+  // runs at whatever it defaults to.
+  frame_intervals_.clear();
+  frame_interval_ = FrameInterval();
+  struct v4l2_streamparm parm;
+  std::memset(&parm, 0, sizeof(parm));
+  parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (ioctl(fd_, VIDIOC_G_PARM, &parm) == 0 &&
+      (parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME) != 0) {
+    frame_interval_ = FrameInterval{parm.parm.capture.timeperframe.numerator,
+                                    parm.parm.capture.timeperframe.denominator};
+    frame_intervals_ = QueryFrameIntervals(fd_, width_, height_);
+  }
+
+  struct v4l2_requestbuffers req;
+  std::memset(&req, 0, sizeof(req));
+  req.count = kBufferCount;
+  req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  req.memory = V4L2_MEMORY_MMAP;
+  if (ioctl(fd_, VIDIOC_REQBUFS, &req) == -1) {
+    return Fail("VIDIOC_REQBUFS");
+  }
+
+  for (unsigned int i = 0; i < req.count; ++i) {
+    struct v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = i;
+    if (ioctl(fd_, VIDIOC_QUERYBUF, &buf) == -1) {
+      return Fail("VIDIOC_QUERYBUF");
+    }
+    void* start = mmap(nullptr, buf.length, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       fd_, buf.m.offset);
+    if (start == MAP_FAILED) {
+      return Fail("mmap");
+    }
+    buffers_.push_back(Buffer{start, buf.length});
+  }
+  if (!QueueAllBuffers()) {
+    return Fail("VIDIOC_QBUF");
+  }
+
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd_ == -1) {
+    return Fail("eventfd");
+  }
+
+  enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (ioctl(fd_, VIDIOC_STREAMON, &type) == -1) {
+    return Fail("VIDIOC_STREAMON");
+  }
+  streaming_ = true;
+  return true;
+}
+
+CaptureBackend::Result V4l2CaptureBackend::Next(CapturedFrame* frame) {
+  // Sleep until the driver has a filled buffer or Wake() is called. A
+  // stopped stream polls as an error, so while paused only the eventfd is
+  // watched.
+  struct pollfd fds[2];
+  fds[0].fd = fd_;
+  fds[0].events = POLLIN;
+  fds[0].revents = 0;
+  fds[1].fd = wake_fd_;
+  fds[1].events = POLLIN;
+  fds[1].revents = 0;
+  if (poll(paused_ ? fds + 1 : fds, paused_ ? 1 : 2, -1) == -1) {
+    if (errno == EINTR) {
+      return kRetry;
+    }
+    error_ = std::string("poll: ") + std::strerror(errno);
+    return kError;
+  }
+  if (fds[1].revents != 0) {
+    eventfd_t count;
+    eventfd_read(wake_fd_, &count);
+    return kWoken;
+  }
+  if ((fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) != 0 &&
+      (fds[0].revents & POLLIN) == 0) {
+    error_ = "device reported an error";
+    return kError;
+  }
+
+  struct v4l2_buffer buf;
+  std::memset(&buf, 0, sizeof(buf));
+  buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  buf.memory = V4L2_MEMORY_MMAP;
+  if (ioctl(fd_, VIDIOC_DQBUF, &buf) == -1) {
+    if (errno == EAGAIN || errno == EINTR) {
+      return kRetry;
+    }
+    error_ = std::string("VIDIOC_DQBUF: ") + std::strerror(errno);
+    return kError;
+  }
+  if (buf.index >= buffers_.size()) {
+    error_ = "driver returned an unknown buffer";
+    return kError;
+  }
+
+  frame->data = static_cast<const uint8_t*>(buffers_[buf.index].start);
+  frame->size = std::min(static_cast<size_t>(buf.bytesused), buffers_[buf.index].length);
+  // UVC drivers stamp buffers with CLOCK_MONOTONIC at the start of the
+  // frame; other clocks are no use for latency, so report them as unknown.
+  frame->timestamp_us = 0;
+  if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) ==
+      V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+    frame->timestamp_us = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000 +
+                          buf.timestamp.tv_usec;
+  }
+  frame->sequence = buf.sequence;
+  frame->buffer_index = buf.index;
+  return kFrame;
+}
+
+bool V4l2CaptureBackend::Release(const CapturedFrame& frame) {
+  struct v4l2_buffer buf;
+  std::memset(&buf, 0, sizeof(buf));
+  buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  buf.memory = V4L2_MEMORY_MMAP;
+  buf.index = frame.buffer_index;
+  if (ioctl(fd_, VIDIOC_QBUF, &buf) == -1) {
+    error_ = std::string("VIDIOC_QBUF: ") + std::strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+bool V4l2CaptureBackend::QueueAllBuffers() {
+  for (unsigned int i = 0; i < buffers_.size(); ++i) {
+    struct v4l2_buffer buf;
+    std::memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buf.memory = V4L2_MEMORY_MMAP;
+    buf.index = i;
+    if (ioctl(fd_, VIDIOC_QBUF, &buf) == -1) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool V4l2CaptureBackend::SetFrameInterval(const FrameInterval& interval) {
+  if (fd_ < 0 || interval.numerator == 0 || interval.denominator == 0) {
+    error_ = "no such frame interval";
+    return false;
+  }
+  struct v4l2_streamparm parm;
+  std::memset(&parm, 0, sizeof(parm));
+  parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  parm.parm.capture.timeperframe.numerator = interval.numerator;
+  parm.parm.capture.timeperframe.denominator = interval.denominator;
+  int result = ioctl(fd_, VIDIOC_S_PARM, &parm);
+  if (result == -1 && errno == EBUSY && streaming_) {
+    // uvcvideo only takes S_PARM while stopped. STREAMOFF hands every
+    // buffer back, so they are all queued again before restarting.
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    ioctl(fd_, VIDIOC_STREAMOFF, &type);
+    streaming_ = false;
+    result = ioctl(fd_, VIDIOC_S_PARM, &parm);
+    const int saved_errno = errno;
+    if (!QueueAllBuffers() || ioctl(fd_, VIDIOC_STREAMON, &type) == -1) {
+      error_ = std::string("restarting stream: ") + std::strerror(errno);
+      return false;
+    }
+    streaming_ = true;
+    errno = saved_errno;
+  }
+  if (result == -1) {
+    error_ = std::string("VIDIOC_S_PARM: ") + std::strerror(errno);
+    return false;
+  }
+  // The driver picks the nearest interval it supports.
+  frame_interval_ = FrameInterval{parm.parm.capture.timeperframe.numerator,
+                                  parm.parm.capture.timeperframe.denominator};
+  return true;
+}
+
+bool V4l2CaptureBackend::Pause() {
+  if (paused_) {
+    return true;
+  }
+  enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (!streaming_ || ioctl(fd_, VIDIOC_STREAMOFF, &type) == -1) {
+    error_ = std::string("VIDIOC_STREAMOFF: ") + std::strerror(errno);
+    return false;
+  }
+  streaming_ = false;
+  paused_ = true;
+  return true;
+}
+
+bool V4l2CaptureBackend::Resume() {
+  if (!paused_) {
+    return true;
+  }
+  // STREAMOFF handed every buffer back.
+  enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+  if (!QueueAllBuffers() || ioctl(fd_, VIDIOC_STREAMON, &type) == -1) {
+    error_ = std::string("resuming stream: ") + std::strerror(errno);
+    return false;
+  }
+  streaming_ = true;
+  paused_ = false;
+  return true;
+}
+
+void V4l2CaptureBackend::Wake() {
+  if (wake_fd_ >= 0) {
+    eventfd_write(wake_fd_, 1);
+  }
+}
+
+void V4l2CaptureBackend::Stop() {
+  if (streaming_) {
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    ioctl(fd_, VIDIOC_STREAMOFF, &type);
+    streaming_ = false;
+  }
+  paused_ = false;
+  for (const Buffer& buffer : buffers_) {
+    munmap(buffer.start, buffer.length);
+  }
+  buffers_.clear();
+  frame_intervals_.clear();
+  if (wake_fd_ >= 0) {
+    close(wake_fd_);
+    wake_fd_ = -1;
+  }
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+}  // namespace usb_video
@@ -0,0 +1,63 @@
+#ifndef USB_VIDEO_V4L2_CAPTURE_BACKEND_H_
+#define USB_VIDEO_V4L2_CAPTURE_BACKEND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "capture_backend.h"
+
+namespace usb_video {
+
+// Captures YUYV from a V4L2 device through mmap'd driver buffers.
+//
+// The device is opened non-blocking and Next() sleeps in poll() on it and
+// an eventfd, so Wake() never waits on the driver. Frames are handed out
+// straight from the driver's buffers; the driver fills the others while
+// one is on loan. Pause() is VIDIOC_STREAMOFF, so the camera stops sending
+// altogether, while the buffers stay mapped for a quick Resume().
+class V4l2CaptureBackend : public CaptureBackend {
+ public:
+  static constexpr unsigned int kBufferCount = 4;
+
+  explicit V4l2CaptureBackend(const std::string& device_path);
+  ~V4l2CaptureBackend() override;
+
+  bool Start(int width, int height) override;
+  Result Next(CapturedFrame* frame) override;
+  bool Release(const CapturedFrame& frame) override;
+  bool SetFrameInterval(const FrameInterval& interval) override;
+  bool Pause() override;
+  bool Resume() override;
+  void Wake() override;
+  void Stop() override;
+  const char* name() const override { return "v4l2"; }
+
+  const std::string& device_path() const { return device_path_; }
+
+  // The YUYV frame intervals |fd| offers at |width| x |height|, fastest
+  // first. Stepwise and continuous ranges are sampled at the common rates
+  // they contain, plus both ends.
+  static std::vector<FrameInterval> QueryFrameIntervals(int fd, int width,
+                                                        int height);
+
+ private:
+  struct Buffer {
+    void* start;
+    size_t length;
+  };
+
+  bool Fail(const char* what);
+  bool QueueAllBuffers();
+
+  std::string device_path_;
+  int fd_;
+  int wake_fd_;
+  std::vector<Buffer> buffers_;
+  bool streaming_;
+};
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_V4L2_CAPTURE_BACKEND_H_
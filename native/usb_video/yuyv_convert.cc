@@ -0,0 +1,127 @@
+#include "yuyv_convert.h"
+
+#include "yuyv_convert_internal.h"
+
+#if defined(__arm__) && defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace usb_video {
+
+namespace {
+
+void ConvertYuyvToRgb24Scalar(const uint8_t* yuyv, size_t pixel_count,
+                              uint8_t* rgb) {
+  internal::ConvertYuyvScalar<3>(yuyv, pixel_count, rgb);
+}
+
+void ConvertYuyvToRgbaScalar(const uint8_t* yuyv, size_t pixel_count,
+                             uint8_t* rgba) {
+  internal::ConvertYuyvScalar<4>(yuyv, pixel_count, rgba);
+}
+
+const YuyvKernel kScalarKernel = {"scalar", ConvertYuyvToRgb24Scalar,
+                                  ConvertYuyvToRgbaScalar};
+
+#if defined(USB_VIDEO_HAVE_X86_KERNELS)
+const YuyvKernel kSse2Kernel = {"sse2", internal::ConvertYuyvToRgb24Sse2,
+                                internal::ConvertYuyvToRgbaSse2};
+const YuyvKernel kAvx2Kernel = {"avx2", internal::ConvertYuyvToRgb24Avx2,
+                                internal::ConvertYuyvToRgbaAvx2};
+
+bool CpuHasSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+  return true;  // Part of the x86-64 baseline.
+#else
+  return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#if defined(_MSC_VER)
+// MSVC has no __builtin_cpu_supports: AVX2 needs the CPU flag, and the OS
+// must save the YMM registers (OSXSAVE, then XCR0 bits 1 and 2).
+bool CpuHasAvx2() {
+  int regs[4];
+  __cpuid(regs, 0);
+  if (regs[0] < 7) return false;
+  __cpuid(regs, 1);
+  const int kOsxsave = 1 << 27;
+  const int kAvx = 1 << 28;
+  if ((regs[2] & (kOsxsave | kAvx)) != (kOsxsave | kAvx)) return false;
+  if ((_xgetbv(0) & 6) != 6) return false;
+  __cpuidex(regs, 7, 0);
+  return (regs[1] & (1 << 5)) != 0;
+}
+#else
+bool CpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+#endif
+#endif
+
+#if defined(USB_VIDEO_HAVE_NEON_KERNELS)
+const YuyvKernel kNeonKernel = {"neon", internal::ConvertYuyvToRgb24Neon,
+                                internal::ConvertYuyvToRgbaNeon};
+
+bool CpuHasNeon() {
+#if defined(__aarch64__)
+  return true;  // Advanced SIMD is mandatory on AArch64.
+#elif defined(__linux__) && defined(HWCAP_NEON)
+  return (getauxval(AT_HWCAP) & HWCAP_NEON) != 0;
+#else
+  return false;
+#endif
+}
+#endif
+
+const YuyvKernel& SelectKernel() {
+#if defined(USB_VIDEO_HAVE_X86_KERNELS)
+  if (CpuHasAvx2()) return kAvx2Kernel;
+  if (CpuHasSse2()) return kSse2Kernel;
+#endif
+#if defined(USB_VIDEO_HAVE_NEON_KERNELS)
+  if (CpuHasNeon()) return kNeonKernel;
+#endif
+  return kScalarKernel;
+}
+
+}  // namespace
+
+const YuyvKernel& ActiveYuyvKernel() {
+  // Function-local static: selected once, thread-safe initialisation.
+  static const YuyvKernel& kernel = SelectKernel();
+  return kernel;
+}
+
+size_t AvailableYuyvKernels(const YuyvKernel** kernels, size_t capacity) {
+  size_t count = 0;
+  auto add = [&](const YuyvKernel& kernel) {
+    if (count < capacity) kernels[count] = &kernel;
+    count++;
+  };
+  add(kScalarKernel);
+#if defined(USB_VIDEO_HAVE_X86_KERNELS)
+  if (CpuHasSse2()) add(kSse2Kernel);
+  if (CpuHasAvx2()) add(kAvx2Kernel);
+#endif
+#if defined(USB_VIDEO_HAVE_NEON_KERNELS)
+  if (CpuHasNeon()) add(kNeonKernel);
+#endif
+  return count;
+}
+
+void ConvertYuyvToRgb24(const uint8_t* yuyv, size_t pixel_count,
+                        uint8_t* rgb) {
+  ActiveYuyvKernel().to_rgb24(yuyv, pixel_count, rgb);
+}
+
+void ConvertYuyvToRgba(const uint8_t* yuyv, size_t pixel_count,
+                       uint8_t* rgba) {
+  ActiveYuyvKernel().to_rgba(yuyv, pixel_count, rgba);
+}
+
+}  // namespace usb_video
@@ -0,0 +1,40 @@
+#ifndef USB_VIDEO_YUYV_CONVERT_H_
+#define USB_VIDEO_YUYV_CONVERT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+
+// Converts packed YUYV 4:2:2 (BT.601 studio range, as delivered by the
+// Disting NT's UVC interface) into interleaved RGB.
+//
+// |pixel_count| must be even; YUYV stores two pixels per four bytes. The
+// output buffer must hold pixel_count * 3 (RGB24) or pixel_count * 4
+// (RGBA8888, alpha = 0xFF) bytes. Every kernel is bit-exact with the scalar
+// integer reference below, so the selected instruction set never changes
+// the picture.
+void ConvertYuyvToRgb24(const uint8_t* yuyv, size_t pixel_count, uint8_t* rgb);
+void ConvertYuyvToRgba(const uint8_t* yuyv, size_t pixel_count, uint8_t* rgba);
+
+using YuyvConvertFn = void (*)(const uint8_t* yuyv, size_t pixel_count,
+                               uint8_t* out);
+
+// One instruction-set implementation of the converters.
+struct YuyvKernel {
+  const char* name;
+  YuyvConvertFn to_rgb24;
+  YuyvConvertFn to_rgba;
+};
+
+// The kernel ConvertYuyvTo* dispatches to, chosen once from CPUID on x86 or
+// the auxiliary vector hwcaps on ARM.
+const YuyvKernel& ActiveYuyvKernel();
+
+// Every kernel this binary was built with that the running CPU supports,
+// scalar first. Used by the tests and benchmarks to compare implementations.
+size_t AvailableYuyvKernels(const YuyvKernel** kernels, size_t capacity);
+
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_YUYV_CONVERT_H_
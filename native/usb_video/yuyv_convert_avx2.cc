@@ -0,0 +1,118 @@
+// AVX2 YUYV converter: sixteen pixels (32 source bytes) per iteration.
+//
+// Same arithmetic as the SSE2 kernel. Every AVX2 integer op used here works
+// within 128-bit lanes, so each lane converts eight pixels exactly as the
+// SSE2 path would; the lanes are only stitched back together at the store.
+// This file is compiled with -mavx2 and only entered after a CPUID check.
+
+#include <immintrin.h>
+
+#include "yuyv_convert_internal.h"
+
+namespace usb_video {
+namespace internal {
+
+namespace {
+
+inline void ConvertSixteen(const uint8_t* yuyv, __m256i* r, __m256i* g,
+                           __m256i* b) {
+  const __m256i raw =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(yuyv));
+
+  const __m256i c = _mm256_sub_epi16(
+      _mm256_and_si256(raw, _mm256_set1_epi16(0x00FF)), _mm256_set1_epi16(16));
+  const __m256i de =
+      _mm256_sub_epi16(_mm256_srli_epi16(raw, 8), _mm256_set1_epi16(128));
+
+  const __m256i bias = _mm256_set1_epi32(128);
+  const __m256i rv = _mm256_add_epi32(
+      _mm256_madd_epi16(de, _mm256_set1_epi32(409 << 16)), bias);
+  const __m256i gv = _mm256_add_epi32(
+      _mm256_madd_epi16(
+          de, _mm256_set_epi16(-208, -100, -208, -100, -208, -100, -208, -100,
+                               -208, -100, -208, -100, -208, -100, -208, -100)),
+      bias);
+  const __m256i bv = _mm256_add_epi32(
+      _mm256_madd_epi16(de, _mm256_set1_epi32(516)), bias);
+
+  const __m256i luma_coeff = _mm256_set1_epi32(298);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i luma_lo =
+      _mm256_madd_epi16(_mm256_unpacklo_epi16(c, zero), luma_coeff);
+  const __m256i luma_hi =
+      _mm256_madd_epi16(_mm256_unpackhi_epi16(c, zero), luma_coeff);
+
+  auto channel = [&](__m256i chroma) {
+    const __m256i lo = _mm256_srai_epi32(
+        _mm256_add_epi32(luma_lo, _mm256_unpacklo_epi32(chroma, chroma)), 8);
+    const __m256i hi = _mm256_srai_epi32(
+        _mm256_add_epi32(luma_hi, _mm256_unpackhi_epi32(chroma, chroma)), 8);
+    const __m256i words = _mm256_packs_epi32(lo, hi);
+    return _mm256_packus_epi16(words, words);
+  };
+
+  *r = channel(rv);
+  *g = channel(gv);
+  *b = channel(bv);
+}
+
+// Interleaves the converted channels into RGBA for pixels 0-7 and 8-15.
+inline void InterleaveRgba(__m256i r, __m256i g, __m256i b, __m256i alpha,
+                           __m256i* first, __m256i* second) {
+  const __m256i rg = _mm256_unpacklo_epi8(r, g);
+  const __m256i ba = _mm256_unpacklo_epi8(b, alpha);
+  const __m256i quads_lo = _mm256_unpacklo_epi16(rg, ba);  // px 0-3, 8-11
+  const __m256i quads_hi = _mm256_unpackhi_epi16(rg, ba);  // px 4-7, 12-15
+  *first = _mm256_permute2x128_si256(quads_lo, quads_hi, 0x20);
+  *second = _mm256_permute2x128_si256(quads_lo, quads_hi, 0x31);
+}
+
+}  // namespace
+
+void ConvertYuyvToRgbaAvx2(const uint8_t* yuyv, size_t pixel_count,
+                           uint8_t* rgba) {
+  const __m256i alpha = _mm256_set1_epi8(static_cast<char>(0xFF));
+  size_t done = 0;
+  for (; done + 16 <= pixel_count; done += 16) {
+    __m256i r, g, b, first, second;
+    ConvertSixteen(yuyv + done * 2, &r, &g, &b);
+    InterleaveRgba(r, g, b, alpha, &first, &second);
+    uint8_t* out = rgba + done * 4;
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), first);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32), second);
+  }
+  ConvertYuyvScalar<4>(yuyv + done * 2, pixel_count - done, rgba + done * 4);
+}
+
+void ConvertYuyvToRgb24Avx2(const uint8_t* yuyv, size_t pixel_count,
+                            uint8_t* rgb) {
+  // Drop every fourth byte within each lane, then store the 12 useful bytes
+  // of each lane with 16-byte writes that overlap the next write. The last
+  // write spills four bytes, so stop while at least two pixels remain for
+  // the scalar tail.
+  const __m256i drop_alpha = _mm256_setr_epi8(
+      0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+      0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+  const __m256i alpha = _mm256_setzero_si256();
+  size_t done = 0;
+  for (; done + 16 < pixel_count; done += 16) {
+    __m256i r, g, b, first, second;
+    ConvertSixteen(yuyv + done * 2, &r, &g, &b);
+    InterleaveRgba(r, g, b, alpha, &first, &second);
+    first = _mm256_shuffle_epi8(first, drop_alpha);
+    second = _mm256_shuffle_epi8(second, drop_alpha);
+    uint8_t* out = rgb + done * 3;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm256_castsi256_si128(first));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12),
+                     _mm256_extracti128_si256(first, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 24),
+                     _mm256_castsi256_si128(second));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 36),
+                     _mm256_extracti128_si256(second, 1));
+  }
+  ConvertYuyvScalar<3>(yuyv + done * 2, pixel_count - done, rgb + done * 3);
+}
+
+}  // namespace internal
+}  // namespace usb_video
@@ -0,0 +1,72 @@
+#ifndef USB_VIDEO_YUYV_CONVERT_INTERNAL_H_
+#define USB_VIDEO_YUYV_CONVERT_INTERNAL_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace usb_video {
+namespace internal {
+
+inline uint8_t ClampToByte(int value) {
+  return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// Scalar reference conversion. |kStride| is 3 for RGB24 and 4 for RGBA8888.
+// The SIMD kernels use this for the pixels left over after their last full
+// vector, so every path shares one definition of the arithmetic.
+template <int kStride>
+inline void ConvertYuyvScalar(const uint8_t* yuyv, size_t pixel_count,
+                              uint8_t* out) {
+  for (size_t i = 0; i + 1 < pixel_count; i += 2) {
+    const int y0 = yuyv[0];
+    const int u = yuyv[1];
+    const int y1 = yuyv[2];
+    const int v = yuyv[3];
+    yuyv += 4;
+
+    const int d = u - 128;
+    const int e = v - 128;
+    const int r_chroma = 409 * e + 128;
+    const int g_chroma = -100 * d - 208 * e + 128;
+    const int b_chroma = 516 * d + 128;
+
+    int luma = 298 * (y0 - 16);
+    out[0] = ClampToByte((luma + r_chroma) >> 8);
+    out[1] = ClampToByte((luma + g_chroma) >> 8);
+    out[2] = ClampToByte((luma + b_chroma) >> 8);
+    if (kStride == 4) out[3] = 0xFF;
+    out += kStride;
+
+    luma = 298 * (y1 - 16);
+    out[0] = ClampToByte((luma + r_chroma) >> 8);
+    out[1] = ClampToByte((luma + g_chroma) >> 8);
+    out[2] = ClampToByte((luma + b_chroma) >> 8);
+    if (kStride == 4) out[3] = 0xFF;
+    out += kStride;
+  }
+}
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+void ConvertYuyvToRgb24Sse2(const uint8_t* yuyv, size_t pixel_count,
+                            uint8_t* rgb);
+void ConvertYuyvToRgbaSse2(const uint8_t* yuyv, size_t pixel_count,
+                           uint8_t* rgba);
+void ConvertYuyvToRgb24Avx2(const uint8_t* yuyv, size_t pixel_count,
+                            uint8_t* rgb);
+void ConvertYuyvToRgbaAvx2(const uint8_t* yuyv, size_t pixel_count,
+                           uint8_t* rgba);
+#define USB_VIDEO_HAVE_X86_KERNELS 1
+#endif
+
+#if defined(__aarch64__) || defined(__ARM_NEON) || defined(__arm__)
+void ConvertYuyvToRgb24Neon(const uint8_t* yuyv, size_t pixel_count,
+                            uint8_t* rgb);
+void ConvertYuyvToRgbaNeon(const uint8_t* yuyv, size_t pixel_count,
+                           uint8_t* rgba);
+#define USB_VIDEO_HAVE_NEON_KERNELS 1
+#endif
+
+}  // namespace internal
+}  // namespace usb_video
+
+#endif  // USB_VIDEO_YUYV_CONVERT_INTERNAL_H_
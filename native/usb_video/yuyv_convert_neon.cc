@@ -0,0 +1,100 @@
+// NEON YUYV converter: sixteen pixels (32 source bytes) per iteration.
+//
+// vld4 splits the stream into even Y, U, odd Y and V planes for free, and
+// vst3/vst4 re-interleave the output, so the only real work is the 32-bit
+// multiply-accumulate. vqmovun's unsigned saturation provides the clamp.
+
+#include <arm_neon.h>
+
+#include "yuyv_convert_internal.h"
+
+namespace usb_video {
+namespace internal {
+
+namespace {
+
+struct Chroma {
+  int32x4_t r;
+  int32x4_t g;
+  int32x4_t b;
+};
+
+inline Chroma ChromaTerms(int16x4_t d, int16x4_t e) {
+  const int32x4_t bias = vdupq_n_s32(128);
+  Chroma chroma;
+  chroma.r = vmlal_n_s16(bias, e, 409);
+  chroma.g = vmlsl_n_s16(vmlsl_n_s16(bias, d, 100), e, 208);
+  chroma.b = vmlal_n_s16(bias, d, 516);
+  return chroma;
+}
+
+// Applies one chroma term to eight pixels of the same parity.
+inline uint8x8_t Channel(int16x8_t c, int32x4_t chroma_lo,
+                         int32x4_t chroma_hi) {
+  const int32x4_t lo =
+      vshrq_n_s32(vaddq_s32(vmull_n_s16(vget_low_s16(c), 298), chroma_lo), 8);
+  const int32x4_t hi =
+      vshrq_n_s32(vaddq_s32(vmull_n_s16(vget_high_s16(c), 298), chroma_hi), 8);
+  return vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+}
+
+inline uint8x16_t Interleave(uint8x8_t even, uint8x8_t odd) {
+  const uint8x8x2_t zipped = vzip_u8(even, odd);
+  return vcombine_u8(zipped.val[0], zipped.val[1]);
+}
+
+inline uint8x16x3_t ConvertSixteen(const uint8_t* yuyv) {
+  const uint8x8x4_t planes = vld4_u8(yuyv);
+  const int16x8_t luma_bias = vdupq_n_s16(16);
+  const int16x8_t chroma_bias = vdupq_n_s16(128);
+  const int16x8_t c_even = vsubq_s16(
+      vreinterpretq_s16_u16(vmovl_u8(planes.val[0])), luma_bias);
+  const int16x8_t d = vsubq_s16(
+      vreinterpretq_s16_u16(vmovl_u8(planes.val[1])), chroma_bias);
+  const int16x8_t c_odd = vsubq_s16(
+      vreinterpretq_s16_u16(vmovl_u8(planes.val[2])), luma_bias);
+  const int16x8_t e = vsubq_s16(
+      vreinterpretq_s16_u16(vmovl_u8(planes.val[3])), chroma_bias);
+
+  const Chroma lo = ChromaTerms(vget_low_s16(d), vget_low_s16(e));
+  const Chroma hi = ChromaTerms(vget_high_s16(d), vget_high_s16(e));
+
+  uint8x16x3_t rgb;
+  rgb.val[0] = Interleave(Channel(c_even, lo.r, hi.r),
+                          Channel(c_odd, lo.r, hi.r));
+  rgb.val[1] = Interleave(Channel(c_even, lo.g, hi.g),
+                          Channel(c_odd, lo.g, hi.g));
+  rgb.val[2] = Interleave(Channel(c_even, lo.b, hi.b),
+                          Channel(c_odd, lo.b, hi.b));
+  return rgb;
+}
+
+}  // namespace
+
+void ConvertYuyvToRgb24Neon(const uint8_t* yuyv, size_t pixel_count,
+                            uint8_t* rgb) {
+  size_t done = 0;
+  for (; done + 16 <= pixel_count; done += 16) {
+    vst3q_u8(rgb + done * 3, ConvertSixteen(yuyv + done * 2));
+  }
+  ConvertYuyvScalar<3>(yuyv + done * 2, pixel_count - done, rgb + done * 3);
+}
+
+void ConvertYuyvToRgbaNeon(const uint8_t* yuyv, size_t pixel_count,
+                           uint8_t* rgba) {
+  const uint8x16_t alpha = vdupq_n_u8(0xFF);
+  size_t done = 0;
+  for (; done + 16 <= pixel_count; done += 16) {
+    const uint8x16x3_t rgb = ConvertSixteen(yuyv + done * 2);
+    uint8x16x4_t out;
+    out.val[0] = rgb.val[0];
+    out.val[1] = rgb.val[1];
+    out.val[2] = rgb.val[2];
+    out.val[3] = alpha;
+    vst4q_u8(rgba + done * 4, out);
+  }
+  ConvertYuyvScalar<4>(yuyv + done * 2, pixel_count - done, rgba + done * 4);
+}
+
+}  // namespace internal
+}  // namespace usb_video
@@ -0,0 +1,117 @@
+// SSE2 YUYV converter: eight pixels (16 source bytes) per iteration.
+//
+// The BT.601 sums overflow 16 bits, so luma and chroma terms are formed in
+// 32-bit lanes with pmaddwd, shifted, then narrowed with saturating packs.
+// packuswb's unsigned saturation doubles as the 0..255 clamp, which keeps
+// the result bit-exact with the scalar reference.
+
+#include <emmintrin.h>
+
+#include <cstring>
+
+#include "yuyv_convert_internal.h"
+
+namespace usb_video {
+namespace internal {
+
+namespace {
+
+// Converts eight pixels into R, G and B bytes in the low halves of the
+// returned registers.
+inline void ConvertEight(const uint8_t* yuyv, __m128i* r, __m128i* g,
+                         __m128i* b) {
+  const __m128i raw =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(yuyv));
+
+  // Even bytes are Y, odd bytes alternate U, V.
+  const __m128i c = _mm_sub_epi16(_mm_and_si128(raw, _mm_set1_epi16(0x00FF)),
+                                  _mm_set1_epi16(16));
+  const __m128i de =
+      _mm_sub_epi16(_mm_srli_epi16(raw, 8), _mm_set1_epi16(128));
+
+  // Per-macropixel chroma terms (four lanes) including the rounding bias,
+  // then duplicated so each pixel pair shares its macropixel's value.
+  const __m128i bias = _mm_set1_epi32(128);
+  const __m128i rv = _mm_add_epi32(
+      _mm_madd_epi16(de, _mm_set_epi16(409, 0, 409, 0, 409, 0, 409, 0)),
+      bias);
+  const __m128i gv = _mm_add_epi32(
+      _mm_madd_epi16(de, _mm_set_epi16(-208, -100, -208, -100, -208, -100,
+                                       -208, -100)),
+      bias);
+  const __m128i bv = _mm_add_epi32(
+      _mm_madd_epi16(de, _mm_set_epi16(0, 516, 0, 516, 0, 516, 0, 516)),
+      bias);
+
+  // 298 * c for pixels 0-3 and 4-7.
+  const __m128i luma_coeff = _mm_set1_epi32(298);
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i luma_lo =
+      _mm_madd_epi16(_mm_unpacklo_epi16(c, zero), luma_coeff);
+  const __m128i luma_hi =
+      _mm_madd_epi16(_mm_unpackhi_epi16(c, zero), luma_coeff);
+
+  auto channel = [&](__m128i chroma) {
+    const __m128i lo = _mm_srai_epi32(
+        _mm_add_epi32(luma_lo, _mm_unpacklo_epi32(chroma, chroma)), 8);
+    const __m128i hi = _mm_srai_epi32(
+        _mm_add_epi32(luma_hi, _mm_unpackhi_epi32(chroma, chroma)), 8);
+    const __m128i words = _mm_packs_epi32(lo, hi);
+    return _mm_packus_epi16(words, words);
+  };
+
+  *r = channel(rv);
+  *g = channel(gv);
+  *b = channel(bv);
+}
+
+}  // namespace
+
+void ConvertYuyvToRgbaSse2(const uint8_t* yuyv, size_t pixel_count,
+                           uint8_t* rgba) {
+  const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+  size_t done = 0;
+  for (; done + 8 <= pixel_count; done += 8) {
+    __m128i r, g, b;
+    ConvertEight(yuyv + done * 2, &r, &g, &b);
+    const __m128i rg = _mm_unpacklo_epi8(r, g);
+    const __m128i ba = _mm_unpacklo_epi8(b, alpha);
+    uint8_t* out = rgba + done * 4;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16),
+                     _mm_unpackhi_epi16(rg, ba));
+  }
+  ConvertYuyvScalar<4>(yuyv + done * 2, pixel_count - done, rgba + done * 4);
+}
+
+void ConvertYuyvToRgb24Sse2(const uint8_t* yuyv, size_t pixel_count,
+                            uint8_t* rgb) {
+  // SSE2 has no byte shuffle, so build RGBA words and store them with
+  // overlapping 4-byte writes three bytes apart. The last write spills one
+  // byte into the next pixel, so stop while at least one pixel remains for
+  // the scalar tail to overwrite it.
+  const __m128i alpha = _mm_setzero_si128();
+  size_t done = 0;
+  for (; done + 8 < pixel_count; done += 8) {
+    __m128i r, g, b;
+    ConvertEight(yuyv + done * 2, &r, &g, &b);
+    const __m128i rg = _mm_unpacklo_epi8(r, g);
+    const __m128i ba = _mm_unpacklo_epi8(b, alpha);
+    __m128i quads[2] = {_mm_unpacklo_epi16(rg, ba),
+                        _mm_unpackhi_epi16(rg, ba)};
+    uint8_t* out = rgb + done * 3;
+    for (int half = 0; half < 2; ++half) {
+      alignas(16) uint32_t words[4];
+      _mm_store_si128(reinterpret_cast<__m128i*>(words), quads[half]);
+      for (int i = 0; i < 4; ++i) {
+        std::memcpy(out, &words[i], 4);
+        out += 3;
+      }
+    }
+  }
+  ConvertYuyvScalar<3>(yuyv + done * 2, pixel_count - done, rgb + done * 3);
+}
+
+}  // namespace internal
+}  // namespace usb_video
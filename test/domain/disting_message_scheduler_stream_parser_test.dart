@@ -0,0 +1,175 @@
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:flutter_midi_command/flutter_midi_command.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:mocktail/mocktail.dart';
+import 'package:nt_helper/domain/disting_message_scheduler.dart';
+import 'package:nt_helper/domain/disting_nt_sysex.dart';
+import 'package:nt_helper/domain/request_key.dart';
+import 'package:nt_helper/domain/sysex/sysex_stream_parser.dart';
+
+class MockMidiCommand extends Mock implements MidiCommand {}
+
+/// A minimal stream parser: F0..F7 framing with an explicit truncation
+/// report when a status byte interrupts a SysEx, as the native one does.
+class _FramingParser implements SysExStreamParser {
+  final List<int> _buffer = [];
+  bool _inSysEx = false;
+  int resets = 0;
+  bool disposed = false;
+
+  @override
+  void feed(
+    Uint8List data, {
+    required void Function(Uint8List sysex) onSysEx,
+    required void Function(Uint8List message) onOther,
+    required void Function() onTruncated,
+  }) {
+    for (final byte in data) {
+      if (byte == 0xF0) {
+        if (_inSysEx) onTruncated();
+        _buffer
+          ..clear()
+          ..add(byte);
+        _inSysEx = true;
+      } else if (_inSysEx && byte == 0xF7) {
+        _buffer.add(byte);
+        _inSysEx = false;
+        onSysEx(Uint8List.fromList(_buffer));
+      } else if (_inSysEx && byte >= 0x80) {
+        _inSysEx = false;
+        onTruncated();
+      } else if (_inSysEx) {
+        _buffer.add(byte);
+      }
+    }
+  }
+
+  @override
+  bool get inSysEx => _inSysEx;
+
+  @override
+  void reset() {
+    resets++;
+    _inSysEx = false;
+    _buffer.clear();
+  }
+
+  @override
+  void dispose() => disposed = true;
+}
+
+const int _testSysExId = 0x00;
+
+Uint8List _sysEx(DistingNTRespMessageType type, List<int> payload) =>
+    Uint8List.fromList([
+      0xF0,
+      0x00, 0x21, 0x27, // Expert Sleepers manufacturer ID
+      0x6D, // Disting NT prefix
+      _testSysExId,
+      type.value,
+      ...payload,
+      0xF7,
+    ]);
+
+void main() {
+  setUpAll(() {
+    registerFallbackValue(Uint8List(0));
+  });
+
+  late MockMidiCommand midi;
+  late StreamController<MidiPacket> incoming;
+  late _FramingParser parser;
+  late DistingMessageScheduler scheduler;
+  final device = MidiDevice('nt', 'disting NT', MidiDeviceType.serial, true);
+  final key = RequestKey(
+    sysExId: _testSysExId,
+    messageType: DistingNTRespMessageType.respNumAlgorithms,
+  );
+  final request = _sysEx(DistingNTRespMessageType.respNumAlgorithms, []);
+  final response = _sysEx(DistingNTRespMessageType.respNumAlgorithms, [
+    0x00,
+    0x00,
+    0x08,
+  ]);
+
+  void receive(List<int> bytes) =>
+      incoming.add(MidiPacket(Uint8List.fromList(bytes), 0, device));
+
+  setUp(() {
+    midi = MockMidiCommand();
+    incoming = StreamController<MidiPacket>.broadcast();
+    parser = _FramingParser();
+    when(() => midi.onMidiPacketReceived).thenAnswer((_) => incoming.stream);
+    when(
+      () => midi.sendData(any(), deviceId: any(named: 'deviceId')),
+    ).thenAnswer((_) {});
+    scheduler = DistingMessageScheduler(
+      midiCommand: midi,
+      inputDevice: device,
+      outputDevice: device,
+      sysExId: _testSysExId,
+      messageInterval: Duration.zero,
+      defaultTimeout: const Duration(seconds: 5),
+      defaultMaxRetries: 1,
+      sysExParser: parser,
+    );
+  });
+
+  tearDown(() {
+    scheduler.dispose();
+    incoming.close();
+  });
+
+  test('reassembles a response split across packets', () async {
+    final future = scheduler.sendRequest(request, key);
+    await Future.microtask(() {});
+    receive(response.sublist(0, 4));
+    receive(response.sublist(4));
+    expect(await future, isNotNull);
+  });
+
+  test('replays the request as soon as its response is truncated', () async {
+    final future = scheduler.sendRequest(request, key);
+    await Future.microtask(() {});
+
+    // Half a response, then a CC: the response can never finish. The
+    // timeout is five seconds, so only the truncation can trigger a resend.
+    receive([...response.sublist(0, 5), 0xB0, 0x01, 0x02]);
+    await Future.microtask(() {});
+    verify(() => midi.sendData(any(), deviceId: device.id)).called(2);
+    expect(scheduler.getDiagnostics()['truncatedSysEx'], 1);
+
+    receive(response);
+    expect(await future, isNotNull);
+  });
+
+  test('a stream error mid-SysEx resets the parser and replays', () async {
+    final future = scheduler.sendRequest(request, key);
+    await Future.microtask(() {});
+    receive(response.sublist(0, 5));
+    await Future.microtask(() {});
+    expect(parser.inSysEx, isTrue);
+
+    incoming.addError(StateError('transfer failed'));
+    await Future.microtask(() {});
+    expect(parser.resets, 1);
+    verify(() => midi.sendData(any(), deviceId: device.id)).called(2);
+
+    receive(response);
+    expect(await future, isNotNull);
+  });
+
+  test('truncation while idle sends nothing', () async {
+    receive([...response.sublist(0, 5), 0xF0]);
+    await Future.microtask(() {});
+    verifyNever(() => midi.sendData(any(), deviceId: any(named: 'deviceId')));
+    expect(scheduler.getDiagnostics()['truncatedSysEx'], 1);
+  });
+
+  test('dispose frees the parser', () {
+    scheduler.dispose();
+    expect(parser.disposed, isTrue);
+  });
+}
@@ -0,0 +1,170 @@
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:flutter_midi_command/flutter_midi_command.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:mocktail/mocktail.dart';
+import 'package:nt_helper/domain/disting_message_scheduler.dart';
+import 'package:nt_helper/domain/disting_nt_sysex.dart';
+import 'package:nt_helper/domain/midi_message_transport.dart';
+import 'package:nt_helper/domain/request_key.dart';
+
+class MockMidiCommand extends Mock implements MidiCommand {}
+
+/// Stands in for the native transport: messages arrive already framed.
+class _FakeTransport implements MidiMessageTransport {
+  StreamController<Uint8List> _messages = StreamController.broadcast();
+  final List<Uint8List> sent = [];
+  bool open = true;
+  int reopenCount = 0;
+
+  void receive(List<int> message) =>
+      _messages.add(Uint8List.fromList(message));
+
+  void unplug() {
+    open = false;
+    _messages.close();
+  }
+
+  @override
+  Stream<Uint8List> get messages => _messages.stream;
+
+  @override
+  bool get isOpen => open;
+
+  @override
+  void send(Uint8List data) {
+    if (!open) throw StateError('MIDI transport is closed');
+    sent.add(data);
+  }
+
+  @override
+  Future<bool> reopen() async {
+    reopenCount++;
+    _messages = StreamController.broadcast();
+    open = true;
+    return true;
+  }
+
+  @override
+  void close() {
+    if (open) unplug();
+  }
+}
+
+const int _testSysExId = 0x00;
+
+List<int> _sysEx(DistingNTRespMessageType type, List<int> payload) => [
+  0xF0,
+  0x00, 0x21, 0x27, // Expert Sleepers manufacturer ID
+  0x6D, // Disting NT prefix
+  _testSysExId,
+  type.value,
+  ...payload,
+  0xF7,
+];
+
+void main() {
+  setUpAll(() {
+    registerFallbackValue(Uint8List(0));
+  });
+
+  late MockMidiCommand midi;
+  late _FakeTransport transport;
+  late DistingMessageScheduler scheduler;
+  final key = RequestKey(
+    sysExId: _testSysExId,
+    messageType: DistingNTRespMessageType.respNumAlgorithms,
+  );
+  final request = Uint8List.fromList(
+    _sysEx(DistingNTRespMessageType.respNumAlgorithms, const []),
+  );
+
+  setUp(() {
+    midi = MockMidiCommand();
+    transport = _FakeTransport();
+    final device = MidiDevice('nt', 'disting NT', MidiDeviceType.serial, true);
+    scheduler = DistingMessageScheduler(
+      midiCommand: midi,
+      inputDevice: device,
+      outputDevice: device,
+      sysExId: _testSysExId,
+      messageInterval: Duration.zero,
+      defaultTimeout: const Duration(milliseconds: 200),
+      defaultMaxRetries: 1,
+      transport: transport,
+    );
+  });
+
+  tearDown(() {
+    scheduler.dispose();
+    transport.close();
+  });
+
+  test('sends through the transport, not flutter_midi_command', () async {
+    final future = scheduler.sendRequest(request, key);
+    await Future.microtask(() {});
+    expect(transport.sent, [request]);
+    verifyNever(() => midi.sendData(any(), deviceId: any(named: 'deviceId')));
+    verifyNever(() => midi.onMidiPacketReceived);
+
+    transport.receive(
+      _sysEx(DistingNTRespMessageType.respNumAlgorithms, [0x00, 0x00, 0x08]),
+    );
+    expect(await future, isNotNull);
+  });
+
+  test('dispatches framed CC messages to the CC callback', () async {
+    final received = <(int, int, int)>[];
+    scheduler.setCcCallback((channel, cc, value) {
+      received.add((channel, cc, value));
+    });
+
+    transport.receive([0xB2, 0x07, 0x64]);
+    transport.receive([0x92, 0x3C, 0x40]);
+    await Future.microtask(() {});
+
+    expect(received, [(2, 7, 100)]);
+  });
+
+  test('ignores SysEx for another SysEx ID', () async {
+    final future = scheduler.sendRequest(
+      request,
+      key,
+      timeout: const Duration(milliseconds: 50),
+    );
+    await Future.microtask(() {});
+    final other = _sysEx(DistingNTRespMessageType.respNumAlgorithms, [0, 0, 8]);
+    other[5] = 0x01;
+    transport.receive(other);
+
+    await expectLater(future, throwsA(isA<TimeoutException>()));
+  });
+
+  test('an unplugged transport fails sends instead of hanging', () async {
+    transport.unplug();
+    await Future.microtask(() {});
+    expect(
+      scheduler.getDiagnostics(),
+      containsPair('subscriptionActive', isFalse),
+    );
+
+    await expectLater(
+      scheduler.sendRequest(request, key),
+      throwsA(isA<StateError>()),
+    );
+  });
+
+  test('forced reconnect reopens the transport and listens again', () async {
+    await scheduler.forceDeviceReconnect();
+    expect(transport.reopenCount, 1);
+    verifyNever(() => midi.disconnectDevice(any()));
+
+    final future = scheduler.sendRequest(request, key);
+    await Future.microtask(() {});
+    transport.receive(
+      _sysEx(DistingNTRespMessageType.respNumAlgorithms, [0x00, 0x00, 0x08]),
+    );
+    expect(await future, isNotNull);
+  });
+}
@@ -0,0 +1,241 @@
+import 'dart:async';
+import 'dart:typed_data';
+
+import 'package:flutter_midi_command/flutter_midi_command.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:mocktail/mocktail.dart';
+import 'package:nt_helper/domain/disting_message_scheduler.dart';
+import 'package:nt_helper/domain/disting_nt_sysex.dart';
+import 'package:nt_helper/domain/request_key.dart';
+
+class MockMidiCommand extends Mock implements MidiCommand {}
+
+const int _sysExId = 0x00;
+
+Uint8List _sysEx(DistingNTRespMessageType type, List<int> payload) {
+  return Uint8List.fromList([
+    0xF0,
+    0x00,
+    0x21,
+    0x27,
+    0x6D,
+    _sysExId,
+    type.value,
+    ...payload,
+    0xF7,
+  ]);
+}
+
+/// A Parameter Value response: slot, parameter (16 bits as three 7-bit
+/// groups) and value.
+Uint8List _valueResponse(int slot, int parameter, int value) {
+  return _sysEx(DistingNTRespMessageType.respParameterValue, [
+    slot,
+    (parameter >> 14) & 0x03,
+    (parameter >> 7) & 0x7F,
+    parameter & 0x7F,
+    (value >> 14) & 0x03,
+    (value >> 7) & 0x7F,
+    value & 0x7F,
+  ]);
+}
+
+RequestKey _valueKey(int slot, int parameter) => RequestKey(
+  sysExId: _sysExId,
+  messageType: DistingNTRespMessageType.respParameterValue,
+  algorithmIndex: slot,
+  parameterNumber: parameter,
+);
+
+void main() {
+  setUpAll(() {
+    registerFallbackValue(Uint8List(0));
+  });
+
+  late MockMidiCommand midi;
+  late StreamController<MidiPacket> incoming;
+  late MidiDevice device;
+  late List<Uint8List> sent;
+  late DistingMessageScheduler scheduler;
+
+  DistingMessageScheduler createScheduler({int maxInFlight = 4}) {
+    return DistingMessageScheduler(
+      midiCommand: midi,
+      inputDevice: device,
+      outputDevice: device,
+      sysExId: _sysExId,
+      messageInterval: Duration.zero,
+      defaultTimeout: const Duration(milliseconds: 200),
+      defaultMaxRetries: 1,
+      maxInFlight: maxInFlight,
+    );
+  }
+
+  void respond(Uint8List sysex) {
+    incoming.add(MidiPacket(sysex, 0, device));
+  }
+
+  Future<void> settle() => Future<void>.delayed(Duration.zero);
+
+  setUp(() {
+    midi = MockMidiCommand();
+    incoming = StreamController<MidiPacket>.broadcast();
+    device = MidiDevice('nt', 'Disting NT', MidiDeviceType.serial, true);
+    sent = [];
+    when(() => midi.onMidiPacketReceived).thenAnswer((_) => incoming.stream);
+    when(
+      () => midi.sendData(any(), deviceId: any(named: 'deviceId')),
+    ).thenAnswer(
+      (invocation) => sent.add(invocation.positionalArguments[0] as Uint8List),
+    );
+    scheduler = createScheduler();
+  });
+
+  tearDown(() {
+    scheduler.dispose();
+    incoming.close();
+  });
+
+  test('keeps several parameter requests in flight', () async {
+    final futures = [
+      for (var p = 0; p < 4; p++)
+        scheduler.sendRequest<ParameterValue>(
+          Uint8List.fromList([p]),
+          _valueKey(1, p),
+        ),
+    ];
+
+    // The window starts at two.
+    expect(sent, hasLength(2));
+    expect(scheduler.getDiagnostics()['inFlight'], 2);
+
+    // Responses are matched by key, whatever order they come in.
+    respond(_valueResponse(1, 1, 11));
+    respond(_valueResponse(1, 0, 10));
+    await settle();
+    expect(sent, hasLength(4));
+
+    respond(_valueResponse(1, 2, 12));
+    respond(_valueResponse(1, 3, 13));
+
+    final results = await Future.wait(futures);
+    expect([for (final r in results) r!.value], [10, 11, 12, 13]);
+    expect([for (final r in results) r!.parameterNumber], [0, 1, 2, 3]);
+  });
+
+  test('requests the firmware cannot tell apart go alone', () async {
+    final first = scheduler.sendRequest<ParameterValue>(
+      Uint8List.fromList([0]),
+      _valueKey(0, 0),
+    );
+    // Enum strings match leniently, so this waits for the window to drain.
+    final enums = scheduler.sendRequest<dynamic>(
+      Uint8List.fromList([1]),
+      RequestKey(
+        sysExId: _sysExId,
+        messageType: DistingNTRespMessageType.respEnumStrings,
+        algorithmIndex: 0,
+        parameterNumber: 5,
+      ),
+    );
+    final after = scheduler.sendRequest<ParameterValue>(
+      Uint8List.fromList([2]),
+      _valueKey(0, 1),
+    );
+    expect(sent, hasLength(1));
+
+    respond(_valueResponse(0, 0, 1));
+    await first;
+    await settle();
+    // The enum request now goes, and nothing goes with it.
+    expect(sent, hasLength(2));
+    expect(sent[1], [1]);
+
+    respond(_sysEx(DistingNTRespMessageType.respEnumStrings, [0, 0, 0, 5, 0]));
+    await enums;
+    await settle();
+    expect(sent, hasLength(3));
+
+    respond(_valueResponse(0, 1, 2));
+    expect((await after)!.value, 2);
+  });
+
+  test('writes wait for outstanding reads', () async {
+    final reads = [
+      for (var p = 0; p < 2; p++)
+        scheduler.sendRequest<ParameterValue>(
+          Uint8List.fromList([p]),
+          _valueKey(2, p),
+        ),
+    ];
+    final write = scheduler.sendRequest<void>(
+      Uint8List.fromList([0x7F]),
+      RequestKey(sysExId: _sysExId),
+      responseExpectation: ResponseExpectation.none,
+    );
+    expect(sent, hasLength(2));
+
+    respond(_valueResponse(2, 0, 0));
+    respond(_valueResponse(2, 1, 0));
+    await Future.wait(reads);
+    await write;
+    expect(sent.last, [0x7F]);
+  });
+
+  test('identical keys are not in flight together', () async {
+    final a = scheduler.sendRequest<ParameterValue>(
+      Uint8List.fromList([0]),
+      _valueKey(3, 7),
+    );
+    final b = scheduler.sendRequest<ParameterValue>(
+      Uint8List.fromList([1]),
+      _valueKey(3, 7),
+    );
+    expect(sent, hasLength(1));
+
+    respond(_valueResponse(3, 7, 1));
+    expect((await a)!.value, 1);
+    await settle();
+    expect(sent, hasLength(2));
+    respond(_valueResponse(3, 7, 2));
+    expect((await b)!.value, 2);
+  });
+
+  test('a timeout halves the window', () async {
+    final lost = scheduler.sendRequest<ParameterValue>(
+      Uint8List.fromList([0]),
+      _valueKey(4, 0),
+    );
+    final answered = scheduler.sendRequest<ParameterValue>(
+      Uint8List.fromList([1]),
+      _valueKey(4, 1),
+    );
+    expect(scheduler.getDiagnostics()['window'], 2);
+
+    respond(_valueResponse(4, 1, 5));
+    expect((await answered)!.value, 5);
+    await expectLater(lost, throwsA(isA<TimeoutException>()));
+    expect(scheduler.getDiagnostics()['window'], 1);
+  });
+
+  test('stays sequential by default', () async {
+    scheduler.dispose();
+    scheduler = createScheduler(maxInFlight: 1);
+
+    final futures = [
+      for (var p = 0; p < 3; p++)
+        scheduler.sendRequest<ParameterValue>(
+          Uint8List.fromList([p]),
+          _valueKey(5, p),
+        ),
+    ];
+    expect(sent, hasLength(1));
+    for (var p = 0; p < 3; p++) {
+      respond(_valueResponse(5, p, p));
+      await futures[p];
+      await settle();
+    }
+    expect(sent, hasLength(3));
+    expect(scheduler.getDiagnostics()['maxInFlight'], 1);
+  });
+}
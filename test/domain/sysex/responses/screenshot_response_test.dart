@@ -0,0 +1,48 @@
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:image/image.dart' as img;
+import 'package:nt_helper/domain/sysex/responses/screenshot_response.dart';
+
+void main() {
+  group('Screenshot response', () {
+    test('gamma table matches the native renderer', () {
+      // native/usb_video/screenshot.cc, kScreenshotGamma.
+      expect(ScreenshotResponse.gamma, [
+        0, 147, 169, 184, 195, 204, 211, 218, //
+        224, 229, 234, 239, 243, 247, 251, 255,
+      ]);
+    });
+
+    test('renders levels in teal inside a black border', () {
+      final levels = Uint8List(256 * 64);
+      levels[0] = 15;
+      levels[1] = 7;
+      levels[256 * 64 - 1] = 200; // clamped to the brightest level
+
+      final png = ScreenshotResponse.render(levels);
+      final image = img.decodePng(png)!;
+
+      expect(image.width, 266);
+      expect(image.height, 74);
+      final border = image.getPixel(0, 0);
+      expect([border.r, border.g, border.b, border.a], [0, 0, 0, 255]);
+      final bright = image.getPixel(5, 5);
+      expect([bright.r, bright.g, bright.b], [0, 255, 255]);
+      final mid = image.getPixel(6, 5);
+      expect([mid.r, mid.g, mid.b], [0, 218, 218]);
+      final clamped = image.getPixel(260, 68);
+      expect([clamped.r, clamped.g, clamped.b], [0, 255, 255]);
+      final dark = image.getPixel(7, 5);
+      expect([dark.r, dark.g, dark.b], [0, 0, 0]);
+    });
+
+    test('leaves missing pixels black', () {
+      final image = img.decodePng(
+        ScreenshotResponse.render(Uint8List.fromList([15])),
+      )!;
+      expect(image.getPixel(5, 5).g, 255);
+      expect(image.getPixel(6, 5).g, 0);
+    });
+  });
+}
@@ -0,0 +1,166 @@
+import 'dart:math';
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:nt_helper/domain/sysex/requests/request_file_upload.dart';
+import 'package:nt_helper/domain/sysex/requests/request_file_upload_chunk.dart';
+import 'package:nt_helper/domain/sysex/responses/all_parameter_values_response.dart';
+import 'package:nt_helper/domain/sysex/responses/file_chunk_response.dart';
+import 'package:nt_helper/domain/sysex/sysex_utils.dart';
+
+/// The per-element encodings the batch helpers replaced, kept here as the
+/// reference they must match byte for byte.
+List<int> _referenceNybbles(List<int> bytes) => [
+  for (final byte in bytes) ...[(byte >> 4) & 0x0F, byte & 0x0F],
+];
+
+Uint8List _referenceUploadChunk(
+  int sysExId,
+  String path,
+  int position,
+  Uint8List data,
+  bool createAlways,
+) {
+  final count = data.length;
+  final message = <int>[
+    ...buildHeader(sysExId),
+    0x7A,
+    4,
+    ...path.codeUnits,
+    0,
+    createAlways ? 1 : 0,
+    0, 0, 0, 0, 0,
+    (position >> 28) & 0x0f,
+    (position >> 21) & 0x7f,
+    (position >> 14) & 0x7f,
+    (position >> 7) & 0x7f,
+    position & 0x7f,
+    0, 0, 0, 0, 0,
+    (count >> 28) & 0x0f,
+    (count >> 21) & 0x7f,
+    (count >> 14) & 0x7f,
+    (count >> 7) & 0x7f,
+    count & 0x7f,
+    ..._referenceNybbles(data),
+  ];
+  message.add(calculateChecksum(message.sublist(7)));
+  message.add(0xF7);
+  return Uint8List.fromList(message);
+}
+
+Uint8List _randomBytes(int length, int max, int seed) {
+  final random = Random(seed);
+  return Uint8List.fromList(
+    List.generate(length, (_) => random.nextInt(max + 1)),
+  );
+}
+
+void main() {
+  // Either side of the native threshold, so whichever codec runs here the
+  // output is checked.
+  const sizes = [0, 1, 15, 16, 17, 255, 256, 257, 1000];
+
+  group('nybble helpers', () {
+    test('encodeNybblesInto matches the per-byte encoding', () {
+      for (final size in sizes) {
+        final bytes = _randomBytes(size, 0xFF, size);
+        final out = Uint8List(2 * size + 3);
+        final sum = encodeNybblesInto(bytes, out, 3);
+        final expected = _referenceNybbles(bytes);
+        expect(out.sublist(3), expected, reason: 'size $size');
+        expect(sum, expected.fold<int>(0, (a, b) => a + b));
+      }
+    });
+
+    test('bytesToNybbles and nybblesToBytes round trip', () {
+      for (final size in sizes) {
+        final bytes = _randomBytes(size, 0xFF, size + 1);
+        final nybbles = bytesToNybbles(bytes);
+        expect(nybbles, _referenceNybbles(bytes));
+        expect(nybblesToBytes(Uint8List.fromList(nybbles)), bytes);
+        expect(nybblesToBytes(List<int>.of(nybbles)), bytes);
+      }
+    });
+
+    test('decodeNybbles masks each nybble and drops an odd last one', () {
+      final nybbles = Uint8List.fromList([0x7F, 0x31, 0x0A, 0x05, 0x09]);
+      expect(decodeNybbles(nybbles), [0xF1, 0xA5]);
+    });
+  });
+
+  group('file upload', () {
+    test('chunk encoding matches the per-byte encoding', () {
+      for (final size in sizes) {
+        final data = _randomBytes(size, 0xFF, size + 2);
+        final message = RequestFileUploadChunkMessage(
+          sysExId: 5,
+          path: '/samples/kick.wav',
+          position: 0x12345678,
+          data: data,
+          createAlways: size.isOdd,
+        );
+        expect(
+          message.encode(),
+          _referenceUploadChunk(
+            5,
+            '/samples/kick.wav',
+            0x12345678,
+            data,
+            size.isOdd,
+          ),
+          reason: 'size $size',
+        );
+      }
+    });
+
+    test('whole-file upload keeps its checksum over the payload', () {
+      final data = _randomBytes(300, 0xFF, 9);
+      final encoded = RequestFileUploadMessage(
+        sysExId: 1,
+        path: '/a.txt',
+        fileSize: data.length,
+        data: data,
+      ).encode();
+      final payload = encoded.sublist(7, encoded.length - 2);
+      expect(payload.sublist(payload.length - 600), _referenceNybbles(data));
+      expect(encoded[encoded.length - 2], calculateChecksum(payload));
+      expect(encoded.last, 0xF7);
+    });
+
+    test('download chunks decode back to the uploaded bytes', () {
+      final bytes = _randomBytes(700, 0xFF, 3);
+      final response = FileChunkResponse(
+        Uint8List.fromList([0, 2, ..._referenceNybbles(bytes)]),
+      );
+      expect(response.parse().data, bytes);
+    });
+  });
+
+  group('AllParameterValuesResponse', () {
+    test('matches decode16 with the flag bits masked off', () {
+      for (final count in [0, 1, 85, 86, 400]) {
+        final data = Uint8List.fromList([
+          3,
+          ..._randomBytes(3 * count, 0x7F, count),
+        ]);
+        final result = AllParameterValuesResponse(data).parse();
+        expect(result.algorithmIndex, 3);
+        expect(result.values, hasLength(count));
+        for (var i = 0; i < count; i++) {
+          final offset = 1 + 3 * i;
+          final expected = decode16([
+            data[offset] & 0x03,
+            data[offset + 1],
+            data[offset + 2],
+          ], 0);
+          expect(result.values[i].parameterNumber, i);
+          expect(result.values[i].value, expected, reason: 'parameter $i');
+          expect(
+            result.values[i].isDisabled,
+            ((data[offset] >> 2) & 0x1F) == 1,
+          );
+        }
+      }
+    });
+  });
+}
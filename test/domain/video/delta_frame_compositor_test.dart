@@ -0,0 +1,155 @@
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:nt_helper/domain/video/delta_frame_compositor.dart';
+
+const _width = 4;
+const _height = 3;
+const _stride = 12; // 4 px * 3 bytes, already a multiple of four
+
+Uint8List _bmp(int fill) {
+  final bytes = Uint8List(54 + _stride * _height);
+  final header = ByteData.sublistView(bytes);
+  bytes[0] = 0x42; // B
+  bytes[1] = 0x4D; // M
+  header.setUint32(2, bytes.length, Endian.little);
+  header.setUint32(10, 54, Endian.little);
+  header.setUint32(14, 40, Endian.little);
+  header.setInt32(18, _width, Endian.little);
+  header.setInt32(22, -_height, Endian.little);
+  bytes.fillRange(54, bytes.length, fill);
+  return bytes;
+}
+
+Uint8List _delta(List<(int firstRow, List<int> rowFills)> spans) {
+  final builder = BytesBuilder();
+  final header = ByteData(10)
+    ..setUint8(0, 0x4E) // N
+    ..setUint8(1, 0x44) // D
+    ..setUint8(2, 1)
+    ..setUint16(4, _width, Endian.little)
+    ..setUint16(6, _height, Endian.little)
+    ..setUint16(8, spans.length, Endian.little);
+  builder.add(header.buffer.asUint8List());
+  for (final (firstRow, rowFills) in spans) {
+    final spanHeader = ByteData(4)
+      ..setUint16(0, firstRow, Endian.little)
+      ..setUint16(2, rowFills.length, Endian.little);
+    builder.add(spanHeader.buffer.asUint8List());
+    for (final fill in rowFills) {
+      builder.add(List<int>.filled(_stride, fill));
+    }
+  }
+  return builder.toBytes();
+}
+
+List<int> _row(Uint8List bmp, int row) =>
+    bmp.sublist(54 + row * _stride, 54 + (row + 1) * _stride);
+
+void main() {
+  group('DeltaFrameCompositor', () {
+    test('passes keyframes through unchanged', () {
+      final compositor = DeltaFrameCompositor();
+      final keyframe = _bmp(7);
+      expect(compositor.apply(keyframe), same(keyframe));
+      expect(compositor.hasKeyframe, isTrue);
+    });
+
+    test('drops deltas until a keyframe arrives', () {
+      final compositor = DeltaFrameCompositor();
+      expect(
+        compositor.apply(_delta([
+          (0, [1]),
+        ])),
+        isNull,
+      );
+    });
+
+    test('patches changed rows into the last keyframe', () {
+      final compositor = DeltaFrameCompositor();
+      compositor.apply(_bmp(0));
+
+      final frame = compositor.apply(_delta([
+        (1, [9, 8]),
+      ]))!;
+
+      expect(frame.sublist(0, 54), _bmp(0).sublist(0, 54));
+      expect(_row(frame, 0), everyElement(0));
+      expect(_row(frame, 1), everyElement(9));
+      expect(_row(frame, 2), everyElement(8));
+    });
+
+    test('deltas accumulate and empty deltas repeat the picture', () {
+      final compositor = DeltaFrameCompositor();
+      compositor.apply(_bmp(0));
+      compositor.apply(_delta([
+        (0, [5]),
+      ]));
+      final frame = compositor.apply(_delta([]))!;
+
+      expect(_row(frame, 0), everyElement(5));
+      expect(_row(frame, 1), everyElement(0));
+    });
+
+    test('returns a fresh buffer for every delta', () {
+      final compositor = DeltaFrameCompositor();
+      compositor.apply(_bmp(0));
+      final first = compositor.apply(_delta([
+        (0, [1]),
+      ]))!;
+      final second = compositor.apply(_delta([
+        (0, [2]),
+      ]))!;
+
+      expect(_row(first, 0), everyElement(1));
+      expect(_row(second, 0), everyElement(2));
+    });
+
+    test('rejects deltas for a different frame size or out of range', () {
+      final compositor = DeltaFrameCompositor();
+      compositor.apply(_bmp(0));
+
+      final wrongSize = _delta([]);
+      ByteData.sublistView(wrongSize).setUint16(4, 8, Endian.little);
+      expect(compositor.apply(wrongSize), isNull);
+
+      expect(
+        compositor.apply(_delta([
+          (2, [1, 1]),
+        ])),
+        isNull,
+      );
+    });
+
+    test('patches deltas into a gray4 keyframe', () {
+      // 7 px wide: rows of four packed bytes, the last nibble is padding.
+      final keyframe = Uint8List(8 + 4 * 2);
+      ByteData.sublistView(keyframe)
+        ..setUint8(0, 0x47) // G
+        ..setUint8(1, 0x34) // 4
+        ..setUint8(2, 1)
+        ..setUint16(4, 7, Endian.little)
+        ..setUint16(6, 2, Endian.little);
+      final delta = Uint8List.fromList([
+        0x4E, 0x44, 1, 0, 7, 0, 2, 0, 1, 0, //
+        1, 0, 1, 0, 0xAB, 0xAB, 0xAB, 0xA0,
+      ]);
+
+      final compositor = DeltaFrameCompositor();
+      expect(compositor.apply(keyframe), same(keyframe));
+      final frame = compositor.apply(delta)!;
+
+      expect(frame.sublist(0, 8), keyframe.sublist(0, 8));
+      expect(frame.sublist(8, 12), everyElement(0));
+      expect(frame.sublist(12), [0xAB, 0xAB, 0xAB, 0xA0]);
+    });
+
+    test('reset forgets the keyframe', () {
+      final compositor = DeltaFrameCompositor();
+      compositor.apply(_bmp(0));
+      compositor.reset();
+      expect(compositor.hasKeyframe, isFalse);
+      expect(compositor.apply(_delta([])), isNull);
+    });
+  });
+}
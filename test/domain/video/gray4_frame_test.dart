@@ -0,0 +1,70 @@
+import 'dart:typed_data';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:nt_helper/domain/video/gray4_frame.dart';
+
+// 3 px wide, 2 rows: each row is two packed bytes, the last nibble padding.
+Uint8List _gray4Frame() {
+  final frame = Uint8List(8 + 2 * 2);
+  ByteData.sublistView(frame)
+    ..setUint8(0, 0x47) // G
+    ..setUint8(1, 0x34) // 4
+    ..setUint8(2, 1)
+    ..setUint16(4, 3, Endian.little)
+    ..setUint16(6, 2, Endian.little);
+  frame.setAll(8, [0x0F, 0x70, 0x12, 0x30]);
+  return frame;
+}
+
+void main() {
+  group('Gray4FrameConverter', () {
+    test('wraps packed rows in a top-down 4 bpp BMP', () {
+      final bmp = Gray4FrameConverter().apply(_gray4Frame())!;
+      final header = ByteData.sublistView(bmp);
+
+      expect(bmp.sublist(0, 2), [0x42, 0x4D]);
+      expect(header.getUint32(2, Endian.little), bmp.length);
+      expect(header.getUint32(10, Endian.little), 54 + 64);
+      expect(header.getInt32(18, Endian.little), 3);
+      expect(header.getInt32(22, Endian.little), -2);
+      expect(header.getUint16(28, Endian.little), 4);
+      expect(header.getUint32(46, Endian.little), 16);
+
+      // Rows are padded from two bytes to four.
+      expect(bmp.length, 54 + 64 + 4 * 2);
+      expect(bmp.sublist(118, 122), [0x0F, 0x70, 0, 0]);
+      expect(bmp.sublist(122, 126), [0x12, 0x30, 0, 0]);
+    });
+
+    test('writes the palette as BGR entries', () {
+      final palette = List<int>.generate(16, (level) => 0xFF000000 | level);
+      palette[15] = 0xFF00FFFF;
+      final bmp = Gray4FrameConverter(palette: palette).apply(_gray4Frame())!;
+
+      expect(bmp.sublist(54 + 3 * 4, 54 + 4 * 4), [3, 0, 0, 0]);
+      expect(bmp.sublist(54 + 15 * 4, 54 + 16 * 4), [0xFF, 0xFF, 0, 0]);
+    });
+
+    test('default palette spans black to white', () {
+      final bmp = Gray4FrameConverter().apply(_gray4Frame())!;
+      expect(bmp.sublist(54, 58), [0, 0, 0, 0]);
+      expect(bmp.sublist(54 + 15 * 4, 54 + 16 * 4), [255, 255, 255, 0]);
+    });
+
+    test('passes other frames through and drops truncated ones', () {
+      final converter = Gray4FrameConverter();
+      final other = Uint8List.fromList([0x42, 0x4D, 0, 0]);
+      expect(converter.apply(other), same(other));
+
+      final frame = _gray4Frame();
+      expect(converter.apply(frame.sublist(0, frame.length - 1)), isNull);
+    });
+
+    test('rejects palettes without sixteen entries', () {
+      expect(
+        () => Gray4FrameConverter(palette: const [0, 1, 2]),
+        throwsArgumentError,
+      );
+    });
+  });
+}
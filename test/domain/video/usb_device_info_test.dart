@@ -0,0 +1,32 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:nt_helper/domain/video/usb_device_info.dart';
+
+void main() {
+  group('UsbDeviceInfo', () {
+    test('reads frame rates as doubles, fastest first', () {
+      final info = UsbDeviceInfo.fromMap({
+        'deviceId': '/dev/video2',
+        'productName': 'disting NT',
+        'vendorId': 0x3773,
+        'productId': 0x0001,
+        'isDistingNT': true,
+        'frameRates': [60, 29.97, 15.0],
+      });
+
+      expect(info.frameRates, [60.0, 29.97, 15.0]);
+      expect(UsbDeviceInfo.fromMap(info.toMap()).frameRates, info.frameRates);
+    });
+
+    test('defaults to no frame rates when the platform sends none', () {
+      final info = UsbDeviceInfo.fromMap({
+        'deviceId': 'usb-1',
+        'productName': 'disting NT',
+        'vendorId': 0x3773,
+        'productId': 0x0001,
+        'isDistingNT': true,
+      });
+
+      expect(info.frameRates, isEmpty);
+    });
+  });
+}
@@ -0,0 +1,188 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:nt_helper/domain/video/usb_device_info.dart';
+import 'package:nt_helper/domain/video/usb_video_hotplug_event.dart';
+import 'package:nt_helper/domain/video/usb_video_manager.dart';
+import 'package:nt_helper/services/platform_channels/usb_video_channel.dart';
+
+const _disting = UsbDeviceInfo(
+  deviceId: '/dev/video2',
+  productName: 'disting NT',
+  vendorId: 0x3773,
+  productId: 0x0001,
+  isDistingNT: true,
+);
+
+class _FakeUsbVideoChannel extends UsbVideoChannel {
+  final hotplug = StreamController<UsbVideoHotplugEvent>.broadcast();
+  final frames = StreamController<dynamic>.broadcast();
+  List<UsbDeviceInfo> cameras = [];
+  final started = <String>[];
+  int stops = 0;
+  int listCalls = 0;
+
+  @override
+  bool get supportsHotplugEvents => true;
+
+  @override
+  Stream<UsbVideoHotplugEvent> get hotplugEvents => hotplug.stream;
+
+  @override
+  Future<bool> isSupported() async => true;
+
+  @override
+  Future<List<UsbDeviceInfo>> listUsbCameras() async {
+    listCalls++;
+    return cameras;
+  }
+
+  @override
+  Future<bool> requestUsbPermission(String deviceId) async => true;
+
+  @override
+  Stream<dynamic> startVideoStream(
+    String deviceId, {
+    bool useTexture = false,
+    Duration? keepAlive,
+    bool useDeltaFrames = false,
+    bool useGray4 = false,
+    List<int>? gray4Palette,
+    double? fps,
+    bool pauseWhenHidden = true,
+  }) {
+    started.add(deviceId);
+    return frames.stream;
+  }
+
+  @override
+  Future<void> stopVideoStream() async {
+    stops++;
+  }
+
+  @override
+  Future<void> dispose() async {}
+}
+
+bool _isStreaming(UsbVideoManager manager) => manager.currentState.maybeWhen(
+  streaming: (stream, width, height, fps) => true,
+  orElse: () => false,
+);
+
+bool _isError(UsbVideoManager manager) =>
+    manager.currentState.maybeWhen(error: (_) => true, orElse: () => false);
+
+Future<void> _settle() => Future.delayed(const Duration(milliseconds: 200));
+
+void main() {
+  group('UsbVideoManager hotplug', () {
+    late _FakeUsbVideoChannel channel;
+    late UsbVideoManager manager;
+
+    setUp(() async {
+      channel = _FakeUsbVideoChannel();
+      manager = UsbVideoManager(channel: channel);
+      await manager.initialize();
+    });
+
+    tearDown(() => manager.dispose());
+
+    test('connects as soon as a missing device is attached', () async {
+      await manager.autoConnect();
+      expect(_isError(manager), isTrue);
+
+      channel.hotplug.add(const UsbVideoDeviceAttached(_disting));
+      await _settle();
+
+      expect(channel.started, [_disting.deviceId]);
+      expect(_isStreaming(manager), isTrue);
+    });
+
+    test('stops the stream and waits without polling on detach', () async {
+      channel.cameras = [_disting];
+      channel.hotplug.add(const UsbVideoDeviceAttached(_disting));
+      await manager.autoConnect();
+      await _settle();
+      expect(_isStreaming(manager), isTrue);
+      final listCallsBefore = channel.listCalls;
+
+      channel.hotplug.add(UsbVideoDeviceDetached(_disting.deviceId));
+      await _settle();
+
+      expect(_isError(manager), isTrue);
+      expect(channel.stops, 1);
+      // The first backoff retry would have probed again by now.
+      await Future.delayed(const Duration(milliseconds: 2200));
+      expect(channel.listCalls, listCallsBefore);
+
+      channel.hotplug.add(const UsbVideoDeviceAttached(_disting));
+      await _settle();
+      expect(_isStreaming(manager), isTrue);
+      expect(channel.started, [_disting.deviceId, _disting.deviceId]);
+    });
+
+    test('does not reconnect after an explicit disconnect', () async {
+      await manager.disconnect();
+      channel.hotplug.add(const UsbVideoDeviceAttached(_disting));
+      await _settle();
+      expect(channel.started, isEmpty);
+    });
+
+    test('ignores devices that are not a Disting NT', () async {
+      await manager.autoConnect();
+      channel.hotplug.add(
+        const UsbVideoDeviceAttached(
+          UsbDeviceInfo(
+            deviceId: '/dev/video0',
+            productName: 'Webcam',
+            vendorId: 1,
+            productId: 2,
+            isDistingNT: false,
+          ),
+        ),
+      );
+      await _settle();
+      expect(channel.started, isEmpty);
+    });
+
+    test('does not take a paused stream for a stall', () async {
+      channel.cameras = [_disting];
+      channel.hotplug.add(const UsbVideoDeviceAttached(_disting));
+      await manager.autoConnect();
+      await _settle();
+      final listener = manager.getRawVideoStream()!.listen((_) {});
+
+      channel.frames.add({'paused': true});
+      // Well past the stall threshold with nothing arriving.
+      await Future.delayed(const Duration(milliseconds: 4200));
+      expect(_isStreaming(manager), isTrue);
+      expect(channel.stops, 0);
+      await listener.cancel();
+    });
+  });
+
+  group('UsbVideoHotplugEvent', () {
+    test('parses attach and detach events', () {
+      final attached = UsbVideoHotplugEvent.fromMap({
+        'event': 'attached',
+        'device': _disting.toMap(),
+      });
+      expect(attached, isA<UsbVideoDeviceAttached>());
+      expect(
+        (attached as UsbVideoDeviceAttached).device.deviceId,
+        '/dev/video2',
+      );
+
+      final detached = UsbVideoHotplugEvent.fromMap({
+        'event': 'detached',
+        'deviceId': '/dev/video2',
+      });
+      expect((detached as UsbVideoDeviceDetached).deviceId, '/dev/video2');
+    });
+
+    test('ignores unknown or malformed events', () {
+      expect(UsbVideoHotplugEvent.fromMap({'event': 'moved'}), isNull);
+      expect(UsbVideoHotplugEvent.fromMap({'event': 'attached'}), isNull);
+    });
+  });
+}
@@ -0,0 +1,70 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:nt_helper/domain/video/video_pipeline_telemetry.dart';
+
+Map<String, dynamic> _stage(int p50) => {
+  'count': 10,
+  'minUs': 1,
+  'meanUs': p50,
+  'p50Us': p50,
+  'p90Us': p50 * 2,
+  'p99Us': p50 * 3,
+  'maxUs': p50 * 4,
+};
+
+void main() {
+  group('VideoPipelineTelemetry', () {
+    test('recognises telemetry reports only', () {
+      expect(
+        VideoPipelineTelemetry.isReport({'type': 'videoTelemetry'}),
+        isTrue,
+      );
+      expect(VideoPipelineTelemetry.isReport({'type': 'other'}), isFalse);
+      expect(VideoPipelineTelemetry.isReport('log line'), isFalse);
+    });
+
+    test('parses a native report', () {
+      final report = VideoPipelineTelemetry.fromMap({
+        'type': 'videoTelemetry',
+        'session': 3,
+        'sessionMs': 12000,
+        'windowMs': 1005,
+        'dequeue': _stage(400),
+        'queueWait': _stage(50),
+        'convert': _stage(30),
+        'encode': _stage(20),
+        'send': _stage(10),
+        'framesCaptured': 720,
+        'framesDelivered': 700,
+        'framesSuppressed': 15,
+        'framesOverwritten': 5,
+        'framesDroppedByDriver': 2,
+        'captureFps': 60.0,
+        'deliveredFps': 58.5,
+        'captureThreadCpuMs': 340,
+        'captureThreadCpuPercent': 2.5,
+      });
+
+      expect(report.session, 3);
+      expect(report.sessionDuration, const Duration(seconds: 12));
+      expect(report.window, const Duration(milliseconds: 1005));
+      expect(report.dequeue.p50Us, 400);
+      expect(report.queueWait.p99Us, 150);
+      expect(report.send.maxUs, 40);
+      expect(report.framesDelivered, 700);
+      expect(report.framesDroppedByDriver, 2);
+      expect(report.deliveredFps, 58.5);
+      expect(report.captureThreadCpu, const Duration(milliseconds: 340));
+      expect(report.captureThreadCpuPercent, 2.5);
+    });
+
+    test('tolerates missing fields and integer rates', () {
+      final report = VideoPipelineTelemetry.fromMap({
+        'type': 'videoTelemetry',
+        'captureFps': 30,
+      });
+      expect(report.captureFps, 30.0);
+      expect(report.encode.count, 0);
+      expect(report.framesCaptured, 0);
+    });
+  });
+}
@@ -0,0 +1,77 @@
+import 'package:flutter_test/flutter_test.dart';
+import 'package:nt_helper/services/platform_channels/alsa_midi_transport.dart';
+
+AlsaSeqPort _port(
+  int client,
+  String clientName,
+  String portName, {
+  bool readable = true,
+  bool writable = true,
+}) => AlsaSeqPort(
+  client: client,
+  port: 0,
+  clientName: clientName,
+  portName: portName,
+  readable: readable,
+  writable: writable,
+);
+
+void main() {
+  group('AlsaMidiTransport.matchPort', () {
+    final through = _port(14, 'Midi Through', 'Midi Through Port-0');
+    final synth = _port(20, 'Synth', 'Synth MIDI 1');
+    final nt = _port(24, 'disting NT', 'disting NT MIDI 1');
+
+    test('matches the device name case-insensitively', () {
+      expect(
+        AlsaMidiTransport.matchPort([
+          through,
+          synth,
+          nt,
+        ], 'DISTING NT MIDI 1', input: true),
+        nt,
+      );
+      expect(
+        AlsaMidiTransport.matchPort([through, synth], 'synth', input: false),
+        synth,
+      );
+    });
+
+    test('prefers an exact name over a partial one', () {
+      final ntSecond = _port(28, 'disting NT 2', 'disting NT 2 MIDI 1');
+      expect(
+        AlsaMidiTransport.matchPort([
+          ntSecond,
+          nt,
+        ], 'disting NT', input: true),
+        nt,
+      );
+    });
+
+    test('falls back to a Disting port', () {
+      expect(
+        AlsaMidiTransport.matchPort([
+          through,
+          nt,
+        ], 'USB MIDI Interface', input: true),
+        nt,
+      );
+      expect(
+        AlsaMidiTransport.matchPort([through, synth], 'Unknown', input: true),
+        isNull,
+      );
+    });
+
+    test('only considers ports in the right direction', () {
+      final outputOnly = _port(24, 'disting NT', 'disting NT', readable: false);
+      expect(
+        AlsaMidiTransport.matchPort([outputOnly], 'disting NT', input: true),
+        isNull,
+      );
+      expect(
+        AlsaMidiTransport.matchPort([outputOnly], 'disting NT', input: false),
+        outputOnly,
+      );
+    });
+  });
+}
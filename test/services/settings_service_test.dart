@@ -29,6 +29,13 @@ const Map<String, Object> _nonDefaultSeeds = {
   'video_popup_bounds_y': 20.0,
   'video_popup_bounds_width': 640.0,
   'video_popup_bounds_height': 180.0,
+  'video_texture_delivery_enabled': true,
+  'video_delta_frames_enabled': true,
+  'video_gray4_enabled': true,
+  'video_pause_when_hidden': false,
+  'native_midi_transport_enabled': true,
+  'native_sysex_parser_enabled': true,
+  'pipelined_requests_enabled': true,
   'show_debug_panel': false,
   'show_contextual_help': false,
   'algorithm_cache_days': 17,
@@ -165,6 +172,34 @@ void main() {
           settings.videoToolbarAlwaysVisible,
           SettingsService.defaultVideoToolbarAlwaysVisible,
         );
+        expect(
+          settings.videoTextureDeliveryEnabled,
+          SettingsService.defaultVideoTextureDeliveryEnabled,
+        );
+        expect(
+          settings.videoDeltaFramesEnabled,
+          SettingsService.defaultVideoDeltaFramesEnabled,
+        );
+        expect(
+          settings.videoGray4Enabled,
+          SettingsService.defaultVideoGray4Enabled,
+        );
+        expect(
+          settings.videoPauseWhenHidden,
+          SettingsService.defaultVideoPauseWhenHidden,
+        );
+        expect(
+          settings.nativeMidiTransportEnabled,
+          SettingsService.defaultNativeMidiTransportEnabled,
+        );
+        expect(
+          settings.nativeSysExParserEnabled,
+          SettingsService.defaultNativeSysExParserEnabled,
+        );
+        expect(
+          settings.pipelinedRequestsEnabled,
+          SettingsService.defaultPipelinedRequestsEnabled,
+        );
         expect(
           settings.videoPopupAlwaysOnTop,
           SettingsService.defaultVideoPopupAlwaysOnTop,
@@ -24,6 +24,9 @@
 #include <comdef.h>
 #include <atlbase.h>
 
+#include "bmp_encoder.h"
+#include "yuyv_convert.h"
+
 #pragma comment(lib, "mfplat.lib")
 #pragma comment(lib, "mfreadwrite.lib")
 #pragma comment(lib, "mfuuid.lib")
@@ -634,33 +637,13 @@ void UsbVideoCapturePlugin::CaptureThread() {
       // Check if it's YUY2 format
       else if (length >= expected_yuy2 && length <= expected_yuy2 + 100) {
         OutputDebugStringA("[USB_VIDEO_CPP] Processing as YUY2 data (converting to RGB)\n");
-        // Convert YUY2 to RGB
+        // The same SIMD conversion the Linux runner uses (native/usb_video).
+        // It treats Y as video range (16-235) and stretches it to 0-255,
+        // where the old float path here passed Y through: black is now 0
+        // rather than 16, white 255 rather than 235, and mid grays move by
+        // up to 20 levels, so screenshots match the Linux app.
         std::vector<uint8_t> rgb_data(width * height * 3);
-        for (UINT32 i = 0; i < width * height / 2; i++) {
-          // YUY2 format: Y0 U Y1 V (4 bytes for 2 pixels)
-          uint8_t y0 = data[i * 4];
-          uint8_t u = data[i * 4 + 1];
-          uint8_t y1 = data[i * 4 + 2];
-          uint8_t v = data[i * 4 + 3];
-
-          // Convert YUV to RGB for pixel 0
-          int r0 = static_cast<int>(y0 + 1.402 * (v - 128));
-          int g0 = static_cast<int>(y0 - 0.344 * (u - 128) - 0.714 * (v - 128));
-          int b0 = static_cast<int>(y0 + 1.772 * (u - 128));
-
-          // Convert YUV to RGB for pixel 1
-          int r1 = static_cast<int>(y1 + 1.402 * (v - 128));
-          int g1 = static_cast<int>(y1 - 0.344 * (u - 128) - 0.714 * (v - 128));
-          int b1 = static_cast<int>(y1 + 1.772 * (u - 128));
-
-          // Clamp values and store
-          rgb_data[i * 6] = static_cast<uint8_t>(std::max(0, std::min(255, r0)));
-          rgb_data[i * 6 + 1] = static_cast<uint8_t>(std::max(0, std::min(255, g0)));
-          rgb_data[i * 6 + 2] = static_cast<uint8_t>(std::max(0, std::min(255, b0)));
-          rgb_data[i * 6 + 3] = static_cast<uint8_t>(std::max(0, std::min(255, r1)));
-          rgb_data[i * 6 + 4] = static_cast<uint8_t>(std::max(0, std::min(255, g1)));
-          rgb_data[i * 6 + 5] = static_cast<uint8_t>(std::max(0, std::min(255, b1)));
-        }
+        usb_video::ConvertYuyvToRgb24(data, (width * height) & ~1u, rgb_data.data());
         bmp = EncodeBMP(rgb_data.data(), width, height);
       }
       else {
@@ -705,45 +688,9 @@ void UsbVideoCapturePlugin::CaptureThread() {
 }
 
 std::vector<uint8_t> UsbVideoCapturePlugin::EncodeBMP(const uint8_t* rgb_data, int width, int height) {
-  // BMP file format for 256x64 RGB image
-  int row_padding = (4 - (width * 3) % 4) % 4;
-  int row_size = width * 3 + row_padding;
-  int data_size = row_size * height;
-  int file_size = 54 + data_size;
-
-  std::vector<uint8_t> bmp(file_size);
-
-  // BMP Header
-  bmp[0] = 'B'; bmp[1] = 'M';
-  *(uint32_t*)&bmp[2] = file_size;
-  *(uint32_t*)&bmp[6] = 0;
-  *(uint32_t*)&bmp[10] = 54;
-
-  // DIB Header
-  *(uint32_t*)&bmp[14] = 40;
-  *(int32_t*)&bmp[18] = width;
-  *(int32_t*)&bmp[22] = -height; // Negative for top-down
-  *(uint16_t*)&bmp[26] = 1;
-  *(uint16_t*)&bmp[28] = 24;
-  *(uint32_t*)&bmp[30] = 0;
-  *(uint32_t*)&bmp[34] = data_size;
-  *(int32_t*)&bmp[38] = 2835;
-  *(int32_t*)&bmp[42] = 2835;
-  *(uint32_t*)&bmp[46] = 0;
-  *(uint32_t*)&bmp[50] = 0;
-
-  // Copy RGB data
-  for (int y = 0; y < height; y++) {
-    for (int x = 0; x < width; x++) {
-      int src_idx = (y * width + x) * 3;
-      int dst_idx = 54 + y * row_size + x * 3;
-      // BMP stores BGR, not RGB
-      bmp[dst_idx] = rgb_data[src_idx + 2];     // B
-      bmp[dst_idx + 1] = rgb_data[src_idx + 1]; // G
-      bmp[dst_idx + 2] = rgb_data[src_idx];     // R
-    }
-  }
-
+  // Top-down 24-bit BMP, byte for byte what the Linux runner sends.
+  std::vector<uint8_t> bmp(usb_video::BmpFileSize(width, height));
+  usb_video::EncodeBmp24(rgb_data, width, height, bmp.data());
   return bmp;
 }
 